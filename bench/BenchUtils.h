@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+struct Entry {
+    const char* name;
+    void (*fn)();
+};
+
+std::vector<Entry>& registry();
+
+struct Registration {
+    Registration(const char* name, void (*fn)()) {
+        registry().push_back({name, fn});
+    }
+};
+
+/// Keep the result of a computation, so the compiler can't optimize it away
+void consume(unsigned long long);
+/// Print the result of a measurement
+void report(const std::string& label, double ns_per_call);
+
+/// Run the function `iterations` times, print and return the average time of one call in nanoseconds
+template <typename Fn>
+double measure(const std::string& label, unsigned iterations, Fn&& fn)
+{
+    const auto start = Clock::now();
+    for (unsigned i = 0; i < iterations; i++)
+        fn();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(Clock::now() - start);
+
+    const double ns_per_call = elapsed.count() / iterations;
+    report(label, ns_per_call);
+    return ns_per_call;
+}
+
+} // namespace Bench
+
+
+#define BENCHMARK(Name) \
+    static void bench_##Name(); \
+    static Bench::Registration bench_registration_##Name(#Name, bench_##Name); \
+    static void bench_##Name()
@@ -0,0 +1,122 @@
+#include "BenchUtils.h"
+
+#include "game/components/rotations/SRS.h"
+#include "game/components/well/Board.h"
+#include "game/util/Matrix.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+
+namespace {
+
+using Board = WellComponents::Board<10, 40>;
+// The minos are only tested for existence, the pointed value is not used
+using MinoPtr = std::shared_ptr<char>;
+using MinoMatrix = Matrix<MinoPtr, Board::height, Board::width>;
+using PieceGrid = Matrix<MinoPtr, 4, 4>;
+
+// The collision test as it was before the bitmask board: a 4x4 loop
+// over the shared Mino pointers of the matrix and the piece grid
+bool hasCollisionCellwise(const MinoMatrix& matrix, const PieceGrid& grid, int offset_x, unsigned offset_y)
+{
+    if (offset_x + 3 < 0 || offset_x >= static_cast<int>(matrix.at(0).size()))
+        return true;
+
+    if (offset_y >= matrix.size())
+        return true;
+
+    size_t piece_gridx = 0, piece_gridy = 0;
+    for (unsigned row = offset_y; row <= offset_y + 3; row++) {
+        for (int cell = offset_x; cell <= offset_x + 3; cell++) {
+            bool board_has_mino_here = true;
+            if (row < matrix.size() &&
+                cell >= 0 &&
+                cell < static_cast<int>(matrix.at(0).size()))
+                board_has_mino_here = matrix.at(row).at(cell).operator bool();
+
+            bool piece_has_mino_here = grid.at(piece_gridy).at(piece_gridx).operator bool();
+
+            if (piece_has_mino_here && board_has_mino_here)
+                return true;
+
+            piece_gridx++;
+        }
+        piece_gridy++;
+        piece_gridx = 0;
+    }
+
+    return false;
+}
+
+bool hasCollisionMasked(const Board& board, const Board::PieceMaskRow& masks, int offset_x, unsigned offset_y)
+{
+    if (offset_x + 3 < 0 || offset_x >= static_cast<int>(board.width))
+        return true;
+
+    if (offset_y >= board.height)
+        return true;
+
+    return board.hasCollision(masks[offset_x + Board::wall_width], offset_y);
+}
+
+} // namespace
+
+
+BENCHMARK(Collision)
+{
+    constexpr unsigned iterations = 200;
+
+    // a half-filled board, with the same content in both representations
+    std::srand(1);
+    const auto mino = std::make_shared<char>('+');
+    Board board;
+    MinoMatrix matrix;
+    for (unsigned row = Board::height / 2; row < Board::height; row++) {
+        for (unsigned col = 0; col < Board::width; col++) {
+            if (std::rand() % 3 == 0)
+                continue;
+            board.setCell(row, col, PieceType::GARBAGE);
+            matrix[row][col] = mino;
+        }
+    }
+
+    const auto& shapes = Rotations::SRS::shapes();
+    for (const auto type : PieceTypeList) {
+        for (unsigned rotation = 0; rotation < 4; rotation++) {
+            const auto& grid_rows = shapes[static_cast<size_t>(type)][rotation].grid_rows;
+
+            PieceGrid grid;
+            for (unsigned row = 0; row < 4; row++) {
+                for (unsigned col = 0; col < 4; col++) {
+                    if (grid_rows[row] & (1u << col))
+                        grid[row][col] = mino;
+                }
+            }
+            const auto masks = Board::makePieceMasks(grid_rows);
+
+            unsigned long long cellwise_hits = 0;
+            unsigned long long masked_hits = 0;
+            const std::string label = std::string(1, toAscii(type))
+                                    + " " + toAscii(static_cast<PieceDirection>(rotation));
+
+            Bench::measure(label + " cellwise (all positions)", iterations, [&](){
+                for (int x = -3; x < static_cast<int>(Board::width); x++) {
+                    for (unsigned y = 0; y < Board::height; y++)
+                        cellwise_hits += hasCollisionCellwise(matrix, grid, x, y);
+                }
+            });
+            Bench::measure(label + " bitmask (all positions)", iterations, [&](){
+                for (int x = -3; x < static_cast<int>(Board::width); x++) {
+                    for (unsigned y = 0; y < Board::height; y++)
+                        masked_hits += hasCollisionMasked(board, masks, x, y);
+                }
+            });
+
+            if (cellwise_hits != masked_hits)
+                std::cout << "  MISMATCH: " << cellwise_hits << " vs " << masked_hits << "\n";
+            Bench::consume(cellwise_hits + masked_hits);
+        }
+    }
+}
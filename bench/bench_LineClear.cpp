@@ -0,0 +1,151 @@
+#include "BenchUtils.h"
+
+#include "game/components/PieceType.h"
+#include "game/components/well/Board.h"
+#include "game/util/Matrix.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <vector>
+#include <stdint.h>
+
+
+namespace {
+
+using Board = WellComponents::Board<10, 40>;
+
+// The line clear of the well before the row bitmasks (Well::checkLineclear
+// and Well::removeEmptyRows, without the animations and events): the cells
+// are shared pointers to minos, every cell of every row is checked, the full
+// rows are collected into a set, then the rows are swapped down one by one
+struct Mino {};
+
+struct CellGridBoard {
+    Matrix<std::shared_ptr<Mino>, Board::height, Board::width> matrix;
+
+    unsigned lineClear() {
+        std::set<uint8_t> pending_cleared_rows;
+        for (unsigned row = 0; row < matrix.size(); row++) {
+            bool row_filled = true;
+            for (auto& cell : matrix[row]) {
+                if (!cell) {
+                    row_filled = false;
+                    break;
+                }
+            }
+
+            if (row_filled)
+                pending_cleared_rows.insert(row);
+        }
+        if (pending_cleared_rows.empty())
+            return 0;
+
+        for (auto row : pending_cleared_rows) {
+            for (auto& cell : matrix[row])
+                cell = nullptr;
+        }
+        const unsigned cleared_count = pending_cleared_rows.size();
+
+        for (int row = matrix.size(); row >= 0; row--) {
+            if (!pending_cleared_rows.count(row))
+                continue;
+
+            int next_filled_row = row;
+            while (pending_cleared_rows.count(next_filled_row))
+                next_filled_row--;
+
+            if (next_filled_row < 0)
+                break;
+
+            matrix[row].swap(matrix[next_filled_row]);
+            pending_cleared_rows.insert(next_filled_row);
+        }
+        return cleared_count;
+    }
+};
+
+unsigned lineClearMasked(Board& board, unsigned first_row, unsigned last_row)
+{
+    const Board::RowSet cleared_rows = board.fullRows(first_row, last_row);
+    if (!cleared_rows)
+        return 0;
+
+    board.clearRows(cleared_rows);
+    board.removeRows(cleared_rows);
+    return countSetBits(cleared_rows);
+}
+
+/// Measure the line clears of copies of a board; the copies are made
+/// in batches, outside of the timed region
+template <typename BoardType, typename Fn>
+void measureClears(const std::string& label, const BoardType& source, unsigned long long& cleared, Fn&& fn)
+{
+    constexpr unsigned batch_size = 100;
+    constexpr unsigned batch_count = 2000;
+
+    std::vector<BoardType> boards(batch_size);
+    Bench::Clock::duration elapsed = Bench::Clock::duration::zero();
+    for (unsigned batch = 0; batch < batch_count; batch++) {
+        std::fill(boards.begin(), boards.end(), source);
+
+        const auto start = Bench::Clock::now();
+        for (auto& board : boards)
+            cleared += fn(board);
+        elapsed += Bench::Clock::now() - start;
+    }
+
+    const auto elapsed_ns = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(elapsed);
+    Bench::report(label, elapsed_ns.count() / (batch_size * batch_count));
+}
+
+} // namespace
+
+
+BENCHMARK(LineClear)
+{
+    constexpr unsigned filled_rows = 30;
+
+    // a dense board, with the same content in both representations;
+    // every row has one hole
+    std::srand(1);
+    const auto mino = std::make_shared<Mino>();
+    Board base_board;
+    CellGridBoard base_gridboard;
+    std::array<unsigned, Board::height> holes;
+    for (unsigned row = Board::height - filled_rows; row < Board::height; row++) {
+        holes[row] = std::rand() % Board::width;
+        for (unsigned col = 0; col < Board::width; col++) {
+            if (col == holes[row])
+                continue;
+            base_board.setCell(row, col, PieceType::GARBAGE);
+            base_gridboard.matrix[row][col] = mino;
+        }
+    }
+
+    // a piece locked at these rows fills the holes of its first and third row
+    for (const unsigned top_row : {Board::height - 4, Board::height - 14, Board::height - 24}) {
+        Board dense_board = base_board;
+        CellGridBoard dense_gridboard = base_gridboard;
+        for (const unsigned row : {top_row, top_row + 2}) {
+            dense_board.setCell(row, holes[row], PieceType::GARBAGE);
+            dense_gridboard.matrix[row][holes[row]] = mino;
+        }
+
+        unsigned long long grid_cleared = 0;
+        unsigned long long masked_cleared = 0;
+        const std::string label = "rows " + std::to_string(top_row) + "-" + std::to_string(top_row + 3);
+
+        measureClears(label + " cell grid", dense_gridboard, grid_cleared, [](CellGridBoard& board){
+            return board.lineClear();
+        });
+        measureClears(label + " row set mask", dense_board, masked_cleared, [top_row](Board& board){
+            return lineClearMasked(board, top_row, top_row + 3);
+        });
+
+        if (grid_cleared != masked_cleared)
+            std::cout << "  MISMATCH: " << grid_cleared << " vs " << masked_cleared << "\n";
+        Bench::consume(grid_cleared + masked_cleared);
+    }
+}
@@ -0,0 +1,39 @@
+#include "BenchUtils.h"
+
+#include "game/components/Well.h"
+#include "game/components/well/MoveGen.h"
+#include "game/util/Random.h"
+
+
+BENCHMARK(MoveGen)
+{
+    constexpr unsigned iterations = 2000;
+
+    Well well;
+    WellComponents::MoveGen<Well::width, Well::height> movegen(well);
+
+    // a random, half-filled board with some overhangs
+    Random rng(1);
+    Well::Board board;
+    for (unsigned row = Well::height - 8; row < Well::height; row++) {
+        for (unsigned col = 0; col < Well::width; col++) {
+            if (rng.below(3) == 0)
+                board.setCell(row, col, PieceType::GARBAGE);
+        }
+    }
+
+    for (const auto type : PieceTypeList) {
+        unsigned long long placement_count = 0;
+        Bench::measure(std::string("search ") + toAscii(type), iterations, [&](){
+            placement_count += movegen.generate(board, type).size();
+        });
+        Bench::consume(placement_count);
+    }
+
+    unsigned long long path_length = 0;
+    Bench::measure("search T + all paths", iterations, [&](){
+        for (const auto& placement : movegen.generate(board, PieceType::T))
+            path_length += movegen.pathTo(placement).size();
+    });
+    Bench::consume(path_length);
+}
@@ -0,0 +1,63 @@
+#include "BenchUtils.h"
+
+#include "game/components/PieceQueue.h"
+#include "game/components/Well.h"
+#include "game/util/Random.h"
+
+#include <cstring>
+#include <vector>
+
+
+BENCHMARK(Snapshot)
+{
+    constexpr unsigned iterations = 200000;
+
+    // a game in progress, with a falling piece over a half-filled board
+    Well well;
+    PieceQueue queue(1);
+    well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [&well, &queue](const WellEvent&){
+        well.addPiece(queue.next());
+    });
+    Random rng(1);
+    for (unsigned frame = 0; frame < 2000 && well.activePiece() == nullptr; frame++)
+        well.update({});
+    well.addGarbageLines(10);
+    for (unsigned i = 0; i < 20; i++) {
+        const auto input = static_cast<InputType>(4 + rng.below(4));
+        std::vector<InputEvent> events;
+        events.emplace_back(input, true, -1);
+        well.update(events);
+        events.front() = InputEvent(input, false, -1);
+        well.update(events);
+    }
+
+    Well::Snapshot well_state = well.snapshot();
+    PieceQueue::Snapshot queue_state = queue.snapshot();
+    unsigned long long checksum = 0;
+
+    Bench::measure("snapshot", iterations, [&](){
+        well_state = well.snapshot();
+        queue_state = queue.snapshot();
+        checksum += well_state.active_piece_y + queue_state.size;
+    });
+    Bench::measure("restore", iterations, [&](){
+        well.restore(well_state);
+        queue.restore(queue_state);
+        checksum += well.activePiece() != nullptr;
+    });
+
+    // the way a rollback buffer would store them
+    static uint8_t buffer[sizeof(Well::Snapshot) + sizeof(PieceQueue::Snapshot)];
+    Bench::measure("snapshot + memcpy + restore", iterations, [&](){
+        const Well::Snapshot saved_well = well.snapshot();
+        const PieceQueue::Snapshot saved_queue = queue.snapshot();
+        std::memcpy(buffer, &saved_well, sizeof(saved_well));
+        std::memcpy(buffer + sizeof(saved_well), &saved_queue, sizeof(saved_queue));
+        std::memcpy(&well_state, buffer, sizeof(well_state));
+        std::memcpy(&queue_state, buffer + sizeof(well_state), sizeof(queue_state));
+        well.restore(well_state);
+        queue.restore(queue_state);
+    });
+    checksum += well.snapshot().active_piece_x;
+    Bench::consume(checksum);
+}
@@ -0,0 +1,45 @@
+#include "BenchUtils.h"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+
+namespace Bench {
+
+std::vector<Entry>& registry()
+{
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+void consume(unsigned long long value)
+{
+    static volatile unsigned long long sink = 0;
+    sink = sink + value;
+}
+
+void report(const std::string& label, double ns_per_call)
+{
+    std::cout << "  " << std::left << std::setw(40) << label
+              << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+              << ns_per_call << " ns\n";
+}
+
+} // namespace Bench
+
+
+// run all benchmarks, or only the ones containing the first argument in their name
+int main(int argc, const char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    for (const auto& entry : Bench::registry()) {
+        if (!std::strstr(entry.name, filter))
+            continue;
+
+        std::cout << entry.name << "\n";
+        entry.fn();
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "Agent.h"
+
+#include <cstdlib>
+
+
+RandomAgent::RandomAgent(DeviceID device_id, uint64_t seed)
+    : device_id(device_id)
+    , rng(seed)
+    , next_key(0)
+    , key_down(false)
+{}
+
+void RandomAgent::update(const HeadlessPlayer& player, std::vector<InputEvent>& inputs)
+{
+    // release the key pressed in the previous frame
+    if (key_down) {
+        inputs.emplace_back(planned_keys.at(next_key), false, device_id);
+        key_down = false;
+        next_key++;
+        return;
+    }
+
+    if (!player.well.activePiece()) {
+        planned_keys.clear();
+        next_key = 0;
+        return;
+    }
+
+    if (next_key >= planned_keys.size())
+        planNextPiece();
+
+    inputs.emplace_back(planned_keys.at(next_key), true, device_id);
+    key_down = true;
+}
+
+void RandomAgent::planNextPiece()
+{
+    planned_keys.clear();
+    next_key = 0;
+
+    const unsigned rotations = rng.below(4);
+    for (unsigned i = 0; i < rotations; i++)
+        planned_keys.push_back(InputType::GAME_ROTATE_RIGHT);
+
+    // moving out of the well is ignored, so a wider range
+    // than the well's half width makes the walls reachable more often
+    const int shift = static_cast<int>(rng.below(13)) - 6;
+    const InputType move_key = shift < 0 ? InputType::GAME_MOVE_LEFT : InputType::GAME_MOVE_RIGHT;
+    for (int i = 0; i < std::abs(shift); i++)
+        planned_keys.push_back(move_key);
+
+    planned_keys.push_back(InputType::GAME_HARDDROP);
+}
+
+
+BotAgent::BotAgent(HeadlessPlayer& player, DeviceID device_id, const AI::BotSettings& settings)
+    : bot(player.well, device_id, settings)
+{}
+
+void BotAgent::update(const HeadlessPlayer& player, std::vector<InputEvent>& inputs)
+{
+    view.hold_empty = player.state.hold_empty;
+    view.hold_piece = player.state.hold_piece;
+    view.hold_allowed = player.state.hold_allowed;
+    view.next_pieces.clear();
+    for (unsigned i = 0; i < player.preview_count; i++)
+        view.next_pieces.push_back(player.piece_queue.peek(i));
+
+    bot.update(player.well, view, inputs);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "game/HeadlessPlayer.h"
+#include "game/ai/Bot.h"
+#include "game/util/Random.h"
+#include "system/Event.h"
+
+#include <vector>
+
+
+/// Produces the inputs of a simulated player, one frame at a time
+class Agent {
+public:
+    virtual ~Agent() = default;
+
+    /// Add the inputs of the current frame, before the well is updated
+    virtual void update(const HeadlessPlayer&, std::vector<InputEvent>& inputs) = 0;
+};
+
+
+/// A baseline player, that rotates and moves every piece randomly,
+/// then hard drops it. Every action is a single key tap.
+class RandomAgent : public Agent {
+public:
+    RandomAgent(DeviceID, uint64_t seed);
+
+    void update(const HeadlessPlayer&, std::vector<InputEvent>& inputs) final;
+
+private:
+    const DeviceID device_id;
+    Random rng;
+
+    std::vector<InputType> planned_keys;
+    unsigned next_key;
+    bool key_down;
+
+    void planNextPiece();
+};
+
+
+/// A CPU player of the game. It plans on the simulation's thread,
+/// without a time limit, so the games can be reproduced.
+class BotAgent : public Agent {
+public:
+    /// Create a bot for the player's well; it must not outlive the player
+    BotAgent(HeadlessPlayer&, DeviceID, const AI::BotSettings&);
+
+    void update(const HeadlessPlayer&, std::vector<InputEvent>& inputs) final;
+
+private:
+    AI::Bot bot;
+    AI::PlayerView view;
+};
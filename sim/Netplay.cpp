@@ -0,0 +1,72 @@
+#include "Netplay.h"
+
+#include "Agent.h"
+#include "game/net/VersusMatch.h"
+
+#include <memory>
+
+
+namespace Sim {
+
+namespace {
+
+struct Side {
+    Net::VersusMatch match;
+    Net::RollbackSession session;
+    RandomAgent agent;
+    Net::InputBits keys;
+
+    Side(const NetplayConfig& config, Net::Transport& transport, unsigned player, uint64_t seed)
+        : match(config.well_config, seed, Net::RollbackSession::stateSlots(config.rollback))
+        , session(match, transport, player, config.rollback)
+        , agent(player, seed + player + 1)
+        , keys(0)
+    {}
+};
+
+} // namespace
+
+
+NetplayResult simulateNetplay(const NetplayConfig& config, uint64_t seed)
+{
+    Net::LoopbackLink link(config.link, seed);
+    std::array<std::unique_ptr<Side>, Net::player_count> sides;
+    for (unsigned player = 0; player < Net::player_count; player++)
+        sides[player] = std::make_unique<Side>(config, link.endpoint(player), player, seed);
+
+    // both sides try to run a frame in every tick until the end of the
+    // match, then wait until every input before the end has arrived;
+    // the end may turn out to be a mispredicted one, then the side continues
+    std::vector<InputEvent> inputs;
+    bool finished = false;
+    while (!finished) {
+        finished = true;
+        for (unsigned player = 0; player < Net::player_count; player++) {
+            Side& side = *sides[player];
+            if (!side.match.isOver() && side.session.frame() < config.frames) {
+                inputs.clear();
+                side.agent.update(side.match.player(player), inputs);
+                side.keys = Net::applyEvents(side.keys, inputs);
+                side.session.update(side.keys);
+            }
+            else
+                side.session.poll();
+
+            const uint32_t last_frame = side.match.isOver() ? side.match.frame() : config.frames;
+            finished = finished && side.session.frame() >= last_frame
+                && side.session.confirmedFrame() >= last_frame;
+        }
+        link.advance(Timing::frame_duration);
+    }
+
+    NetplayResult result;
+    result.in_sync = sides[0]->match.stateHash() == sides[1]->match.stateHash();
+    result.match_frames = sides[0]->match.frame();
+    for (unsigned player = 0; player < Net::player_count; player++)
+        result.stats[player] = sides[player]->session.stats();
+    result.sent_packets = link.sentPackets();
+    result.lost_packets = link.lostPackets();
+    return result;
+}
+
+} // namespace Sim
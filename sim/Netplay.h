@@ -0,0 +1,36 @@
+#pragma once
+
+#include "game/WellConfig.h"
+#include "game/net/LoopbackTransport.h"
+#include "game/net/Rollback.h"
+
+#include <array>
+#include <stdint.h>
+
+
+namespace Sim {
+
+struct NetplayConfig {
+    Net::LinkConditions link;
+    Net::RollbackSettings rollback;
+    /// The maximum length of the match, in frames
+    uint32_t frames = 60 * 60 * 2;
+    WellConfig well_config;
+};
+
+struct NetplayResult {
+    /// True if both sides ended with the same match state
+    bool in_sync = false;
+    /// The length of the match, in frames; shorter than the configured
+    /// length if a player has topped out
+    uint32_t match_frames = 0;
+    std::array<Net::RollbackStats, Net::player_count> stats;
+    uint64_t sent_packets = 0;
+    uint64_t lost_packets = 0;
+};
+
+/// Play a versus match between two simulated players, each running
+/// its own copy of the match, connected through a loopback link
+NetplayResult simulateNetplay(const NetplayConfig&, uint64_t seed);
+
+} // namespace Sim
@@ -0,0 +1,163 @@
+#include "Simulation.h"
+
+#include "Agent.h"
+#include "game/HeadlessPlayer.h"
+#include "game/MatchRules.h"
+
+#include <memory>
+#include <assert.h>
+
+
+namespace Sim {
+
+std::string toString(GameEnd end)
+{
+    switch (end) {
+        case GameEnd::TOP_OUT: return "top out";
+        case GameEnd::LINE_GOAL: return "line goal";
+        case GameEnd::FINISHED: return "finished";
+        case GameEnd::BATTLE_WON: return "battle won";
+        case GameEnd::TIME_LIMIT: return "time limit";
+    }
+    assert(false);
+    return "";
+}
+
+namespace {
+
+struct Player {
+    HeadlessPlayer headless;
+    std::unique_ptr<Agent> agent;
+    PlayerResult result;
+
+    Player(const MatchRules& rules, const Config& config, unsigned index, uint64_t seed)
+        : headless(rules, config.well_config, seed)
+    {
+        switch (config.agent) {
+            case AgentType::RANDOM:
+                agent = std::make_unique<RandomAgent>(index, seed + index + 1);
+                break;
+            case AgentType::BOT:
+                agent = std::make_unique<BotAgent>(headless, AI::first_bot_device + index,
+                    AI::BotSettings::fromDifficulty(config.bot_difficulty));
+                break;
+        }
+    }
+};
+
+/// A match of simulated players, with the rules of the Gameplay state
+class Match {
+public:
+    Match(const Config& config, uint64_t seed)
+        : config(config)
+        , rules(config.mode == Mode::BATTLE ? GameMode::MP_BATTLE : GameMode::SP_MARATHON)
+        , rng(seed)
+    {
+        assert(config.player_count > 0);
+        assert(config.mode != Mode::BATTLE || config.player_count > 1);
+        assert(config.agent != AgentType::BOT || config.player_count <= AI::max_bot_count);
+
+        for (unsigned i = 0; i < config.player_count; i++) {
+            players.emplace_back(std::make_unique<Player>(rules, config, i, seed));
+            player_states.push_back(&players.back()->headless.state.gameplay);
+        }
+        for (unsigned i = 0; i < config.player_count; i++)
+            registerObservers(i);
+    }
+
+    GameResult run(uint64_t seed) {
+        std::vector<InputEvent> inputs;
+        unsigned playing_count = players.size();
+
+        for (uint64_t frame = 0; frame < config.max_frames && playing_count > 0; frame++) {
+            for (auto& player : players) {
+                if (!player->headless.isPlaying())
+                    continue;
+
+                inputs.clear();
+                player->agent->update(player->headless, inputs);
+                player->result.garbage_received += player->headless.update(inputs);
+                player->result.frames++;
+            }
+            for (auto* state : player_states)
+                rules.updateIncomingAttacks(*state);
+
+            playing_count = endFinishedGames();
+        }
+
+        GameResult output;
+        output.seed = seed;
+        for (auto& player : players) {
+            const auto& stats = player->headless.state.stats;
+            player->result.lines = stats.total_cleared_lines;
+            player->result.level = stats.level;
+            player->result.score = stats.score;
+            output.frames += player->result.frames;
+            output.players.push_back(player->result);
+        }
+        return output;
+    }
+
+private:
+    const Config config;
+    const MatchRules rules;
+    Random rng;
+    std::vector<std::unique_ptr<Player>> players;
+    std::vector<MatchRules::PlayerState*> player_states;
+
+    void registerObservers(unsigned index) {
+        Player& player = *players.at(index);
+        auto& well = player.headless.well;
+
+        well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [&player](const WellEvent&){
+            if (player.headless.isPlaying())
+                player.result.pieces++;
+        });
+        well.registerObserver(WellEvent::Type::GAME_OVER, [this, &player](const WellEvent&){
+            player.result.end = GameEnd::TOP_OUT;
+
+            const int winner = rules.finishBattleMaybe(player_states);
+            if (winner >= 0)
+                players.at(winner)->result.end = GameEnd::BATTLE_WON;
+        });
+        player.headless.setAttackHandler([this, &player, index](unsigned lines){
+            if (rules.sendAttack(rng, player_states, index, lines) >= 0)
+                player.result.garbage_sent += lines;
+        });
+    }
+
+    /// Stop the games that have reached their goal, and returns the number of still playing players
+    unsigned endFinishedGames() {
+        unsigned playing_count = 0;
+        for (auto& player : players) {
+            auto& state = player->headless.state;
+            if (state.gameplay.status == MatchRules::PlayerStatus::FINISHED
+                && player->result.end == GameEnd::TIME_LIMIT) {
+                player->result.end = GameEnd::FINISHED;
+                continue;
+            }
+            if (!player->headless.isPlaying())
+                continue;
+
+            if (config.mode == Mode::SINGLEPLAYER && config.line_goal
+                && state.stats.total_cleared_lines >= config.line_goal) {
+                state.gameplay.status = MatchRules::PlayerStatus::FINISHED;
+                player->result.end = GameEnd::LINE_GOAL;
+                continue;
+            }
+            playing_count++;
+        }
+        return playing_count;
+    }
+};
+
+} // namespace
+
+
+GameResult simulateGame(const Config& config, uint64_t seed)
+{
+    Match match(config, seed);
+    return match.run(seed);
+}
+
+} // namespace Sim
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "game/WellConfig.h"
+#include "game/ai/BotSettings.h"
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+
+namespace Sim {
+
+enum class Mode : uint8_t {
+    SINGLEPLAYER,
+    BATTLE,
+};
+
+/// The controller of the simulated players
+enum class AgentType : uint8_t {
+    RANDOM,  ///< see `RandomAgent`
+    BOT,     ///< see `BotAgent`
+};
+
+/// The reason a player's game has ended
+enum class GameEnd : uint8_t {
+    TOP_OUT,     ///< the well was filled up
+    LINE_GOAL,   ///< the required amount of lines was cleared
+    FINISHED,    ///< the last level of the marathon was completed
+    BATTLE_WON,  ///< every other player has topped out
+    TIME_LIMIT,  ///< the maximum simulated time has passed
+};
+constexpr unsigned GameEndCount = 5;
+std::string toString(GameEnd);
+
+struct Config {
+    Mode mode = Mode::SINGLEPLAYER;
+    unsigned player_count = 1;
+    AgentType agent = AgentType::RANDOM;
+    AI::BotDifficulty bot_difficulty = AI::BotDifficulty::MEDIUM;
+    /// Singleplayer games end after this many cleared lines; 0 means no goal
+    unsigned line_goal = 0;
+    /// The maximum length of a game, in frames
+    uint64_t max_frames = 60 * 60 * 10;
+    WellConfig well_config;
+};
+
+struct PlayerResult {
+    GameEnd end = GameEnd::TIME_LIMIT;
+    uint64_t frames = 0;
+    unsigned pieces = 0;
+    unsigned lines = 0;
+    unsigned level = 1;
+    unsigned score = 0;
+    unsigned garbage_sent = 0;
+    unsigned garbage_received = 0;
+};
+
+struct GameResult {
+    uint64_t seed = 0;
+    /// The number of simulated frames, summed for all players
+    uint64_t frames = 0;
+    std::vector<PlayerResult> players;
+};
+
+/// Play a full game with simulated players. The result only depends on
+/// the config and the seed, and games can run on multiple threads in parallel.
+GameResult simulateGame(const Config&, uint64_t seed);
+
+} // namespace Sim
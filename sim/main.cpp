@@ -0,0 +1,280 @@
+#include "Netplay.h"
+#include "Simulation.h"
+#include "game/Timing.h"
+#include "game/util/Random.h"
+#include "game/util/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace {
+
+void printHelp()
+{
+    std::cout << "Usage: openblok_sim [options]\n"
+              << "  --games <n>          Number of games to simulate (default: 1000)\n"
+              << "  --threads <n>        Number of worker threads (default: all cores)\n"
+              << "  --battle <players>   Play battles between 2-4 players, instead of singleplayer games\n"
+              << "  --lines <n>          End singleplayer games after <n> cleared lines (default: no goal)\n"
+              << "  --bot <difficulty>   Play with CPU players: easy, medium, hard or expert\n"
+              << "                       (default: a random baseline player)\n"
+              << "  --minutes <n>        Maximum simulated length of a game (default: 10)\n"
+              << "  --rotation <name>    Rotation system: srs, tgm or classic (default: srs)\n"
+              << "  --seed <n>           Base seed of the games (default: random)\n"
+              << "  --netplay            Play one versus match between two sides connected through\n"
+              << "                       a simulated network, and print the rollback statistics\n"
+              << "  --latency <ms>       Netplay: the delay of the packets (default: 50)\n"
+              << "  --jitter <ms>        Netplay: the maximum random extra delay (default: 10)\n"
+              << "  --loss <percent>     Netplay: the chance of losing a packet (default: 2)\n"
+              << "  --delay <frames>     Netplay: the input delay (default: 2)\n"
+              << "  --verbose            Print the result of every game\n"
+              << "  --help               Display this help then quit\n";
+}
+
+bool parseNumber(const char* text, unsigned long long& output)
+{
+    char* end = nullptr;
+    output = std::strtoull(text, &end, 10);
+    return end && *end == '\0' && end != text;
+}
+
+int runNetplay(const Sim::NetplayConfig& config, uint64_t seed)
+{
+    std::cout << "Simulating a netplay match of at most " << config.frames << " frames, seed " << seed << "\n";
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto result = Sim::simulateNetplay(config, seed);
+    const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start_time;
+
+    const double match_seconds = std::chrono::duration<double>(Timing::frame_duration).count() * result.match_frames;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Match length: " << result.match_frames << " frames (" << match_seconds << " s)\n"
+              << "Packets: " << result.sent_packets << " sent, " << result.lost_packets << " lost\n";
+    for (unsigned i = 0; i < result.stats.size(); i++) {
+        const auto& stats = result.stats.at(i);
+        std::cout << "Side " << (i + 1) << ":\n"
+                  << "  rollbacks:           " << stats.rollbacks << "\n"
+                  << "  max rollback depth:  " << stats.max_rollback_depth << " frames\n"
+                  << "  resimulated frames:  " << stats.resimulated_frames
+                  << " (" << stats.resimulated_frames / match_seconds << " per second)\n"
+                  << "  stalled frames:      " << stats.stalled_frames << "\n"
+                  << "  checksums verified:  " << stats.verified_checksums << "\n";
+        if (stats.desynced)
+            std::cout << "  desync from frame:   " << stats.desync_frame << "\n";
+    }
+    std::cout << "Wall time: " << wall_time.count() << " s\n"
+              << "States in sync: " << (result.in_sync ? "yes" : "NO") << "\n";
+    return result.in_sync ? 0 : 1;
+}
+
+void printResult(const Sim::GameResult& game)
+{
+    std::cout << "seed " << game.seed;
+    for (unsigned i = 0; i < game.players.size(); i++) {
+        const auto& player = game.players.at(i);
+        std::cout << " | P" << (i + 1)
+                  << " lines " << player.lines
+                  << " level " << player.level
+                  << " score " << player.score
+                  << " pieces " << player.pieces
+                  << " (" << Sim::toString(player.end) << ")";
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+
+int main(int argc, const char** argv)
+{
+    unsigned long long game_count = 1000;
+    unsigned long long thread_count = std::max(1u, std::thread::hardware_concurrency());
+    unsigned long long minutes = 10;
+    unsigned long long base_seed = Random::makeSeed();
+    bool verbose = false;
+    bool netplay = false;
+    Sim::Config config;
+    Sim::NetplayConfig netplay_config;
+    netplay_config.link.latency = std::chrono::milliseconds(50);
+    netplay_config.link.jitter = std::chrono::milliseconds(10);
+    netplay_config.link.loss = 0.02;
+
+    const std::unordered_map<std::string, RotationStyle> str_to_rotation {
+        {"srs", RotationStyle::SRS},
+        {"tgm", RotationStyle::TGM},
+        {"classic", RotationStyle::CLASSIC},
+    };
+    const std::unordered_map<std::string, AI::BotDifficulty> str_to_difficulty {
+        {"easy", AI::BotDifficulty::EASY},
+        {"medium", AI::BotDifficulty::MEDIUM},
+        {"hard", AI::BotDifficulty::HARD},
+        {"expert", AI::BotDifficulty::EXPERT},
+    };
+
+    for (int arg_i = 1; arg_i < argc; arg_i++) {
+        const std::string arg = argv[arg_i];
+        if (arg == "--help") {
+            printHelp();
+            return 0;
+        }
+        if (arg == "--verbose") {
+            verbose = true;
+            continue;
+        }
+        if (arg == "--netplay") {
+            netplay = true;
+            continue;
+        }
+
+        if (++arg_i >= argc) {
+            std::cerr << "'" << arg << "' requires a parameter!\n";
+            return 1;
+        }
+        const char* param = argv[arg_i];
+        unsigned long long number = 0;
+
+        if (arg == "--rotation") {
+            if (!str_to_rotation.count(param)) {
+                std::cerr << "Unknown rotation system '" << param << "'.\n";
+                return 1;
+            }
+            config.well_config.rotation_style = str_to_rotation.at(param);
+            continue;
+        }
+        if (arg == "--bot") {
+            if (!str_to_difficulty.count(param)) {
+                std::cerr << "Unknown difficulty '" << param << "'.\n";
+                return 1;
+            }
+            config.agent = Sim::AgentType::BOT;
+            config.bot_difficulty = str_to_difficulty.at(param);
+            continue;
+        }
+        if (!parseNumber(param, number)) {
+            std::cerr << "'" << arg << "' requires a number as parameter!\n";
+            return 1;
+        }
+
+        if (arg == "--games")
+            game_count = number;
+        else if (arg == "--threads")
+            thread_count = std::max(1ull, number);
+        else if (arg == "--lines")
+            config.line_goal = number;
+        else if (arg == "--minutes")
+            minutes = number;
+        else if (arg == "--seed")
+            base_seed = number;
+        else if (arg == "--latency")
+            netplay_config.link.latency = std::chrono::milliseconds(number);
+        else if (arg == "--jitter")
+            netplay_config.link.jitter = std::chrono::milliseconds(number);
+        else if (arg == "--loss")
+            netplay_config.link.loss = std::min(number, 100ull) / 100.0;
+        else if (arg == "--delay")
+            netplay_config.rollback.input_delay = std::min(number, 8ull);
+        else if (arg == "--battle") {
+            if (number < 2 || number > 4) {
+                std::cerr << "Battles require 2-4 players.\n";
+                return 1;
+            }
+            config.mode = Sim::Mode::BATTLE;
+            config.player_count = number;
+        }
+        else {
+            std::cerr << "Unknown parameter '" << arg << "'.\n";
+            return 1;
+        }
+    }
+    config.max_frames = minutes * 60 * 60;
+
+    if (netplay) {
+        netplay_config.frames = config.max_frames;
+        netplay_config.well_config = config.well_config;
+        return runNetplay(netplay_config, base_seed);
+    }
+
+    // every game gets its own seed, derived from the base seed
+    std::vector<uint64_t> seeds(game_count);
+    Random seed_rng(base_seed);
+    for (auto& seed : seeds)
+        seed = (static_cast<uint64_t>(seed_rng.next()) << 32) | seed_rng.next();
+
+    std::cout << "Simulating " << game_count << " games on " << thread_count
+              << " threads, base seed " << base_seed << "\n";
+
+    std::vector<Sim::GameResult> results(game_count);
+    const auto start_time = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(thread_count);
+        for (size_t i = 0; i < seeds.size(); i++) {
+            pool.submit([&config, &seeds, &results, i]{
+                results[i] = Sim::simulateGame(config, seeds[i]);
+            });
+        }
+        pool.wait();
+    }
+    const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - start_time;
+
+
+    uint64_t total_frames = 0;
+    unsigned long long total_lines = 0;
+    unsigned long long total_levels = 0;
+    unsigned long long total_score = 0;
+    unsigned long long total_pieces = 0;
+    unsigned long long total_garbage = 0;
+    uint64_t total_player_frames = 0;
+    std::array<unsigned long long, Sim::GameEndCount> end_counts {};
+    for (const auto& game : results) {
+        if (verbose)
+            printResult(game);
+
+        total_frames += game.frames;
+        for (const auto& player : game.players) {
+            total_lines += player.lines;
+            total_levels += player.level;
+            total_score += player.score;
+            total_pieces += player.pieces;
+            total_garbage += player.garbage_sent;
+            total_player_frames += player.frames;
+            end_counts.at(static_cast<size_t>(player.end))++;
+        }
+    }
+
+    const double player_count = std::max<double>(1, game_count * config.player_count);
+    const double simulated_seconds = std::chrono::duration<double>(Timing::frame_duration).count()
+                                   * total_player_frames;
+    const double frames_per_sec = total_frames / std::max(wall_time.count(), 1e-9);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "Average per player:\n"
+              << "  lines:           " << total_lines / player_count << "\n"
+              << "  level:           " << total_levels / player_count << "\n"
+              << "  score:           " << total_score / player_count << "\n"
+              << "  pieces:          " << total_pieces / player_count << "\n";
+    if (config.mode == Sim::Mode::BATTLE)
+        std::cout << "  garbage sent:    " << total_garbage / player_count << "\n";
+    std::cout << "  pieces/second:   " << total_pieces / std::max(simulated_seconds, 1e-9)
+              << " (of simulated time)\n"
+              << "Game end causes:\n";
+    for (unsigned i = 0; i < Sim::GameEndCount; i++) {
+        std::cout << "  " << std::left << std::setw(17) << (Sim::toString(static_cast<Sim::GameEnd>(i)) + ":")
+                  << std::right << end_counts.at(i) << "\n";
+    }
+    std::cout << "Throughput:\n"
+              << "  wall time:       " << wall_time.count() << " s\n"
+              << "  frames/second:   " << frames_per_sec << "\n"
+              << "  per core:        " << frames_per_sec / thread_count << "\n";
+
+    return 0;
+}
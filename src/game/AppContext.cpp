@@ -2,18 +2,13 @@
 
 #include "system/Log.h"
 
-#include <cstdlib>
-#include <ctime>
 
-
-bool AppContext::init()
+bool AppContext::init(bool headless)
 {
     const std::string log_tag = "init";
     try {
         Log::info(log_tag) << "Initializing video...\n";
-        m_window = Window::create();
-
-        std::srand(std::time(nullptr));
+        m_window = Window::create(headless);
     }
     catch (const std::exception& err) {
         Window::showErrorMessage(err.what());
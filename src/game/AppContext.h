@@ -3,6 +3,7 @@
 #include "SysConfig.h"
 #include "Theme.h"
 #include "WellConfig.h"
+#include "components/MinoStorage.h"
 #include "system/InputConfigFile.h"
 #include "system/Window.h"
 
@@ -15,7 +16,9 @@ class GameState;
 
 class AppContext {
 public:
-    bool init();
+    /// In headless mode, nothing is displayed or played, so the game
+    /// can also run on machines without a display or a sound device
+    bool init(bool headless = false);
 
     Window& window() { return *m_window; }
     GraphicsContext& gcx() { return m_window->graphicsContext(); }
@@ -24,6 +27,7 @@ public:
     SysConfig& sysconfig() { return m_sysconfig; }
     ThemeConfig& theme() { return m_themeconfig; }
     WellConfig& wellconfig() { return m_wellconfig; }
+    MinoStorage& minos() { return m_minos; }
     std::stack<std::unique_ptr<GameState>>& states() { return m_states; }
 
 private:
@@ -32,5 +36,6 @@ private:
     SysConfig m_sysconfig;
     ThemeConfig m_themeconfig;
     WellConfig m_wellconfig;
+    MinoStorage m_minos;
     std::stack<std::unique_ptr<GameState>> m_states;
 };
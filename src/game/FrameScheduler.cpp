@@ -0,0 +1,56 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+FrameScheduler::FrameScheduler(const FrameSchedulerSettings& settings, Duration frame_duration)
+    : settings(settings)
+    , frame_duration(frame_duration)
+    , accumulated_time(Duration::zero())
+{
+    assert(settings.max_catchup_updates > 0);
+    assert(frame_duration > Duration::zero());
+}
+
+void FrameScheduler::start(Clock::time_point now)
+{
+    last_time = now;
+    accumulated_time = frame_duration;
+}
+
+unsigned FrameScheduler::beginFrame(Clock::time_point now)
+{
+    accumulated_time += std::max(now - last_time, Clock::duration::zero());
+    last_time = now;
+
+    uint64_t due_updates = accumulated_time / frame_duration;
+    if (due_updates == 0)
+        return 0;
+
+    if (due_updates > 1)
+        m_stats.late_frames++;
+
+    // the updates over the limit are not run; the game slows down for a while instead
+    const unsigned max_updates = settings.frame_skip ? settings.max_catchup_updates : 1;
+    if (due_updates > max_updates) {
+        m_stats.dropped_updates += due_updates - max_updates;
+        accumulated_time -= (due_updates - max_updates) * frame_duration;
+        due_updates = max_updates;
+    }
+
+    accumulated_time -= due_updates * frame_duration;
+    m_stats.updates += due_updates;
+    m_stats.skipped_draws += due_updates - 1;
+    return static_cast<unsigned>(due_updates);
+}
+
+float FrameScheduler::interpolation() const
+{
+    return std::chrono::duration<float>(accumulated_time) / frame_duration;
+}
+
+FrameScheduler::Clock::time_point FrameScheduler::nextUpdateTime() const
+{
+    return last_time + (frame_duration - accumulated_time);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Timing.h"
+
+#include <chrono>
+#include <stdint.h>
+
+
+struct FrameSchedulerSettings {
+    /// Skip drawing while the game is behind, and run the missed updates
+    /// in one batch; without it, the game slows down instead
+    bool frame_skip = true;
+    /// At most this many updates are run before drawing again; if the game
+    /// is even more behind, the rest of the missed updates are dropped
+    unsigned max_catchup_updates = 4;
+};
+
+/// The frame counters of the main loop
+struct FrameStats {
+    uint64_t updates = 0;
+    uint64_t draws = 0;
+    /// The loop iterations that started so late, that more than one update was due
+    uint64_t late_frames = 0;
+    /// The updates that were run without drawing their result
+    uint64_t skipped_draws = 0;
+    /// The updates that were never run, because the game was too far behind;
+    /// the game has slowed down by this many frames
+    uint64_t dropped_updates = 0;
+};
+
+
+/// Fixed timestep scheduling for the main loop: the game logic is updated
+/// at a constant rate, independent of how long drawing takes. When drawing
+/// makes the loop late, the missed updates are run in a batch, but only up
+/// to a limit, so a slow machine can't get into a spiral of ever longer
+/// catch-up batches.
+///
+/// The time is passed in by the caller, so the scheduling can be tested
+/// without waiting.
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameScheduler(const FrameSchedulerSettings& = FrameSchedulerSettings(),
+                            Duration frame_duration = Timing::frame_duration);
+
+    /// Start the timing from now; the first update is due immediately
+    void start(Clock::time_point now);
+    /// Returns the number of updates that should run now, before drawing;
+    /// if it's zero, there's nothing new to draw either
+    unsigned beginFrame(Clock::time_point now);
+    /// Has to be called after drawing the result of the updates
+    void frameDrawn() { m_stats.draws++; }
+
+    /// The part of the next update's time that has already passed, between
+    /// 0 and 1; drawing can use it to interpolate between two updates
+    float interpolation() const;
+    /// The time when the next update is due; the loop can sleep until then
+    Clock::time_point nextUpdateTime() const;
+
+    const FrameStats& stats() const { return m_stats; }
+
+private:
+    const FrameSchedulerSettings settings;
+    const Duration frame_duration;
+
+    Clock::time_point last_time;
+    /// The passed time not yet simulated by the updates
+    Duration accumulated_time;
+
+    FrameStats m_stats;
+};
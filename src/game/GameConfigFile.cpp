@@ -19,6 +19,13 @@ std::unordered_map<std::string, bool*> createBoolBind(SysConfig& sys) {
         {"fullscreen", &sys.fullscreen},
         {"sfx", &sys.sfx},
         {"music", &sys.music},
+        {"record_replays", &sys.record_replays},
+        {"frame_skip", &sys.frame_skip},
+    };
+}
+std::unordered_map<std::string, unsigned short*> createNumericBind(SysConfig& sys) {
+    return {
+        {"max_frame_skip", &sys.max_frame_skip},
     };
 }
 std::unordered_map<std::string, std::string*> createStringBind(SysConfig& sys) {
@@ -43,6 +50,14 @@ std::unordered_map<std::string, unsigned short*> createNumericBind(WellConfig& w
     };
 }
 
+const std::set<std::string> accepted_sysenum_keys = {"cpu_level"};
+const std::unordered_map<std::string, AI::BotDifficulty> str_to_botdifficulty {
+    {"easy", AI::BotDifficulty::EASY},
+    {"medium", AI::BotDifficulty::MEDIUM},
+    {"hard", AI::BotDifficulty::HARD},
+    {"expert", AI::BotDifficulty::EXPERT},
+};
+
 const std::set<std::string> accepted_wellenum_keys = {"lock_type", "rotation"};
 const std::unordered_map<std::string, LockDelayType> str_to_locktype {
     {"instant", LockDelayType::CLASSIC},
@@ -79,6 +94,16 @@ void GameConfigFile::save(SysConfig& sys, WellConfig& well, const std::string& p
         for (const auto& pair : sys_strings)
             sys_entries.emplace(pair.first, '"' + *pair.second + '"');
 
+        auto sys_ushorts = createNumericBind(sys);
+        for (const auto& pair : sys_ushorts)
+            sys_entries.emplace(pair.first, std::to_string(*pair.second));
+
+        std::map<AI::BotDifficulty, const std::string> botdifficulty_to_str;
+        for (const auto& pair : str_to_botdifficulty)
+            botdifficulty_to_str.emplace(pair.second, pair.first);
+        assert(botdifficulty_to_str.count(sys.cpu_difficulty));
+        sys_entries.emplace("cpu_level", botdifficulty_to_str.at(sys.cpu_difficulty));
+
         config.emplace("system", std::move(sys_entries));
     }
     {
@@ -122,6 +147,7 @@ std::tuple<SysConfig, WellConfig> GameConfigFile::load(const std::string& path)
 
     auto sys_bools = createBoolBind(sys);
     auto sys_strings = createStringBind(sys);
+    auto sys_ushorts = createNumericBind(sys);
     auto well_bools = createBoolBind(well);
     auto well_ushorts = createNumericBind(well);
 
@@ -155,6 +181,24 @@ std::tuple<SysConfig, WellConfig> GameConfigFile::load(const std::string& path)
 
                     *sys_strings.at(key_str) = val_str.substr(1, val_str.size() - 2);
                 }
+                else if (sys_ushorts.count(key_str)) {
+                    try {
+                        auto value = std::stoul(val_str);
+                        if (value == 0 || value > 0xFFFF)
+                            throw std::out_of_range("");
+
+                        *sys_ushorts.at(key_str) = value;
+                    }
+                    catch (...) {
+                        throw std::runtime_error("Invalid numeric value '" + val_str + "', skipped");
+                    }
+                }
+                else if (accepted_sysenum_keys.count(key_str)) {
+                    if (str_to_botdifficulty.count(val_str))
+                        sys.cpu_difficulty = str_to_botdifficulty.at(val_str);
+                    else
+                        throw std::runtime_error("Invalid CPU level value '" + val_str + "', skipped");
+                }
                 else if (well_bools.count(key_str)) {
                     *well_bools.at(key_str) = ConfigFile::parseBool(keyval);
                 }
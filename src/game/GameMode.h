@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+
+enum class GameMode : uint8_t {
+    SP_MARATHON,
+    SP_40LINES,
+    SP_2MIN,
+    SP_MARATHON_SIMPLE,
+    MP_MARATHON,
+    MP_BATTLE,
+    MP_MARATHON_SIMPLE,
+};
@@ -14,6 +14,9 @@ public:
 
     virtual void update(const std::vector<Event>&, AppContext&) = 0;
     virtual void draw(GraphicsContext& gcx) = 0;
+    /// Called before drawing, with the part of the next update's time that
+    /// has already passed (0 to 1), to smooth the motion between updates
+    virtual void interpolate(float) {}
 
     virtual void on_pause() {}
     virtual void on_resume() {}
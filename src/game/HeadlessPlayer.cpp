@@ -0,0 +1,148 @@
+#include "HeadlessPlayer.h"
+
+#include "game/util/Hash.h"
+
+
+HeadlessPlayer::HeadlessPlayer(const MatchRules& rules, const WellConfig& config, uint64_t seed)
+    : well(config)
+    , piece_queue(seed)
+    , preview_count(config.max_next_pieces)
+    , rules(rules)
+{
+    well.setRandomSeed(seed);
+    piece_queue.fill(preview_count);
+
+    state.gameplay = rules.newPlayer();
+    state.hold_allowed = true;
+    state.hold_empty = true;
+    state.hold_piece = PieceType::I;
+    well.setGravity(rules.gravity(state.gameplay));
+
+    registerObservers();
+}
+
+void HeadlessPlayer::setAttackHandler(std::function<void(unsigned)>&& handler)
+{
+    attack_handler = std::move(handler);
+}
+
+unsigned HeadlessPlayer::update(const std::vector<InputEvent>& inputs)
+{
+    if (!isPlaying())
+        return 0;
+
+    well.update(inputs);
+    const unsigned garbage_lines = state.gameplay.pending_garbage_lines;
+    well.addGarbageLines(garbage_lines);
+    state.gameplay.pending_garbage_lines = 0;
+
+    rules.onFrameEnd(state.gameplay, state.stats);
+    return garbage_lines;
+}
+
+void HeadlessPlayer::addNextPiece()
+{
+    well.addPiece(piece_queue.next());
+    piece_queue.fill(preview_count);
+    state.hold_allowed = true;
+}
+
+void HeadlessPlayer::registerObservers()
+{
+    well.registerObserver(WellEvent::Type::PIECE_LOCKED, [this](const WellEvent&){
+        rules.onPieceLocked(state.gameplay);
+    });
+    well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [this](const WellEvent&){
+        if (!isPlaying())
+            return;
+
+        rules.onNextRequested(state.gameplay);
+        addNextPiece();
+    });
+    well.registerObserver(WellEvent::Type::HOLD_REQUESTED, [this](const WellEvent&){
+        if (!state.hold_allowed)
+            return;
+
+        const PieceType type = well.activePiece()->type();
+        well.deletePiece();
+        if (state.hold_empty) {
+            state.hold_empty = false;
+            state.hold_piece = type;
+            addNextPiece();
+        }
+        else {
+            well.addPiece(state.hold_piece);
+            state.hold_piece = type;
+        }
+        state.hold_allowed = false;
+    });
+    well.registerObserver(WellEvent::Type::LINE_CLEAR, [this](const WellEvent& event){
+        const auto result = rules.onLineClear(state.gameplay, state.stats, event.lineclear);
+        if (result.level_ups > 0)
+            well.setGravity(rules.gravity(state.gameplay));
+        if (result.attack_lines > 0 && attack_handler)
+            attack_handler(result.attack_lines);
+    });
+    well.registerObserver(WellEvent::Type::MINI_TSPIN_DETECTED, [this](const WellEvent&){
+        rules.onTSpin(state.stats, ScoreType::MINI_TSPIN);
+    });
+    well.registerObserver(WellEvent::Type::TSPIN_DETECTED, [this](const WellEvent&){
+        rules.onTSpin(state.stats, ScoreType::TSPIN);
+    });
+    well.registerObserver(WellEvent::Type::HARDDROPPED, [this](const WellEvent& event){
+        rules.onHardDrop(state.stats, event.harddrop);
+    });
+    well.registerObserver(WellEvent::Type::SOFTDROPPED, [this](const WellEvent&){
+        rules.onSoftDrop(state.stats);
+    });
+    well.registerObserver(WellEvent::Type::GAME_OVER, [this](const WellEvent&){
+        rules.onGameOver(state.gameplay);
+    });
+}
+
+void HeadlessPlayer::save(Snapshot& saved) const
+{
+    saved.state = state;
+    saved.piece_queue = piece_queue.snapshot();
+    saved.well = well.snapshot();
+}
+
+void HeadlessPlayer::restore(const Snapshot& saved)
+{
+    state = saved.state;
+    piece_queue.restore(saved.piece_queue);
+    well.restore(saved.well);
+}
+
+uint64_t HeadlessPlayer::stateHash() const
+{
+    const auto& player = state.gameplay;
+    uint64_t hash = static_cast<uint8_t>(player.status);
+    hash = Hash::combine(hash, player.lineclear_levels_left);
+    hash = Hash::combine(hash, static_cast<uint32_t>(player.lineclears_left));
+    hash = Hash::combine(hash, player.gravity_levels_left);
+    hash = Hash::combine(hash, static_cast<uint8_t>(player.previous_lineclear_type));
+    hash = Hash::combine(hash, player.back2back_length);
+    hash = Hash::combine(hash, player.combo_length);
+    hash = Hash::combine(hash, player.prev_piece_cleared_line);
+    hash = Hash::combine(hash, player.current_piece_cleared_line);
+    hash = Hash::combine(hash, player.queued_garbage_lines);
+    hash = Hash::combine(hash, player.pending_garbage_lines);
+    for (unsigned i = 0; i < player.incoming_attack_count; i++) {
+        hash = Hash::combine(hash, player.incoming_attacks[i].source);
+        hash = Hash::combine(hash, player.incoming_attacks[i].lines);
+        hash = Hash::combine(hash, player.incoming_attacks[i].frames_left);
+    }
+
+    hash = Hash::combine(hash, state.stats.score);
+    hash = Hash::combine(hash, state.stats.level);
+    hash = Hash::combine(hash, state.stats.total_cleared_lines);
+    hash = Hash::combine(hash, state.stats.gametime.count());
+
+    hash = Hash::combine(hash, state.hold_allowed);
+    hash = Hash::combine(hash, state.hold_empty);
+    hash = Hash::combine(hash, static_cast<uint8_t>(state.hold_piece));
+    hash = Hash::combine(hash, piece_queue.stateHash());
+    hash = Hash::combine(hash, well.stateHash());
+    return hash;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "MatchRules.h"
+#include "PlayerStatistics.h"
+#include "WellConfig.h"
+#include "game/components/PieceQueue.h"
+#include "game/components/Well.h"
+
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+
+/// A player of a match without graphics, audio or animations: a well with
+/// its piece and hold queues, played by the match rules. Used where the game
+/// runs without a display, like the simulator and the netplay matches.
+class HeadlessPlayer {
+public:
+    /// Create a player of the match; the rules must outlive the player.
+    /// Every player of a match should get the same seed, so they get
+    /// the same pieces and garbage gaps.
+    HeadlessPlayer(const MatchRules&, const WellConfig&, uint64_t seed);
+
+    Well well;
+    /// The upcoming pieces; the visible ones are always generated
+    PieceQueue piece_queue;
+    const unsigned preview_count;
+
+    /// The rest of the player's state
+    struct State {
+        MatchRules::PlayerState gameplay;
+        PlayerStatistics stats;
+        bool hold_allowed;
+        bool hold_empty;
+        PieceType hold_piece;
+    };
+    State state;
+
+    bool isPlaying() const { return state.gameplay.status == MatchRules::PlayerStatus::PLAYING; }
+
+    /// Set the function that receives the garbage lines sent by the line clears of the player
+    void setAttackHandler(std::function<void(unsigned lines)>&&);
+
+    /// Update the well with the inputs of the current frame, then add the
+    /// garbage lines due in this frame; returns the number of added lines.
+    /// The incoming attacks are advanced by the match, after every player was updated.
+    unsigned update(const std::vector<InputEvent>&);
+
+    struct Snapshot {
+        State state;
+        PieceQueue::Snapshot piece_queue;
+        Well::Snapshot well;
+    };
+    void save(Snapshot&) const;
+    void restore(const Snapshot&);
+    /// A hash of the state, see `Well::stateHash()`
+    uint64_t stateHash() const;
+
+private:
+    const MatchRules& rules;
+    std::function<void(unsigned)> attack_handler;
+
+    void addNextPiece();
+    void registerObservers();
+};
+
+static_assert(std::is_trivially_copyable<HeadlessPlayer::Snapshot>::value, "Player snapshots must be plain data");
@@ -0,0 +1,295 @@
+#include "MatchRules.h"
+
+#include "BattleAttackTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+
+constexpr unsigned short MatchRules::max_queued_garbage;
+constexpr uint16_t MatchRules::attack_travel_frames;
+constexpr unsigned MatchRules::max_incoming_attacks;
+
+
+MatchRules::MatchRules(GameMode gamemode, unsigned short starting_gravity_level)
+    : gamemode(gamemode)
+{
+    assert(starting_gravity_level < 15);
+
+    // TODO: consider alternative algorithm
+    for (int i = 14; i >= starting_gravity_level; i--) {
+        float multiplier = std::pow(0.8 - (i * 0.007), i);
+        gravity_levels.push_back(std::chrono::duration_cast<Duration>(multiplier * std::chrono::seconds(1)));
+    }
+    if (usesDynamicLineAwards()) {
+        for (int i = 15; i > starting_gravity_level; i--)
+            lineclears_required.push_back(i * 5);
+    }
+    else {
+        if (gamemode == GameMode::SP_40LINES)
+            lineclears_required.push_back(40);
+        else {
+            for (int i = 15; i > starting_gravity_level; i--)
+                lineclears_required.push_back(10);
+        }
+    }
+}
+
+MatchRules::PlayerState MatchRules::newPlayer() const
+{
+    PlayerState player;
+    player.status = PlayerStatus::PLAYING;
+    player.gravity_levels_left = gravity_levels.size() - 1;
+    player.lineclear_levels_left = lineclears_required.size() - 1;
+    player.lineclears_left = lineclears_required.back();
+    player.previous_lineclear_type = ScoreType::CLEAR_SINGLE;
+    player.back2back_length = 0;
+    player.combo_length = 0;
+    player.prev_piece_cleared_line = false;
+    player.current_piece_cleared_line = false;
+    player.queued_garbage_lines = 0;
+    player.pending_garbage_lines = 0;
+    player.incoming_attacks.fill({0, 0, 0});
+    player.incoming_attack_count = 0;
+    return player;
+}
+
+Duration MatchRules::gravity(const PlayerState& player) const
+{
+    return gravity_levels.at(player.gravity_levels_left);
+}
+
+bool MatchRules::usesDynamicLineAwards() const
+{
+    switch (gamemode) {
+        case GameMode::SP_40LINES:
+        case GameMode::SP_MARATHON_SIMPLE:
+        case GameMode::MP_MARATHON_SIMPLE:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool MatchRules::isFinishable() const
+{
+    switch (gamemode) {
+        case GameMode::MP_BATTLE:
+            return false;
+        default:
+            // every singleplayer mode, and the multiplayer marathons
+            return true;
+    }
+}
+
+void MatchRules::onPieceLocked(PlayerState& player) const
+{
+    player.prev_piece_cleared_line = player.current_piece_cleared_line;
+    player.current_piece_cleared_line = false;
+}
+
+void MatchRules::onNextRequested(PlayerState& player) const
+{
+    player.pending_garbage_lines = player.queued_garbage_lines;
+    player.queued_garbage_lines = 0;
+}
+
+MatchRules::LineClear MatchRules::onLineClear(PlayerState& player, PlayerStatistics& stats,
+                                              const WellEvent::lineclear_t& lcevent) const
+{
+    assert(lcevent.count > 0);
+    assert(lcevent.count <= 4);
+
+    LineClear result;
+    result.type = ScoreTable::lineclearType(lcevent);
+    result.back2back = ScoreTable::canContinueBackToBack(player.previous_lineclear_type, result.type);
+    result.combo_length = 0;
+    result.attack_lines = 0;
+    result.level_ups = 0;
+    result.finished = false;
+
+    stats.eventCount(result.type)++;
+    stats.total_cleared_lines += lcevent.count;
+
+    unsigned score = ScoreTable::value(result.type);
+    if (result.back2back) {
+        score *= ScoreTable::back2backMultiplier();
+        player.back2back_length++;
+        stats.back_to_back_count++;
+        stats.back_to_back_longest = std::max(stats.back_to_back_longest, player.back2back_length);
+    }
+    else
+        player.back2back_length = 0;
+
+    if (player.prev_piece_cleared_line) {
+        player.combo_length++;
+        score += ScoreTable::value(ScoreType::COMBO);
+        result.combo_length = player.combo_length;
+    }
+    else
+        player.combo_length = 0;
+
+    stats.score += score * stats.level;
+
+    if (isBattle()) {
+        unsigned sendable_lines = BattleAttackTable::sendableLineCount(lcevent, result.back2back);
+
+        // reduce the own garbage first
+        const unsigned smallest = std::min<unsigned>(sendable_lines, player.queued_garbage_lines);
+        player.queued_garbage_lines -= smallest;
+        sendable_lines -= smallest;
+        result.attack_lines = sendable_lines;
+    }
+
+    updateLevel(player, stats, result, lcevent);
+
+    player.previous_lineclear_type = result.type;
+    player.current_piece_cleared_line = true;
+    return result;
+}
+
+void MatchRules::updateLevel(PlayerState& player, PlayerStatistics& stats, LineClear& result,
+                             const WellEvent::lineclear_t& lcevent) const
+{
+    auto& lines_left = player.lineclears_left;
+    int line_awards = lcevent.count;
+    if (usesDynamicLineAwards()) {
+        line_awards = ScoreTable::lineAwards(result.type);
+        if (result.back2back)
+            line_awards *= ScoreTable::back2backMultiplier();
+
+        line_awards += player.combo_length / 2;
+    }
+    lines_left -= line_awards;
+
+    while (lines_left <= 0) {
+        if (player.lineclear_levels_left == 0 || player.gravity_levels_left == 0) {
+            lines_left = 0;
+            if (isFinishable()) {
+                player.status = PlayerStatus::FINISHED;
+                result.finished = true;
+            }
+            return;
+        }
+
+        player.gravity_levels_left--;
+        lines_left += lineclears_required[--player.lineclear_levels_left];
+        stats.level++;
+        result.level_ups++;
+    }
+}
+
+void MatchRules::onTSpin(PlayerStatistics& stats, ScoreType type) const
+{
+    assert(type == ScoreType::TSPIN || type == ScoreType::MINI_TSPIN);
+    stats.score += ScoreTable::value(type);
+    stats.eventCount(type)++;
+}
+
+void MatchRules::onHardDrop(PlayerStatistics& stats, const WellEvent::harddrop_t& event) const
+{
+    assert(event.count < 22);
+    stats.score += event.count * ScoreTable::value(ScoreType::HARDDROP);
+}
+
+void MatchRules::onSoftDrop(PlayerStatistics& stats) const
+{
+    stats.score += ScoreTable::value(ScoreType::SOFTDROP);
+}
+
+void MatchRules::onGameOver(PlayerState& player) const
+{
+    player.status = PlayerStatus::GAME_OVER;
+}
+
+bool MatchRules::onFrameEnd(PlayerState& player, PlayerStatistics& stats) const
+{
+    stats.gametime += Timing::frame_duration;
+
+    if (gamemode == GameMode::SP_2MIN && player.status == PlayerStatus::PLAYING
+        && stats.gametime >= std::chrono::minutes(2)) {
+        player.status = PlayerStatus::FINISHED;
+        return true;
+    }
+    return false;
+}
+
+void MatchRules::receiveGarbage(PlayerState& player, unsigned lines) const
+{
+    player.queued_garbage_lines = std::min<unsigned>(player.queued_garbage_lines + lines, max_queued_garbage);
+}
+
+int MatchRules::attackTarget(Random& rng, const std::vector<PlayerState*>& players, unsigned source) const
+{
+    std::vector<unsigned> possible_targets;
+    for (unsigned i = 0; i < players.size(); i++) {
+        if (i != source && players[i]->status == PlayerStatus::PLAYING)
+            possible_targets.push_back(i);
+    }
+    if (possible_targets.empty())
+        return -1;
+
+    return possible_targets.at(rng.below(possible_targets.size()));
+}
+
+int MatchRules::sendAttack(Random& rng, const std::vector<PlayerState*>& players,
+                           unsigned source, unsigned lines) const
+{
+    assert(lines > 0);
+    const int target_index = attackTarget(rng, players, source);
+    if (target_index < 0)
+        return -1;
+
+    PlayerState& target = *players[target_index];
+    if (target.incoming_attack_count == max_incoming_attacks) {
+        auto& last = target.incoming_attacks.back();
+        last.lines = std::min<unsigned>(last.lines + lines, max_queued_garbage);
+    }
+    else
+        target.incoming_attacks[target.incoming_attack_count++] = {
+            static_cast<uint8_t>(source),
+            static_cast<uint8_t>(std::min<unsigned>(lines, max_queued_garbage)),
+            attack_travel_frames,
+        };
+
+    return target_index;
+}
+
+unsigned MatchRules::updateIncomingAttacks(PlayerState& player) const
+{
+    unsigned arrived_lines = 0;
+    unsigned remaining = 0;
+    for (unsigned i = 0; i < player.incoming_attack_count; i++) {
+        IncomingAttack attack = player.incoming_attacks[i];
+        if (--attack.frames_left == 0)
+            arrived_lines += attack.lines;
+        else
+            player.incoming_attacks[remaining++] = attack;
+    }
+    std::fill(player.incoming_attacks.begin() + remaining, player.incoming_attacks.end(), IncomingAttack {0, 0, 0});
+    player.incoming_attack_count = remaining;
+
+    if (arrived_lines > 0)
+        receiveGarbage(player, arrived_lines);
+    return arrived_lines;
+}
+
+int MatchRules::finishBattleMaybe(const std::vector<PlayerState*>& players) const
+{
+    if (!isBattle())
+        return -1;
+
+    int winner = -1;
+    for (unsigned i = 0; i < players.size(); i++) {
+        if (players[i]->status != PlayerStatus::PLAYING)
+            continue;
+        // more than one player is still playing
+        if (winner >= 0)
+            return -1;
+        winner = i;
+    }
+    if (winner >= 0)
+        players[winner]->status = PlayerStatus::FINISHED;
+    return winner;
+}
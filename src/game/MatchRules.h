@@ -0,0 +1,135 @@
+#pragma once
+
+#include "GameMode.h"
+#include "PlayerStatistics.h"
+#include "ScoreTable.h"
+#include "Timing.h"
+#include "WellEvent.h"
+#include "game/util/Random.h"
+
+#include <array>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+
+/// The rules of a match, without any graphics or audio: scoring, levels
+/// and gravity, the end of the games, and the garbage of the battles.
+/// The rules don't own any state; the state of the players is plain data,
+/// updated by forwarding the events of their wells, so the same rules
+/// are used by the game, the simulator and the netplay matches.
+class MatchRules {
+public:
+    MatchRules(GameMode, unsigned short starting_gravity_level = 0);
+
+    GameMode mode() const { return gamemode; }
+    bool isBattle() const { return gamemode == GameMode::MP_BATTLE; }
+
+    /// The garbage of an attack, on its way to the target
+    struct IncomingAttack {
+        /// The index of the attacker
+        uint8_t source;
+        uint8_t lines;
+        uint16_t frames_left;
+    };
+    /// The attacks arrive after a second, when their animations end
+    static constexpr uint16_t attack_travel_frames = 60;
+    /// A player can have at most this many attacks on the way; the next
+    /// attacks are merged into the last one
+    static constexpr unsigned max_incoming_attacks = 8;
+
+    enum class PlayerStatus : uint8_t {
+        PLAYING,
+        GAME_OVER,
+        FINISHED,
+    };
+    /// The match related state of a player
+    struct PlayerState {
+        PlayerStatus status;
+        /// The number of levels not reached yet; the rest of the levels
+        /// are at the beginning of `lineclears_required` and `gravity_levels`
+        uint8_t lineclear_levels_left;
+        uint8_t gravity_levels_left;
+        int lineclears_left;
+        ScoreType previous_lineclear_type;
+        unsigned short back2back_length;
+        unsigned short combo_length;
+        bool prev_piece_cleared_line;
+        bool current_piece_cleared_line;
+        /// The garbage waiting for the next piece
+        unsigned short queued_garbage_lines;
+        /// The garbage to add to the well in the current frame
+        unsigned short pending_garbage_lines;
+        /// The attacks sent to the player, that haven't arrived yet, the oldest first
+        std::array<IncomingAttack, max_incoming_attacks> incoming_attacks;
+        uint8_t incoming_attack_count;
+    };
+    PlayerState newPlayer() const;
+    /// The garbage queue of a player holds at most this many lines
+    static constexpr unsigned short max_queued_garbage = 20;
+
+    /// The current gravity of the player's well
+    Duration gravity(const PlayerState&) const;
+    /// The number of levels in the level tables, for validating saved states
+    unsigned lineclearLevelCount() const { return lineclears_required.size(); }
+    unsigned gravityLevelCount() const { return gravity_levels.size(); }
+
+    /// What happened by a line clear, besides the changes of the player's state
+    struct LineClear {
+        ScoreType type;
+        bool back2back;
+        /// The length of the combo, or 0 if the previous piece didn't clear any lines
+        unsigned short combo_length;
+        /// The number of garbage lines to send to an opponent,
+        /// after reducing the player's own queued garbage
+        unsigned short attack_lines;
+        unsigned short level_ups;
+        /// The player has completed the last level
+        bool finished;
+    };
+
+    // The well events of the player
+    void onPieceLocked(PlayerState&) const;
+    /// Moves the queued garbage into the current frame
+    void onNextRequested(PlayerState&) const;
+    LineClear onLineClear(PlayerState&, PlayerStatistics&, const WellEvent::lineclear_t&) const;
+    /// The T-Spins without line clears
+    void onTSpin(PlayerStatistics&, ScoreType) const;
+    void onHardDrop(PlayerStatistics&, const WellEvent::harddrop_t&) const;
+    void onSoftDrop(PlayerStatistics&) const;
+    void onGameOver(PlayerState&) const;
+
+    /// Advance the game time of a playing player by one frame;
+    /// returns true if the player has reached the time limit of the mode
+    bool onFrameEnd(PlayerState&, PlayerStatistics&) const;
+
+    /// Add the garbage of an attack to the queue of the target
+    void receiveGarbage(PlayerState&, unsigned lines) const;
+    /// Choose a random target of an attack from the other players who are
+    /// still playing; returns its index, or -1 if there's no one to attack
+    int attackTarget(Random&, const std::vector<PlayerState*>&, unsigned source) const;
+    /// Send the attack of a line clear to a random target, where it arrives
+    /// after `attack_travel_frames`; returns the index of the target, or -1
+    int sendAttack(Random&, const std::vector<PlayerState*>&, unsigned source, unsigned lines) const;
+    /// Advance the attacks on their way to the player by one frame, and queue
+    /// the garbage of the arrived ones; called at the end of every frame,
+    /// after every well was updated. Returns the number of arrived lines.
+    unsigned updateIncomingAttacks(PlayerState&) const;
+    /// In battles, the last player still playing wins the match;
+    /// returns the index of the winner, or -1 if the match goes on
+    int finishBattleMaybe(const std::vector<PlayerState*>&) const;
+
+private:
+    const GameMode gamemode;
+
+    // the levels of the match, the same for every player;
+    // the next level is at the back
+    std::vector<unsigned short> lineclears_required;
+    std::vector<Duration> gravity_levels;
+
+    bool usesDynamicLineAwards() const;
+    bool isFinishable() const;
+    void updateLevel(PlayerState&, PlayerStatistics&, LineClear&, const WellEvent::lineclear_t&) const;
+};
+
+static_assert(std::is_trivially_copyable<MatchRules::PlayerState>::value, "Player states must be plain data");
@@ -3,6 +3,9 @@
 #include "ScoreTable.h"
 #include "Timing.h"
 
+#include <array>
+#include <type_traits>
+
 
 struct PlayerStatistics {
     unsigned score;
@@ -10,12 +13,18 @@ struct PlayerStatistics {
     unsigned short total_cleared_lines;
     unsigned short back_to_back_count;
     unsigned short back_to_back_longest;
-    std::map<ScoreType, unsigned short> event_count;
+    std::array<unsigned short, ScoreTypeCount> event_count;
     Duration gametime;
 
     PlayerStatistics()
         : score(0), level(1), total_cleared_lines(0)
         , back_to_back_count(0), back_to_back_longest(0)
+        , event_count{}
         , gametime(Duration::zero())
     {}
+
+    unsigned short& eventCount(ScoreType type) { return event_count[static_cast<uint8_t>(type)]; }
+    unsigned short eventCount(ScoreType type) const { return event_count[static_cast<uint8_t>(type)]; }
 };
+
+static_assert(std::is_trivially_copyable<PlayerStatistics>::value, "PlayerStatistics must be plain data");
@@ -47,7 +47,7 @@ const std::map<ScoreType, unsigned short> ScoreTable::lineaward_table = {
     {ScoreType::CLEAR_TSPIN_TRIPLE, 16},
 };
 
-float ScoreTable::back2back_multiplier = 1.5;
+const float ScoreTable::back2back_multiplier = 1.5;
 const std::string ScoreTable::back2back_name = tr("BACK-TO-BACK");
 
 
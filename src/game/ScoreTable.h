@@ -21,6 +21,7 @@ enum class ScoreType : unsigned char {
     HARDDROP,
     COMBO,
 };
+constexpr unsigned ScoreTypeCount = static_cast<unsigned>(ScoreType::COMBO) + 1;
 
 
 class ScoreTable {
@@ -40,6 +41,6 @@ private:
     static const std::map<ScoreType, const std::string> score_name;
     static const std::map<ScoreType, unsigned short> lineaward_table;
 
-    static float back2back_multiplier;
+    static const float back2back_multiplier;
     static const std::string back2back_name;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "game/ai/BotSettings.h"
+
 #include <string>
 
 
@@ -8,11 +10,22 @@ struct SysConfig {
     bool sfx;
     bool music;
     std::string theme_dir_name;
+    AI::BotDifficulty cpu_difficulty;
+    bool record_replays;
+    /// When the game can't keep up, skip drawing until the game logic
+    /// catches up, at most `max_frame_skip` frames in a row (zero turns
+    /// the skipping off)
+    bool frame_skip;
+    unsigned short max_frame_skip;
 
     SysConfig()
         : fullscreen(false)
         , sfx(true)
         , music(true)
         , theme_dir_name("default")
+        , cpu_difficulty(AI::BotDifficulty::MEDIUM)
+        , record_replays(false)
+        , frame_skip(true)
+        , max_frame_skip(3)
     {}
 };
@@ -26,6 +26,15 @@ public:
         is_running = true;
     }
 
+    /// Returns the time passed since the start of the transition.
+    Duration elapsed() const { return timer; }
+
+    /// Sets the timer and the running state directly, eg. when loading a saved game state.
+    void restore(Duration elapsed, bool running) {
+        timer = elapsed;
+        is_running = running;
+    }
+
     /// Stops the transition and resets its timer to zero.
     virtual void stop() {
         is_running = false;
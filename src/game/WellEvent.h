@@ -28,14 +28,24 @@ struct WellEvent {
         uint8_t count;
     };
 
+    /// The well positions of the minos of the locked piece
+    struct piecelock_t {
+        uint8_t count;
+        uint8_t rows[4];
+        uint8_t cols[4];
+    };
+
     struct lineclear_t {
         uint8_t count;
         LineClearType type;
+        /// The cleared rows of the well, where bit N is row N
+        uint64_t rows;
     };
 
     Type type;
     union {
         harddrop_t harddrop;
+        piecelock_t piecelock;
         lineclear_t lineclear;
     };
 
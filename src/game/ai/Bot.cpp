@@ -0,0 +1,276 @@
+#include "Bot.h"
+
+#include "game/ScoreTable.h"
+#include "game/util/ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+#include <assert.h>
+
+
+namespace AI {
+
+Bot::Bot(Well& well, DeviceID device_id, const BotSettings& settings, ThreadPool& workers)
+    : Bot(well, device_id, settings, &workers)
+{}
+
+Bot::Bot(Well& well, DeviceID device_id, const BotSettings& settings)
+    : Bot(well, device_id, settings, nullptr)
+{}
+
+Bot::Bot(Well& well, DeviceID device_id, const BotSettings& settings, ThreadPool* workers)
+    : device_id(device_id)
+    , settings(settings)
+    , workers(workers)
+    , movegen(well)
+    , phase(Phase::WAITING_FOR_PIECE)
+    , hold_pressed(false)
+    , softdrop_held(false)
+    , release_pending(false)
+    , pending_release(InputType::GAME_HARDDROP)
+    , frames_since_input(0)
+    , path_pos(0)
+    , last_clear(ScoreType::CLEAR_SINGLE)
+    , piece_locked(false)
+    , planner(well, settings)
+    , cancel_search(false)
+    , search_running(false)
+    , result_ready(false)
+{
+    assert(isBotDevice(device_id));
+    plan.valid = false;
+
+    well.registerObserver(WellEvent::Type::PIECE_LOCKED, [this](const WellEvent&){
+        piece_locked = true;
+    });
+    well.registerObserver(WellEvent::Type::LINE_CLEAR, [this](const WellEvent& event){
+        last_clear = ScoreTable::lineclearType(event.lineclear);
+    });
+}
+
+Bot::~Bot()
+{
+    cancel_search = true;
+    std::unique_lock<std::mutex> lock(search_mutex);
+    search_finished.wait(lock, [this]{ return !search_running; });
+}
+
+void Bot::update(const Well& well, const PlayerView& view, std::vector<InputEvent>& output)
+{
+    // every key is released in the frame after it was pressed
+    if (release_pending) {
+        release(pending_release, output);
+        release_pending = false;
+    }
+    frames_since_input++;
+
+    if (piece_locked) {
+        piece_locked = false;
+        hold_pressed = false;
+        phase = Phase::WAITING_FOR_PIECE;
+    }
+
+    const Piece* const piece = well.activePiece();
+    if (!piece) {
+        if (softdrop_held) {
+            release(InputType::GAME_SOFTDROP, output);
+            softdrop_held = false;
+        }
+        return;
+    }
+
+    switch (phase) {
+        case Phase::WAITING_FOR_PIECE:
+            if (startSearch(well, view))
+                phase = Phase::THINKING;
+            return;
+        case Phase::THINKING:
+            if (!takeResult())
+                return;
+            phase = Phase::MOVING;
+            if (!plan.valid)
+                replanNow(well);
+            break;
+        case Phase::MOVING:
+            break;
+    }
+
+    if (plan.use_hold && !hold_pressed) {
+        if (frames_since_input < settings.frames_per_input)
+            return;
+        if (view.hold_allowed) {
+            press(InputType::GAME_HOLD, output);
+            hold_pressed = true;
+            return;
+        }
+        replanNow(well);
+    }
+
+    // the piece may have been moved by gravity, or the board
+    // may have changed by garbage, so the path is always recalculated
+    InputType input;
+    if (!nextInput(well, input)) {
+        replanNow(well);
+        if (!nextInput(well, input))
+            input = InputType::GAME_HARDDROP;
+    }
+
+    // soft drop is held down, instead of tapping
+    if (input == InputType::GAME_SOFTDROP) {
+        if (!softdrop_held) {
+            output.emplace_back(InputType::GAME_SOFTDROP, true, device_id);
+            softdrop_held = true;
+        }
+        return;
+    }
+    if (softdrop_held) {
+        release(InputType::GAME_SOFTDROP, output);
+        softdrop_held = false;
+    }
+
+    if (frames_since_input >= settings.frames_per_input)
+        press(input, output);
+}
+
+bool Bot::startSearch(const Well& well, const PlayerView& view)
+{
+    assert(well.activePiece());
+
+    // the previous search may still be running, if the piece was locked
+    // before it finished; the bot must not block the game, so it stops it,
+    // and tries again in the next frame
+    std::lock_guard<std::mutex> lock(search_mutex);
+    if (search_running) {
+        cancel_search = true;
+        return false;
+    }
+
+    request.board = well.lockedMinos();
+    request.current_piece = well.activePiece()->type();
+    request.hold_empty = view.hold_empty;
+    request.hold_piece = view.hold_piece;
+    request.hold_allowed = view.hold_allowed;
+    request.last_clear = last_clear;
+    request.gravity_delay = well.gravityDelay();
+
+    // one extra piece may be used when the hold queue is empty
+    const size_t next_count = std::min<size_t>(view.next_pieces.size(), settings.search_depth);
+    request.next_pieces.assign(view.next_pieces.cbegin(), view.next_pieces.cbegin() + next_count);
+
+    cancel_search = false;
+    if (!workers) {
+        result = planner.search(request, Planner::Clock::time_point::max(), cancel_search);
+        result_ready = true;
+        return true;
+    }
+
+    search_running = true;
+    result_ready = false;
+
+    const auto deadline = Planner::Clock::now() + settings.think_time;
+    workers->submit([this, deadline]{
+        const Plan found = planner.search(request, deadline, cancel_search);
+
+        std::lock_guard<std::mutex> lock(search_mutex);
+        result = found;
+        result_ready = true;
+        search_running = false;
+        search_finished.notify_all();
+    });
+    return true;
+}
+
+bool Bot::takeResult()
+{
+    std::lock_guard<std::mutex> lock(search_mutex);
+    if (!result_ready)
+        return false;
+
+    plan = result;
+    path_pos = 0;
+    result_ready = false;
+    return true;
+}
+
+void Bot::replanNow(const Well& well)
+{
+    // a quick, one piece search on the current position
+    plan.valid = false;
+    plan.use_hold = false;
+    movegen.setGravity(well.gravityDelay(), settings.inputInterval());
+
+    int best_score = std::numeric_limits<int>::min();
+    for (const auto& placement : movegen.generate(well)) {
+        auto board = well.lockedMinos();
+        const unsigned cleared_lines = movegen.lockOnto(board, placement);
+        const auto move_result = Evaluator::moveResult(cleared_lines, placement.tspin, last_clear);
+        const int score = planner.evaluator().evaluate(move_result) + planner.evaluator().evaluate(board);
+        if (score > best_score) {
+            best_score = score;
+            plan.valid = true;
+            plan.placement = placement;
+        }
+    }
+
+    plan.path.clear();
+    if (plan.valid)
+        plan.path = movegen.stepsTo(plan.placement);
+    path_pos = 0;
+}
+
+bool Bot::nextInput(const Well& well, InputType& output)
+{
+    if (!plan.valid)
+        return false;
+    if (followPath(well, output))
+        return true;
+
+    // the piece was moved off the path (eg. by gravity or garbage),
+    // so the path is searched again from its current position
+    movegen.setGravity(well.gravityDelay(), settings.inputInterval());
+    for (const auto& placement : movegen.generate(well)) {
+        if (movegen.isSameSpot(placement, plan.placement)) {
+            plan.path = movegen.stepsTo(placement);
+            path_pos = 0;
+            return followPath(well, output);
+        }
+    }
+    return false;
+}
+
+bool Bot::followPath(const Well& well, InputType& output)
+{
+    const Piece* const piece = well.activePiece();
+    assert(piece);
+    if (piece->type() != plan.placement.type)
+        return false;
+
+    // the piece may be at a later step already, moved there
+    // by the previous key press or a held soft drop
+    for (size_t step = path_pos; step < plan.path.size(); step++) {
+        const auto& expected = plan.path[step];
+        if (expected.x == well.activePieceX()
+            && expected.y == well.activePieceY()
+            && expected.orientation == piece->orientation()) {
+            path_pos = step;
+            output = expected.input;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Bot::press(InputType input, std::vector<InputEvent>& output)
+{
+    output.emplace_back(input, true, device_id);
+    release_pending = true;
+    pending_release = input;
+    frames_since_input = 0;
+}
+
+void Bot::release(InputType input, std::vector<InputEvent>& output)
+{
+    output.emplace_back(input, false, device_id);
+}
+
+} // namespace AI
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "BotSettings.h"
+#include "Planner.h"
+#include "game/components/Well.h"
+#include "game/components/well/MoveGen.h"
+#include "system/Event.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+class ThreadPool;
+
+
+namespace AI {
+
+/// The CPU players use virtual input devices, starting from this ID
+constexpr DeviceID first_bot_device = 100;
+constexpr DeviceID max_bot_count = 4;
+inline bool isBotDevice(DeviceID device_id) {
+    return device_id >= first_bot_device && device_id < first_bot_device + max_bot_count;
+}
+
+
+/// The parts of the player's state the bot can see, besides its well
+struct PlayerView {
+    bool hold_empty;
+    PieceType hold_piece;
+    bool hold_allowed;
+    std::vector<PieceType> next_pieces;
+};
+
+
+/// A CPU player, that controls a well by generating input events,
+/// just like a human player would do with a keyboard or a gamepad.
+///
+/// When a new piece appears, the bot starts planning its placement on
+/// a worker thread, and polls the result in every frame, so the game loop
+/// is never blocked by the search. Then the piece is moved into its target
+/// position with one key press at a time, at the rate of the difficulty,
+/// along the path found by the search. The path is only searched again
+/// on the game thread if the piece leaves it, eg. when it's moved by gravity.
+class Bot {
+public:
+    /// Create a bot for the well; the bot and its worker pool must not outlive the well
+    Bot(Well&, DeviceID, const BotSettings&, ThreadPool&);
+    /// Create a bot that plans on the calling thread, without a time limit,
+    /// so its moves only depend on the game (eg. for simulations)
+    Bot(Well&, DeviceID, const BotSettings&);
+    /// Waits for the running search to finish
+    ~Bot();
+
+    DeviceID deviceID() const { return device_id; }
+
+    /// Update the bot, then add its input events of the current frame to the list.
+    /// Should be called once every frame, before the well is updated.
+    void update(const Well&, const PlayerView&, std::vector<InputEvent>& output);
+
+private:
+    const DeviceID device_id;
+    const BotSettings settings;
+    ThreadPool* const workers;
+    WellComponents::MoveGen<Well::width, Well::height> movegen;
+
+    enum class Phase : uint8_t {
+        WAITING_FOR_PIECE,
+        THINKING,
+        MOVING,
+    };
+    Phase phase;
+    Plan plan;
+    bool hold_pressed;
+    bool softdrop_held;
+    bool release_pending;
+    InputType pending_release;
+    unsigned frames_since_input;
+    /// The current step of the path of the plan
+    size_t path_pos;
+
+    // updated by the well observers
+    ScoreType last_clear;
+    bool piece_locked;
+
+    // shared with the worker thread
+    Planner planner;
+    PlanRequest request;
+    std::atomic<bool> cancel_search;
+    std::mutex search_mutex;
+    std::condition_variable search_finished;
+    bool search_running;
+    bool result_ready;
+    Plan result;
+
+    Bot(Well&, DeviceID, const BotSettings&, ThreadPool*);
+
+    bool startSearch(const Well&, const PlayerView&);
+    bool takeResult();
+    void press(InputType, std::vector<InputEvent>&);
+    void release(InputType, std::vector<InputEvent>&);
+    /// Choose a target among the current placements, if the plan can't be followed
+    void replanNow(const Well&);
+    /// The next key of the path to the planned placement
+    bool nextInput(const Well&, InputType&);
+    /// The next key of the current path, if the piece is still on it
+    bool followPath(const Well&, InputType&);
+};
+
+} // namespace AI
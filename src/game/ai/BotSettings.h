@@ -0,0 +1,59 @@
+#pragma once
+
+#include "game/Timing.h"
+
+#include <array>
+#include <stdint.h>
+
+
+namespace AI {
+
+enum class BotDifficulty : uint8_t {
+    EASY,
+    MEDIUM,
+    HARD,
+    EXPERT,
+};
+
+constexpr std::array<BotDifficulty, 4> BotDifficultyList = {{
+    BotDifficulty::EASY,
+    BotDifficulty::MEDIUM,
+    BotDifficulty::HARD,
+    BotDifficulty::EXPERT,
+}};
+
+
+/// The limits of a CPU player
+struct BotSettings {
+    /// The number of pieces to plan ahead, including the current one;
+    /// it is also limited by the number of visible next pieces
+    unsigned search_depth;
+    /// The number of boards kept on every level of the beam search
+    unsigned beam_width;
+    /// The time budget of planning the placement of a piece
+    Duration think_time;
+    /// The number of frames between two key presses (at least 2,
+    /// as every key is released in the frame after the press)
+    unsigned frames_per_input;
+    /// Whether the bot may use the hold queue
+    bool use_hold;
+
+    /// The time between two key presses
+    Duration inputInterval() const { return frames_per_input * Timing::frame_duration; }
+
+    static BotSettings fromDifficulty(BotDifficulty difficulty) {
+        switch (difficulty) {
+            case BotDifficulty::EASY:
+                return {1, 4, std::chrono::milliseconds(20), 12, false};
+            case BotDifficulty::MEDIUM:
+                return {2, 12, std::chrono::milliseconds(50), 6, true};
+            case BotDifficulty::HARD:
+                return {3, 32, std::chrono::milliseconds(100), 3, true};
+            case BotDifficulty::EXPERT:
+                return {4, 96, std::chrono::milliseconds(150), 2, true};
+        }
+        return {1, 1, Duration::zero(), 2, false};
+    }
+};
+
+} // namespace AI
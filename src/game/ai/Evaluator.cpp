@@ -0,0 +1,165 @@
+#include "Evaluator.h"
+
+#include "game/BattleAttackTable.h"
+#include "game/util/BitScan.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+
+namespace AI {
+
+EvalWeights EvalWeights::defaults()
+{
+    EvalWeights weights;
+    weights.max_height = -3;
+    weights.danger_height = -60;
+    weights.holes = -40;
+    weights.hole_rows = -25;
+    weights.bumpiness = -6;
+    weights.well_depth = 8;
+    weights.tslot = 30;
+    weights.tslot_lines = 25;
+    weights.attack = 70;
+    weights.wasted_line = -20;
+    weights.back2back = 40;
+    return weights;
+}
+
+
+Evaluator::Evaluator(const EvalWeights& weights)
+    : weights(weights)
+{
+}
+
+MoveResult Evaluator::moveResult(unsigned cleared_lines, TSpinDetectionResult tspin, ScoreType last_clear)
+{
+    if (cleared_lines == 0)
+        return {0, 0, last_clear};
+
+    WellEvent::lineclear_t lineclear;
+    lineclear.count = cleared_lines;
+    lineclear.rows = 0;
+    switch (tspin) {
+        case TSpinDetectionResult::TSPIN:
+            lineclear.type = LineClearType::TSPIN;
+            break;
+        case TSpinDetectionResult::MINI_TSPIN:
+            // a mini T-Spin can clear two lines next to the wall,
+            // but it counts as a normal double
+            lineclear.type = (cleared_lines == 1) ? LineClearType::MINI_TSPIN : LineClearType::NORMAL;
+            break;
+        default:
+            lineclear.type = LineClearType::NORMAL;
+            break;
+    }
+
+    const auto clear_type = ScoreTable::lineclearType(lineclear);
+    const bool back2back = ScoreTable::canContinueBackToBack(last_clear, clear_type);
+    return {cleared_lines, BattleAttackTable::sendableLineCount(lineclear, back2back), clear_type};
+}
+
+int Evaluator::evaluate(const MoveResult& result) const
+{
+    if (result.cleared_lines == 0)
+        return 0;
+
+    int score = result.attack * weights.attack;
+    if (result.attack == 0)
+        score += result.cleared_lines * weights.wasted_line;
+    // a line clear that could continue a back-to-back chain
+    if (ScoreTable::canContinueBackToBack(result.last_clear, result.last_clear))
+        score += weights.back2back;
+    return score;
+}
+
+int Evaluator::evaluate(const Board& board) const
+{
+    std::array<int, Board::width> heights;
+    unsigned top_row = Board::height;
+    for (unsigned col = 0; col < Board::width; col++) {
+        const unsigned column_top = board.columnTop(col);
+        heights[col] = Board::height - column_top;
+        top_row = std::min(top_row, column_top);
+    }
+
+    int score = 0;
+
+    const int max_height = Board::height - top_row;
+    constexpr int danger_line = Well::visible_height * 3 / 4;
+    score += max_height * weights.max_height;
+    if (max_height > danger_line)
+        score += (max_height - danger_line) * weights.danger_height;
+
+    // the empty cells under a mino
+    Board::RowMask covered = 0;
+    for (unsigned row = top_row; row < Board::height; row++) {
+        const auto row_mask = board.rowMask(row);
+        const auto holes = covered & ~row_mask;
+        if (holes) {
+            score += countSetBits(holes) * weights.holes;
+            score += weights.hole_rows;
+        }
+        covered |= row_mask;
+    }
+
+    // one deep well is kept for line clears, the rest of the surface should be flat
+    const auto well_col = std::distance(heights.cbegin(), std::min_element(heights.cbegin(), heights.cend()));
+    const int left_height = (well_col > 0) ? heights[well_col - 1] : Board::height;
+    const int right_height = (well_col + 1 < static_cast<int>(Board::width)) ? heights[well_col + 1] : Board::height;
+    const int well_depth = std::min(left_height, right_height) - heights[well_col];
+    score += std::min(well_depth, 4) * weights.well_depth;
+
+    for (unsigned col = 0; col + 1 < Board::width; col++) {
+        if (static_cast<int>(col) == well_col || static_cast<int>(col + 1) == well_col)
+            continue;
+        score += std::abs(heights[col] - heights[col + 1]) * weights.bumpiness;
+    }
+
+    score += tslotScore(board, top_row);
+    return score;
+}
+
+int Evaluator::tslotScore(const Board& board, unsigned top_row) const
+{
+    // Look for places where a T piece pointing down would fit, with
+    // an overhang on one side, and an open path from above on the other:
+    //
+    //   X..  or  ..X
+    //   ...      ...
+    //   X.X      X.X
+    int best_score = 0;
+    const unsigned first_row = (top_row >= 2) ? top_row - 2 : 0;
+    for (unsigned row = first_row; row + 2 < Board::height; row++) {
+        const auto mid_mask = board.rowMask(row + 1);
+        const auto bottom_mask = board.rowMask(row + 2);
+
+        for (unsigned col = 0; col + 2 < Board::width; col++) {
+            if (mid_mask & (0b111u << col))
+                continue;
+            if ((bottom_mask >> col & 0b111u) != 0b101u)
+                continue;
+
+            const bool left_overhang = board.isOccupied(row, col);
+            const bool right_overhang = board.isOccupied(row, col + 2);
+            if (left_overhang == right_overhang || board.isOccupied(row, col + 1))
+                continue;
+
+            // the piece must be able to get into the slot from above
+            const unsigned open_col = left_overhang ? col + 2 : col;
+            if (board.columnTop(open_col) <= row || board.columnTop(col + 1) <= row)
+                continue;
+
+            int score = weights.tslot;
+            if ((mid_mask | (0b111u << col)) == Board::full_row)
+                score += weights.tslot_lines;
+            if ((bottom_mask | (0b010u << col)) == Board::full_row)
+                score += weights.tslot_lines;
+            best_score = std::max(best_score, score);
+        }
+    }
+    return best_score;
+}
+
+} // namespace AI
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "game/ScoreTable.h"
+#include "game/components/Well.h"
+#include "game/components/well/TSpin.h"
+
+
+namespace AI {
+
+/// The weights of the evaluation; positive values are rewarded,
+/// negative values are penalized
+struct EvalWeights {
+    int max_height;       ///< per row of the highest column
+    int danger_height;    ///< per row of the highest column, over the danger line
+    int holes;            ///< per empty cell, that has a mino above it
+    int hole_rows;        ///< per row with at least one hole
+    int bumpiness;        ///< per row of height difference between the neighbouring columns
+    int well_depth;       ///< per row of the deepest well, up to 4 rows
+    int tslot;            ///< per T-Spin slot
+    int tslot_lines;      ///< per row, that would be cleared by the T piece in a T-Spin slot
+    int attack;           ///< per garbage line sent
+    int wasted_line;      ///< per cleared line, that didn't send garbage
+    int back2back;        ///< for keeping a back-to-back chain alive
+
+    static EvalWeights defaults();
+};
+
+
+/// The result of locking a piece
+struct MoveResult {
+    unsigned cleared_lines;
+    unsigned attack;
+    /// The type of the last line clear, for back-to-back detection
+    ScoreType last_clear;
+};
+
+
+/// The weighted heuristic evaluation of a board
+class Evaluator {
+public:
+    using Board = Well::Board;
+
+    explicit Evaluator(const EvalWeights& weights = EvalWeights::defaults());
+
+    /// The score of the board itself, independently of how it was created
+    int evaluate(const Board&) const;
+    /// The score of a locked piece
+    int evaluate(const MoveResult&) const;
+
+    /// The line clear and the attack of locking a piece, that cleared `cleared_lines` lines
+    /// with `tspin`, where the type of the last line clear before it was `last_clear`
+    static MoveResult moveResult(unsigned cleared_lines, TSpinDetectionResult tspin, ScoreType last_clear);
+
+private:
+    const EvalWeights weights;
+
+    int tslotScore(const Board&, unsigned top_row) const;
+};
+
+} // namespace AI
@@ -0,0 +1,123 @@
+#include "Planner.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+namespace AI {
+
+Planner::Planner(const Well& well, const BotSettings& settings, const EvalWeights& weights)
+    : settings(settings)
+    , eval(weights)
+    , movegen(well)
+{
+}
+
+Plan Planner::search(const PlanRequest& request, Clock::time_point deadline, const std::atomic<bool>& cancelled)
+{
+    // the current piece, followed by the visible next pieces
+    pieces.clear();
+    pieces.push_back(request.current_piece);
+    pieces.insert(pieces.end(), request.next_pieces.cbegin(), request.next_pieces.cend());
+
+    movegen.setGravity(request.gravity_delay, settings.inputInterval());
+
+    beam.clear();
+    first_paths.clear();
+    {
+        Node root;
+        root.board = request.board;
+        root.move_score = 0;
+        root.total_score = 0;
+        root.last_clear = request.last_clear;
+        root.hold_empty = request.hold_empty;
+        root.hold_piece = request.hold_piece;
+        root.next_piece_idx = 0;
+        root.first_move = Plan();
+        root.first_path = 0;
+        beam.push_back(root);
+    }
+
+    const unsigned max_depth = std::max(1u, settings.search_depth);
+    Plan best_plan;
+    best_plan.valid = false;
+    uint16_t best_path = 0;
+
+    for (unsigned depth = 0; depth < max_depth; depth++) {
+        const bool is_root = (depth == 0);
+        children.clear();
+
+        bool out_of_time = false;
+        for (const auto& node : beam) {
+            if (node.next_piece_idx >= pieces.size())
+                continue;
+
+            const PieceType piece = pieces[node.next_piece_idx];
+            expand(node, piece, node.hold_piece, node.hold_empty, node.next_piece_idx + 1, is_root, false);
+
+            // the held piece can be swapped once in every turn
+            const bool hold_allowed = settings.use_hold && (!is_root || request.hold_allowed);
+            if (hold_allowed && !(!node.hold_empty && node.hold_piece == piece)) {
+                if (!node.hold_empty)
+                    expand(node, node.hold_piece, piece, false, node.next_piece_idx + 1, is_root, true);
+                else if (node.next_piece_idx + 1u < pieces.size())
+                    expand(node, pieces[node.next_piece_idx + 1], piece, false, node.next_piece_idx + 2, is_root, true);
+            }
+
+            if (cancelled || Clock::now() >= deadline) {
+                out_of_time = true;
+                break;
+            }
+        }
+        if (children.empty())
+            break;
+
+        // keep the best nodes for the next level; a partially expanded level
+        // is only used if there's no other choice
+        const auto beam_size = std::min<size_t>(std::max(1u, settings.beam_width), children.size());
+        std::partial_sort(children.begin(), children.begin() + beam_size, children.end(),
+            [](const Node& a, const Node& b){ return a.total_score > b.total_score; });
+        children.resize(beam_size);
+
+        if (!out_of_time || !best_plan.valid) {
+            best_plan = children.front().first_move;
+            best_path = children.front().first_path;
+        }
+        if (out_of_time)
+            break;
+
+        beam.swap(children);
+    }
+
+    if (best_plan.valid)
+        best_plan.path = first_paths.at(best_path);
+    return best_plan;
+}
+
+void Planner::expand(const Node& node, PieceType piece, PieceType new_hold, bool new_hold_empty,
+                     uint8_t next_piece_idx, bool is_root, bool used_hold)
+{
+    for (const auto& placement : movegen.generate(node.board, piece)) {
+        children.emplace_back(node);
+        auto& child = children.back();
+
+        const unsigned cleared_lines = movegen.lockOnto(child.board, placement);
+        const auto result = Evaluator::moveResult(cleared_lines, placement.tspin, node.last_clear);
+        child.last_clear = result.last_clear;
+        child.move_score = node.move_score + eval.evaluate(result);
+        child.total_score = child.move_score + eval.evaluate(child.board);
+        child.hold_empty = new_hold_empty;
+        child.hold_piece = new_hold;
+        child.next_piece_idx = next_piece_idx;
+
+        if (is_root) {
+            child.first_move.valid = true;
+            child.first_move.use_hold = used_hold;
+            child.first_move.placement = placement;
+            child.first_path = first_paths.size();
+            first_paths.push_back(movegen.stepsTo(placement));
+        }
+    }
+}
+
+} // namespace AI
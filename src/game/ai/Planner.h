@@ -0,0 +1,92 @@
+#pragma once
+
+#include "BotSettings.h"
+#include "Evaluator.h"
+#include "game/components/Well.h"
+#include "game/components/well/MoveGen.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+
+namespace AI {
+
+/// Everything the bot can see when it plans the placement of a piece
+struct PlanRequest {
+    Well::Board board;
+    PieceType current_piece;
+    bool hold_empty;
+    PieceType hold_piece;
+    bool hold_allowed;
+    /// The visible next pieces
+    std::vector<PieceType> next_pieces;
+    /// The type of the last line clear, for back-to-back detection
+    ScoreType last_clear;
+    /// The current gravity of the well
+    Duration gravity_delay;
+};
+
+using PathStep = WellComponents::MoveGen<Well::width, Well::height>::PathStep;
+
+/// The placement of the current piece, chosen by the search
+struct Plan {
+    bool valid;
+    /// Swap the current piece with the held one first
+    bool use_hold;
+    WellComponents::MoveGen<Well::width, Well::height>::Placement placement;
+    /// The key presses that move the piece from its spawn position to the placement
+    std::vector<PathStep> path;
+};
+
+
+/// A beam search over the placements of the current, held and next pieces.
+/// On every level of the search, every board of the beam is expanded
+/// with the placements of the next piece (and the held piece),
+/// then the best boards are kept for the next level.
+class Planner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Planner(const Well&, const BotSettings&, const EvalWeights& = EvalWeights::defaults());
+
+    /// Find the best placement of the current piece. The search stops
+    /// early at the deadline, or when `cancelled` is set, and returns
+    /// the best plan of the deepest completed level.
+    Plan search(const PlanRequest&, Clock::time_point deadline, const std::atomic<bool>& cancelled);
+
+    const Evaluator& evaluator() const { return eval; }
+
+private:
+    struct Node {
+        Well::Board board;
+        /// The sum of the move scores on the path to this node
+        int move_score;
+        /// The move score plus the score of the board
+        int total_score;
+        ScoreType last_clear;
+        bool hold_empty;
+        PieceType hold_piece;
+        /// The index of the next unused piece in the piece list
+        uint8_t next_piece_idx;
+        /// The first move on the path to this node, and the index of its path
+        /// (the paths are only stored once, for the placements of the current piece)
+        Plan first_move;
+        uint16_t first_path;
+    };
+
+    const BotSettings settings;
+    const Evaluator eval;
+    WellComponents::MoveGen<Well::width, Well::height> movegen;
+
+    // reused between the searches
+    std::vector<PieceType> pieces;
+    std::vector<Node> beam;
+    std::vector<Node> children;
+    std::vector<std::vector<PathStep>> first_paths;
+
+    void expand(const Node&, PieceType piece, PieceType new_hold, bool new_hold_empty,
+                uint8_t next_piece_idx, bool is_root, bool used_hold);
+};
+
+} // namespace AI
@@ -1,7 +1,9 @@
 #include "HoldQueue.h"
 
 #include "Mino.h"
-#include "PieceFactory.h"
+#include "Piece.h"
+#include "PieceRender.h"
+#include "rotations/SRS.h"
 #include "game/Timing.h"
 #include "system/GraphicsContext.h"
 
@@ -21,7 +23,7 @@ HoldQueue::HoldQueue()
 
     size_t i = 0;
     for(const auto ptype : PieceTypeList) {
-        piece_storage[i] = PieceFactory::make_uptr(ptype);
+        piece_storage[i] = Piece(ptype, Rotations::SRS::shapes());
         i++;
     }
 }
@@ -66,12 +68,29 @@ void HoldQueue::swapWithEmpty(PieceType other)
     empty = false;
 }
 
+HoldQueue::Snapshot HoldQueue::snapshot() const
+{
+    Snapshot saved;
+    saved.swap_allowed = swap_allowed;
+    saved.empty = empty;
+    saved.current_piece = current_piece;
+    return saved;
+}
+
+void HoldQueue::restore(const Snapshot& saved)
+{
+    swap_allowed = saved.swap_allowed;
+    empty = saved.empty;
+    current_piece = saved.current_piece;
+    swapblocked_alpha.stop();
+}
+
 void HoldQueue::update()
 {
     swapblocked_alpha.update(Timing::frame_duration);
 }
 
-void HoldQueue::draw(GraphicsContext& gcx, int x, int y) const
+void HoldQueue::draw(GraphicsContext& gcx, const MinoStorage& minos, int x, int y) const
 {
     if (swapblocked_alpha.running()) {
         gcx.drawFilledRect({
@@ -82,8 +101,8 @@ void HoldQueue::draw(GraphicsContext& gcx, int x, int y) const
 
     if (!empty) {
         const auto& piece = piece_storage.at(static_cast<size_t>(current_piece));
-        const float padding_x = (4 - Piece::displayWidth(piece->type())) / 2.0f;
-        piece->draw(x + Mino::texture_size_px * (0.5f + padding_x),
-                    y + Mino::texture_size_px);
+        const float padding_x = (4 - Piece::displayWidth(piece.type())) / 2.0f;
+        drawPiece(minos, piece, x + Mino::texture_size_px * (0.5f + padding_x),
+                  y + Mino::texture_size_px);
     }
 }
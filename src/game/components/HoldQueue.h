@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Piece.h"
 #include "PieceType.h"
 #include "game/Transition.h"
 #include "system/Color.h"
@@ -9,7 +10,7 @@
 
 
 class GraphicsContext;
-class Piece;
+class MinoStorage;
 
 
 /// A piece holder, allows swapping the active piece once in every turn.
@@ -29,22 +30,32 @@ public:
 
     /// True, if the holder is empty.
     bool isEmpty() const { return empty; }
+    /// The currently held piece; only valid if the holder is not empty.
+    PieceType heldPiece() const { return current_piece; }
 
     /// Returns the currently held piece, and replaces it with the specified one.
     PieceType swapWith(PieceType);
     void swapWithEmpty(PieceType);
 
+    struct Snapshot {
+        bool swap_allowed;
+        bool empty;
+        PieceType current_piece;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot&);
+
     /// Update the animations
     void update();
 
     /// Draw the current holded piece at (x,y), if any.
-    void draw(GraphicsContext&, int x, int y) const;
+    void draw(GraphicsContext&, const MinoStorage&, int x, int y) const;
 
 private:
     bool swap_allowed;
     bool empty;
     PieceType current_piece;
-    std::array<std::unique_ptr<Piece>, 7> piece_storage;
+    std::array<Piece, 7> piece_storage;
 
     Transition<uint8_t> swapblocked_alpha;
 };
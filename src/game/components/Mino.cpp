@@ -3,20 +3,36 @@
 #include <assert.h>
 
 
-Mino::Mino(std::unique_ptr<Texture> texture, char ascii_val)
-    : texture(std::move(texture))
+Mino::Mino(std::shared_ptr<Texture> atlas, const Rectangle& atlas_rect, char ascii_val)
+    : atlas(std::move(atlas))
+    , atlas_rect(atlas_rect)
     , ascii_val(ascii_val)
 {
 }
 
+Rectangle Mino::toAtlas(const Rectangle& from) const
+{
+    return {atlas_rect.x + from.x, atlas_rect.y + from.y, from.w, from.h};
+}
+
 void Mino::draw(int x, int y)
 {
-    assert(texture);
-    texture->drawScaled({x, y, texture_size_px, texture_size_px});
+    assert(atlas);
+    atlas->drawPartialScaled(atlas_rect, {x, y, texture_size_px, texture_size_px});
 }
 
 void Mino::drawPartial(const Rectangle& from, const Rectangle& to)
 {
-    assert(texture);
-    texture->drawPartialScaled(from, to);
+    assert(atlas);
+    atlas->drawPartialScaled(toAtlas(from), to);
+}
+
+void Mino::addSprite(std::vector<SpriteQuad>& batch, int x, int y) const
+{
+    batch.push_back({atlas_rect, {x, y, texture_size_px, texture_size_px}});
+}
+
+void Mino::addPartialSprite(std::vector<SpriteQuad>& batch, const Rectangle& from, const Rectangle& to) const
+{
+    batch.push_back({toAtlas(from), to});
 }
@@ -3,19 +3,27 @@
 #include "system/Texture.h"
 
 #include <memory>
+#include <vector>
 #include <stdint.h>
 
 
 /// A Mino represents one block of a piece.
 class Mino {
 public:
-    /// Create a mino with the texture and Ascii value
-    Mino(std::unique_ptr<Texture> texture, char ascii_val);
+    /// Create a mino from a part of a texture atlas, and its Ascii value
+    Mino(std::shared_ptr<Texture> atlas, const Rectangle& atlas_rect, char ascii_val);
 
     /// Draw the Mino at the provided coordinates
     void draw(int x, int y);
     /// Draw part of the Mino texture to the provided area
     void drawPartial(const Rectangle& from, const Rectangle& to);
+
+    /// Add the Mino at the provided coordinates to a sprite batch of its atlas,
+    /// to be drawn later with the other Minos (see `MinoStorage::drawSprites`)
+    void addSprite(std::vector<SpriteQuad>&, int x, int y) const;
+    /// Add part of the Mino to a sprite batch, like `drawPartial`
+    void addPartialSprite(std::vector<SpriteQuad>&, const Rectangle& from, const Rectangle& to) const;
+
     /// The Ascii value of the Mino, used mainly for debugging
     char asAscii() const { return ascii_val; }
 
@@ -23,6 +31,9 @@ public:
     static constexpr int8_t texture_size_px = 32;
 
 private:
-    const std::unique_ptr<Texture> texture;
+    const std::shared_ptr<Texture> atlas;
+    const Rectangle atlas_rect;
     const char ascii_val;
+
+    Rectangle toAtlas(const Rectangle& from) const;
 };
@@ -3,42 +3,50 @@
 #include "Mino.h"
 #include "game/AppContext.h"
 #include "system/GraphicsContext.h"
+#include "system/Texture.h"
 
 #include <assert.h>
 
 
-std::unordered_map<PieceType, std::shared_ptr<Mino>, PieceTypeHash> MinoStorage::minos;
-std::unordered_map<PieceType, std::shared_ptr<Mino>, PieceTypeHash> MinoStorage::ghosts;
-std::shared_ptr<Mino> MinoStorage::matrixcell;
-
-#ifndef NDEBUG
-void MinoStorage::loadDummyMinos()
+void MinoStorage::load(AppContext& app)
 {
-    for (const auto& type : PieceTypeList) {
-        minos[type] = std::make_shared<Mino>(nullptr, ::toAscii(type));
-        ghosts[type] = std::make_shared<Mino>(nullptr, 'g');
-    }
-    minos[PieceType::GARBAGE] = std::make_shared<Mino>(nullptr, ::toAscii(PieceType::GARBAGE));
-    matrixcell.reset();
+    // the order of the atlas cells: the 8 minos, the 7 ghosts, then the matrix cell
+    atlas_images.clear();
+    if (app.theme().gameplay.custom_minos)
+        addCustomMinos(app);
+    else
+        addTintedMinos(app.theme().get_texture("mino.png"));
+    addGhosts(app.theme().get_texture("ghost.png"), app.theme().gameplay.tint_ghost);
+    addImage(app.theme().get_texture("matrix.png"), 0xFFFFFF_rgb);
+
+    atlas = app.gcx().loadAtlas(atlas_images, Mino::texture_size_px, Mino::texture_size_px);
+    atlas_images.clear();
+
+    int cell = 0;
+    const auto next_cell = [&cell]() -> Rectangle {
+        return {(cell++) * Mino::texture_size_px, 0, Mino::texture_size_px, Mino::texture_size_px};
+    };
+    minos[PieceType::GARBAGE] = std::make_shared<Mino>(atlas, next_cell(), ::toAscii(PieceType::GARBAGE));
+    for (const auto& type : PieceTypeList)
+        minos[type] = std::make_shared<Mino>(atlas, next_cell(), ::toAscii(type));
+    for (const auto& type : PieceTypeList)
+        ghosts[type] = std::make_shared<Mino>(atlas, next_cell(), 'g');
+    matrixcell = std::make_shared<Mino>(atlas, next_cell(), '.');
 }
-#endif
 
-void MinoStorage::loadMinos(AppContext& app)
+void MinoStorage::addImage(const std::string& path, const RGBColor& tint, const std::string& fallback_path)
 {
-    if (app.theme().gameplay.custom_minos)
-        loadCustomMinos(app);
-    else
-        loadTintedMinos(app.gcx(), app.theme().get_texture("mino.png"));
+    atlas_images.push_back({path, tint, fallback_path});
 }
 
-void MinoStorage::loadTintedMinos(GraphicsContext& gcx, const std::string& path)
+void MinoStorage::addTintedMinos(const std::string& path)
 {
-    minos[PieceType::GARBAGE] = std::make_shared<Mino>(gcx.loadTexture(path), ::toAscii(PieceType::GARBAGE));
+    addImage(path, 0xFFFFFF_rgb);
     for (const auto& type : PieceTypeList)
-        minos[type] = std::make_shared<Mino>(gcx.loadTexture(path, color(type)), ::toAscii(type));
+        addImage(path, color(type));
 }
 
-void MinoStorage::loadCustomMinos(AppContext& app)
+void MinoStorage::addCustomMinos(AppContext& app)
 {
     static const std::unordered_map<PieceType, const std::string, PieceTypeHash> suffixes = {
         { PieceType::I, "i" },
@@ -50,65 +58,47 @@ void MinoStorage::loadCustomMinos(AppContext& app)
         { PieceType::Z, "z" },
         { PieceType::GARBAGE, "garbage" },
     };
-    for (const auto& pair : suffixes) {
-        const PieceType type = pair.first;
-        try {
-            const std::string path = app.theme().get_texture("mino_" + pair.second + ".png");
-            minos[type] = std::make_shared<Mino>(app.gcx().loadTexture(path), ::toAscii(type));
-        }
-        catch (const std::runtime_error& err) {
-            // fallback to regular mino
-            minos[type] = std::make_shared<Mino>(app.gcx().loadTexture(
-                app.theme().get_texture("mino.png")), ::toAscii(type));
-        }
-    }
-}
-
-void MinoStorage::loadGhosts(AppContext& app)
-{
-    const auto path = app.theme().get_texture("ghost.png");
-
-    if (app.theme().gameplay.tint_ghost)
-        loadTintedGhosts(app.gcx(), path);
-    else
-        loadSimpleGhosts(app.gcx(), path);
-}
-
-void MinoStorage::loadTintedGhosts(GraphicsContext& gcx, const std::string& path)
-{
+    // fallback to regular mino
+    const std::string fallback_path = app.theme().get_texture("mino.png");
+    const auto add_custom = [&](PieceType type) {
+        addImage(app.theme().get_texture("mino_" + suffixes.at(type) + ".png"), 0xFFFFFF_rgb, fallback_path);
+    };
+    add_custom(PieceType::GARBAGE);
     for (const auto& type : PieceTypeList)
-        ghosts[type] = std::make_shared<Mino>(gcx.loadTexture(path, color(type)), 'g');
+        add_custom(type);
 }
 
-void MinoStorage::loadSimpleGhosts(GraphicsContext& gcx, const std::string& path)
+void MinoStorage::addGhosts(const std::string& path, bool tinted)
 {
     for (const auto& type : PieceTypeList)
-        ghosts[type] = std::make_shared<Mino>(gcx.loadTexture(path), 'g');
+        addImage(path, tinted ? color(type) : 0xFFFFFF_rgb);
 }
 
-void MinoStorage::loadMatrixCell(GraphicsContext& gcx, const std::string& path)
-{
-    matrixcell = std::make_shared<Mino>(gcx.loadTexture(path), '.');
-}
-
-std::shared_ptr<Mino> MinoStorage::getMino(PieceType type)
+std::shared_ptr<Mino> MinoStorage::getMino(PieceType type) const
 {
     assert(minos.count(type));
     return minos.at(type);
 }
 
-std::shared_ptr<Mino> MinoStorage::getGhost(PieceType type)
+std::shared_ptr<Mino> MinoStorage::getGhost(PieceType type) const
 {
     assert(ghosts.count(type));
     return ghosts.at(type);
 }
 
-std::shared_ptr<Mino> MinoStorage::getMatrixCell()
+std::shared_ptr<Mino> MinoStorage::getMatrixCell() const
 {
     assert(matrixcell);
     return matrixcell;
 }
 
+void MinoStorage::drawSprites(std::vector<SpriteQuad>& batch) const
+{
+    assert(atlas);
+    atlas->drawSprites(batch);
+    batch.clear();
+}
+
 RGBColor MinoStorage::color(PieceType type)
 {
     static const std::unordered_map<PieceType, RGBColor, PieceTypeHash> map = {
@@ -2,37 +2,49 @@
 
 #include "PieceType.h"
 #include "system/Color.h"
+#include "system/GraphicsContext.h"
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 class AppContext;
-class GraphicsContext;
 class Mino;
+class Texture;
+struct SpriteQuad;
 
 
+/// The mino textures of the current theme. Owned by the AppContext,
+/// and passed to everything that draws pieces.
+///
+/// All textures are loaded into one atlas, so any number of Minos
+/// can be drawn together, with a single sprite batch.
 class MinoStorage {
 public:
-    static void loadMinos(AppContext&);
-    static void loadGhosts(AppContext&);
-    static void loadMatrixCell(GraphicsContext&, const std::string&);
+    /// Load the minos, ghosts and the matrix cell of the current theme
+    void load(AppContext&);
 
-    static std::shared_ptr<Mino> getMino(PieceType);
-    static std::shared_ptr<Mino> getGhost(PieceType);
-    static std::shared_ptr<Mino> getMatrixCell();
+    std::shared_ptr<Mino> getMino(PieceType) const;
+    std::shared_ptr<Mino> getGhost(PieceType) const;
+    std::shared_ptr<Mino> getMatrixCell() const;
 
-    static RGBColor color(PieceType);
+    /// Draw the sprites of the Minos added to the batch, then clear it
+    void drawSprites(std::vector<SpriteQuad>&) const;
 
-#ifndef NDEBUG
-    static void loadDummyMinos();
-#endif
+    static RGBColor color(PieceType);
 
 private:
-    static void loadTintedMinos(GraphicsContext&, const std::string&);
-    static void loadCustomMinos(AppContext&);
-    static void loadTintedGhosts(GraphicsContext&, const std::string&);
-    static void loadSimpleGhosts(GraphicsContext&, const std::string&);
-    static std::unordered_map<PieceType, std::shared_ptr<Mino>, PieceTypeHash> minos;
-    static std::unordered_map<PieceType, std::shared_ptr<Mino>, PieceTypeHash> ghosts;
-    static std::shared_ptr<Mino> matrixcell;
+    void addTintedMinos(const std::string&);
+    void addCustomMinos(AppContext&);
+    void addGhosts(const std::string&, bool tinted);
+    void addImage(const std::string& path, const RGBColor& tint,
+                  const std::string& fallback_path = std::string());
+
+    // the images of the atlas, in load order
+    std::vector<GraphicsContext::AtlasImage> atlas_images;
+    std::shared_ptr<Texture> atlas;
+
+    std::unordered_map<PieceType, std::shared_ptr<Mino>, PieceTypeHash> minos;
+    std::unordered_map<PieceType, std::shared_ptr<Mino>, PieceTypeHash> ghosts;
+    std::shared_ptr<Mino> matrixcell;
 };
@@ -1,40 +1,48 @@
 #pragma once
 
+#include "Piece.h"
+#include "PieceQueue.h"
 #include "PieceType.h"
 #include "system/Color.h"
+#include "system/Texture.h"
 
-#include <deque>
+#include <array>
 #include <memory>
+#include <vector>
 
 
 class GraphicsContext;
-class Piece;
+class MinoStorage;
 
 /// Produces the next piece randomly, and allows to preview
-/// the next N pieces.
+/// the next N pieces. The order of the pieces only depends on the seed.
 class NextQueue {
 public:
     /// Create a piece queue and allow previewing the next N pieces.
-    NextQueue(unsigned displayed_piece_count = 1);
-    ~NextQueue();
+    NextQueue(unsigned displayed_piece_count = 1, uint64_t seed = 0);
 
     /// Pop the top of the queue.
     PieceType next();
     void setPreviewCount(unsigned);
+    unsigned previewCount() const { return displayed_piece_count; }
+    /// Restart the queue with a new random seed. When there are multiple players,
+    /// they should use the same seed to get the same order of pieces.
+    void setRandomSeed(uint64_t);
+    /// The upcoming pieces
+    const PieceQueue& pieces() const { return piece_queue; }
+
+    PieceQueue::Snapshot snapshot() const { return piece_queue.snapshot(); }
+    void restore(const PieceQueue::Snapshot&);
 
     /// Draw the N previewable pieces at (x,y)
-    void draw(GraphicsContext&, int x, int y) const;
+    void draw(GraphicsContext&, const MinoStorage&, int x, int y) const;
 
 private:
-    static std::deque<PieceType> global_piece_queue;
-    std::deque<PieceType>::const_iterator global_queue_it;
-    std::deque<PieceType> piece_queue;
-    std::array<std::unique_ptr<Piece>, 7> piece_storage;
+    PieceQueue piece_queue;
+    std::array<Piece, 7> piece_storage;
     unsigned displayed_piece_count;
+    mutable std::vector<SpriteQuad> sprite_batch;
 
-    // When there are multiple players, we want to provide
-    // the same order of pieces for all of them.
-    void generate_global_pieces();
     void fill_queue();
-    void draw_nth_piece(unsigned i, int x, int y) const;
+    void draw_nth_piece(const MinoStorage&, unsigned i, int x, int y) const;
 };
@@ -1,7 +1,6 @@
 #include "Piece.h"
 
-#include "MinoStorage.h"
-
+#include <unordered_map>
 #include <assert.h>
 
 
@@ -34,18 +33,18 @@ uint8_t Piece::displayWidth(PieceType type) {
     return width_map.at(type);
 }
 
-Piece::Piece(PieceType type, const std::array<std::bitset<16>, 4>& gridbits)
-    : piece_type(type)
+Piece::Piece()
+    : shapes(nullptr)
+    , piece_type(PieceType::I)
+    , current_rotation(PieceDirection::NORTH)
+{}
+
+Piece::Piece(PieceType type, const PieceShapeTable& shapes)
+    : shapes(&shapes)
+    , piece_type(type)
     , current_rotation(PieceDirection::NORTH)
 {
-    // fill 4 frames of 4x4 grids
-    for (size_t frame = 0; frame < 4; frame++) {
-        for (size_t i = 0; i < 16; i++) {
-            if (gridbits[frame].test(15 - i)) {
-                grids[frame][i / 4][i % 4] = MinoStorage::getMino(type);
-            }
-        }
-    }
+    assert(type != PieceType::GARBAGE);
 }
 
 void Piece::rotateCCW()
@@ -59,24 +58,24 @@ void Piece::rotateCW()
     current_rotation = nextCW(current_rotation);
 }
 
-const PieceGrid& Piece::currentGrid() const
+const PieceShape& Piece::shape(PieceDirection direction) const
+{
+    assert(shapes);
+    return (*shapes)[static_cast<uint8_t>(piece_type)][static_cast<uint8_t>(direction)];
+}
+
+bool Piece::hasMinoAt(unsigned row, unsigned col) const
 {
-    return grids.at(static_cast<uint8_t>(current_rotation));
+    assert(row < 4 && col < 4);
+    return shape(current_rotation).grid_rows[row] & (1u << col);
 }
 
-PieceGrid& Piece::currentGridMut()
+const std::array<uint8_t, 4>& Piece::gridRows(PieceDirection direction) const
 {
-    return grids[static_cast<uint8_t>(current_rotation)];
+    return shape(direction).grid_rows;
 }
 
-void Piece::draw(int x, int y) const
+const std::array<int8_t, 4>& Piece::bottomProfile() const
 {
-    const auto& frame = currentGrid();
-    for (size_t row = 0; row < 4; row++) {
-        for (size_t col = 0; col < 4; col++) {
-            if (frame[row][col])
-                frame[row][col]->draw(x + col * Mino::texture_size_px,
-                                      y + row * Mino::texture_size_px);
-        }
-    }
+    return shape(current_rotation).bottom_profile;
 }
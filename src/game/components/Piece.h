@@ -1,21 +1,19 @@
 #pragma once
 
-#include "Mino.h"
+#include "PieceShape.h"
 #include "PieceType.h"
-#include "game/util/Matrix.h"
 
 #include <array>
-#include <bitset>
-#include <memory>
 #include <stdint.h>
 
 
-// 4x4 grid of nullable Minos
-typedef Matrix<std::shared_ptr<Mino>, 4, 4> PieceGrid;
-
 /// A Piece is a collection of Minos, that can be controlled as one.
 /// It can have specific rotation grids for all four states,
 /// and can change between them using rotateLeft/rotateRight.
+///
+/// The piece is a small value type: the shapes come from a static
+/// table of the rotation system, and the Minos are only looked up
+/// when the piece is drawn (see PieceRender.h).
 class Piece {
 public:
     static PieceType typeFromAscii(char);
@@ -23,23 +21,26 @@ public:
     PieceType type() const { return piece_type; }
     PieceDirection orientation() const { return current_rotation; }
 
-    /// Create a Piece of type, with the four rotations as bitflags
-    Piece(PieceType, const std::array<std::bitset<16>, 4>&);
+    /// Create an empty Piece, that has to be assigned before use
+    Piece();
+    /// Create a Piece of type, with the rotation grids of the shape table
+    Piece(PieceType, const PieceShapeTable&);
 
     /// Rotate the piece clockwise
     void rotateCW();
     /// Rotate the piece counter-clockwise
     void rotateCCW();
-    /// Read the rotation grid of the piece
-    const PieceGrid& currentGrid() const;
-    /// Returns the rotation grid, allowing modifications
-    PieceGrid& currentGridMut();
-
-    /// Draw the Piece
-    void draw(int x, int y) const;
+    /// Returns true if the current rotation grid has a mino at the position
+    bool hasMinoAt(unsigned row, unsigned col) const;
+    /// The rows of a rotation grid as bitmasks, where bit N is the Nth column
+    const std::array<uint8_t, 4>& gridRows(PieceDirection) const;
+    /// The lowest occupied row of the current rotation grid in every column, or -1 if the column is empty
+    const std::array<int8_t, 4>& bottomProfile() const;
 
 private:
-    const PieceType piece_type;
+    const PieceShapeTable* shapes;
+    PieceType piece_type;
     PieceDirection current_rotation;
-    std::array<PieceGrid, 4> grids;
+
+    const PieceShape& shape(PieceDirection) const;
 };
@@ -0,0 +1,78 @@
+#include "PieceQueue.h"
+
+#include "game/util/Hash.h"
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+
+
+PieceQueue::PieceQueue(uint64_t seed)
+    : rng(seed)
+    , piece_count(0)
+    , pieces{}
+{}
+
+void PieceQueue::setRandomSeed(uint64_t seed)
+{
+    rng.setSeed(seed);
+    piece_count = 0;
+}
+
+PieceType PieceQueue::next()
+{
+    fill(1);
+    const PieceType piece = pieces.front();
+    std::copy(pieces.cbegin() + 1, pieces.cbegin() + piece_count, pieces.begin());
+    piece_count--;
+    return piece;
+}
+
+void PieceQueue::fill(unsigned count)
+{
+    assert(count + PieceTypeList.size() - 1 <= capacity);
+    while (piece_count < count)
+        generateBag();
+}
+
+PieceType PieceQueue::peek(unsigned index) const
+{
+    assert(index < piece_count);
+    return pieces[index];
+}
+
+PieceQueue::Snapshot PieceQueue::snapshot() const
+{
+    Snapshot saved;
+    saved.rng = rng.snapshot();
+    saved.size = piece_count;
+    saved.pieces = pieces;
+    return saved;
+}
+
+void PieceQueue::restore(const Snapshot& saved)
+{
+    assert(saved.size <= Snapshot::max_size);
+
+    rng.restore(saved.rng);
+    piece_count = saved.size;
+    pieces = saved.pieces;
+}
+
+uint64_t PieceQueue::stateHash() const
+{
+    uint64_t hash = Hash::combine(rng.snapshot(), piece_count);
+    for (unsigned i = 0; i < piece_count; i++)
+        hash = Hash::combine(hash, static_cast<uint8_t>(pieces[i]));
+    return hash;
+}
+
+void PieceQueue::generateBag()
+{
+    assert(piece_count + PieceTypeList.size() <= capacity);
+
+    auto bag_begin = pieces.begin() + piece_count;
+    std::copy(PieceTypeList.cbegin(), PieceTypeList.cend(), bag_begin);
+    rng.shuffle(bag_begin, bag_begin + PieceTypeList.size());
+    piece_count += PieceTypeList.size();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "PieceType.h"
+#include "game/util/Random.h"
+
+#include <array>
+#include <type_traits>
+#include <stdint.h>
+
+
+/// An endless sequence of pieces, generated as shuffled bags of every piece type.
+/// The order only depends on the seed, so players with the same seed get the same pieces.
+/// The pieces are stored inline, so the queue can be copied without allocations.
+class PieceQueue {
+public:
+    /// The number of pieces that can be stored; up to three bags,
+    /// which is enough when at most 15 pieces are previewed
+    static constexpr unsigned capacity = 3 * PieceTypeList.size();
+
+    explicit PieceQueue(uint64_t seed = 0);
+
+    /// Restart the sequence with a new random seed
+    void setRandomSeed(uint64_t);
+
+    /// Pop the top of the queue
+    PieceType next();
+    /// Make sure at least `count` upcoming pieces are available for previewing
+    void fill(unsigned count);
+    /// The number of pieces available for previewing
+    unsigned size() const { return piece_count; }
+    /// The Nth upcoming piece, where 0 is the next one; it must be already generated
+    PieceType peek(unsigned index) const;
+
+    /// The state of the queue
+    struct Snapshot {
+        static constexpr unsigned max_size = capacity;
+
+        uint64_t rng;
+        uint8_t size;
+        std::array<PieceType, max_size> pieces;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot&);
+    /// A hash of the state, see `Well::stateHash()`
+    uint64_t stateHash() const;
+
+private:
+    Random rng;
+    uint8_t piece_count;
+    std::array<PieceType, capacity> pieces;
+
+    void generateBag();
+};
+
+static_assert(std::is_trivially_copyable<PieceQueue::Snapshot>::value, "PieceQueue snapshots must be plain data");
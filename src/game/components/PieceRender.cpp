@@ -0,0 +1,27 @@
+#include "PieceRender.h"
+
+#include "Mino.h"
+#include "MinoStorage.h"
+#include "Piece.h"
+
+
+void drawPiece(const MinoStorage& minos, const Piece& piece, int x, int y)
+{
+    std::vector<SpriteQuad> batch;
+    batch.reserve(4);
+    addPieceSprites(batch, minos, piece, x, y);
+    minos.drawSprites(batch);
+}
+
+void addPieceSprites(std::vector<SpriteQuad>& batch, const MinoStorage& minos, const Piece& piece, int x, int y)
+{
+    const auto mino = minos.getMino(piece.type());
+    for (unsigned row = 0; row < 4; row++) {
+        for (unsigned col = 0; col < 4; col++) {
+            if (piece.hasMinoAt(row, col))
+                mino->addSprite(batch,
+                                x + col * Mino::texture_size_px,
+                                y + row * Mino::texture_size_px);
+        }
+    }
+}
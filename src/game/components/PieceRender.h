@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+
+class MinoStorage;
+class Piece;
+struct SpriteQuad;
+
+/// Draw the Minos of the piece's current rotation, with the top left corner of its grid at (x,y)
+void drawPiece(const MinoStorage&, const Piece&, int x, int y);
+/// Add the Minos of the piece to a sprite batch, instead of drawing them immediately
+void addPieceSprites(std::vector<SpriteQuad>&, const MinoStorage&, const Piece&, int x, int y);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+
+
+/// The occupied cells of a piece's 4x4 grid in one rotation state
+struct PieceShape {
+    /// The rows of the grid as bitmasks, where bit N is the Nth column
+    std::array<uint8_t, 4> grid_rows;
+    /// The lowest occupied row in every column, or -1 if the column is empty
+    std::array<int8_t, 4> bottom_profile;
+};
+
+/// The shapes of every piece type (I to Z) in all four rotation states
+using PieceShapeTable = std::array<std::array<PieceShape, 4>, 7>;
+
+
+namespace PieceShapeDetail {
+constexpr uint8_t gridRow(uint16_t grid, unsigned row) {
+    uint8_t output = 0;
+    for (unsigned col = 0; col < 4; col++) {
+        if (grid & (1u << (15 - row * 4 - col)))
+            output |= (1u << col);
+    }
+    return output;
+}
+constexpr int8_t bottomRow(uint16_t grid, unsigned col) {
+    int8_t output = -1;
+    for (unsigned row = 0; row < 4; row++) {
+        if (grid & (1u << (15 - row * 4 - col)))
+            output = row;
+    }
+    return output;
+}
+} // namespace PieceShapeDetail
+
+/// Create the shape of a 4x4 grid at compile time, where the highest bit
+/// is the top left cell, and the rows follow each other (AAAABBBBCCCCDDDD)
+constexpr PieceShape makePieceShape(uint16_t grid) {
+    using namespace PieceShapeDetail;
+    return {
+        {{gridRow(grid, 0), gridRow(grid, 1), gridRow(grid, 2), gridRow(grid, 3)}},
+        {{bottomRow(grid, 0), bottomRow(grid, 1), bottomRow(grid, 2), bottomRow(grid, 3)}},
+    };
+}
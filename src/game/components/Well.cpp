@@ -1,30 +1,29 @@
 #include "Well.h"
 
-#include "MinoStorage.h"
 #include "Piece.h"
-#include "PieceFactory.h"
-#include "animations/CellLockAnim.h"
-#include "animations/HalfHeightLineClearAnim.h"
-#include "animations/LineClearAnim.h"
 #include "rotations/RotationFactory.h"
 #include "game/Timing.h"
 #include "game/WellConfig.h"
 #include "game/WellEvent.h"
+#include "game/util/Hash.h"
 
 #include <algorithm>
-#include <cstdlib>
 #include <assert.h>
 
 
-Well::Well() : Well(WellConfig()) {}
+template <unsigned Width, unsigned Height>
+BasicWell<Width, Height>::BasicWell() : BasicWell(WellConfig()) {}
 
-Well::Well(const WellConfig& config)
+template <unsigned Width, unsigned Height>
+BasicWell<Width, Height>::BasicWell(const WellConfig& config)
     : gameover(false)
     , temporal_disable_timer(Duration::zero())
     , active_piece_x(0)
     , active_piece_y(0)
     , ghost_piece_y(0)
+    , has_active_piece(false)
     , softdrop_timer(Duration::zero())
+    , pending_cleared_rows(0)
     , last_lineclear_type(LineClearType::NORMAL)
     , das(Timing::frame_duration_60Hz * config.shift_normal,
           Timing::frame_duration_60Hz * config.shift_turbo)
@@ -36,24 +35,17 @@ Well::Well(const WellConfig& config)
     rotation_fn = RotationFactory::make(config.rotation_style);
 }
 
-Well::~Well() = default;
+template <unsigned Width, unsigned Height>
+BasicWell<Width, Height>::~BasicWell() = default;
 
-void Well::updateKeystateOnly(const std::vector<InputEvent>& events)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::updateKeystateOnly(const std::vector<InputEvent>& events)
 {
     input.updateKeystate(events);
 }
 
-void Well::updateAnimationsOnly()
-{
-    for (auto& anim : animations)
-        anim->update(Timing::frame_duration);
-
-    animations.remove_if([](std::unique_ptr<WellAnimation>& animptr){
-        return !animptr->isActive();
-    });
-}
-
-void Well::updateGameplayOnly(const std::vector<InputEvent>& events)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::updateGameplayOnly(const std::vector<InputEvent>& events)
 {
     if (gameover)
         return;
@@ -63,42 +55,41 @@ void Well::updateGameplayOnly(const std::vector<InputEvent>& events)
         return;
     }
 
-    if (pending_cleared_rows.size())
+    if (pending_cleared_rows)
         this->removeEmptyRows();
 
-    if (!active_piece)
+    if (!has_active_piece)
         this->notify(WellEvent(WellEvent::Type::NEXT_REQUESTED));
 
     if (!lock_delay.lockInProgress())
         tspin.clear();
 
     input.handleKeys(*this, events);
-    if (!active_piece)
+    if (!has_active_piece)
         return;
 
     gravity.update(*this);
     lock_delay.update(*this);
 }
 
-#ifndef NDEBUG
-void Well::update(const std::vector<InputEvent>& events)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::update(const std::vector<InputEvent>& events)
 {
     updateKeystateOnly(events);
-    updateAnimationsOnly();
     updateGameplayOnly(events);
 }
-#endif
 
-void Well::addPiece(PieceType type)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::addPiece(PieceType type)
 {
     // the player can only control one piece at a time
-    assert(!active_piece);
+    assert(!has_active_piece);
 
-    active_piece = PieceFactory::make_uptr(type);
-    active_piece_x = 3;
+    createActivePiece(type);
+    active_piece_x = (width - 4) / 2;
 
-    // try to place the piece in row 20, then move up if it fails
-    for (active_piece_y = 20; active_piece_y >= 18; active_piece_y--) {
+    // try to place the piece in the first visible row, then move up if it fails
+    for (active_piece_y = hidden_height; active_piece_y >= hidden_height - 2; active_piece_y--) {
         if (!hasCollisionAt(active_piece_x, active_piece_y)) {
             calculateGhostOffset();
             lock_delay.cancel();
@@ -112,90 +103,91 @@ void Well::addPiece(PieceType type)
     notify(WellEvent(WellEvent::Type::GAME_OVER));
 }
 
-void Well::deletePiece()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::createActivePiece(PieceType type)
 {
-    active_piece.reset();
+    active_piece = Piece(type, rotation_fn->pieceShapes());
+    has_active_piece = true;
+    for (const auto direction : {PieceDirection::NORTH, PieceDirection::EAST,
+                                 PieceDirection::SOUTH, PieceDirection::WEST}) {
+        active_piece_masks[static_cast<uint8_t>(direction)]
+            = Board::makePieceMasks(active_piece.gridRows(direction));
+    }
 }
 
-void Well::addGarbageLines(unsigned short line_count)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::deletePiece()
+{
+    has_active_piece = false;
+}
+
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::addGarbageLines(unsigned short line_count)
 {
     if (!line_count)
         return;
 
-    std::rotate(matrix.begin(), matrix.begin() + line_count, matrix.end());
-
-    size_t gap_location = std::rand() % 10;
-    for (size_t row = matrix.size() - line_count; row < matrix.size(); row++) {
-        auto& mx_row = matrix.at(row);
-        for (size_t col = 0; col < mx_row.size(); col++)
-            mx_row.at(col) = MinoStorage::getMino(PieceType::GARBAGE);
-        mx_row.at(gap_location).reset();
-    }
+    board.addGarbageRows(line_count, garbage_rng.below(width));
 
-    if (active_piece)
+    if (has_active_piece)
         calculateGhostOffset();
 }
 
-void Well::setGravity(Duration duration)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::setGravity(Duration duration)
 {
     gravity.setRate(duration);
     softdrop_delay = gravity.currentDelay() / 20;
 }
 
-void Well::setRotationFn(std::unique_ptr<RotationFn>&& fn)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::setRotationFn(std::unique_ptr<RotationFn>&& fn)
 {
     rotation_fn.swap(fn);
 }
 
-bool Well::hasCollisionAt(int offset_x, unsigned offset_y) const
+template <unsigned Width, unsigned Height>
+bool BasicWell<Width, Height>::hasCollisionAt(int offset_x, unsigned offset_y) const
 {
-    // At least one line of the piece grid must be on the board.
-    // Horizontally, a piece can go between -3 and width+3,
-    // vertically from 0 to heigh+3 (it cannot be over the board)
-    if (offset_x + 3 < 0 || offset_x >= static_cast<int>(matrix.at(0).size()))
-        return true;
-
-    if (offset_y >= matrix.size())
-        return true;
-
-    assert(active_piece);
-
-    size_t piece_gridx = 0, piece_gridy = 0;
-    for (unsigned row = offset_y; row <= offset_y + 3; row++) {
-        for (int cell = offset_x; cell <= offset_x + 3; cell++) {
-            bool board_has_mino_here = true;
-            if (row < matrix.size() &&
-                cell >= 0 &&
-                cell < static_cast<int>(matrix.at(0).size()))
-                board_has_mino_here = matrix.at(row).at(cell).operator bool();
+    assert(has_active_piece);
 
-            bool piece_has_mino_here = active_piece->currentGrid()
-                                       .at(piece_gridy).at(piece_gridx).operator bool();
-
-            if (piece_has_mino_here && board_has_mino_here)
-                return true;
-
-            piece_gridx++;
-        }
-        piece_gridy++;
-        piece_gridx = 0;
-    }
-
-    return false;
+    const auto& masks = active_piece_masks[static_cast<uint8_t>(active_piece.orientation())];
+    return board.hasCollisionAt(masks, offset_x, offset_y);
 }
 
-void Well::calculateGhostOffset()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::calculateGhostOffset()
 {
-    assert(active_piece);
+    assert(has_active_piece);
+
+    // If the piece is above the surface in all of its columns,
+    // the landing row can be read from the column heights directly
+    const auto& profile = active_piece.bottomProfile();
+    int landing_y = height;
+    bool above_surface = true;
+    for (unsigned col = 0; col < profile.size() && above_surface; col++) {
+        if (profile[col] < 0)
+            continue;
 
+        const int highest_y = board.columnTop(active_piece_x + col) - 1 - profile[col];
+        above_surface = active_piece_y <= highest_y;
+        landing_y = std::min(landing_y, highest_y);
+    }
+    if (above_surface) {
+        ghost_piece_y = landing_y;
+        return;
+    }
+
+    // Otherwise the piece is under an overhang, step down row by row
     ghost_piece_y = active_piece_y;
-    while (ghost_piece_y + 1u < matrix.size() && !hasCollisionAt(active_piece_x, ghost_piece_y + 1))
+    while (ghost_piece_y + 1u < height && !hasCollisionAt(active_piece_x, ghost_piece_y + 1))
         ghost_piece_y++;
 }
 
-void Well::moveLeftNow()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::moveLeftNow()
 {
-    if (!active_piece || active_piece_x - 1 <= -3)
+    if (!has_active_piece || active_piece_x - 1 <= -3)
         return;
 
     if (!hasCollisionAt(active_piece_x - 1, active_piece_y)) {
@@ -206,9 +198,10 @@ void Well::moveLeftNow()
     }
 }
 
-void Well::moveRightNow()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::moveRightNow()
 {
-    if (!active_piece || active_piece_x + 1 >= static_cast<int>(matrix[0].size()))
+    if (!has_active_piece || active_piece_x + 1 >= static_cast<int>(width))
         return;
 
     if (!hasCollisionAt(active_piece_x + 1, active_piece_y)) {
@@ -219,17 +212,19 @@ void Well::moveRightNow()
     }
 }
 
-bool Well::isOnGround() const
+template <unsigned Width, unsigned Height>
+bool BasicWell<Width, Height>::isOnGround() const
 {
-    assert(active_piece);
-    assert(active_piece_y + 1u < matrix.size());
+    assert(has_active_piece);
+    assert(active_piece_y + 1u < height);
 
     return hasCollisionAt(active_piece_x, active_piece_y + 1);
 }
 
-void Well::moveDownNow()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::moveDownNow()
 {
-    if (!active_piece || active_piece_y + 1u >= matrix.size())
+    if (!has_active_piece || active_piece_y + 1u >= height)
         return;
 
     // This function does NOT lock (unless Sonic Drop is active),
@@ -243,9 +238,10 @@ void Well::moveDownNow()
         lockThenRequestNext(); // sonic drop manual lock
 }
 
-void Well::hardDrop()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::hardDrop()
 {
-    assert(active_piece);
+    assert(has_active_piece);
 
     WellEvent harddrop_event(WellEvent::Type::HARDDROPPED);
     harddrop_event.harddrop.count = ghost_piece_y - active_piece_y;
@@ -258,14 +254,15 @@ void Well::hardDrop()
     notify(harddrop_event);
 }
 
-bool Well::placeByWallKick(RotationDirection direction)
+template <unsigned Width, unsigned Height>
+bool BasicWell<Width, Height>::placeByWallKick(RotationDirection direction)
 {
-    assert(active_piece);
+    assert(has_active_piece);
 
     const bool clockwise = (direction == RotationDirection::CLOCKWISE);
-    const auto target_rot = active_piece->orientation();
+    const auto target_rot = active_piece.orientation();
     const auto starting_rot = clockwise ? prevCW(target_rot) : nextCW(target_rot);
-    const auto offsets = rotation_fn->possibleOffsets(active_piece->type(), starting_rot, clockwise);
+    const auto offsets = rotation_fn->possibleOffsets(active_piece.type(), starting_rot, clockwise);
 
     for (const auto& offset : offsets) {
         tspin.onWallKick();
@@ -280,24 +277,25 @@ bool Well::placeByWallKick(RotationDirection direction)
     return false;
 }
 
-void Well::rotateNow(RotationDirection direction)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::rotateNow(RotationDirection direction)
 {
-    if (!active_piece)
+    if (!has_active_piece)
         return;
 
     tspin.clear();
 
     if (direction == RotationDirection::CLOCKWISE)
-        active_piece->rotateCW();
+        active_piece.rotateCW();
     else
-        active_piece->rotateCCW();
+        active_piece.rotateCCW();
 
     if (hasCollisionAt(active_piece_x, active_piece_y)) {
         if (!placeByWallKick(direction)) {
             if (direction == RotationDirection::CLOCKWISE)
-                active_piece->rotateCCW();
+                active_piece.rotateCCW();
             else
-                active_piece->rotateCW();
+                active_piece.rotateCW();
             return;
         }
     }
@@ -309,13 +307,14 @@ void Well::rotateNow(RotationDirection direction)
     notify(WellEvent(WellEvent::Type::PIECE_ROTATED));
 }
 
-void Well::lockThenRequestNext()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::lockThenRequestNext()
 {
     auto tspin_type = tspin.check(*this);
     lockAndReleasePiece();
 
     // no line clear happened
-    if (pending_cleared_rows.empty()) {
+    if (!pending_cleared_rows) {
         switch(tspin_type) {
             case TSpinDetectionResult::TSPIN:
                 notify(WellEvent(WellEvent::Type::TSPIN_DETECTED));
@@ -332,11 +331,11 @@ void Well::lockThenRequestNext()
     else {
         switch(tspin_type) {
             case TSpinDetectionResult::TSPIN:
-                assert(pending_cleared_rows.size() < 4);
+                assert(countSetBits(pending_cleared_rows) < 4);
                 last_lineclear_type = LineClearType::TSPIN;
                 break;
             case TSpinDetectionResult::MINI_TSPIN:
-                assert(pending_cleared_rows.size() < 4);
+                assert(countSetBits(pending_cleared_rows) < 4);
                 last_lineclear_type = LineClearType::MINI_TSPIN;
                 break;
             default:
@@ -345,141 +344,201 @@ void Well::lockThenRequestNext()
         }
 
         WellEvent clear_anim_event(WellEvent::Type::LINE_CLEAR_ANIMATION_START);
-        clear_anim_event.lineclear.count = pending_cleared_rows.size();
+        clear_anim_event.lineclear.count = countSetBits(pending_cleared_rows);
         clear_anim_event.lineclear.type = last_lineclear_type;
+        clear_anim_event.lineclear.rows = pending_cleared_rows;
         notify(clear_anim_event);
     }
 }
 
 /// This function locks the active piece at its current location:
-/// moves the minos of the piece into the matrix, fires a PIECE_LOCKED event,
+/// moves the minos of the piece onto the board, fires a PIECE_LOCKED event,
 /// and checks if there are clearable lines
-void Well::lockAndReleasePiece()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::lockAndReleasePiece()
 {
-    assert(active_piece);
+    assert(has_active_piece);
     assert(isOnGround());
 
-    std::list<std::pair<unsigned, unsigned>> pending_anims;
+    WellEvent lock_event(WellEvent::Type::PIECE_LOCKED);
+    lock_event.piecelock.count = 0;
+    unsigned last_row = active_piece_y;
 
     for (unsigned row = 0; row < 4; row++) {
         for (unsigned cell = 0; cell < 4; cell++) {
-            if (active_piece_y + row >= matrix.size() ||
-                active_piece_x + cell >= matrix.at(0).size() ||
+            if (active_piece_y + row >= height ||
+                active_piece_x + cell >= width ||
                 active_piece_x + static_cast<int>(cell) < 0)
                 continue;
 
-            if (active_piece->currentGrid().at(row).at(cell)) {
-                matrix[active_piece_y + row][active_piece_x + cell].swap(
-                    active_piece->currentGridMut()[row][cell]
-                );
+            if (active_piece.hasMinoAt(row, cell)) {
+                board.setCell(active_piece_y + row, active_piece_x + cell, active_piece.type());
+                last_row = active_piece_y + row;
 
-                if (active_piece_y + row >= 20) {
-                    pending_anims.emplace_back(active_piece_y + row - 20,
-                                               active_piece_x + cell);
-                }
+                // a piece has 4 minos
+                assert(lock_event.piecelock.count < 4);
+                lock_event.piecelock.rows[lock_event.piecelock.count] = active_piece_y + row;
+                lock_event.piecelock.cols[lock_event.piecelock.count] = active_piece_x + cell;
+                lock_event.piecelock.count++;
             }
         }
     }
 
     deletePiece();
-    notify(WellEvent(WellEvent::Type::PIECE_LOCKED));
-
-    checkLineclear();
-    if (pending_cleared_rows.empty()) {
-        // To avoid graphical glitches (animations flying in the air),
-        // only add cell lock animation if there was no line clear event
-        for (const auto& coord : pending_anims)
-            animations.emplace_back(std::make_unique<CellLockAnim>(coord.first, coord.second));
-    }
+    notify(lock_event);
+
+    // only the rows of the locked piece could have become full
+    checkLineclear(active_piece_y, last_row);
 }
 
-/// This function checks if there are fully filled rows, puts them
-/// into pending_cleared_rows, and creates the line clear animations
-void Well::checkLineclear()
+/// This function checks if the rows of the just locked piece became full,
+/// and puts them into pending_cleared_rows
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::checkLineclear(unsigned first_row, unsigned last_row)
 {
-    assert(!active_piece);
+    assert(!has_active_piece);
 
-    for (unsigned row = 0; row < matrix.size(); row++) {
-        bool row_filled = true;
-        for (auto& cell : matrix[row]) {
-            if (!cell) {
-                row_filled = false;
-                break;
-            }
-        }
-
-        if (row_filled)
-            pending_cleared_rows.insert(row);
-    }
-
-    assert(pending_cleared_rows.size() <= 4); // you can clear only 4 rows at once
-    if (pending_cleared_rows.size()) {
-        for (auto row : pending_cleared_rows) {
-            for (auto& cell : matrix[row])
-                cell = nullptr;
+    pending_cleared_rows = board.fullRows(first_row, last_row);
+    if (!pending_cleared_rows)
+        return;
 
-            if (row >= 2)
-                animations.emplace_back(std::make_unique<LineClearAnim>(row));
-            else if (row == 1)
-                animations.emplace_back(std::make_unique<HalfHeightLineClearAnim>());
+    assert(countSetBits(pending_cleared_rows) <= 4); // you can clear only 4 rows at once
+    board.clearRows(pending_cleared_rows);
 
-            temporal_disable_timer = Timing::frame_duration_60Hz * 40; // TODO: make this configurable
-        }
-    }
+    temporal_disable_timer = Timing::frame_duration_60Hz * 40; // TODO: make this configurable
 }
 
 /// This function consumes the lines previously stored in pending_cleared_rows,
 /// and fires the LINE_CLEAR event
-void Well::removeEmptyRows()
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::removeEmptyRows()
 {
     // this function should be called if there are empty rows
-    assert(pending_cleared_rows.size());
-    assert(pending_cleared_rows.size() <= 4);
+    assert(pending_cleared_rows);
+    assert(countSetBits(pending_cleared_rows) <= 4);
 
     WellEvent clear_event(WellEvent::Type::LINE_CLEAR);
-    clear_event.lineclear.count = pending_cleared_rows.size();
+    clear_event.lineclear.count = countSetBits(pending_cleared_rows);
     clear_event.lineclear.type = last_lineclear_type;
+    clear_event.lineclear.rows = pending_cleared_rows;
     notify(clear_event);
 
-    for (int row = matrix.size(); row >= 0; row--) {
-        if (!pending_cleared_rows.count(row))
-            continue;
+    board.removeRows(pending_cleared_rows);
+    pending_cleared_rows = 0;
+}
 
-        int next_filled_row = row;
-        while (pending_cleared_rows.count(next_filled_row))
-            next_filled_row--;
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::notify(const WellEvent& event)
+{
+    for (const auto& obs : observers[static_cast<uint8_t>(event.type)])
+        obs(event);
+}
 
-        if (next_filled_row < 0)
-            break;
+template <unsigned Width, unsigned Height>
+typename BasicWell<Width, Height>::Snapshot BasicWell<Width, Height>::snapshot() const
+{
+    Snapshot saved;
+    saved.board = board;
+    saved.gameover = gameover;
+    saved.temporal_disable_timer = temporal_disable_timer;
+    saved.has_active_piece = has_active_piece;
+    saved.active_piece_type = active_piece.type();
+    saved.active_piece_orientation = active_piece.orientation();
+    saved.active_piece_x = active_piece_x;
+    saved.active_piece_y = active_piece_y;
+    saved.softdrop_timer = softdrop_timer;
+    saved.pending_cleared_rows = pending_cleared_rows;
+    saved.last_lineclear_type = last_lineclear_type;
+    saved.garbage_rng = garbage_rng.snapshot();
+    saved.das = das.snapshot();
+    saved.gravity = gravity.snapshot();
+    saved.input = input.snapshot();
+    saved.lock_delay = lock_delay.snapshot();
+    saved.tspin = tspin.snapshot();
+    return saved;
+}
 
-        matrix[row].swap(matrix[next_filled_row]);
-        pending_cleared_rows.insert(next_filled_row);
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::restore(const Snapshot& saved)
+{
+    board = saved.board;
+    gameover = saved.gameover;
+    temporal_disable_timer = saved.temporal_disable_timer;
+    softdrop_timer = saved.softdrop_timer;
+    pending_cleared_rows = saved.pending_cleared_rows;
+    last_lineclear_type = saved.last_lineclear_type;
+    garbage_rng.restore(saved.garbage_rng);
+    das.restore(saved.das);
+    gravity.restore(saved.gravity);
+    input.restore(saved.input);
+    lock_delay.restore(saved.lock_delay);
+    tspin.restore(saved.tspin);
+
+    // the softdrop speed depends on the gravity
+    setGravity(gravity.currentDelay());
+
+    has_active_piece = false;
+    if (saved.has_active_piece) {
+        createActivePiece(saved.active_piece_type);
+        while (active_piece.orientation() != saved.active_piece_orientation)
+            active_piece.rotateCW();
+        active_piece_x = saved.active_piece_x;
+        active_piece_y = saved.active_piece_y;
+        calculateGhostOffset();
     }
-
-    pending_cleared_rows.clear();
 }
 
-void Well::notify(const WellEvent& event)
+template <unsigned Width, unsigned Height>
+uint64_t BasicWell<Width, Height>::stateHash() const
 {
-    for (const auto& obs : observers[static_cast<uint8_t>(event.type)])
-        obs(event);
+    // the same fields as the snapshot, but the board has its own hash already
+    uint64_t hash = board.hash();
+    hash = Hash::combine(hash, gameover);
+    hash = Hash::combine(hash, temporal_disable_timer.count());
+    hash = Hash::combine(hash, has_active_piece);
+    if (has_active_piece) {
+        hash = Hash::combine(hash, static_cast<uint8_t>(active_piece.type()));
+        hash = Hash::combine(hash, static_cast<uint8_t>(active_piece.orientation()));
+        hash = Hash::combine(hash, static_cast<uint8_t>(active_piece_x));
+        hash = Hash::combine(hash, active_piece_y);
+    }
+    hash = Hash::combine(hash, softdrop_timer.count());
+    hash = Hash::combine(hash, pending_cleared_rows);
+    hash = Hash::combine(hash, static_cast<uint8_t>(last_lineclear_type));
+    hash = Hash::combine(hash, garbage_rng.snapshot());
+
+    hash = Hash::combine(hash, das.snapshot().das_timer.count());
+    const auto gravity_state = gravity.snapshot();
+    hash = Hash::combine(hash, gravity_state.gravity_delay.count());
+    hash = Hash::combine(hash, gravity_state.gravity_timer.count());
+    hash = Hash::combine(hash, gravity_state.skip_gravity);
+    const auto input_state = input.snapshot();
+    hash = Hash::combine(hash, input_state.keystates);
+    hash = Hash::combine(hash, input_state.previous_keystates);
+    const auto lock_delay_state = lock_delay.snapshot();
+    hash = Hash::combine(hash, lock_delay_state.reset_counter);
+    hash = Hash::combine(hash, lock_delay_state.current_lowest_row);
+    hash = Hash::combine(hash, lock_delay_state.countdown_elapsed.count());
+    hash = Hash::combine(hash, lock_delay_state.countdown_running);
+    const auto tspin_state = tspin.snapshot();
+    hash = Hash::combine(hash, tspin_state.allowed);
+    hash = Hash::combine(hash, tspin_state.last_rotation_point);
+    return hash;
 }
 
-#ifndef NDEBUG
-
-std::string Well::asAscii() const
+template <unsigned Width, unsigned Height>
+std::string BasicWell<Width, Height>::asAscii() const
 {
     return ascii.asAscii(*this);
 }
 
-void Well::fromAscii(const std::string& text)
+template <unsigned Width, unsigned Height>
+void BasicWell<Width, Height>::fromAscii(const std::string& text)
 {
     ascii.fromAscii(*this, text);
 }
 
-#endif
 
-void Well::drawContent(GraphicsContext& gcx, int x, int y) const
-{
-    renderer.drawContent(*this, gcx, x, y);
-}
+template class BasicWell<10, 40>;
+template class BasicWell<4, 40>;
+template class BasicWell<20, 40>;
@@ -1,50 +1,58 @@
 #pragma once
 
+#include "Piece.h"
 #include "game/WellEvent.h"
-#include "game/util/Matrix.h"
+#include "game/util/Random.h"
+#include "well/Ascii.h"
 #include "well/AutoRepeat.h"
+#include "well/Board.h"
 #include "well/Input.h"
 #include "well/Gravity.h"
 #include "well/LockDelay.h"
-#include "well/Render.h"
 #include "well/TSpin.h"
 
-#include <list>
+#include <array>
+#include <functional>
 #include <memory>
-#include <set>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 #include <stdint.h>
 
-#ifndef NDEBUG
-#include "well/Ascii.h"
-#include <string>
-#endif
-
 
-class AppContext;
-class GraphicsContext;
-class Mino;
-class Piece;
 class RotationFn;
-class WellAnimation;
 struct WellConfig;
+namespace WellComponents {
+    class Render;
+    template <unsigned Width, unsigned Height> class MoveGen;
+}
 enum class PieceType : uint8_t;
 
 
-class Well {
+/// The playfield of a player, `Width` columns wide and `Height` rows tall.
+/// The upper half of the rows is a hidden buffer zone, where the new pieces appear.
+/// The supported sizes are explicitly instantiated in Well.cpp, see the aliases below.
+template <unsigned Width, unsigned Height>
+class BasicWell {
 public:
+    static constexpr unsigned width = Width;
+    static constexpr unsigned height = Height;
+    static constexpr unsigned visible_height = Height / 2;
+    static constexpr unsigned hidden_height = Height - visible_height;
+
+    /// The locked minos of the well
+    using Board = WellComponents::Board<Width, Height>;
+
     /// Create a new well
-    Well();
-    Well(const WellConfig&);
-    ~Well();
+    BasicWell();
+    BasicWell(const WellConfig&);
+    ~BasicWell();
 
     /// Update the keystate of the well: Currently the system keystate
     /// is not directly accessible, so it is required to check the input
     /// events every frame. This function does not call any game logic.
     void updateKeystateOnly(const std::vector<InputEvent>&);
-    /// Update the active animations of the well
-    void updateAnimationsOnly();
     /// Update the game logic of the well
     void updateGameplayOnly(const std::vector<InputEvent>&);
 
@@ -56,30 +64,66 @@ public:
     /// Can return nullptr, eg. during animations.
     /// This function is only for reading the piece information.
     /// For actual input handling, call Well's update method.
-    const std::unique_ptr<Piece>& activePiece() const { return active_piece; }
+    const Piece* activePiece() const { return has_active_piece ? &active_piece : nullptr; }
+    /// The position of the active piece's grid; only valid if there's an active piece
+    int activePieceX() const { return active_piece_x; }
+    unsigned activePieceY() const { return active_piece_y; }
+    /// Returns the locked minos of the well, without the active piece.
+    const Board& lockedMinos() const { return board; }
 
     /// Add garbage lines to the bottom of the well.
     void addGarbageLines(unsigned short);
+    /// Set the seed of the random garbage gap positions
+    void setRandomSeed(uint64_t seed) { garbage_rng.setSeed(seed); }
 
     /// Set the gravity update rate
     void setGravity(Duration);
+    /// The time it takes for gravity to move the piece down by one row
+    Duration gravityDelay() const { return gravity.currentDelay(); }
     /// Set the rotation function
     void setRotationFn(std::unique_ptr<RotationFn>&&);
 
-    /// Draw the Minos in the Well
-    void drawContent(GraphicsContext&, int x, int y) const;
-
     /// Register an external event observer.
     template <typename WellObserver>
     void registerObserver(WellEvent::Type evtype, WellObserver&& obs) {
         observers[static_cast<uint8_t>(evtype)].push_back(std::forward<WellObserver>(obs));
     }
 
-#ifndef NDEBUG
+    /// The game state of the well, without its settings and observers.
+    /// Can be used to continue the game later, eg. when seeking in a replay.
+    /// It's plain data of a fixed size, so it can be copied with memcpy.
+    struct Snapshot {
+        Board board;
+        bool gameover;
+        Duration temporal_disable_timer;
+        bool has_active_piece;
+        PieceType active_piece_type;
+        PieceDirection active_piece_orientation;
+        int8_t active_piece_x;
+        uint8_t active_piece_y;
+        Duration softdrop_timer;
+        typename Board::RowSet pending_cleared_rows;
+        LineClearType last_lineclear_type;
+        uint64_t garbage_rng;
+
+        WellComponents::AutoRepeat::Snapshot das;
+        WellComponents::Gravity::Snapshot gravity;
+        WellComponents::Input::Snapshot input;
+        WellComponents::LockDelay::Snapshot lock_delay;
+        WellComponents::TSpin::Snapshot tspin;
+    };
+    Snapshot snapshot() const;
+    /// Continue the game from a saved state. The settings of the well
+    /// must be the same as when the state was saved.
+    void restore(const Snapshot&);
+    /// A hash of the game state, for checking that two games are still
+    /// in the same state (eg. replays or network matches). The board is
+    /// hashed incrementally, so the call is cheap even in every frame.
+    uint64_t stateHash() const;
+
     void update(const std::vector<InputEvent>&); ///< Update both the keystate and the game logic
     std::string asAscii() const;
     void fromAscii(const std::string&);
-#endif
 
 private:
     // true when gameover detected
@@ -87,20 +131,23 @@ private:
     // input is temporally disabled, eg, during blocking animations
     Duration temporal_disable_timer;
 
-    // the grid matrix
-    // TODO: set dimensions from config
-    Matrix<std::shared_ptr<Mino>, 40, 10> matrix;
+    // the locked minos
+    Board board;
 
     // the active piece
     int8_t active_piece_x;
     uint8_t active_piece_y;
     uint8_t ghost_piece_y;
-    std::unique_ptr<Piece> active_piece;
+    bool has_active_piece;
+    Piece active_piece;
+    std::array<typename Board::PieceMaskRow, 4> active_piece_masks;
 
     // softdrop timers
     Duration softdrop_delay;
     Duration softdrop_timer;
 
+    void createActivePiece(PieceType);
+
     // active piece movement
     enum class RotationDirection : uint8_t { CLOCKWISE, COUNTER_CLOCKWISE };
     void moveLeftNow();
@@ -119,28 +166,25 @@ private:
     void lockThenRequestNext();
 
     // line clears
-    void checkLineclear();
+    void checkLineclear(unsigned first_row, unsigned last_row);
     void removeEmptyRows();
-    std::set<uint8_t> pending_cleared_rows;
+    typename Board::RowSet pending_cleared_rows;
     LineClearType last_lineclear_type;
 
+    // garbage
+    Random garbage_rng;
+
     // listeners
     std::unordered_map<uint8_t, std::vector<std::function<void(const WellEvent&)>>> observers;
     void notify(const WellEvent&);
 
-    // animations
-    std::list<std::unique_ptr<WellAnimation>> animations;
-
     // components
     WellComponents::AutoRepeat das;
     WellComponents::Gravity gravity;
     WellComponents::Input input;
     WellComponents::LockDelay lock_delay;
-    WellComponents::Render renderer;
     WellComponents::TSpin tspin;
-#ifndef NDEBUG
     WellComponents::Ascii ascii;
-#endif
 
     // TODO: These are the classes that are still too much coupled to the Well
     friend class WellComponents::Gravity;
@@ -148,7 +192,24 @@ private:
     friend class WellComponents::LockDelay;
     friend class WellComponents::Render;
     friend class WellComponents::TSpin;
-#ifndef NDEBUG
     friend class WellComponents::Ascii;
-#endif
+    friend class WellComponents::MoveGen<Width, Height>;
 };
+
+template <unsigned Width, unsigned Height> constexpr unsigned BasicWell<Width, Height>::width;
+template <unsigned Width, unsigned Height> constexpr unsigned BasicWell<Width, Height>::height;
+template <unsigned Width, unsigned Height> constexpr unsigned BasicWell<Width, Height>::visible_height;
+template <unsigned Width, unsigned Height> constexpr unsigned BasicWell<Width, Height>::hidden_height;
+
+/// The standard, 10 columns wide well, with 20 visible rows
+using Well = BasicWell<10, 40>;
+/// A 4 columns wide well, eg. for combo training
+using NarrowWell = BasicWell<4, 40>;
+/// A 20 columns wide well, eg. for big mode
+using WideWell = BasicWell<20, 40>;
+
+static_assert(std::is_trivially_copyable<Well::Snapshot>::value, "Well snapshots must be plain data");
+
+extern template class BasicWell<10, 40>;
+extern template class BasicWell<4, 40>;
+extern template class BasicWell<20, 40>;
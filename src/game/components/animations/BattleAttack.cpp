@@ -1,16 +1,15 @@
 #include "BattleAttack.h"
 
 #include "game/components/Mino.h"
-#include "game/components/MinoStorage.h"
 
 #include <cmath>
+#include <assert.h>
 
 
-BattleAttackAnim::BattleAttackAnim(int start_x, int width, int center_y, int arc_y, std::function<void()>&& callback)
+BattleAttackAnim::BattleAttackAnim(std::shared_ptr<Mino> mino, int start_x, int width, int center_y, int arc_y)
     : arc_center_x(start_x + width / 2)
     , arc_center_y(center_y)
-    , arc_percent(std::chrono::seconds(1), [](double t){ return t; }, std::move(callback))
-    , mino(MinoStorage::getMino(PieceType::GARBAGE))
+    , mino(std::move(mino))
 {
     assert(width != 0);
     assert(center_y < arc_y);
@@ -24,15 +23,12 @@ BattleAttackAnim::BattleAttackAnim(int start_x, int width, int center_y, int arc
     arc_angle_end = std::atan2(dy, dx2);
     arc_angle_diff = arc_angle_end - arc_angle_start;
 
-    arc_x = std::cos(arc_angle_start);
-    arc_y = std::sin(arc_angle_start);
+    setProgress(0.0);
 }
 
-void BattleAttackAnim::update()
+void BattleAttackAnim::setProgress(double progress)
 {
-    arc_percent.update(Timing::frame_duration);
-
-    const double angle = arc_angle_start + arc_angle_diff * arc_percent.value();
+    const double angle = arc_angle_start + arc_angle_diff * progress;
 
     arc_x = arc_center_x + std::cos(angle) * arc_radius;
     arc_y = arc_center_y + std::sin(angle) * arc_radius;
@@ -1,7 +1,5 @@
 #pragma once
 
-#include "game/Transition.h"
-
 #include <memory>
 
 class Font;
@@ -9,22 +7,23 @@ class Mino;
 class Texture;
 
 
+/// The garbage of an attack, flying on an arc from the attacker to the target.
+/// The animation has no timer of its own; it's drawn at the progress of the
+/// attack, which is part of the game state.
 class BattleAttackAnim {
 public:
-    BattleAttackAnim(int start_x, int width, int center_y, int arc_y, std::function<void()>&& callback = []{});
+    BattleAttackAnim(std::shared_ptr<Mino>, int start_x, int width, int center_y, int arc_y);
 
-    void update();
+    /// Move the garbage to a point of the arc, from 0 (the start) to 1 (the end)
+    void setProgress(double);
     void draw() const;
 
-    bool isActive() const { return arc_percent.running(); }
-
 private:
     int arc_center_x, arc_center_y;
     int arc_radius;
     double arc_angle_start, arc_angle_end;
     double arc_angle_diff;
     double arc_x, arc_y;
-    Transition<double> arc_percent;
 
     std::shared_ptr<Mino> mino;
 };
@@ -4,14 +4,12 @@
 #include "system/GraphicsContext.h"
 
 
-HalfHeightLineClearAnim::HalfHeightLineClearAnim()
-    : LineClearAnim(19)
+HalfHeightLineClearAnim::HalfHeightLineClearAnim(unsigned well_width)
+    : LineClearAnim(-1, well_width)
 {}
 
 void HalfHeightLineClearAnim::draw(GraphicsContext& gcx, int x, int y) const
 {
-    // TODO: fix magic numbers
-    static const int row_width = Mino::texture_size_px * 10;
     gcx.drawFilledRect({
         x + static_cast<int>(row_percent.value() * row_width),
         y,
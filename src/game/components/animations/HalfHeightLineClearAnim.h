@@ -5,6 +5,6 @@
 
 class HalfHeightLineClearAnim : public LineClearAnim {
 public:
-    HalfHeightLineClearAnim();
+    HalfHeightLineClearAnim(unsigned well_width);
     void draw(GraphicsContext& gcx, int x, int y) const override;
 };
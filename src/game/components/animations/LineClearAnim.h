@@ -7,7 +7,8 @@
 
 class LineClearAnim : public WellAnimation {
 public:
-    LineClearAnim(unsigned row);
+    /// Create a line clear animation for the visible row of a well, `well_width` columns wide
+    LineClearAnim(int row, unsigned well_width);
     virtual ~LineClearAnim() {}
 
     void update(Duration t) override;
@@ -19,5 +20,6 @@ public:
 
 protected:
     const int row;
+    const int row_width;
     Transition<double> row_percent;
 };
@@ -8,8 +8,9 @@ namespace Rotations {
 class Classic : public RotationFn {
 public:
     Classic();
-    std::map<PieceType, std::array<std::bitset<16>, 4>> initialPositions() final;
-    std::vector<Offset> possibleOffsets(PieceType, PieceDirection, bool) final {
+    /// The shapes of the pieces, also usable without a rotation object
+    static const PieceShapeTable& shapes();
+    OffsetList possibleOffsets(PieceType, PieceDirection, bool) const final {
         return {};
     }
 };
@@ -1,12 +1,10 @@
 #pragma once
 
+#include "game/components/PieceShape.h"
 #include "game/components/PieceType.h"
 
-#include <array>
-#include <bitset>
-#include <map>
 #include <string>
-#include <vector>
+#include <stddef.h>
 
 
 namespace Rotations {
@@ -14,22 +12,47 @@ namespace Rotations {
         int x;
         int y;
     };
+
+    /// A non-owning view of a constant list of offsets,
+    /// usually pointing into the static kick tables of a rotation system
+    class OffsetList {
+    public:
+        constexpr OffsetList() : first(nullptr), last(nullptr) {}
+        constexpr OffsetList(const Offset* list, size_t count) : first(list), last(list + count) {}
+        template <size_t N>
+        constexpr OffsetList(const Offset (&list)[N]) : first(list), last(list + N) {}
+
+        constexpr const Offset* begin() const { return first; }
+        constexpr const Offset* end() const { return last; }
+        constexpr size_t size() const { return last - first; }
+        constexpr bool empty() const { return first == last; }
+
+    private:
+        const Offset* first;
+        const Offset* last;
+    };
 }
 
 class RotationFn {
 public:
-    RotationFn(const std::string& rotation_name) : rotation_name(rotation_name) {}
+    RotationFn(const std::string& rotation_name, const PieceShapeTable& piece_shapes)
+        : rotation_name(rotation_name)
+        , piece_shapes(piece_shapes)
+    {}
     virtual ~RotationFn() {}
 
     const std::string& rotationName() const { return rotation_name; };
 
-    virtual std::map<PieceType, std::array<std::bitset<16>, 4>> initialPositions() = 0;
+    /// The shapes of the pieces in this rotation system
+    const PieceShapeTable& pieceShapes() const { return piece_shapes; }
 
-    virtual std::vector<Rotations::Offset> possibleOffsets(PieceType, PieceDirection, bool) = 0;
-    std::vector<Rotations::Offset> operator() (PieceType p, PieceDirection from, bool cw) {
+    /// The wall kicks to try when the rotation failed, in order
+    virtual Rotations::OffsetList possibleOffsets(PieceType, PieceDirection, bool) const = 0;
+    Rotations::OffsetList operator() (PieceType p, PieceDirection from, bool cw) const {
         return possibleOffsets(p, from, cw);
     };
 
 protected:
     std::string rotation_name;
+    const PieceShapeTable& piece_shapes;
 };
@@ -2,137 +2,100 @@
 
 namespace Rotations {
 
+// the rotation states of the pieces, in the order of PieceType and PieceDirection
+//                     AAAABBBBCCCCDDDD
+constexpr PieceShapeTable shape_table = {{
+    {{makePieceShape(0b0000111100000000), // I
+      makePieceShape(0b0010001000100010),
+      makePieceShape(0b0000000011110000),
+      makePieceShape(0b0100010001000100)}},
+    {{makePieceShape(0b1000111000000000), // J
+      makePieceShape(0b0110010001000000),
+      makePieceShape(0b0000111000100000),
+      makePieceShape(0b0100010011000000)}},
+    {{makePieceShape(0b0010111000000000), // L
+      makePieceShape(0b0100010001100000),
+      makePieceShape(0b0000111010000000),
+      makePieceShape(0b1100010001000000)}},
+    {{makePieceShape(0b0110011000000000), // O
+      makePieceShape(0b0110011000000000),
+      makePieceShape(0b0110011000000000),
+      makePieceShape(0b0110011000000000)}},
+    {{makePieceShape(0b0110110000000000), // S
+      makePieceShape(0b0100011000100000),
+      makePieceShape(0b0000011011000000),
+      makePieceShape(0b1000110001000000)}},
+    {{makePieceShape(0b0100111000000000), // T
+      makePieceShape(0b0100011001000000),
+      makePieceShape(0b0000111001000000),
+      makePieceShape(0b0100110001000000)}},
+    {{makePieceShape(0b1100011000000000), // Z
+      makePieceShape(0b0010011001000000),
+      makePieceShape(0b0000110001100000),
+      makePieceShape(0b0100110010000000)}},
+}};
+
 SRS::SRS()
-    : RotationFn("SRS rotation system")
+    : RotationFn("SRS rotation system", shape_table)
 {}
 
-std::map<PieceType, std::array<std::bitset<16>, 4>> SRS::initialPositions()
+const PieceShapeTable& SRS::shapes()
 {
-    //                                    AAAABBBBCCCCDDDD
-    static const std::map<PieceType, std::array<std::bitset<16>, 4>> fields = {
-        {PieceType::I, {{std::bitset<16>("0000111100000000"),
-                         std::bitset<16>("0010001000100010"),
-                         std::bitset<16>("0000000011110000"),
-                         std::bitset<16>("0100010001000100")}}},
-        {PieceType::J, {{std::bitset<16>("1000111000000000"),
-                         std::bitset<16>("0110010001000000"),
-                         std::bitset<16>("0000111000100000"),
-                         std::bitset<16>("0100010011000000")}}},
-        {PieceType::L, {{std::bitset<16>("0010111000000000"),
-                         std::bitset<16>("0100010001100000"),
-                         std::bitset<16>("0000111010000000"),
-                         std::bitset<16>("1100010001000000")}}},
-        {PieceType::O, {{std::bitset<16>("0110011000000000"),
-                         std::bitset<16>("0110011000000000"),
-                         std::bitset<16>("0110011000000000"),
-                         std::bitset<16>("0110011000000000")}}},
-        {PieceType::S, {{std::bitset<16>("0110110000000000"),
-                         std::bitset<16>("0100011000100000"),
-                         std::bitset<16>("0000011011000000"),
-                         std::bitset<16>("1000110001000000")}}},
-        {PieceType::T, {{std::bitset<16>("0100111000000000"),
-                         std::bitset<16>("0100011001000000"),
-                         std::bitset<16>("0000111001000000"),
-                         std::bitset<16>("0100110001000000")}}},
-        {PieceType::Z, {{std::bitset<16>("1100011000000000"),
-                         std::bitset<16>("0010011001000000"),
-                         std::bitset<16>("0000110001100000"),
-                         std::bitset<16>("0100110010000000")}}},
-    };
-
-    return fields;
+    return shape_table;
 }
 
-std::vector<Rotations::Offset> SRS::possibleOffsets(PieceType piece, PieceDirection from, bool clockwise)
-{
-    std::vector<Rotations::Offset> output;
+// the kick tables are indexed by the starting direction, then by
+// the rotation direction (counter-clockwise first, then clockwise)
 
-    if (piece == PieceType::O)
-        return output;
+constexpr Offset i_kicks[4][2][4] = {
+    {{{-1,  0}, { 2,  0}, {-1, -2}, { 2,  1}},   // north
+     {{-2,  0}, { 1,  0}, {-2,  1}, { 1, -2}}},
+    {{{ 2,  0}, {-1,  0}, { 2, -1}, {-1,  2}},   // east
+     {{-1,  0}, { 2,  0}, {-1, -2}, { 2,  1}}},
+    {{{ 1,  0}, {-2,  0}, { 1,  2}, {-2, -1}},   // south
+     {{ 2,  0}, {-1,  0}, { 2, -1}, {-1,  2}}},
+    {{{-2,  0}, { 1,  0}, {-2,  1}, { 1, -2}},   // west
+     {{ 1,  0}, {-2,  0}, { 1,  2}, {-2, -1}}},
+};
 
-    if (piece == PieceType::I) {
-        switch (from) {
-            case PieceDirection::NORTH:
-            case PieceDirection::SOUTH:
-                if (clockwise) {
-                    output = {
-                        {-2,  0},
-                        { 1,  0},
-                        {-2,  1},
-                        { 1, -2},
-                    };
-                }
-                else {
-                    output = {
-                        {-1,  0},
-                        { 2,  0},
-                        {-1, -2},
-                        { 2,  1},
-                    };
-                }
-                break;
-            case PieceDirection::EAST:
-            case PieceDirection::WEST:
-                if (clockwise) {
-                    output = {
-                        {-1,  0},
-                        { 2,  0},
-                        {-1, -2},
-                        { 2,  1},
-                    };
-                }
-                else {
-                    output = {
-                        { 2,  0},
-                        {-1,  0},
-                        { 2, -1},
-                        {-1,  2},
-                    };
-                }
-                break;
-        }
-        // south mirrors north and west mirrors east on all coords
-        if (from == PieceDirection::SOUTH || from == PieceDirection::WEST) {
-            for (auto& item : output) {
-                item.x *= -1;
-                item.y *= -1;
-            }
-        }
+constexpr Offset jlsz_kicks[4][2][4] = {
+    {{{ 1,  0}, { 1, -1}, { 0,  2}, { 1,  2}},   // north
+     {{-1,  0}, {-1, -1}, { 0,  2}, {-1,  2}}},
+    {{{ 1,  0}, { 1,  1}, { 0, -2}, { 1, -2}},   // east
+     {{ 1,  0}, { 1,  1}, { 0, -2}, { 1, -2}}},
+    {{{-1,  0}, {-1, -1}, { 0,  2}, {-1,  2}},   // south
+     {{ 1,  0}, { 1, -1}, { 0,  2}, { 1,  2}}},
+    {{{-1,  0}, {-1,  1}, { 0, -2}, {-1, -2}},   // west
+     {{-1,  0}, {-1,  1}, { 0, -2}, {-1, -2}}},
+};
 
-        return output;
-    }
+// the T piece skips one of the kicks when starting from north or south
+constexpr Offset t_kicks[4][2][4] = {
+    {{{ 1,  0}, { 1, -1}, { 1,  2}},             // north
+     {{-1,  0}, {-1, -1}, {-1,  2}}},
+    {{{ 1,  0}, { 1,  1}, { 0, -2}, { 1, -2}},   // east
+     {{ 1,  0}, { 1,  1}, { 0, -2}, { 1, -2}}},
+    {{{-1,  0}, { 0,  2}, {-1,  2}},             // south
+     {{ 1,  0}, { 0,  2}, { 1,  2}}},
+    {{{-1,  0}, {-1,  1}, { 0, -2}, {-1, -2}},   // west
+     {{-1,  0}, {-1,  1}, { 0, -2}, {-1, -2}}},
+};
+constexpr size_t t_kick_counts[4] = {3, 4, 3, 4};
 
-    // not I or O pieces
+OffsetList SRS::possibleOffsets(PieceType piece, PieceDirection from, bool clockwise) const
+{
+    const auto dir = static_cast<size_t>(from);
 
-    int xpos = 0;
-    switch (from) {
-        case PieceDirection::NORTH:
-            xpos = clockwise ? -1 : 1;
-            output.push_back({xpos, 0});
-            output.push_back({xpos, -1});
-            if (piece != PieceType::T) output.push_back({0, 2});
-            output.push_back({xpos, 2});
-            break;
-        case PieceDirection::SOUTH:
-            xpos = clockwise ? 1 : -1;
-            output.push_back({xpos, 0});
-            if (piece != PieceType::T) output.push_back({xpos, -1});
-            output.push_back({0, 2});
-            output.push_back({xpos, 2});
-            break;
-        case PieceDirection::EAST:
-        case PieceDirection::WEST:
-            xpos = (from == PieceDirection::EAST) ? 1 : -1;
-            output = {
-                {xpos,  0},
-                {xpos,  1},
-                {   0, -2},
-                {xpos, -2},
-            };
-            break;
+    switch (piece) {
+        case PieceType::O:
+            return {};
+        case PieceType::I:
+            return i_kicks[dir][clockwise];
+        case PieceType::T:
+            return OffsetList(t_kicks[dir][clockwise], t_kick_counts[dir]);
+        default:
+            return jlsz_kicks[dir][clockwise];
     }
-
-    return output;
 }
 
 } // namespace Rotations
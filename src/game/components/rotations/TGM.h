@@ -9,8 +9,9 @@ class TGM : public RotationFn {
 public:
     TGM();
 
-    std::map<PieceType, std::array<std::bitset<16>, 4>> initialPositions() final;
-    std::vector<Rotations::Offset> possibleOffsets(PieceType, PieceDirection, bool) final;
+    /// The shapes of the pieces, also usable without a rotation object
+    static const PieceShapeTable& shapes();
+    OffsetList possibleOffsets(PieceType, PieceDirection, bool) const final;
 };
 
 } // namespace Rotations
@@ -1,6 +1,5 @@
 #include "Ascii.h"
 
-#include "game/components/MinoStorage.h"
 #include "game/components/Piece.h"
 #include "game/components/Well.h"
 
@@ -9,17 +8,20 @@
 
 namespace WellComponents {
 
-void Ascii::fromAscii(Well& well, const std::string& text)
+template <unsigned Width, unsigned Height>
+void Ascii::fromAscii(BasicWell<Width, Height>& well, const std::string& text)
 {
-    assert(text.length() == 22 * (well.matrix[0].size() + 1));
+    // the visible area, and the two bottom rows of the buffer zone
+    constexpr unsigned first_row = BasicWell<Width, Height>::hidden_height - 2;
+    assert(text.length() == (Height - first_row) * (Width + 1));
 
     unsigned str_i = 0;
-    for (unsigned row = 18; row < well.matrix.size(); row++) {
-        for (unsigned cell = 0; cell < well.matrix[0].size(); cell++) {
+    for (unsigned row = first_row; row < Height; row++) {
+        for (unsigned cell = 0; cell < Width; cell++) {
             if (text.at(str_i) == '.')
-                well.matrix[row][cell].reset();
+                well.board.clearCell(row, cell);
             else
-                well.matrix[row][cell] = MinoStorage::getMino(Piece::typeFromAscii(text.at(str_i)));
+                well.board.setCell(row, cell, Piece::typeFromAscii(text.at(str_i)));
 
             str_i++;
         }
@@ -28,21 +30,24 @@ void Ascii::fromAscii(Well& well, const std::string& text)
     }
 }
 
-std::string Ascii::asAscii(const Well& well) const
+template <unsigned Width, unsigned Height>
+std::string Ascii::asAscii(const BasicWell<Width, Height>& well) const
 {
+    constexpr unsigned first_row = BasicWell<Width, Height>::hidden_height - 2;
+
     // the piece must be inside the grid, at least partially
     assert(0 <= well.active_piece_x + 3);
-    assert(well.active_piece_x < static_cast<int>(well.matrix[0].size()));
-    assert(well.active_piece_y < well.matrix.size());
+    assert(well.active_piece_x < static_cast<int>(Width));
+    assert(well.active_piece_y < Height);
 
     std::string board_layer;
     std::string piece_layer;
 
     // print board
-    for (size_t row = 18; row < well.matrix.size(); row++) {
-        for (size_t cell = 0; cell < well.matrix[0].size(); cell++) {
-            if (well.matrix[row][cell])
-                board_layer += well.matrix[row][cell]->asAscii();
+    for (size_t row = first_row; row < Height; row++) {
+        for (size_t cell = 0; cell < Width; cell++) {
+            if (well.board.isOccupied(row, cell))
+                board_layer += ::toAscii(well.board.cellType(row, cell));
             else
                 board_layer += '.';
         }
@@ -50,27 +55,23 @@ std::string Ascii::asAscii(const Well& well) const
     }
 
     // print piece layer
-    for (unsigned row = 18; row < well.matrix.size(); row++) {
-        for (unsigned cell = 0; cell < well.matrix[0].size(); cell++) {
+    for (unsigned row = first_row; row < Height; row++) {
+        for (unsigned cell = 0; cell < Width; cell++) {
             char appended_char = '.';
 
-            if (well.active_piece) {
+            if (well.has_active_piece) {
                 // if there may be some piece minos (real or ghost) in this column
                 if (well.active_piece_x <= static_cast<int>(cell)
                     && static_cast<int>(cell) <= well.active_piece_x + 3) {
                     // check ghost first - it should be under the real piece
                     if (well.ghost_piece_y <= row && row <= well.ghost_piece_y + 3u) {
-                        const auto& mino = well.active_piece->currentGrid().at(row - well.ghost_piece_y)
-                                                                           .at(cell - well.active_piece_x);
-                        if (mino)
+                        if (well.active_piece.hasMinoAt(row - well.ghost_piece_y, cell - well.active_piece_x))
                             appended_char = 'g';
                     }
                     // check piece - overwrite the ascii char even if it has a value
                     if (well.active_piece_y <= row && row <= well.active_piece_y + 3u) {
-                        const auto& mino = well.active_piece->currentGrid().at(row - well.active_piece_y)
-                                                                           .at(cell - well.active_piece_x);
-                        if (mino)
-                            appended_char = std::tolower(mino->asAscii());
+                        if (well.active_piece.hasMinoAt(row - well.active_piece_y, cell - well.active_piece_x))
+                            appended_char = std::tolower(toAscii(well.active_piece.type()));
                     }
                 }
             }
@@ -93,4 +94,11 @@ std::string Ascii::asAscii(const Well& well) const
     return output;
 }
 
+template void Ascii::fromAscii(Well&, const std::string&);
+template void Ascii::fromAscii(NarrowWell&, const std::string&);
+template void Ascii::fromAscii(WideWell&, const std::string&);
+template std::string Ascii::asAscii(const Well&) const;
+template std::string Ascii::asAscii(const NarrowWell&) const;
+template std::string Ascii::asAscii(const WideWell&) const;
+
 } // namespace WellComponents
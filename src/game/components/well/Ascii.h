@@ -3,7 +3,7 @@
 #include <string>
 
 
-class Well;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
@@ -12,9 +12,11 @@ class Ascii {
 public:
     /// Get the well's string representation.
     /// Can be useful for testing and debugging.
-    void fromAscii(Well&, const std::string& text);
+    template <unsigned Width, unsigned Height>
+    void fromAscii(BasicWell<Width, Height>&, const std::string& text);
     /// Set the contents of the well from an Ascii string.
-    std::string asAscii(const Well&) const;
+    template <unsigned Width, unsigned Height>
+    std::string asAscii(const BasicWell<Width, Height>&) const;
 };
 
 } // namespace WellComponents
@@ -40,4 +40,16 @@ void AutoRepeat::onDASMove()
     das_timer = autorepeat_delay;
 }
 
+AutoRepeat::Snapshot AutoRepeat::snapshot() const
+{
+    Snapshot saved;
+    saved.das_timer = das_timer;
+    return saved;
+}
+
+void AutoRepeat::restore(const Snapshot& saved)
+{
+    das_timer = saved.das_timer;
+}
+
 } // namespace WellComponents
@@ -3,7 +3,7 @@
 #include "game/Timing.h"
 
 
-class Well;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
@@ -22,6 +22,12 @@ public:
     bool movementAllowed();
     void onDASMove();
 
+    struct Snapshot {
+        Duration das_timer;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot&);
+
 private:
     const Duration time_to_activate;
     const Duration autorepeat_delay;
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "game/components/PieceType.h"
+#include "game/util/BitScan.h"
+#include "game/util/Hash.h"
+#include "game/util/Matrix.h"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <assert.h>
+#include <stdint.h>
+
+
+namespace WellComponents {
+
+/// The locked contents of a well of `Width` columns and `Height` rows.
+/// The occupancy of the cells is stored as one bitmask per row, so collision
+/// and line clear checks work on integers. The type of the locked minos
+/// is stored separately, as it is only required for rendering.
+///
+/// The row masks are padded with always-set wall bits on both sides, and
+/// there are always-full floor rows under the bottom of the well, so a 4x4
+/// piece grid can be tested against the board without any bounds checking.
+///
+/// The rows are accessed through a table of storage slots, so adding garbage
+/// and removing cleared rows only moves the slot indices, not the row contents.
+///
+/// The board also keeps a hash of its occupied cells, for checking that two
+/// games are still in the same state. Every row has its own hash, which
+/// depends on its position and contents, and the hash of the board is their
+/// XOR. Placing minos updates only the rows of the cells, and moving rows
+/// updates only the occupied rows, so the board is never hashed again fully.
+template <unsigned Width, unsigned Height>
+class Board {
+public:
+    static constexpr unsigned width = Width;
+    static constexpr unsigned height = Height;
+    /// A piece grid can hang out of the well by at most 3 columns or rows
+    static constexpr unsigned wall_width = 3;
+
+    using RowMask = typename std::conditional<(width + 2 * wall_width <= 16), uint16_t, uint32_t>::type;
+    static_assert(width + 2 * wall_width <= sizeof(RowMask) * 8, "The well is too wide for the row mask type");
+    static_assert(height < 0xFF, "The well is too high for the column height type");
+    static_assert(height <= 64, "The well is too high for the row set type");
+
+    /// A set of rows, where bit N is row N
+    using RowSet = uint64_t;
+
+    static constexpr RowMask full_row = (1u << width) - 1;
+
+    /// The rows of a 4x4 piece grid, shifted to a horizontal position
+    using PieceMask = std::array<RowMask, 4>;
+    /// The masks of a piece grid for every horizontal position,
+    /// from -wall_width to width - 1
+    using PieceMaskRow = std::array<PieceMask, width + wall_width>;
+    /// Create the masks for every position of a 4x4 piece grid,
+    /// where bit N of a grid row is the Nth column
+    static PieceMaskRow makePieceMasks(const std::array<uint8_t, 4>& grid_rows) {
+        PieceMaskRow output;
+        for (unsigned shift = 0; shift < output.size(); shift++) {
+            for (unsigned row = 0; row < 4; row++)
+                output[shift][row] = static_cast<RowMask>(grid_rows[row] << shift);
+        }
+        return output;
+    }
+
+    Board() {
+        clear();
+    }
+
+    /// Remove every mino from the board
+    void clear() {
+        for (unsigned row = 0; row < slots.size(); row++)
+            slots[row] = row;
+        std::fill(rows.begin(), rows.begin() + height, wall_mask);
+        std::fill(rows.begin() + height, rows.end(), static_cast<RowMask>(~0u));
+        for (auto& row : types)
+            row.fill(PieceType::GARBAGE);
+        column_tops.fill(height);
+        cells_hash = 0;
+    }
+
+    /// The hash of the occupied cells; boards with the same minos
+    /// at the same places have the same hash, regardless of their types
+    uint64_t hash() const { return cells_hash; }
+    /// Calculate the hash from scratch; always the same as `hash()`
+    uint64_t calculateHash() const {
+        return rowRangeHash(0, height);
+    }
+
+    /// The occupancy bitmask of the row (bit N is column N)
+    RowMask rowMask(unsigned row) const {
+        assert(row < height);
+        return (rows[slots[row]] >> wall_width) & full_row;
+    }
+    bool isRowFull(unsigned row) const {
+        assert(row < height);
+        return rows[slots[row]] == static_cast<RowMask>(~0u);
+    }
+    bool isOccupied(unsigned row, unsigned col) const {
+        assert(row < height && col < width);
+        return rows[slots[row]] & (1u << (col + wall_width));
+    }
+    /// The row of the topmost mino in the column, or `height` if the column is empty
+    unsigned columnTop(unsigned col) const {
+        assert(col < width);
+        return column_tops[col];
+    }
+    /// The piece type of the mino at the position; only valid for occupied cells
+    PieceType cellType(unsigned row, unsigned col) const {
+        assert(isOccupied(row, col));
+        return types[slots[row]][col];
+    }
+
+    /// Returns true if the piece mask placed at `top_row` overlaps with
+    /// the locked minos, the walls or the floor
+    bool hasCollision(const PieceMask& piece, unsigned top_row) const {
+        assert(top_row < height);
+        return (rows[slots[top_row]] & piece[0])
+             | (rows[slots[top_row + 1]] & piece[1])
+             | (rows[slots[top_row + 2]] & piece[2])
+             | (rows[slots[top_row + 3]] & piece[3]);
+    }
+
+    /// Returns true if a piece, with the masks of one of its rotations, collides
+    /// with the board at the position. Unlike `hasCollision`, the position
+    /// may be anywhere, even completely outside of the well.
+    bool hasCollisionAt(const PieceMaskRow& piece, int offset_x, unsigned offset_y) const {
+        // At least one line of the piece grid must be on the board.
+        // Horizontally, a piece can go between -3 and width+3,
+        // vertically from 0 to heigh+3 (it cannot be over the board)
+        if (offset_x + static_cast<int>(wall_width) < 0 || offset_x >= static_cast<int>(width))
+            return true;
+
+        if (offset_y >= height)
+            return true;
+
+        // the walls and the floor are part of the board masks
+        return hasCollision(piece[offset_x + wall_width], offset_y);
+    }
+
+    void setCell(unsigned row, unsigned col, PieceType type) {
+        assert(row < height && col < width);
+        const RowMask old_mask = rowMask(row);
+        rows[slots[row]] |= (1u << (col + wall_width));
+        types[slots[row]][col] = type;
+        cells_hash ^= rowHash(row, old_mask) ^ rowHash(row, rowMask(row));
+        column_tops[col] = std::min<uint8_t>(column_tops[col], row);
+    }
+    void clearCell(unsigned row, unsigned col) {
+        assert(row < height && col < width);
+        const RowMask old_mask = rowMask(row);
+        rows[slots[row]] &= ~(1u << (col + wall_width));
+        cells_hash ^= rowHash(row, old_mask) ^ rowHash(row, rowMask(row));
+        if (column_tops[col] == row)
+            column_tops[col] = findColumnTop(col, row + 1);
+    }
+
+    /// The full rows between `first_row` and `last_row` (inclusive)
+    RowSet fullRows(unsigned first_row, unsigned last_row) const {
+        assert(first_row <= last_row && last_row < height);
+        RowSet output = 0;
+        for (unsigned row = first_row; row <= last_row; row++) {
+            if (isRowFull(row))
+                output |= RowSet(1) << row;
+        }
+        return output;
+    }
+    /// Remove every mino from the rows, but keep the rows in place
+    void clearRows(RowSet cleared_rows) {
+        RowMask touched_cols = 0;
+        for (RowSet remaining = cleared_rows; remaining; remaining &= remaining - 1) {
+            const unsigned row = lowestSetBit(remaining);
+            assert(row < height);
+            touched_cols |= rowMask(row);
+            cells_hash ^= rowHash(row, rowMask(row));
+            rows[slots[row]] = wall_mask;
+        }
+
+        // only the columns with their topmost mino in a cleared row are searched again
+        for (; touched_cols; touched_cols &= touched_cols - 1) {
+            const unsigned col = lowestSetBit(touched_cols);
+            if (cleared_rows & (RowSet(1) << column_tops[col]))
+                column_tops[col] = findColumnTop(col, column_tops[col] + 1);
+        }
+    }
+
+    /// Remove the (already cleared) rows, and move the rows above them down
+    void removeRows(RowSet cleared_rows) {
+        if (!cleared_rows)
+            return;
+
+        // the rows may have been filled again since they were cleared (eg. by garbage)
+        RowSet occupied_rows = 0;
+        for (RowSet remaining = cleared_rows; remaining; remaining &= remaining - 1) {
+            const unsigned row = lowestSetBit(remaining);
+            assert(row < height);
+            if (rowMask(row))
+                occupied_rows |= RowSet(1) << row;
+        }
+        clearRows(occupied_rows);
+
+        // the remaining rows keep their slots, but move down,
+        // and the slots of the removed rows are reused at the top;
+        // only the occupied rows above a removed one change their hash
+        const unsigned top_row = topRow();
+        std::array<uint8_t, height> new_slots;
+        unsigned removed_count = 0;
+        unsigned kept_row = countSetBits(cleared_rows);
+        unsigned src_row = 0;
+        for (RowSet remaining = cleared_rows; remaining; remaining &= remaining - 1) {
+            const unsigned row = lowestSetBit(remaining);
+
+            const unsigned shift = kept_row - src_row;
+            for (unsigned moved_row = std::max(src_row, top_row); moved_row < row; moved_row++) {
+                const RowMask mask = rowMask(moved_row);
+                cells_hash ^= rowHash(moved_row, mask) ^ rowHash(moved_row + shift, mask);
+            }
+
+            std::copy(slots.cbegin() + src_row, slots.cbegin() + row, new_slots.begin() + kept_row);
+            kept_row += row - src_row;
+            src_row = row + 1;
+            new_slots[removed_count++] = slots[row];
+        }
+        std::copy(slots.cbegin() + src_row, slots.cbegin() + height, new_slots.begin() + kept_row);
+        std::copy(new_slots.cbegin(), new_slots.cend(), slots.begin());
+
+        // the columns move down by the number of removed rows under their top
+        for (auto& top : column_tops) {
+            if (top < height)
+                top += countSetBits(cleared_rows >> top);
+        }
+    }
+
+    /// Move every row up by `count`, and fill the bottom rows with garbage,
+    /// except for the column `gap_col`
+    void addGarbageRows(unsigned count, unsigned gap_col) {
+        assert(count <= height);
+        assert(gap_col < width);
+
+        // every occupied row moves, and the garbage rows are added below them
+        const unsigned moved_rows_begin = topRow();
+        cells_hash ^= rowRangeHash(moved_rows_begin, height);
+
+        // the top rows are pushed out, and their slots are reused at the bottom
+        std::rotate(slots.begin(), slots.begin() + count, slots.begin() + height);
+
+        const RowMask garbage_row = static_cast<RowMask>(~(1u << (gap_col + wall_width)));
+        for (unsigned row = height - count; row < height; row++) {
+            rows[slots[row]] = garbage_row;
+            types[slots[row]].fill(PieceType::GARBAGE);
+        }
+
+        cells_hash ^= rowRangeHash(moved_rows_begin - std::min(moved_rows_begin, count), height);
+
+        // the columns are raised by the garbage, except the empty gap column;
+        // the pushed out minos are not on the board anymore
+        for (unsigned col = 0; col < width; col++) {
+            auto& top = column_tops[col];
+            if (top == height)
+                top = (col == gap_col || count == 0) ? height : height - count;
+            else if (top >= count)
+                top -= count;
+            else
+                top = findColumnTop(col, 0);
+        }
+    }
+
+private:
+    static constexpr RowMask wall_mask = static_cast<RowMask>(~(full_row << wall_width));
+
+    /// The storage slot of every row, including the floor
+    std::array<uint8_t, height + wall_width> slots;
+    /// The row masks and cell types, indexed by slots
+    std::array<RowMask, height + wall_width> rows;
+    Matrix<PieceType, height, width> types;
+    std::array<uint8_t, width> column_tops;
+    uint64_t cells_hash;
+
+    /// The hash of a row with the occupancy mask; empty rows have no effect on the board hash
+    static uint64_t rowHash(unsigned row, RowMask mask) {
+        return mask ? Hash::mix((static_cast<uint64_t>(row + 1) << 32) | mask) : 0;
+    }
+    /// The hashes of the rows from `first_row` until `end_row` (exclusive), combined
+    uint64_t rowRangeHash(unsigned first_row, unsigned end_row) const {
+        uint64_t output = 0;
+        for (unsigned row = first_row; row < end_row; row++)
+            output ^= rowHash(row, rowMask(row));
+        return output;
+    }
+    /// The row of the topmost mino, or `height` if the board is empty
+    unsigned topRow() const {
+        return *std::min_element(column_tops.cbegin(), column_tops.cend());
+    }
+
+    /// The first occupied row of the column, starting the search at `first_row`
+    unsigned findColumnTop(unsigned col, unsigned first_row) const {
+        const RowMask col_bit = 1u << (col + wall_width);
+        unsigned row = first_row;
+        while (row < height && !(rows[slots[row]] & col_bit))
+            row++;
+        return row;
+    }
+};
+
+template <unsigned Width, unsigned Height> constexpr unsigned Board<Width, Height>::width;
+template <unsigned Width, unsigned Height> constexpr unsigned Board<Width, Height>::height;
+template <unsigned Width, unsigned Height> constexpr unsigned Board<Width, Height>::wall_width;
+template <unsigned Width, unsigned Height>
+constexpr typename Board<Width, Height>::RowMask Board<Width, Height>::full_row;
+template <unsigned Width, unsigned Height>
+constexpr typename Board<Width, Height>::RowMask Board<Width, Height>::wall_mask;
+
+} // namespace WellComponents
@@ -25,7 +25,24 @@ void Gravity::skipNextUpdate()
     skip_gravity = true;
 }
 
-void Gravity::update(Well& well)
+Gravity::Snapshot Gravity::snapshot() const
+{
+    Snapshot saved;
+    saved.gravity_delay = gravity_delay;
+    saved.gravity_timer = gravity_timer;
+    saved.skip_gravity = skip_gravity;
+    return saved;
+}
+
+void Gravity::restore(const Snapshot& saved)
+{
+    gravity_delay = saved.gravity_delay;
+    gravity_timer = saved.gravity_timer;
+    skip_gravity = saved.skip_gravity;
+}
+
+template <unsigned Width, unsigned Height>
+void Gravity::update(BasicWell<Width, Height>& well)
 {
     gravity_timer += Timing::frame_duration;
     while (gravity_timer >= gravity_delay) {
@@ -39,9 +56,14 @@ void Gravity::update(Well& well)
     skip_gravity = false;
 }
 
-void Gravity::applyGravity(Well& well)
+template <unsigned Width, unsigned Height>
+void Gravity::applyGravity(BasicWell<Width, Height>& well)
 {
     well.moveDownNow();
 }
 
+template void Gravity::update(Well&);
+template void Gravity::update(NarrowWell&);
+template void Gravity::update(WideWell&);
+
 } // namespace WellComponents
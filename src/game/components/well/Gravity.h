@@ -3,7 +3,7 @@
 #include "game/Timing.h"
 
 
-class Well;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
@@ -14,11 +14,20 @@ public:
 
     void setRate(Duration);
     /// Updates the gravity timer, and calls applyGravity() if needed
-    void update(Well&);
+    template <unsigned Width, unsigned Height>
+    void update(BasicWell<Width, Height>&);
     /// Do not apply gravity during the next update() call
     void skipNextUpdate();
 
-    Duration currentDelay() { return gravity_delay; }
+    Duration currentDelay() const { return gravity_delay; }
+
+    struct Snapshot {
+        Duration gravity_delay;
+        Duration gravity_timer;
+        bool skip_gravity;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot&);
 
 private:
     Duration gravity_delay;
@@ -26,7 +35,8 @@ private:
     bool skip_gravity;
 
     /// Asks the well to move the active piece one row down
-    void applyGravity(Well&);
+    template <unsigned Width, unsigned Height>
+    void applyGravity(BasicWell<Width, Height>&);
 };
 
 } // namespace WellComponents
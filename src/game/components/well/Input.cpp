@@ -6,24 +6,31 @@
 namespace WellComponents {
 
 Input::Input()
+    : keystates(0)
+    , previous_keystates(0)
+{}
+
+void Input::restore(const Snapshot& saved)
 {
-    keystates[InputType::GAME_MOVE_LEFT] = false;
-    keystates[InputType::GAME_MOVE_RIGHT] = false;
-    keystates[InputType::GAME_SOFTDROP] = false;
-    keystates[InputType::GAME_ROTATE_LEFT] = false;
-    keystates[InputType::GAME_ROTATE_RIGHT] = false;
-    previous_keystates = keystates;
+    keystates = saved.keystates;
+    previous_keystates = saved.previous_keystates;
 }
 
 void Input::updateKeystate(const std::vector<InputEvent>& events)
 {
     previous_keystates = keystates;
 
-    for (const auto& event : events)
-        keystates[event.type()] = event.down();
+    for (const auto& event : events) {
+        const uint16_t bit = 1u << static_cast<uint8_t>(event.type());
+        if (event.down())
+            keystates |= bit;
+        else
+            keystates &= ~bit;
+    }
 }
 
-void Input::handleKeys(Well& well, const std::vector<InputEvent>& events)
+template <unsigned Width, unsigned Height>
+void Input::handleKeys(BasicWell<Width, Height>& well, const std::vector<InputEvent>& events)
 {
     // for some events onpress/onrelease handling is better suited
     for (const auto& event : events) {
@@ -41,11 +48,11 @@ void Input::handleKeys(Well& well, const std::vector<InputEvent>& events)
                 break;
 
             case InputType::GAME_ROTATE_LEFT:
-                well.rotateNow(Well::RotationDirection::COUNTER_CLOCKWISE);
+                well.rotateNow(BasicWell<Width, Height>::RotationDirection::COUNTER_CLOCKWISE);
                 break;
 
             case InputType::GAME_ROTATE_RIGHT:
-                well.rotateNow(Well::RotationDirection::CLOCKWISE);
+                well.rotateNow(BasicWell<Width, Height>::RotationDirection::CLOCKWISE);
                 break;
 
             default:
@@ -57,7 +64,7 @@ void Input::handleKeys(Well& well, const std::vector<InputEvent>& events)
             switch (event.type()) {
             case InputType::GAME_MOVE_LEFT:
             case InputType::GAME_MOVE_RIGHT:
-                if (!(keystates.at(InputType::GAME_MOVE_LEFT) || keystates.at(InputType::GAME_MOVE_RIGHT)))
+                if (!(isDown(InputType::GAME_MOVE_LEFT) || isDown(InputType::GAME_MOVE_RIGHT)))
                     well.das.reset();
                 break;
             default:
@@ -67,7 +74,7 @@ void Input::handleKeys(Well& well, const std::vector<InputEvent>& events)
     }
 
 
-    if (keystates.at(InputType::GAME_MOVE_LEFT) ^ keystates.at(InputType::GAME_MOVE_RIGHT)) {
+    if (isDown(InputType::GAME_MOVE_LEFT) ^ isDown(InputType::GAME_MOVE_RIGHT)) {
         bool can_move = false;
         well.das.update();
         if (well.das.inactive()) {
@@ -79,7 +86,7 @@ void Input::handleKeys(Well& well, const std::vector<InputEvent>& events)
             can_move = true;
         }
         if (can_move) {
-            if (keystates.at(InputType::GAME_MOVE_LEFT))
+            if (isDown(InputType::GAME_MOVE_LEFT))
                 well.moveLeftNow();
             else
                 well.moveRightNow();
@@ -87,16 +94,20 @@ void Input::handleKeys(Well& well, const std::vector<InputEvent>& events)
     }
 
     well.softdrop_timer -= Timing::frame_duration;
-    if (keystates.at(InputType::GAME_SOFTDROP)) {
+    if (isDown(InputType::GAME_SOFTDROP)) {
         well.gravity.skipNextUpdate();
 
         if (well.softdrop_timer <= Duration::zero()) {
             well.moveDownNow();
             well.softdrop_timer = well.softdrop_delay;
-            if (well.active_piece && !well.lock_delay.lockInProgress())
+            if (well.has_active_piece && !well.lock_delay.lockInProgress())
                 well.notify(WellEvent(WellEvent::Type::SOFTDROPPED));
         }
     }
 }
 
+template void Input::handleKeys(Well&, const std::vector<InputEvent>&);
+template void Input::handleKeys(NarrowWell&, const std::vector<InputEvent>&);
+template void Input::handleKeys(WideWell&, const std::vector<InputEvent>&);
+
 } // namespace WellComponents
@@ -2,11 +2,11 @@
 
 #include "system/Event.h"
 
-#include <unordered_map>
 #include <vector>
+#include <stdint.h>
 
 
-class Well;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
@@ -18,11 +18,22 @@ public:
     /// Update the key states only, but do not activate any game events
     void updateKeystate(const std::vector<InputEvent>&);
     /// Activate game events based on the saved keystate and the current input events
-    void handleKeys(Well&, const std::vector<InputEvent>&);
+    template <unsigned Width, unsigned Height>
+    void handleKeys(BasicWell<Width, Height>&, const std::vector<InputEvent>&);
+
+    /// The key states, where bit N is the state of the Nth InputType
+    struct Snapshot {
+        uint16_t keystates;
+        uint16_t previous_keystates;
+    };
+    Snapshot snapshot() const { return {keystates, previous_keystates}; }
+    void restore(const Snapshot&);
 
 private:
-    std::unordered_map<InputType, bool, InputTypeHash> keystates;
-    decltype(keystates) previous_keystates;
+    uint16_t keystates;
+    uint16_t previous_keystates;
+
+    bool isDown(InputType type) const { return keystates & (1u << static_cast<uint8_t>(type)); }
 };
 
 } // namespace WellComponents
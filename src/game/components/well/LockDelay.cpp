@@ -5,7 +5,8 @@
 
 namespace WellComponents {
 
-LockDelay::LockDelay(Well& well, Duration delay, LockDelayType type, bool instant_harddrop)
+template <unsigned Width, unsigned Height>
+LockDelay::LockDelay(BasicWell<Width, Height>& well, Duration delay, LockDelayType type, bool instant_harddrop)
     : harddrop_locks_instantly(instant_harddrop)
     , type(type)
     , reset_counter(reset_counter_max)
@@ -16,7 +17,8 @@ LockDelay::LockDelay(Well& well, Duration delay, LockDelayType type, bool instan
 {
 }
 
-void LockDelay::update(Well& well)
+template <unsigned Width, unsigned Height>
+void LockDelay::update(BasicWell<Width, Height>& well)
 {
     if (well.isOnGround()) {
         countdown.unpause();
@@ -48,7 +50,8 @@ bool LockDelay::lockInProgress() const
     return countdown.running();
 }
 
-void LockDelay::onDescend(Well& well)
+template <unsigned Width, unsigned Height>
+void LockDelay::onDescend(BasicWell<Width, Height>& well)
 {
     if (well.active_piece_y > current_lowest_row) {
         reset_counter = reset_counter_max;
@@ -78,4 +81,31 @@ void LockDelay::onSuccesfulRotation()
     onHorizontalMove();
 }
 
+LockDelay::Snapshot LockDelay::snapshot() const
+{
+    Snapshot saved;
+    saved.reset_counter = reset_counter;
+    saved.current_lowest_row = current_lowest_row;
+    saved.countdown_elapsed = countdown.elapsed();
+    saved.countdown_running = countdown.running();
+    return saved;
+}
+
+void LockDelay::restore(const Snapshot& saved)
+{
+    reset_counter = saved.reset_counter;
+    current_lowest_row = saved.current_lowest_row;
+    countdown.restore(saved.countdown_elapsed, saved.countdown_running);
+}
+
+template LockDelay::LockDelay(Well&, Duration, LockDelayType, bool);
+template LockDelay::LockDelay(NarrowWell&, Duration, LockDelayType, bool);
+template LockDelay::LockDelay(WideWell&, Duration, LockDelayType, bool);
+template void LockDelay::update(Well&);
+template void LockDelay::update(NarrowWell&);
+template void LockDelay::update(WideWell&);
+template void LockDelay::onDescend(Well&);
+template void LockDelay::onDescend(NarrowWell&);
+template void LockDelay::onDescend(WideWell&);
+
 } // namespace WellComponents
@@ -4,33 +4,49 @@
 #include "game/components/LockDelayType.h"
 
 
-class Well;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
 
 class LockDelay {
 public:
-    LockDelay(Well&, Duration delay, LockDelayType type, bool instant_harddrop = true);
+    template <unsigned Width, unsigned Height>
+    LockDelay(BasicWell<Width, Height>&, Duration delay, LockDelayType type, bool instant_harddrop = true);
 
-    void update(Well&);
+    template <unsigned Width, unsigned Height>
+    void update(BasicWell<Width, Height>&);
     void cancel();
 
     bool harddropLocksInstantly() const { return harddrop_locks_instantly; }
+    LockDelayType delayType() const { return type; }
+    /// With extended lock delay, the piece can be moved or rotated this many
+    /// times, before it locks instantly on the ground; the counter restarts
+    /// when the piece reaches a new lowest row
+    static constexpr uint8_t reset_counter_max = 10;
     /// Sonic locking is possible if hard drop doesn't lock instantly (Sonic Drop),
     /// and the piece has started locking, but not finished yet
     bool sonicLockPossible() const;
     /// The piece has started locking, but not finished yet
     bool lockInProgress() const;
 
-    void onDescend(Well&);
+    template <unsigned Width, unsigned Height>
+    void onDescend(BasicWell<Width, Height>&);
     void onHorizontalMove();
     void onSuccesfulRotation();
 
+    struct Snapshot {
+        uint8_t reset_counter;
+        uint8_t current_lowest_row;
+        Duration countdown_elapsed;
+        bool countdown_running;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot&);
+
 private:
     const bool harddrop_locks_instantly;
     const LockDelayType type;
-    static constexpr uint8_t reset_counter_max = 10;
     uint8_t reset_counter;
     uint8_t current_lowest_row; ///< this number grows the deeper you are in the well
 
@@ -0,0 +1,385 @@
+#include "MoveGen.h"
+
+#include "game/components/Piece.h"
+#include "game/components/Well.h"
+#include "game/components/rotations/RotationFn.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+namespace {
+constexpr std::array<PieceDirection, 4> directions = {{
+    PieceDirection::NORTH,
+    PieceDirection::EAST,
+    PieceDirection::SOUTH,
+    PieceDirection::WEST,
+}};
+
+/// Higher is better
+unsigned tspinRank(TSpinDetectionResult tspin)
+{
+    switch (tspin) {
+        case TSpinDetectionResult::TSPIN:
+            return 2;
+        case TSpinDetectionResult::MINI_TSPIN:
+            return 1;
+        default:
+            return 0;
+    }
+}
+} // namespace
+
+
+namespace WellComponents {
+
+template <unsigned Width, unsigned Height>
+MoveGen<Width, Height>::MoveGen(const BasicWell<Width, Height>& well)
+    : rotation_fn(*well.rotation_fn)
+    , tspin(well.tspin)
+    , lock_delay_type(well.lock_delay.delayType())
+    , fall_per_input(0)
+    , board(nullptr)
+    , piece_type(PieceType::I)
+{
+    queue.reserve(state_count);
+
+    for (const auto type : PieceTypeList) {
+        const auto type_idx = static_cast<size_t>(type);
+        const Piece piece(type, rotation_fn.pieceShapes());
+
+        for (const auto direction : directions) {
+            const auto dir_idx = static_cast<size_t>(direction);
+            const auto& grid_rows = piece.gridRows(direction);
+            piece_masks[type_idx][dir_idx] = Board::makePieceMasks(grid_rows);
+
+            // move the shape to the top left corner of the grid
+            int8_t dx = 0;
+            while (dx < 4 && std::none_of(grid_rows.cbegin(), grid_rows.cend(),
+                                          [dx](uint8_t row){ return row & (1u << dx); }))
+                dx++;
+            int8_t dy = 0;
+            while (dy < 4 && grid_rows[dy] == 0)
+                dy++;
+            std::array<uint8_t, 4> normalized {};
+            for (int row = dy; row < 4; row++)
+                normalized[row - dy] = grid_rows[row] >> dx;
+
+            auto& footprint = footprints[type_idx][dir_idx];
+            footprint = {static_cast<uint8_t>(dir_idx), dx, dy};
+            for (size_t prev_dir = 0; prev_dir < dir_idx; prev_dir++) {
+                const auto& prev_footprint = footprints[type_idx][prev_dir];
+                const auto& prev_rows = piece.gridRows(directions[prev_dir]);
+                std::array<uint8_t, 4> prev_normalized {};
+                for (int row = prev_footprint.dy; row < 4; row++)
+                    prev_normalized[row - prev_footprint.dy] = prev_rows[row] >> prev_footprint.dx;
+
+                if (prev_normalized == normalized) {
+                    footprint.orientation = prev_footprint.orientation;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+template <unsigned Width, unsigned Height>
+void MoveGen<Width, Height>::setGravity(Duration gravity_delay, Duration input_interval)
+{
+    // rounded down; the piece may fall a bit more in the game,
+    // but the bots search again before every key press
+    if (gravity_delay <= Duration::zero())
+        fall_per_input = Height;
+    else
+        fall_per_input = static_cast<unsigned>(std::min<Duration::rep>(input_interval / gravity_delay, Height));
+}
+
+template <unsigned Width, unsigned Height>
+bool MoveGen<Width, Height>::hasCollisionAt(int x, int y, PieceDirection orientation) const
+{
+    if (y < 0)
+        return true;
+
+    const auto& masks = piece_masks[static_cast<size_t>(piece_type)][static_cast<size_t>(orientation)];
+    return board->hasCollisionAt(masks, x, y);
+}
+
+template <unsigned Width, unsigned Height>
+const std::vector<typename MoveGen<Width, Height>::Placement>&
+MoveGen<Width, Height>::generate(const BasicWell<Width, Height>& well)
+{
+    found_placements.clear();
+    if (!well.has_active_piece)
+        return found_placements;
+
+    const auto& piece = well.active_piece;
+    const auto lock_delay = well.lock_delay.snapshot();
+    search(well.board, piece.type(), {well.active_piece_x, well.active_piece_y, piece.orientation()},
+           {lock_delay.reset_counter, lock_delay.current_lowest_row});
+    return found_placements;
+}
+
+template <unsigned Width, unsigned Height>
+const std::vector<typename MoveGen<Width, Height>::Placement>&
+MoveGen<Width, Height>::generate(const Board& target_board, PieceType type)
+{
+    found_placements.clear();
+    board = &target_board;
+    piece_type = type;
+
+    // the same as BasicWell::addPiece
+    constexpr int8_t spawn_x = (Width - 4) / 2;
+    constexpr unsigned hidden_height = BasicWell<Width, Height>::hidden_height;
+    for (unsigned spawn_y = hidden_height; spawn_y >= hidden_height - 2; spawn_y--) {
+        if (!hasCollisionAt(spawn_x, spawn_y, PieceDirection::NORTH)) {
+            // the piece may fall before the first key press
+            Position start = {spawn_x, static_cast<uint8_t>(spawn_y), PieceDirection::NORTH};
+            LockState start_lock = {LockDelay::reset_counter_max, 0};
+            descend(start, start_lock, fall_per_input);
+            search(target_board, type, start, start_lock);
+            break;
+        }
+    }
+    return found_placements;
+}
+
+template <unsigned Width, unsigned Height>
+void MoveGen<Width, Height>::search(const Board& target_board, PieceType type, Position start, LockState start_lock)
+{
+    assert(type != PieceType::GARBAGE);
+
+    board = &target_board;
+    piece_type = type;
+    visited.reset();
+    queued.reset();
+    used_footprints.reset();
+    found_placements.clear();
+    queue.clear();
+
+    visit(start, start_lock, no_state, InputType::GAME_HARDDROP, 0);
+
+    for (size_t queue_pos = 0; queue_pos < queue.size(); queue_pos++) {
+        const Position pos = queue[queue_pos];
+        const uint16_t state = stateIndex(pos.x, pos.y, pos.orientation);
+        const LockState lock = lock_states[state];
+        queued[state] = false;
+
+        if (grounded[state]) {
+            // the piece doesn't move after touching the ground
+            if (lock_delay_type == LockDelayType::CLASSIC)
+                continue;
+            // the piece locks instantly on the ground, if there are no more resets
+            if (lock_delay_type == LockDelayType::EXTENDED && lock.resets_left == 0)
+                continue;
+        }
+
+        // the same as LockDelay::onHorizontalMove and onSuccesfulRotation
+        LockState moved_lock = lock;
+        if (lock_delay_type == LockDelayType::EXTENDED && moved_lock.resets_left > 0)
+            moved_lock.resets_left--;
+
+        // the well doesn't let the piece move to the leftmost position
+        if (pos.x - 1 > -3 && !hasCollisionAt(pos.x - 1, pos.y, pos.orientation)) {
+            visit({static_cast<int8_t>(pos.x - 1), pos.y, pos.orientation},
+                  moved_lock, state, InputType::GAME_MOVE_LEFT, 0);
+        }
+        if (!hasCollisionAt(pos.x + 1, pos.y, pos.orientation)) {
+            visit({static_cast<int8_t>(pos.x + 1), pos.y, pos.orientation},
+                  moved_lock, state, InputType::GAME_MOVE_RIGHT, 0);
+        }
+
+        // the same as BasicWell::rotateNow and placeByWallKick
+        for (const bool clockwise : {true, false}) {
+            const auto target_rot = clockwise ? nextCW(pos.orientation) : prevCW(pos.orientation);
+            const auto input = clockwise ? InputType::GAME_ROTATE_RIGHT : InputType::GAME_ROTATE_LEFT;
+
+            if (!hasCollisionAt(pos.x, pos.y, target_rot)) {
+                visit({pos.x, pos.y, target_rot}, moved_lock, state, input, 0);
+                continue;
+            }
+
+            uint8_t rotation_point = 0;
+            for (const auto& offset : rotation_fn.possibleOffsets(type, pos.orientation, clockwise)) {
+                rotation_point++;
+                const int new_x = pos.x + offset.x;
+                const int new_y = pos.y + offset.y;
+                if (!hasCollisionAt(new_x, new_y, target_rot)) {
+                    visit({static_cast<int8_t>(new_x), static_cast<uint8_t>(new_y), target_rot},
+                          moved_lock, state, input, rotation_point);
+                    break;
+                }
+            }
+        }
+
+        if (!grounded[state]) {
+            Position below = pos;
+            LockState below_lock = lock;
+            descend(below, below_lock, 1);
+            visit(below, below_lock, state, InputType::GAME_SOFTDROP, 0);
+        }
+    }
+}
+
+template <unsigned Width, unsigned Height>
+unsigned MoveGen<Width, Height>::descend(Position& pos, LockState& lock, unsigned rows) const
+{
+    unsigned moved_rows = 0;
+    while (moved_rows < rows && !hasCollisionAt(pos.x, pos.y + 1, pos.orientation)) {
+        pos.y++;
+        moved_rows++;
+    }
+
+    // the same as LockDelay::onDescend
+    if (moved_rows > 0 && lock_delay_type == LockDelayType::EXTENDED && pos.y > lock.lowest_row)
+        lock = {LockDelay::reset_counter_max, pos.y};
+    return moved_rows;
+}
+
+template <unsigned Width, unsigned Height>
+void MoveGen<Width, Height>::visit(Position pos, LockState lock,
+                                   uint16_t from_state, InputType input, uint8_t rotation_point)
+{
+    bool is_rotation = (input == InputType::GAME_ROTATE_LEFT || input == InputType::GAME_ROTATE_RIGHT);
+
+    // the piece falls until the next key press, which also
+    // means the piece wasn't locked right after a rotation
+    if (from_state != no_state && descend(pos, lock, fall_per_input) > 0)
+        is_rotation = false;
+
+    const uint16_t state = stateIndex(pos.x, pos.y, pos.orientation);
+
+    if (visited[state]) {
+        // with more resets left, the piece may get further from here
+        if (lock.dominates(lock_states[state])) {
+            lock_states[state] = lock;
+            parents[state] = from_state;
+            parent_inputs[state] = input;
+            if (!queued[state]) {
+                queued[state] = true;
+                queue.push_back(pos);
+            }
+        }
+
+        // a grounded T piece may be rotated into a spin position
+        // after it was already reached in a different way
+        if (!is_rotation || piece_type != PieceType::T || !grounded[state] || placement_index[state] == no_state)
+            return;
+
+        auto& placement = found_placements[placement_index[state]];
+        const auto new_tspin = tspin.classify(*board, pos.x, pos.y, pos.orientation, rotation_point);
+        if (tspinRank(new_tspin) > tspinRank(placement.tspin)) {
+            placement.tspin = new_tspin;
+            placement.from_state = from_state;
+            placement.last_input = input;
+        }
+        return;
+    }
+
+    visited[state] = true;
+    queued[state] = true;
+    lock_states[state] = lock;
+    parents[state] = from_state;
+    parent_inputs[state] = input;
+    queue.push_back(pos);
+
+    const bool on_ground = hasCollisionAt(pos.x, pos.y + 1, pos.orientation);
+    grounded[state] = on_ground;
+    placement_index[state] = no_state;
+    if (!on_ground)
+        return;
+
+    // the same shape may be at the same place in multiple rotations
+    const auto& footprint = footprints[static_cast<size_t>(piece_type)][static_cast<size_t>(pos.orientation)];
+    const unsigned footprint_idx = (footprint.orientation * Height + pos.y + footprint.dy) * Width
+                                 + pos.x + footprint.dx;
+    assert(footprint_idx < used_footprints.size());
+    if (used_footprints[footprint_idx])
+        return;
+    used_footprints[footprint_idx] = true;
+
+    Placement placement;
+    placement.type = piece_type;
+    placement.x = pos.x;
+    placement.y = pos.y;
+    placement.orientation = pos.orientation;
+    placement.tspin = TSpinDetectionResult::NONE;
+    if (is_rotation && piece_type == PieceType::T)
+        placement.tspin = tspin.classify(*board, pos.x, pos.y, pos.orientation, rotation_point);
+    placement.from_state = from_state;
+    placement.last_input = input;
+
+    placement_index[state] = found_placements.size();
+    found_placements.push_back(placement);
+}
+
+template <unsigned Width, unsigned Height>
+std::vector<InputType> MoveGen<Width, Height>::pathTo(const Placement& placement) const
+{
+    std::vector<InputType> path;
+    for (const auto& step : stepsTo(placement))
+        path.push_back(step.input);
+    return path;
+}
+
+template <unsigned Width, unsigned Height>
+std::vector<typename MoveGen<Width, Height>::PathStep>
+MoveGen<Width, Height>::stepsTo(const Placement& placement) const
+{
+    std::vector<PathStep> steps;
+    PathStep hard_drop = {InputType::GAME_HARDDROP, placement.x, placement.y, placement.orientation};
+    if (placement.from_state != no_state) {
+        steps.push_back(stepAt(placement.from_state, placement.last_input));
+        for (uint16_t state = placement.from_state; parents[state] != no_state; state = parents[state])
+            steps.push_back(stepAt(parents[state], parent_inputs[state]));
+        std::reverse(steps.begin(), steps.end());
+
+        // the hard drop does the same
+        while (!steps.empty() && steps.back().input == InputType::GAME_SOFTDROP) {
+            hard_drop = steps.back();
+            hard_drop.input = InputType::GAME_HARDDROP;
+            steps.pop_back();
+        }
+    }
+    steps.push_back(hard_drop);
+    return steps;
+}
+
+template <unsigned Width, unsigned Height>
+unsigned MoveGen<Width, Height>::lockOnto(Board& target_board, const Placement& placement) const
+{
+    const auto& grid_rows = Piece(placement.type, rotation_fn.pieceShapes()).gridRows(placement.orientation);
+    for (unsigned row = 0; row < 4; row++) {
+        for (unsigned col = 0; col < 4; col++) {
+            if (grid_rows[row] & (1u << col))
+                target_board.setCell(placement.y + row, placement.x + col, placement.type);
+        }
+    }
+
+    const unsigned first_row = placement.y;
+    const unsigned last_row = std::min(placement.y + 3u, Height - 1);
+    const auto cleared_rows = target_board.fullRows(first_row, last_row);
+    if (cleared_rows) {
+        target_board.clearRows(cleared_rows);
+        target_board.removeRows(cleared_rows);
+    }
+    return countSetBits(cleared_rows);
+}
+
+template <unsigned Width, unsigned Height>
+bool MoveGen<Width, Height>::isSameSpot(const Placement& a, const Placement& b) const
+{
+    if (a.type != b.type)
+        return false;
+
+    const auto& footprint_a = footprints[static_cast<size_t>(a.type)][static_cast<size_t>(a.orientation)];
+    const auto& footprint_b = footprints[static_cast<size_t>(b.type)][static_cast<size_t>(b.orientation)];
+    return footprint_a.orientation == footprint_b.orientation
+        && a.x + footprint_a.dx == b.x + footprint_b.dx
+        && a.y + footprint_a.dy == b.y + footprint_b.dy;
+}
+
+template class MoveGen<10, 40>;
+template class MoveGen<4, 40>;
+template class MoveGen<20, 40>;
+
+} // namespace WellComponents
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Board.h"
+#include "TSpin.h"
+#include "game/components/LockDelayType.h"
+#include "game/components/PieceType.h"
+#include "game/Timing.h"
+#include "system/Event.h"
+
+#include <array>
+#include <bitset>
+#include <vector>
+#include <stdint.h>
+
+
+class RotationFn;
+template <unsigned Width, unsigned Height> class BasicWell;
+
+
+namespace WellComponents {
+
+/// Finds every final resting position of a piece, that can be reached
+/// from its current or spawn position by moving, rotating (with the wall kicks
+/// of the rotation system) and soft dropping it, including tucks and spins.
+///
+/// The search is a breadth-first search over the (x, y, rotation) states
+/// of the piece, so the returned input paths are the shortest ones (except
+/// with extended lock delay, where a longer path with more resets left
+/// may be preferred).
+/// The lock delay rules are followed: with classic lock delay, the piece
+/// is not moved after touching the ground; with extended lock delay, the
+/// moves and rotations use up the resets of the lock timer, and the piece
+/// locks when it's on the ground without resets left; with infinite lock
+/// delay, it can be moved freely on the ground. Gravity is ignored, unless
+/// it's set with `setGravity`.
+///
+/// The generator keeps its buffers between the searches, so it does not
+/// allocate memory after the first few calls. The placements and their paths
+/// are valid until the next search. A generator belongs to one well,
+/// and has to be recreated if the rotation system of the well changes.
+template <unsigned Width, unsigned Height>
+class MoveGen {
+public:
+    using Board = WellComponents::Board<Width, Height>;
+
+    struct Placement {
+        PieceType type;
+        int8_t x;
+        uint8_t y;
+        PieceDirection orientation;
+        /// The T-Spin the piece would do when locked here
+        TSpinDetectionResult tspin;
+
+    private:
+        // the last step of the path to this placement
+        uint16_t from_state;
+        InputType last_input;
+        friend class MoveGen;
+    };
+
+    /// A key press of a path, and the position of the piece where it has to be pressed
+    struct PathStep {
+        InputType input;
+        int8_t x;
+        uint8_t y;
+        PieceDirection orientation;
+    };
+
+    explicit MoveGen(const BasicWell<Width, Height>&);
+
+    /// Let the piece fall between the key presses, which follow each other
+    /// at the given interval; a zero interval ignores gravity
+    void setGravity(Duration gravity_delay, Duration input_interval);
+
+    /// Search the placements of the active piece of the well, from its current position
+    const std::vector<Placement>& generate(const BasicWell<Width, Height>&);
+    /// Search the placements of a new piece, from its spawn position on the board;
+    /// returns no placements if the piece can't spawn
+    const std::vector<Placement>& generate(const Board&, PieceType);
+    /// The results of the last search
+    const std::vector<Placement>& placements() const { return found_placements; }
+
+    /// The key presses that move the piece from its starting position into the placement,
+    /// then lock it with a hard drop. A soft drop moves the piece down by one row.
+    std::vector<InputType> pathTo(const Placement&) const;
+    /// The same path as `pathTo`, with the positions of the piece along the way
+    std::vector<PathStep> stepsTo(const Placement&) const;
+
+    /// Lock the piece onto the board and remove the cleared lines;
+    /// returns the number of cleared lines
+    unsigned lockOnto(Board&, const Placement&) const;
+    /// Returns true if the placements put the same piece onto the same cells,
+    /// even if they are in different rotations
+    bool isSameSpot(const Placement&, const Placement&) const;
+
+private:
+    static constexpr unsigned pos_x_count = Width + Board::wall_width;
+    static constexpr unsigned state_count = 4 * Height * pos_x_count;
+    static constexpr uint16_t no_state = 0xFFFF;
+    static_assert(state_count < no_state, "The well is too big for the state indices");
+
+    struct Position {
+        int8_t x;
+        uint8_t y;
+        PieceDirection orientation;
+    };
+    /// The state of the lock delay (only used with extended lock delay)
+    struct LockState {
+        uint8_t resets_left;
+        /// The lowest row reached by the piece
+        uint8_t lowest_row;
+
+        bool dominates(const LockState& other) const {
+            return resets_left > other.resets_left && lowest_row <= other.lowest_row;
+        }
+    };
+    static uint16_t stateIndex(int x, unsigned y, PieceDirection orientation) {
+        return (static_cast<unsigned>(orientation) * Height + y) * pos_x_count + x + Board::wall_width;
+    }
+    static PathStep stepAt(uint16_t state, InputType input) {
+        const unsigned row_index = state / pos_x_count;
+        return {
+            input,
+            static_cast<int8_t>(static_cast<int>(state % pos_x_count) - static_cast<int>(Board::wall_width)),
+            static_cast<uint8_t>(row_index % Height),
+            static_cast<PieceDirection>(row_index / Height),
+        };
+    }
+
+    const RotationFn& rotation_fn;
+    const TSpin tspin;
+    const LockDelayType lock_delay_type;
+    /// The number of rows the piece falls between two key presses
+    unsigned fall_per_input;
+
+    /// The collision masks of every piece type and rotation
+    std::array<std::array<typename Board::PieceMaskRow, 4>, PieceTypeList.size()> piece_masks;
+    /// To detect the rotations that have the same shape (eg. S, Z and I),
+    /// every rotation is mapped to the first rotation with the same shape,
+    /// and the offset of the shape inside the piece grid
+    struct Footprint {
+        uint8_t orientation;
+        int8_t dx;
+        int8_t dy;
+    };
+    std::array<std::array<Footprint, 4>, PieceTypeList.size()> footprints;
+
+    // search buffers
+    const Board* board;
+    PieceType piece_type;
+    std::bitset<state_count> visited;
+    std::bitset<state_count> queued;
+    std::bitset<state_count> grounded;
+    std::bitset<4 * Height * Width> used_footprints;
+    // a state is searched again if it's reached with more lock delay resets
+    std::vector<Position> queue;
+    std::array<LockState, state_count> lock_states;
+    std::array<uint16_t, state_count> parents;
+    std::array<InputType, state_count> parent_inputs;
+    std::array<uint16_t, state_count> placement_index;
+    std::vector<Placement> found_placements;
+
+    bool hasCollisionAt(int x, int y, PieceDirection) const;
+    void search(const Board&, PieceType, Position start, LockState start_lock);
+    /// Move the piece down by `rows`, or until it reaches the ground;
+    /// returns the number of rows it has moved
+    unsigned descend(Position&, LockState&, unsigned rows) const;
+    void visit(Position, LockState, uint16_t from_state, InputType, uint8_t rotation_point);
+};
+
+} // namespace WellComponents
@@ -4,68 +4,191 @@
 #include "game/components/MinoStorage.h"
 #include "game/components/Piece.h"
 #include "game/components/Well.h"
+#include "game/components/animations/CellLockAnim.h"
+#include "game/components/animations/HalfHeightLineClearAnim.h"
+#include "game/components/animations/LineClearAnim.h"
 #include "game/components/animations/WellAnimation.h"
+#include "game/util/BitScan.h"
 
+#include <array>
+#include <memory>
 #include <stddef.h>
 
 
 namespace WellComponents {
 
-Render::Render()
-    : top_row_height(Mino::texture_size_px * 0.3)
+Render::Render(const MinoStorage& mino_storage)
+    : mino_storage(mino_storage)
+    , top_row_height(Mino::texture_size_px * 0.3)
     , top_row_cliprect({0, Mino::texture_size_px - top_row_height, Mino::texture_size_px, top_row_height})
+    , pending_lock_anim_count(0)
 {}
 
-void Render::drawContent(const Well& well, GraphicsContext& gcx, int draw_offset_x, int draw_offset_y) const
+Render::~Render() = default;
+
+template <unsigned Width, unsigned Height>
+void Render::registerObservers(BasicWell<Width, Height>& well)
 {
-    // Draw board Minos
-    for (int col = 0; col < 10; col++) {
-        const auto& cell = well.matrix.at(19).at(col);
-        if (cell) {
-            cell->drawPartial(top_row_cliprect, {
-                draw_offset_x + col * Mino::texture_size_px, draw_offset_y,
-                Mino::texture_size_px, top_row_height});
+    constexpr unsigned hidden_height = BasicWell<Width, Height>::hidden_height;
+
+    well.registerObserver(WellEvent::Type::PIECE_LOCKED, [this](const WellEvent& event){
+        pending_lock_anim_count = 0;
+        for (unsigned i = 0; i < event.piecelock.count; i++) {
+            if (event.piecelock.rows[i] >= hidden_height) {
+                pending_lock_anims[pending_lock_anim_count++] = {event.piecelock.rows[i] - hidden_height,
+                                                                 event.piecelock.cols[i]};
+            }
         }
+    });
+
+    well.registerObserver(WellEvent::Type::LINE_CLEAR_ANIMATION_START, [this](const WellEvent& event){
+        // To avoid graphical glitches (animations flying in the air),
+        // only add cell lock animation if there was no line clear event
+        pending_lock_anim_count = 0;
+
+        for (auto rows = event.lineclear.rows; rows; rows &= rows - 1) {
+            const unsigned row = lowestSetBit(rows);
+            if (row >= hidden_height)
+                animations.emplace_back(std::make_unique<LineClearAnim>(row - hidden_height, Width));
+            else if (row == hidden_height - 1)
+                animations.emplace_back(std::make_unique<HalfHeightLineClearAnim>(Width));
+        }
+    });
+}
+
+void Render::updateAnimations()
+{
+    for (unsigned i = 0; i < pending_lock_anim_count; i++) {
+        animations.emplace_back(std::make_unique<CellLockAnim>(pending_lock_anims[i].first,
+                                                               pending_lock_anims[i].second));
     }
-    draw_offset_y += top_row_height;
-    for (unsigned row = 0; row < 20; row++) {
-        for (unsigned col = 0; col < 10; col++) {
-            const auto& cell = well.matrix.at(row + 20).at(col);
-            if (cell) {
-                cell->draw(draw_offset_x + col * Mino::texture_size_px,
-                           draw_offset_y + row * Mino::texture_size_px);
+    pending_lock_anim_count = 0;
+
+    for (auto& anim : animations)
+        anim->update(Timing::frame_duration);
+
+    animations.remove_if([](std::unique_ptr<WellAnimation>& animptr){
+        return !animptr->isActive();
+    });
+}
+
+template <unsigned Width, unsigned Height>
+void Render::updateBoardLayer(const BasicWell<Width, Height>& well, GraphicsContext& gcx) const
+{
+    // the bottom row of the buffer zone is partially visible
+    constexpr unsigned partial_row = BasicWell<Width, Height>::hidden_height - 1;
+    constexpr unsigned layer_rows = BasicWell<Width, Height>::visible_height + 1;
+
+    // a new texture is needed for drawing sharply at a different scale,
+    // and when the contents of the previous one were lost
+    if (!board_layer.texture
+        || board_layer.draw_scale != gcx.getDrawScale()
+        || board_layer.target_resets != gcx.renderTargetResets()) {
+        board_layer.texture = gcx.createRenderTarget(
+            Width * Mino::texture_size_px,
+            top_row_height + (layer_rows - 1) * Mino::texture_size_px);
+        board_layer.draw_scale = gcx.getDrawScale();
+        board_layer.target_resets = gcx.renderTargetResets();
+        board_layer.cells.assign(layer_rows * Width, 0);
+    }
+
+    // Find the rows that differ from the texture; comparing the cells, instead of
+    // tracking the changes of the board, also catches restoring saved states
+    std::array<bool, layer_rows> dirty_rows;
+    bool has_dirty_rows = false;
+    for (unsigned layer_row = 0; layer_row < layer_rows; layer_row++) {
+        const unsigned row = partial_row + layer_row;
+        const auto row_mask = well.board.rowMask(row);
+        uint8_t* const cached_cells = &board_layer.cells[layer_row * Width];
+
+        dirty_rows[layer_row] = false;
+        for (unsigned col = 0; col < Width; col++) {
+            const uint8_t cell = (row_mask & (1u << col))
+                ? static_cast<uint8_t>(well.board.cellType(row, col)) + 1
+                : 0;
+            if (cached_cells[col] != cell) {
+                cached_cells[col] = cell;
+                dirty_rows[layer_row] = true;
             }
         }
+        has_dirty_rows |= dirty_rows[layer_row];
     }
+    if (!has_dirty_rows)
+        return;
+
+    // Redraw the changed rows fully
+    gcx.setRenderTarget(board_layer.texture.get());
+    for (unsigned layer_row = 0; layer_row < layer_rows; layer_row++) {
+        if (!dirty_rows[layer_row])
+            continue;
+
+        const unsigned row = partial_row + layer_row;
+        const bool is_partial = layer_row == 0;
+        const int row_y = is_partial ? 0 : top_row_height + (layer_row - 1) * Mino::texture_size_px;
+        const int row_height = is_partial ? top_row_height : Mino::texture_size_px;
+        gcx.clearRect({0, row_y, static_cast<int>(Width) * Mino::texture_size_px, row_height});
+
+        for (unsigned col = 0; col < Width; col++) {
+            if (!well.board.isOccupied(row, col))
+                continue;
+
+            const auto& mino = mino_storage.getMino(well.board.cellType(row, col));
+            const int x = col * Mino::texture_size_px;
+            if (is_partial)
+                mino->addPartialSprite(sprite_batch, top_row_cliprect, {x, row_y, Mino::texture_size_px, row_height});
+            else
+                mino->addSprite(sprite_batch, x, row_y);
+        }
+    }
+    mino_storage.drawSprites(sprite_batch);
+    gcx.setRenderTarget(nullptr);
+}
+
+template <unsigned Width, unsigned Height>
+void Render::drawContent(const BasicWell<Width, Height>& well, GraphicsContext& gcx,
+                         int draw_offset_x, int draw_offset_y) const
+{
+    // the bottom row of the buffer zone is partially visible
+    constexpr int first_row = BasicWell<Width, Height>::hidden_height;
+    constexpr int partial_row = first_row - 1;
+
+    // Draw board Minos
+    updateBoardLayer(well, gcx);
+    board_layer.texture->drawScaled({
+        draw_offset_x, draw_offset_y,
+        static_cast<int>(Width) * Mino::texture_size_px,
+        top_row_height + static_cast<int>(BasicWell<Width, Height>::visible_height) * Mino::texture_size_px});
+    draw_offset_y += top_row_height;
 
     // Draw current piece
-    if (well.active_piece) {
+    if (well.has_active_piece) {
         // draw ghost
-        const auto& ghost_cell = MinoStorage::getGhost(well.active_piece->type());
+        const auto& ghost_cell = mino_storage.getGhost(well.active_piece.type());
         for (unsigned row = 0; row < 4; row++) {
-            if (well.ghost_piece_y + row < 20) // hide buffer zone
+            if (well.ghost_piece_y + row < first_row) // hide buffer zone
                 continue;
             for (unsigned col = 0; col < 4; col++) {
-                if (well.active_piece->currentGrid().at(row).at(col)) {
-                    ghost_cell->draw(draw_offset_x + (well.active_piece_x + col) * Mino::texture_size_px,
-                                     draw_offset_y + (well.ghost_piece_y + row - 20) * Mino::texture_size_px);
+                if (well.active_piece.hasMinoAt(row, col)) {
+                    ghost_cell->addSprite(sprite_batch,
+                                          draw_offset_x + (well.active_piece_x + col) * Mino::texture_size_px,
+                                          draw_offset_y + (well.ghost_piece_y + row - first_row) * Mino::texture_size_px);
                 }
             }
         }
 
         // draw piece
+        const auto& cell = mino_storage.getMino(well.active_piece.type());
         for (int row = 0; row < 4; row++) {
-            if (well.active_piece_y + row < 19) // hide buffer zone
+            if (well.active_piece_y + row < partial_row) // hide buffer zone
                 continue;
 
-            if (well.active_piece_y + row < 20) { // partially draw the topmost row
+            if (well.active_piece_y + row < first_row) { // partially draw the topmost row
                 draw_offset_y -= top_row_height;
                 for (int col = 0; col < 4; col++) {
-                    const auto& cell = well.active_piece->currentGrid().at(row).at(col);
-                    if (cell) {
-                        cell->drawPartial(top_row_cliprect, {
+                    if (well.active_piece.hasMinoAt(row, col)) {
+                        cell->addPartialSprite(sprite_batch, top_row_cliprect, {
                             draw_offset_x + (well.active_piece_x + col) * Mino::texture_size_px,
-                            draw_offset_y + (well.active_piece_y + row - 19) * Mino::texture_size_px,
+                            draw_offset_y + (well.active_piece_y + row - partial_row) * Mino::texture_size_px,
                             Mino::texture_size_px, top_row_height});
                     }
                 }
@@ -74,18 +197,28 @@ void Render::drawContent(const Well& well, GraphicsContext& gcx, int draw_offset
             }
 
             for (unsigned col = 0; col < 4; col++) {
-                const auto& cell = well.active_piece->currentGrid().at(row).at(col);
-                if (cell) {
-                    cell->draw(draw_offset_x + (well.active_piece_x + col) * Mino::texture_size_px,
-                               draw_offset_y + (well.active_piece_y + row - 20) * Mino::texture_size_px);
+                if (well.active_piece.hasMinoAt(row, col)) {
+                    cell->addSprite(sprite_batch,
+                                    draw_offset_x + (well.active_piece_x + col) * Mino::texture_size_px,
+                                    draw_offset_y + (well.active_piece_y + row - first_row) * Mino::texture_size_px);
                 }
             }
         }
     }
 
+    // The piece and the ghost are drawn with one batch, below the animations
+    mino_storage.drawSprites(sprite_batch);
+
     // Draw animations
-    for (auto& anim : well.animations)
+    for (auto& anim : animations)
         anim->draw(gcx, draw_offset_x, draw_offset_y);
 }
 
+template void Render::registerObservers(Well&);
+template void Render::registerObservers(NarrowWell&);
+template void Render::registerObservers(WideWell&);
+template void Render::drawContent(const Well&, GraphicsContext&, int, int) const;
+template void Render::drawContent(const NarrowWell&, GraphicsContext&, int, int) const;
+template void Render::drawContent(const WideWell&, GraphicsContext&, int, int) const;
+
 } // namespace WellComponents
@@ -1,23 +1,73 @@
 #pragma once
 
 #include "system/Rectangle.h"
+#include "system/Texture.h"
+
+#include <array>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stdint.h>
 
 
 class GraphicsContext;
-class Well;
+class MinoStorage;
+class WellAnimation;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
 
+/// Draws a well and its animations. The animations are created
+/// from the events of the well, so it has to be registered as an observer.
+///
+/// The locked Minos are drawn on a cached texture, and only its changed rows
+/// are redrawn; the active piece, its ghost and the animations are drawn
+/// on top of it every frame.
 class Render {
 public:
-    Render();
-    void drawContent(const Well&, GraphicsContext&, int draw_offset_x, int draw_offset_y) const;
+    Render(const MinoStorage&);
+    ~Render();
+
+    /// Start observing the well, to create animations on its events
+    template <unsigned Width, unsigned Height>
+    void registerObservers(BasicWell<Width, Height>&);
+
+    /// Update the active animations of the well
+    void updateAnimations();
+
+    template <unsigned Width, unsigned Height>
+    void drawContent(const BasicWell<Width, Height>&, GraphicsContext&, int draw_offset_x, int draw_offset_y) const;
 
 private:
+    const MinoStorage& mino_storage;
     const int top_row_height;
     const Rectangle top_row_cliprect;
+
+    std::list<std::unique_ptr<WellAnimation>> animations;
+
+    // The Minos of the current frame; kept to reuse its memory
+    mutable std::vector<SpriteQuad> sprite_batch;
+
+    struct BoardLayer {
+        std::unique_ptr<Texture> texture;
+        // the texture is recreated when these change
+        float draw_scale = 0.f;
+        unsigned target_resets = 0;
+        // the cells currently on the texture, row by row
+        // (0 is empty, otherwise the piece type + 1)
+        std::vector<uint8_t> cells;
+    };
+    mutable BoardLayer board_layer;
+
+    template <unsigned Width, unsigned Height>
+    void updateBoardLayer(const BasicWell<Width, Height>&, GraphicsContext&) const;
+
+    // The visible cells of the last locked piece. Their animations are created
+    // on the next update, unless the lock also caused a line clear.
+    std::array<std::pair<unsigned, unsigned>, 4> pending_lock_anims;
+    unsigned pending_lock_anim_count;
 };
 
 } // namespace WellComponents
-
@@ -38,17 +38,48 @@ void TSpin::onSuccesfulRotation()
         allowed = true;
 }
 
-TSpinDetectionResult TSpin::check(Well& well)
+TSpin::Snapshot TSpin::snapshot() const
+{
+    Snapshot saved;
+    saved.allowed = allowed;
+    saved.last_rotation_point = last_rotation_point;
+    return saved;
+}
+
+void TSpin::restore(const Snapshot& saved)
+{
+    allowed = saved.allowed;
+    last_rotation_point = saved.last_rotation_point;
+}
+
+template <unsigned Width, unsigned Height>
+TSpinDetectionResult TSpin::check(BasicWell<Width, Height>& well)
 {
     if (!enabled)
         return TSpinDetectionResult::NONE;
 
-    if (well.active_piece->type() != PieceType::T || !allowed)
+    if (well.active_piece.type() != PieceType::T || !allowed)
         return TSpinDetectionResult::NONE;
 
     // ack
     allowed = false;
 
+    return classify(well.board, well.active_piece_x, well.active_piece_y,
+                    well.active_piece.orientation(), last_rotation_point);
+}
+
+template <unsigned Width, unsigned Height>
+TSpinDetectionResult TSpin::classify(const Board<Width, Height>& board,
+                                     int piece_x, unsigned piece_y, PieceDirection orientation,
+                                     uint8_t rotation_point) const
+{
+    if (!enabled)
+        return TSpinDetectionResult::NONE;
+
+    // rotation by kick may not be a valid tspin
+    if (rotation_point != 0 && !allow_kick)
+        return TSpinDetectionResult::NONE;
+
 
     // First, collect the coords we'll have to check,
     // then rotate the coords to the same orientation as the T piece
@@ -56,15 +87,15 @@ TSpinDetectionResult TSpin::check(Well& well)
     // A?B
     // ?T?
     // D?C
-    std::array<std::pair<int8_t, uint8_t>, 4> diagonals = {{
-        std::make_pair(well.active_piece_x, well.active_piece_y),
-        std::make_pair(well.active_piece_x + 2, well.active_piece_y),
-        std::make_pair(well.active_piece_x + 2, well.active_piece_y + 2),
-        std::make_pair(well.active_piece_x, well.active_piece_y + 2),
+    std::array<std::pair<int, unsigned>, 4> diagonals = {{
+        std::make_pair(piece_x, piece_y),
+        std::make_pair(piece_x + 2, piece_y),
+        std::make_pair(piece_x + 2, piece_y + 2),
+        std::make_pair(piece_x, piece_y + 2),
     }};
 
     auto pattern_orientation = PieceDirection::NORTH;
-    while (pattern_orientation != well.active_piece->orientation()) {
+    while (pattern_orientation != orientation) {
         pattern_orientation = nextCW(pattern_orientation);
         std::rotate(diagonals.begin(), diagonals.begin() + 1, diagonals.end());
     }
@@ -79,18 +110,18 @@ TSpinDetectionResult TSpin::check(Well& well)
         const auto& coord = diagonals.at(i);
 
         // the walls may not count
-        if (coord.first < 0 || coord.first >= static_cast<int>(well.matrix.at(0).size())) {
+        if (coord.first < 0 || coord.first >= static_cast<int>(Width)) {
             if (allow_wall)
                 diagonals_occupied[i] = true;
             continue;
         }
         // the bottom layer always counts
-        if (coord.second >= well.matrix.size()) {
+        if (coord.second >= Height) {
             diagonals_occupied[i] = true;
             continue;
         }
 
-        if (well.matrix.at(coord.second).at(coord.first).operator bool())
+        if (board.isOccupied(coord.second, coord.first))
             diagonals_occupied[i] = true;
     }
     if (std::count(diagonals_occupied.begin(), diagonals_occupied.end(), true) < 3)
@@ -103,7 +134,7 @@ TSpinDetectionResult TSpin::check(Well& well)
 
     bool is_proper_tspin = false;
     const bool front_touch = diagonals_occupied[0] && diagonals_occupied[1];
-    if (last_rotation_point == 3 || front_touch)
+    if (rotation_point == 3 || front_touch)
         is_proper_tspin = true;
 
     if (is_proper_tspin)
@@ -112,4 +143,11 @@ TSpinDetectionResult TSpin::check(Well& well)
         return TSpinDetectionResult::MINI_TSPIN;
 }
 
+template TSpinDetectionResult TSpin::check(Well&);
+template TSpinDetectionResult TSpin::check(NarrowWell&);
+template TSpinDetectionResult TSpin::check(WideWell&);
+template TSpinDetectionResult TSpin::classify(const Well::Board&, int, unsigned, PieceDirection, uint8_t) const;
+template TSpinDetectionResult TSpin::classify(const NarrowWell::Board&, int, unsigned, PieceDirection, uint8_t) const;
+template TSpinDetectionResult TSpin::classify(const WideWell::Board&, int, unsigned, PieceDirection, uint8_t) const;
+
 } // namespace WellComponents
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "game/components/PieceType.h"
+
 #include <stdint.h>
 
 
@@ -10,21 +12,38 @@ enum class TSpinDetectionResult : uint8_t {
 };
 
 
-class Well;
+template <unsigned Width, unsigned Height> class BasicWell;
 
 
 namespace WellComponents {
 
+template <unsigned Width, unsigned Height> class Board;
+
 class TSpin {
 public:
     TSpin(bool enabled = true, bool allow_wall = true, bool allow_kick = true);
 
-    TSpinDetectionResult check(Well&);
+    template <unsigned Width, unsigned Height>
+    TSpinDetectionResult check(BasicWell<Width, Height>&);
+    /// Classify a T piece resting at the position, that got there by a rotation
+    /// using the rotation point `rotation_point` (0 means no wall kick).
+    /// Unlike `check`, this doesn't depend on the state of the active piece.
+    template <unsigned Width, unsigned Height>
+    TSpinDetectionResult classify(const Board<Width, Height>&,
+                                  int piece_x, unsigned piece_y, PieceDirection,
+                                  uint8_t rotation_point) const;
 
     void clear();
     void onWallKick();
     void onSuccesfulRotation();
 
+    struct Snapshot {
+        bool allowed;
+        uint8_t last_rotation_point;
+    };
+    Snapshot snapshot() const;
+    void restore(const Snapshot&);
+
 private:
     const bool enabled;
     const bool allow_wall;
@@ -35,11 +35,13 @@ PlayerArea::GameEndVars::GameEndVars(AppContext& app)
 
 PlayerArea::PlayerArea(AppContext& app, bool draw_gauge)
     : ui_well(app)
+    , mino_storage(app.minos())
     , draw_gauge(draw_gauge)
     , garbage_gauge(app, ui_well.height())
     , rect_level{}
     , rect_score{}
     , rect_goal{}
+    , text_goal_counter(nullptr)
     , rect_time{}
     , game_end(app)
     , special_update([]{})
@@ -59,6 +61,13 @@ PlayerArea::PlayerArea(AppContext& app, bool draw_gauge)
     tex_goal = font_label->renderText(tr("GOAL"), labelcolor_normal);
     tex_level = font_label->renderText(tr("LEVEL"), labelcolor_normal);
 
+    text_level_counter_wide = font_content->createGlyphText(labelcolor_normal);
+    text_level_counter_narrow = font_content->createGlyphText(labelcolor_normal);
+    text_score_counter = font_content->createGlyphText(labelcolor_normal);
+    text_goal_counter_normal = font_content->createGlyphText(labelcolor_normal);
+    text_goal_counter_highlight = font_content_highlight->createGlyphText(labelcolor_highlight);
+    text_time_counter = font_content->createGlyphText(labelcolor_normal);
+
     setScore(0);
     setGoalCounter(0);
     setLevelCounter(app.theme().gameplay.draw_labels, 0);
@@ -188,31 +197,24 @@ void PlayerArea::update()
 
 void PlayerArea::setLevelCounter(bool show_label, unsigned num)
 {
-    tex_level_counter_narrow = font_content->renderText((show_label ? tr("LEVEL ") : "")
-        + std::to_string(num), labelcolor_normal);
-    tex_level_counter_wide = font_content->renderText(std::to_string(num), labelcolor_normal);
+    text_level_counter_narrow->setText((show_label ? tr("LEVEL ") : "") + std::to_string(num));
+    text_level_counter_wide->setText(std::to_string(num));
 }
 
 void PlayerArea::setScore(unsigned num)
 {
-    tex_score_counter = font_content->renderText(std::to_string(num), labelcolor_normal);
+    text_score_counter->setText(std::to_string(num));
 }
 
 void PlayerArea::setGoalCounter(unsigned num)
 {
-    if (num <= 5)
-        tex_goal_counter = font_content_highlight->renderText(std::to_string(num), labelcolor_highlight);
-    else
-        tex_goal_counter = font_content->renderText(std::to_string(num), labelcolor_normal);
+    text_goal_counter = (num <= 5) ? text_goal_counter_highlight.get() : text_goal_counter_normal.get();
+    text_goal_counter->setText(std::to_string(num));
 }
 
 void PlayerArea::setGametime(Duration gametime)
 {
-    const auto newstr = Timing::toString(gametime);
-    if (newstr != gametime_text) {
-        gametime_text = newstr;
-        tex_time_counter = font_content->renderText(gametime_text, labelcolor_normal);
-    }
+    text_time_counter->setText(Timing::toString(gametime));
 }
 
 void PlayerArea::setGarbageCount(unsigned lines)
@@ -264,6 +266,16 @@ void PlayerArea::startGameFinish()
     };
 }
 
+void PlayerArea::resetGameEnd()
+{
+    game_end.sfx_onanimend.reset();
+    game_end.anim_percent.restart();
+    game_end.tex_gameover->setAlpha(0x0);
+    game_end.tex_finish->setAlpha(0x0);
+    special_update = []{};
+    special_draw = [](GraphicsContext&){};
+}
+
 void PlayerArea::drawActive(GraphicsContext& gcx) const
 {
     draw_fn_active(gcx);
@@ -294,17 +306,17 @@ void PlayerArea::drawWidePassive(GraphicsContext& gcx) const
                           rect_score.y - inner_padding - label_height);
     }
 
-    hold_queue.draw(gcx, x(), y() + label_height + inner_padding);
-    next_queue.draw(gcx, rightside_x - sidebar_width, y() + label_height + inner_padding);
-
-    tex_score_counter->drawAt(rect_score.x + (rect_score.w - tex_score_counter->width()) / 2,
-                              rect_score.y + 5);
-    tex_time_counter->drawAt(rect_time.x + (rect_time.w - tex_time_counter->width()) / 2,
-                             rect_time.y + 5);
-    tex_goal_counter->drawAt(rect_goal.x + (rect_goal.w - tex_goal_counter->width()) / 2,
-                             rect_goal.y + 5);
-    tex_level_counter_wide->drawAt(rect_level.x + (rect_level.w - tex_level_counter_wide->width()) / 2,
-                                   rect_level.y + 5);
+    hold_queue.draw(gcx, mino_storage, x(), y() + label_height + inner_padding);
+    next_queue.draw(gcx, mino_storage, rightside_x - sidebar_width, y() + label_height + inner_padding);
+
+    text_score_counter->drawAt(rect_score.x + (rect_score.w - text_score_counter->width()) / 2,
+                               rect_score.y + 5);
+    text_time_counter->drawAt(rect_time.x + (rect_time.w - text_time_counter->width()) / 2,
+                              rect_time.y + 5);
+    text_goal_counter->drawAt(rect_goal.x + (rect_goal.w - text_goal_counter->width()) / 2,
+                              rect_goal.y + 5);
+    text_level_counter_wide->drawAt(rect_level.x + (rect_level.w - text_level_counter_wide->width()) / 2,
+                                    rect_level.y + 5);
 }
 
 void PlayerArea::drawWideActive(GraphicsContext& gcx) const
@@ -326,11 +338,11 @@ void PlayerArea::drawNarrowPassive(GraphicsContext& gcx) const
         tex_next->drawAt(x() + width() - tex_next->width() - 5, y());
     }
 
-    hold_queue.draw(gcx, x(), y());
-    next_queue.draw(gcx, x() + width() - ui_well.wellWidth() / 2, y());
+    hold_queue.draw(gcx, mino_storage, x(), y());
+    next_queue.draw(gcx, mino_storage, x() + width() - ui_well.wellWidth() / 2, y());
 
-    tex_level_counter_narrow->drawAt(rect_level.x + 10, rect_level.y);
-    tex_score_counter->drawAt(rect_score.x + rect_score.w - tex_score_counter->width() - 10, rect_score.y);
+    text_level_counter_narrow->drawAt(rect_level.x + 10, rect_level.y);
+    text_score_counter->drawAt(rect_score.x + rect_score.w - text_score_counter->width() - 10, rect_score.y);
 }
 
 void PlayerArea::drawNarrowActive(GraphicsContext& gcx) const
@@ -8,11 +8,13 @@
 #include "game/components/HoldQueue.h"
 #include "game/components/NextQueue.h"
 #include "system/Color.h"
+#include "system/GlyphText.h"
 #include "system/SoundEffect.h"
 
 class AppContext;
 class Font;
 class GraphicsContext;
+class MinoStorage;
 class SoundEffect;
 
 
@@ -36,6 +38,8 @@ public:
 
     void startGameOver();
     void startGameFinish();
+    /// Remove the game over or finish animation, eg. when the game is rolled back
+    void resetGameEnd();
 
     void enableGameOverSFX(bool);
 
@@ -44,6 +48,7 @@ public:
     unsigned queuedGarbageLines() const { return garbage_gauge.lineCount(); }
 
     Well& well() { return ui_well.well(); };
+    void updateWellAnimations() { ui_well.updateAnimations(); }
     ::Rectangle wellBox() const { return wellbox; }
     int wellCenterX() const { return wellBox().x + wellBox().w / 2; }
     int wellCenterY() const { return wellBox().y + wellBox().h / 2; }
@@ -74,25 +79,28 @@ protected:
     std::unique_ptr<Texture> tex_next;
     NextQueue next_queue;
 
+    const MinoStorage& mino_storage;
     const bool draw_gauge;
     GarbageGauge garbage_gauge;
 
     ::Rectangle rect_level;
     std::unique_ptr<Texture> tex_level;
-    std::unique_ptr<Texture> tex_level_counter_wide;
-    std::unique_ptr<Texture> tex_level_counter_narrow;
+    std::unique_ptr<GlyphText> text_level_counter_wide;
+    std::unique_ptr<GlyphText> text_level_counter_narrow;
 
     ::Rectangle rect_score;
     std::unique_ptr<Texture> tex_score;
-    std::unique_ptr<Texture> tex_score_counter;
+    std::unique_ptr<GlyphText> text_score_counter;
 
     ::Rectangle rect_goal;
     std::unique_ptr<Texture> tex_goal;
-    std::unique_ptr<Texture> tex_goal_counter;
+    // the counter is highlighted near the goal
+    std::unique_ptr<GlyphText> text_goal_counter_normal;
+    std::unique_ptr<GlyphText> text_goal_counter_highlight;
+    GlyphText* text_goal_counter;
 
-    std::string gametime_text;
     ::Rectangle rect_time;
-    std::unique_ptr<Texture> tex_time_counter;
+    std::unique_ptr<GlyphText> text_time_counter;
 
     void calcWellBox();
     void calcUITexPos(float);
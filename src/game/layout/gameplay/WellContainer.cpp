@@ -10,8 +10,10 @@ namespace Layout {
 
 WellContainer::WellContainer(AppContext& app)
     : m_well(app.wellconfig())
+    , renderer(app.minos())
 {
     LineClearAnim::anim_color = app.theme().colors.line_clear;
+    renderer.registerObservers(m_well);
 
     bounding_box.w = wellWidth() + border_width * 2;
     bounding_box.h = wellHeight() + border_width * 2;
@@ -25,9 +27,14 @@ void WellContainer::setPosition(int x, int y)
     bounding_box.y = y;
 }
 
+void WellContainer::updateAnimations()
+{
+    renderer.updateAnimations();
+}
+
 void WellContainer::drawContent(GraphicsContext& gcx) const
 {
-    m_well.drawContent(gcx, x() + border_width, y() + border_width);
+    renderer.drawContent(m_well, gcx, x() + border_width, y() + border_width);
 }
 
 } // namespace Layout
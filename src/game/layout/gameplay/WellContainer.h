@@ -2,6 +2,7 @@
 
 #include "game/components/Mino.h"
 #include "game/components/Well.h"
+#include "game/components/well/Render.h"
 #include "game/layout/Box.h"
 #include "system/Color.h"
 
@@ -12,14 +13,18 @@ namespace Layout {
 class WellContainer : public Layout::Box {
 public:
     WellContainer(AppContext&);
+    // the renderer observes the well
+    WellContainer(const WellContainer&) = delete;
+    WellContainer& operator=(const WellContainer&) = delete;
 
     void setPosition(int x, int y) override;
+    void updateAnimations();
     void drawContent(GraphicsContext&) const;
 
     Well& well() { return m_well; }
 
-    int wellWidth() const { return 10 * Mino::texture_size_px; }
-    int wellHeight() const { return 20.3 * Mino::texture_size_px; }
+    int wellWidth() const { return Well::width * Mino::texture_size_px; }
+    int wellHeight() const { return (Well::visible_height + 0.3) * Mino::texture_size_px; }
     int wellX() const { return x() + border_width; }
     int wellY() const { return y() + border_width; }
 
@@ -27,5 +32,6 @@ private:
     static constexpr uint8_t border_width = 5;
 
     Well m_well;
+    WellComponents::Render renderer;
 };
 } // namespace Layout
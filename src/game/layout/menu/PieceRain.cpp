@@ -1,11 +1,12 @@
 #include "PieceRain.h"
 
 #include "game/components/Mino.h"
+#include "game/components/MinoStorage.h"
 #include "game/components/Piece.h"
-#include "game/components/PieceFactory.h"
+#include "game/components/PieceRender.h"
+#include "game/components/rotations/SRS.h"
 
 #include <cmath>
-#include <cstdlib>
 
 
 static const int PADDING_PX = 5;
@@ -15,6 +16,7 @@ namespace Layout {
 
 PieceRain::PieceRain()
     : displayed_piece_count(0)
+    , rng(Random::makeSeed())
     , bottom_y(std::chrono::seconds(4),
                [this](double t) {
                    return this->y() + this->height() + t * PIECE_SIDES_PX; },
@@ -37,11 +39,11 @@ void PieceRain::update()
 {
     // fill from back if there are too few
     while (active_pieces.size() < displayed_piece_count) {
-        const unsigned type_idx = std::rand() % PieceTypeList.size();
-        const unsigned rotation_cnt = std::rand() % 4;
-        active_pieces.emplace_back(PieceFactory::make_uptr(PieceTypeList.at(type_idx)));
+        const unsigned type_idx = rng.below(PieceTypeList.size());
+        const unsigned rotation_cnt = rng.below(4);
+        active_pieces.emplace_back(PieceTypeList.at(type_idx), Rotations::SRS::shapes());
         for (unsigned i = 0; i < rotation_cnt; i++)
-            active_pieces.back()->rotateCW();
+            active_pieces.back().rotateCW();
     }
     // remove from front if there are too many
     while (active_pieces.size() > displayed_piece_count)
@@ -55,13 +57,14 @@ void PieceRain::reload()
     active_pieces.clear();
 }
 
-void PieceRain::draw() const
+void PieceRain::draw(const MinoStorage& minos) const
 {
     int piece_y = bottom_y.value();
     for (const auto& piece : active_pieces) {
-        piece->draw(x() + PADDING_PX, piece_y + PADDING_PX);
+        addPieceSprites(sprite_batch, minos, piece, x() + PADDING_PX, piece_y + PADDING_PX);
         piece_y -= PIECE_SIDES_PX;
     }
+    minos.drawSprites(sprite_batch);
 }
 
 } // namespace Layout
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "game/Transition.h"
+#include "game/components/Piece.h"
 #include "game/layout/Box.h"
+#include "game/util/Random.h"
+#include "system/Texture.h"
 
 #include <list>
-#include <memory>
+#include <vector>
 
-
-class Piece;
+class MinoStorage;
 
 
 namespace Layout {
@@ -18,14 +20,17 @@ public:
     void setHeight(unsigned);
 
     void update();
-    void draw() const;
+    void draw(const MinoStorage&) const;
 
     void reload();
 
 private:
     unsigned displayed_piece_count;
-    std::list<std::unique_ptr<Piece>> active_pieces;
+    std::list<Piece> active_pieces;
+    Random rng;
 
     Transition<int> bottom_y;
+
+    mutable std::vector<SpriteQuad> sprite_batch;
 };
 } // namespace Layout
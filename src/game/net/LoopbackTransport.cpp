@@ -0,0 +1,93 @@
+#include "LoopbackTransport.h"
+
+#include <algorithm>
+#include <deque>
+#include <assert.h>
+
+
+namespace Net {
+
+class LoopbackLink::Endpoint : public Transport {
+public:
+    Endpoint(LoopbackLink& link, unsigned side)
+        : link(link)
+        , side(side)
+    {}
+
+    void send(const Packet& packet) final {
+        link.transmit(1 - side, packet);
+    }
+
+    bool receive(Packet& output) final {
+        if (incoming.empty() || incoming.front().arrival > link.now)
+            return false;
+
+        output = std::move(incoming.front().data);
+        incoming.pop_front();
+        return true;
+    }
+
+    struct InFlight {
+        Duration arrival;
+        Packet data;
+    };
+    /// Ordered by the arrival time
+    std::deque<InFlight> incoming;
+
+private:
+    LoopbackLink& link;
+    const unsigned side;
+};
+
+
+LoopbackLink::LoopbackLink(const LinkConditions& conditions, uint64_t seed)
+    : conditions(conditions)
+    , rng(seed)
+    , now(Duration::zero())
+    , sent_packets(0)
+    , lost_packets(0)
+{
+    assert(conditions.loss >= 0.0 && conditions.loss <= 1.0);
+    assert(conditions.jitter >= Duration::zero());
+
+    for (unsigned side = 0; side < endpoints.size(); side++)
+        endpoints[side] = std::make_unique<Endpoint>(*this, side);
+}
+
+LoopbackLink::~LoopbackLink() = default;
+
+Transport& LoopbackLink::endpoint(unsigned side)
+{
+    assert(side < endpoints.size());
+    return *endpoints[side];
+}
+
+void LoopbackLink::advance(Duration elapsed)
+{
+    now += elapsed;
+}
+
+void LoopbackLink::transmit(unsigned target_side, const Packet& packet)
+{
+    sent_packets++;
+
+    // a random number in [0, 1), with 24 bits of precision
+    const double roll = rng.below(1u << 24) / static_cast<double>(1u << 24);
+    if (roll < conditions.loss) {
+        lost_packets++;
+        return;
+    }
+
+    Duration arrival = now + conditions.latency;
+    if (conditions.jitter > Duration::zero()) {
+        const auto jitter_us = std::chrono::duration_cast<std::chrono::microseconds>(conditions.jitter).count();
+        arrival += std::chrono::microseconds(rng.below(static_cast<uint32_t>(jitter_us) + 1));
+    }
+
+    auto& incoming = endpoints[target_side]->incoming;
+    const auto position = std::upper_bound(incoming.begin(), incoming.end(), arrival,
+        [](Duration time, const Endpoint::InFlight& entry){ return time < entry.arrival; });
+    incoming.insert(position, Endpoint::InFlight{arrival, packet});
+}
+
+} // namespace Net
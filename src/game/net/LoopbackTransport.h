@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Transport.h"
+#include "game/Timing.h"
+#include "game/util/Random.h"
+
+#include <array>
+#include <memory>
+
+
+namespace Net {
+
+/// The artificial network conditions of a loopback link
+struct LinkConditions {
+    /// The base delay of every packet
+    Duration latency = Duration::zero();
+    /// A random extra delay of at most this much; packets may overtake each other
+    Duration jitter = Duration::zero();
+    /// The chance of a packet getting lost, between 0 and 1
+    double loss = 0.0;
+};
+
+/// An in-process connection between two transport endpoints, simulating
+/// a real network. The link has its own clock, which only moves forward
+/// when `advance` is called, so tests and simulations are reproducible
+/// and independent of the speed of the machine.
+class LoopbackLink {
+public:
+    explicit LoopbackLink(const LinkConditions& = LinkConditions(), uint64_t seed = 0);
+    ~LoopbackLink();
+
+    /// One of the two sides of the link (0 or 1)
+    Transport& endpoint(unsigned side);
+    /// Let time pass; the packets that have arrived can be received after this
+    void advance(Duration);
+
+    /// The number of sent and lost packets, in both directions
+    uint64_t sentPackets() const { return sent_packets; }
+    uint64_t lostPackets() const { return lost_packets; }
+
+private:
+    class Endpoint;
+
+    const LinkConditions conditions;
+    Random rng;
+    Duration now;
+    std::array<std::unique_ptr<Endpoint>, 2> endpoints;
+
+    uint64_t sent_packets;
+    uint64_t lost_packets;
+
+    /// Put a packet into the incoming queue of the target side
+    void transmit(unsigned target_side, const Packet&);
+};
+
+} // namespace Net
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Rollback.h"
+#include "system/Event.h"
+
+#include <string>
+#include <stdint.h>
+
+
+namespace Net {
+
+/// The settings of an online battle of the game
+struct NetplaySettings {
+    /// The index of the local player, 0 or 1; the other side has to use the other one
+    unsigned local_player = 0;
+    uint16_t local_port = 0;
+    std::string remote_host;
+    uint16_t remote_port = 0;
+    /// Every random decision of the match depends on it, so it has to be
+    /// the same on both sides
+    uint64_t seed = 0;
+    RollbackSettings rollback;
+};
+
+/// The input device of the remote player in the game; its inputs
+/// come from the rollback session
+constexpr DeviceID remote_device = 120;
+
+} // namespace Net
@@ -0,0 +1,330 @@
+#include "Rollback.h"
+
+#include "game/Timing.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+namespace Net {
+
+namespace {
+constexpr uint8_t inputs_packet_tag = 0x01;
+/// The tag, the three frame numbers and the input count, each at least one byte
+constexpr size_t min_packet_size = 5;
+constexpr unsigned input_type_count = static_cast<unsigned>(InputType::MENU_CANCEL) + 1;
+constexpr unsigned frames_per_second = std::chrono::seconds(1) / Timing::frame_duration;
+
+void writeVarint(Packet& packet, uint64_t value)
+{
+    while (value >= 0x80) {
+        packet.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    packet.push_back(static_cast<uint8_t>(value));
+}
+
+/// Reads the values of a packet; the packets may come from anywhere,
+/// so a reading past the end only sets an error flag
+class PacketReader {
+public:
+    explicit PacketReader(const Packet& packet)
+        : packet(packet)
+        , read_pos(0)
+        , failed(false)
+    {}
+
+    bool ok() const { return !failed; }
+
+    uint8_t readByte() {
+        if (read_pos >= packet.size()) {
+            failed = true;
+            return 0;
+        }
+        return packet[read_pos++];
+    }
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = readByte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        failed = true;
+        return 0;
+    }
+
+private:
+    const Packet& packet;
+    size_t read_pos;
+    bool failed;
+};
+} // namespace
+
+
+InputBits applyEvents(InputBits keys, const std::vector<InputEvent>& events)
+{
+    for (const auto& event : events) {
+        const InputBits bit = 1u << static_cast<uint8_t>(event.type());
+        if (event.down())
+            keys |= bit;
+        else
+            keys &= ~bit;
+    }
+    return keys;
+}
+
+void toEvents(InputBits previous, InputBits current, DeviceID device_id, std::vector<InputEvent>& output)
+{
+    const InputBits changed = previous ^ current;
+    for (unsigned type = 0; type < input_type_count; type++) {
+        const InputBits bit = 1u << type;
+        if (changed & bit)
+            output.emplace_back(static_cast<InputType>(type), current & bit, device_id);
+    }
+}
+
+
+RollbackSession::RollbackSession(RollbackGame& game, Transport& transport, unsigned local_player,
+                                 const RollbackSettings& settings)
+    : game(game)
+    , transport(transport)
+    , local_player(local_player)
+    , settings(settings)
+    , state_slots(stateSlots(settings))
+    , current_frame(0)
+    , local_inputs{}
+    , local_count(settings.input_delay)
+    , local_acked(0)
+    , remote_inputs{}
+    , remote_count(0)
+    , used_remote_inputs{}
+    , needs_rollback(false)
+    , rollback_frame(0)
+    , has_local_checksum(false)
+    , local_checksum_frame(0)
+    , local_checksum(0)
+    , has_remote_checksum(false)
+    , remote_checksum_frame(0)
+    , remote_checksum(0)
+    , next_compared_frame(0)
+    , window_frames(0)
+    , window_resimulated(0)
+{
+    assert(local_player < player_count);
+    assert(settings.max_rollback > 0);
+    // the inputs of both sides have to fit into the buffers,
+    // from the oldest frame that may be rolled back to
+    assert(2 * (settings.max_rollback + settings.input_delay) < input_buffer_size);
+    // a checksum has to become final before the next one is calculated
+    assert(settings.max_rollback < checksum_interval);
+}
+
+uint32_t RollbackSession::confirmedFrame() const
+{
+    return std::min(current_frame, remote_count);
+}
+
+bool RollbackSession::update(InputBits local_keys)
+{
+    receivePackets();
+    rollBack();
+
+    if (current_frame >= remote_count + settings.max_rollback) {
+        m_stats.stalled_frames++;
+        sendInputs();
+        return false;
+    }
+
+    local_inputs[local_count % input_buffer_size] = local_keys;
+    local_count++;
+
+    game.saveState(current_frame % state_slots);
+    simulate(current_frame);
+    current_frame++;
+
+    window_frames++;
+    if (window_frames == frames_per_second) {
+        m_stats.resimulated_per_second = window_resimulated;
+        window_frames = 0;
+        window_resimulated = 0;
+    }
+
+    sendInputs();
+    return true;
+}
+
+void RollbackSession::poll()
+{
+    receivePackets();
+    rollBack();
+    sendInputs();
+}
+
+InputBits RollbackSession::remoteInput(uint32_t frame) const
+{
+    if (frame < remote_count)
+        return remote_inputs[frame % input_buffer_size];
+    if (remote_count > 0)
+        return remote_inputs[(remote_count - 1) % input_buffer_size];
+    return 0;
+}
+
+void RollbackSession::simulate(uint32_t frame)
+{
+    const InputBits remote_keys = remoteInput(frame);
+    used_remote_inputs[frame % input_buffer_size] = remote_keys;
+
+    std::array<InputBits, player_count> keys;
+    keys[local_player] = local_inputs[frame % input_buffer_size];
+    keys[1 - local_player] = remote_keys;
+
+    // a rolled back frame replaces the hash of its earlier simulation
+    if (frame % checksum_interval == 0) {
+        has_local_checksum = true;
+        local_checksum_frame = frame;
+        local_checksum = game.stateHash();
+    }
+    game.advanceFrame(keys);
+}
+
+void RollbackSession::rollBack()
+{
+    if (!needs_rollback)
+        return;
+
+    const unsigned depth = current_frame - rollback_frame;
+    assert(depth <= settings.max_rollback);
+
+    game.loadState(rollback_frame % state_slots);
+    for (uint32_t frame = rollback_frame; frame < current_frame; frame++) {
+        if (frame != rollback_frame)
+            game.saveState(frame % state_slots);
+        simulate(frame);
+    }
+
+    needs_rollback = false;
+    m_stats.rollbacks++;
+    m_stats.last_rollback_depth = depth;
+    m_stats.max_rollback_depth = std::max(m_stats.max_rollback_depth, depth);
+    m_stats.resimulated_frames += depth;
+    window_resimulated += depth;
+}
+
+void RollbackSession::receivePackets()
+{
+    Packet packet;
+    while (transport.receive(packet))
+        readPacket(packet);
+}
+
+void RollbackSession::readPacket(const Packet& packet)
+{
+    if (packet.size() < min_packet_size)
+        return;
+
+    PacketReader reader(packet);
+    if (reader.readByte() != inputs_packet_tag)
+        return;
+
+    const uint64_t first_frame = reader.readVarint();
+    const uint64_t acked = reader.readVarint();
+
+    // the frame is sent with an offset of one, zero means no checksum
+    const uint64_t checksum_frame = reader.readVarint();
+    if (checksum_frame > 0) {
+        uint64_t checksum = 0;
+        for (unsigned i = 0; i < 8; i++)
+            checksum |= static_cast<uint64_t>(reader.readByte()) << (8 * i);
+        if (!reader.ok())
+            return;
+        if (!has_remote_checksum || checksum_frame - 1 > remote_checksum_frame) {
+            has_remote_checksum = true;
+            remote_checksum_frame = checksum_frame - 1;
+            remote_checksum = checksum;
+        }
+    }
+
+    const uint8_t count = reader.readByte();
+    if (!reader.ok())
+        return;
+
+    local_acked = std::max<uint64_t>(local_acked, std::min<uint64_t>(acked, local_count));
+
+    for (uint64_t frame = first_frame; frame < first_frame + count; frame++) {
+        InputBits keys = reader.readByte();
+        keys |= reader.readByte() << 8;
+        if (!reader.ok())
+            return;
+
+        // skip the already known inputs; stop at a gap, the missing
+        // inputs will arrive again with the later packets
+        if (frame < remote_count)
+            continue;
+        if (frame > remote_count || frame >= current_frame + input_buffer_size / 2)
+            return;
+
+        remote_inputs[frame % input_buffer_size] = keys;
+        remote_count++;
+
+        const bool mispredicted = frame < current_frame
+            && keys != used_remote_inputs[frame % input_buffer_size];
+        if (mispredicted && (!needs_rollback || frame < rollback_frame)) {
+            needs_rollback = true;
+            rollback_frame = frame;
+        }
+    }
+}
+
+void RollbackSession::sendInputs()
+{
+    assert(local_count - local_acked <= input_buffer_size);
+
+    Packet packet;
+    packet.push_back(inputs_packet_tag);
+    writeVarint(packet, local_acked);
+    writeVarint(packet, remote_count);
+    if (localChecksumFinal()) {
+        compareChecksums();
+        writeVarint(packet, local_checksum_frame + 1);
+        for (unsigned i = 0; i < 8; i++)
+            packet.push_back(static_cast<uint8_t>(local_checksum >> (8 * i)));
+    }
+    else
+        writeVarint(packet, 0);
+    packet.push_back(static_cast<uint8_t>(local_count - local_acked));
+    for (uint32_t frame = local_acked; frame < local_count; frame++) {
+        const InputBits keys = local_inputs[frame % input_buffer_size];
+        packet.push_back(keys & 0xFF);
+        packet.push_back(keys >> 8);
+    }
+    transport.send(packet);
+}
+
+bool RollbackSession::localChecksumFinal() const
+{
+    // every input before the frame is known, and there's no pending rollback
+    // (the inputs are sent only after rolling back)
+    return has_local_checksum && local_checksum_frame <= remote_count && !needs_rollback;
+}
+
+void RollbackSession::compareChecksums()
+{
+    const bool comparable = has_remote_checksum
+        && remote_checksum_frame == local_checksum_frame
+        && local_checksum_frame >= next_compared_frame;
+    if (!comparable || m_stats.desynced)
+        return;
+
+    next_compared_frame = local_checksum_frame + 1;
+    if (remote_checksum == local_checksum)
+        m_stats.verified_checksums++;
+    else {
+        m_stats.desynced = true;
+        m_stats.desync_frame = local_checksum_frame;
+    }
+}
+
+} // namespace Net
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Transport.h"
+#include "system/Event.h"
+
+#include <array>
+#include <vector>
+#include <stdint.h>
+
+
+namespace Net {
+
+/// The key states of a player in a frame, where bit N is the state of the Nth InputType
+using InputBits = uint16_t;
+/// The key states after the input events
+InputBits applyEvents(InputBits, const std::vector<InputEvent>&);
+/// Add the input events that change the previous key states to the current ones
+void toEvents(InputBits previous, InputBits current, DeviceID, std::vector<InputEvent>& output);
+
+constexpr unsigned player_count = 2;
+
+
+/// A deterministic simulation, that can save its state and go back to it
+class RollbackGame {
+public:
+    virtual ~RollbackGame() = default;
+
+    /// Save the current state into a slot, overwriting the previous state there
+    virtual void saveState(unsigned slot) = 0;
+    /// Continue from the state saved into the slot
+    virtual void loadState(unsigned slot) = 0;
+    /// Simulate one frame with the key states of the players
+    virtual void advanceFrame(const std::array<InputBits, player_count>&) = 0;
+    /// A hash of the current state, which is the same on both sides while
+    /// the two games are in sync
+    virtual uint64_t stateHash() const = 0;
+};
+
+
+struct RollbackSettings {
+    /// The local inputs are applied this many frames later, which
+    /// hides small latencies without rolling back
+    unsigned input_delay = 2;
+    /// The local game can run at most this many frames ahead of the
+    /// remote inputs; it waits for the other side after that
+    unsigned max_rollback = 8;
+};
+
+struct RollbackStats {
+    uint64_t rollbacks = 0;
+    /// The number of frames re-simulated by the last and the longest rollback
+    unsigned last_rollback_depth = 0;
+    unsigned max_rollback_depth = 0;
+    uint64_t resimulated_frames = 0;
+    /// The number of frames re-simulated during the last second of the match
+    unsigned resimulated_per_second = 0;
+    /// The updates when the local game had to wait for the other side
+    uint64_t stalled_frames = 0;
+    /// The number of state checksums that matched the other side's
+    uint64_t verified_checksums = 0;
+    /// The two sides had different states at the beginning of `desync_frame`;
+    /// the games can't get back in sync after that
+    bool desynced = false;
+    uint32_t desync_frame = 0;
+};
+
+
+/// Runs a match of two players on separate machines. Both sides simulate
+/// the whole match, and send only their own inputs to the other one.
+/// While the remote inputs of a frame have not arrived yet, they are
+/// predicted to be the same as the last known ones. When the real inputs
+/// arrive and they differ from the prediction, the game is restored to
+/// that frame, and the frames since then are simulated again.
+///
+/// The packets contain every local input not yet confirmed by the other
+/// side, so lost packets don't have to be detected or resent separately.
+///
+/// To detect desyncs, the state of every `checksum_interval`th frame is
+/// hashed once it was simulated with the real inputs, and the latest hash
+/// is sent along with the inputs to the other side.
+///
+/// The battles of the game and the headless `VersusMatch` of the simulator
+/// are the games of the sessions; they share the rules of the match.
+class RollbackSession {
+public:
+    /// The game has to provide `stateSlots()` slots for its saved states
+    RollbackSession(RollbackGame&, Transport&, unsigned local_player,
+                    const RollbackSettings& = RollbackSettings());
+
+    static unsigned stateSlots(const RollbackSettings& settings) { return settings.max_rollback + 1; }
+    /// The number of frames between two state checksums
+    static constexpr unsigned checksum_interval = 60;
+
+    /// Simulate the next frame, with the current local key states; returns
+    /// false if the frame can't be simulated yet, because the other side
+    /// is too far behind
+    bool update(InputBits local_keys);
+    /// Process the received inputs, without simulating a new frame
+    void poll();
+
+    /// The number of simulated frames
+    uint32_t frame() const { return current_frame; }
+    /// The frames before this one were simulated with the real inputs of both sides
+    uint32_t confirmedFrame() const;
+    const RollbackStats& stats() const { return m_stats; }
+
+private:
+    /// The inputs are stored for this many frames
+    static constexpr unsigned input_buffer_size = 64;
+
+    RollbackGame& game;
+    Transport& transport;
+    const unsigned local_player;
+    const RollbackSettings settings;
+    const unsigned state_slots;
+
+    uint32_t current_frame;
+
+    /// The local inputs are known for the frames before `local_count`,
+    /// and the other side has received them before `local_acked`
+    std::array<InputBits, input_buffer_size> local_inputs;
+    uint32_t local_count;
+    uint32_t local_acked;
+
+    /// The remote inputs are known for the frames before `remote_count`
+    std::array<InputBits, input_buffer_size> remote_inputs;
+    uint32_t remote_count;
+    /// The remote inputs the frames were simulated with, including the predicted ones
+    std::array<InputBits, input_buffer_size> used_remote_inputs;
+
+    bool needs_rollback;
+    uint32_t rollback_frame;
+
+    /// The hash of the state at the beginning of `local_checksum_frame`;
+    /// it's final once the inputs before that frame are all known
+    bool has_local_checksum;
+    uint32_t local_checksum_frame;
+    uint64_t local_checksum;
+    /// The latest final checksum received from the other side
+    bool has_remote_checksum;
+    uint32_t remote_checksum_frame;
+    uint64_t remote_checksum;
+    /// The frames before this one were already compared
+    uint32_t next_compared_frame;
+
+    RollbackStats m_stats;
+    unsigned window_frames;
+    unsigned window_resimulated;
+
+    InputBits remoteInput(uint32_t frame) const;
+    void simulate(uint32_t frame);
+    void rollBack();
+
+    void receivePackets();
+    void readPacket(const Packet&);
+    void sendInputs();
+    bool localChecksumFinal() const;
+    void compareChecksums();
+};
+
+} // namespace Net
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+
+/// Network play: the matches are simulated on every side, and only the
+/// inputs of the players are exchanged (see Rollback.h).
+namespace Net {
+
+using Packet = std::vector<uint8_t>;
+
+/// An unreliable, unordered datagram connection to the other side
+/// of a match. Packets may be lost, duplicated or reordered.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    /// Send a packet; never blocks
+    virtual void send(const Packet&) = 0;
+    /// Take the next received packet; returns false if there's none
+    virtual bool receive(Packet& output) = 0;
+};
+
+} // namespace Net
@@ -0,0 +1,151 @@
+#include "UdpTransport.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+
+namespace Net {
+
+namespace {
+#ifdef _WIN32
+using SocketHandle = SOCKET;
+constexpr SocketHandle invalid_socket = INVALID_SOCKET;
+void closeSocket(SocketHandle handle) { closesocket(handle); }
+#else
+using SocketHandle = int;
+constexpr SocketHandle invalid_socket = -1;
+void closeSocket(SocketHandle handle) { close(handle); }
+#endif
+} // namespace
+
+
+struct UdpTransport::Impl {
+    SocketHandle handle;
+    sockaddr_storage peer_address;
+    socklen_t peer_address_size;
+#ifdef _WIN32
+    bool wsa_started;
+#endif
+
+    Impl()
+        : handle(invalid_socket)
+        , peer_address()
+        , peer_address_size(0)
+#ifdef _WIN32
+        , wsa_started(false)
+#endif
+    {}
+
+    ~Impl() {
+        if (handle != invalid_socket)
+            closeSocket(handle);
+#ifdef _WIN32
+        if (wsa_started)
+            WSACleanup();
+#endif
+    }
+
+    void open(uint16_t local_port) {
+#ifdef _WIN32
+        WSADATA wsa_data;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+            throw std::runtime_error("Could not initialize the network");
+        wsa_started = true;
+#endif
+        handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (handle == invalid_socket)
+            throw std::runtime_error("Could not create a UDP socket");
+
+#ifdef _WIN32
+        u_long non_blocking = 1;
+        const bool blocking_changed = ioctlsocket(handle, FIONBIO, &non_blocking) == 0;
+#else
+        const bool blocking_changed = fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+        if (!blocking_changed)
+            throw std::runtime_error("Could not make the UDP socket non-blocking");
+
+        sockaddr_in local_address;
+        std::memset(&local_address, 0, sizeof(local_address));
+        local_address.sin_family = AF_INET;
+        local_address.sin_addr.s_addr = htonl(INADDR_ANY);
+        local_address.sin_port = htons(local_port);
+        if (bind(handle, reinterpret_cast<sockaddr*>(&local_address), sizeof(local_address)) != 0)
+            throw std::runtime_error("Could not use the UDP port " + std::to_string(local_port));
+    }
+
+    void resolvePeer(const std::string& host, uint16_t port) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+
+        addrinfo* result = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || !result)
+            throw std::runtime_error("Could not find the address of " + host);
+
+        std::memcpy(&peer_address, result->ai_addr, result->ai_addrlen);
+        peer_address_size = result->ai_addrlen;
+        freeaddrinfo(result);
+    }
+
+    bool isPeer(const sockaddr_storage& address) const {
+        const auto& peer = reinterpret_cast<const sockaddr_in&>(peer_address);
+        const auto& other = reinterpret_cast<const sockaddr_in&>(address);
+        return other.sin_family == AF_INET
+            && other.sin_addr.s_addr == peer.sin_addr.s_addr
+            && other.sin_port == peer.sin_port;
+    }
+};
+
+
+UdpTransport::UdpTransport(uint16_t local_port, const std::string& host, uint16_t remote_port)
+    : impl(std::make_unique<Impl>())
+{
+    impl->open(local_port);
+    impl->resolvePeer(host, remote_port);
+}
+
+UdpTransport::~UdpTransport() = default;
+
+void UdpTransport::send(const Packet& packet)
+{
+    // a failed send is the same as a lost packet
+    sendto(impl->handle, reinterpret_cast<const char*>(packet.data()), packet.size(), 0,
+           reinterpret_cast<const sockaddr*>(&impl->peer_address), impl->peer_address_size);
+}
+
+bool UdpTransport::receive(Packet& output)
+{
+    sockaddr_storage source;
+    while (true) {
+        output.resize(max_packet_size);
+        socklen_t source_size = sizeof(source);
+        const auto received = recvfrom(impl->handle, reinterpret_cast<char*>(output.data()), output.size(), 0,
+                                       reinterpret_cast<sockaddr*>(&source), &source_size);
+        if (received < 0) {
+            output.clear();
+            return false;
+        }
+
+        // only the other side can play the match, the packets of others
+        // (and the empty ones) are dropped, and the next one is read instead
+        if (received > 0 && impl->isPeer(source)) {
+            output.resize(received);
+            return true;
+        }
+    }
+}
+
+} // namespace Net
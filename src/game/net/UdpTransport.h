@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Transport.h"
+
+#include <memory>
+#include <string>
+
+
+namespace Net {
+
+/// A transport over a non-blocking UDP socket, between two configured
+/// addresses; the packets from every other address are dropped.
+/// Throws `std::runtime_error` if the socket can't be created or the
+/// address is invalid.
+class UdpTransport : public Transport {
+public:
+    /// Exchange packets with the other side at `host:remote_port`
+    UdpTransport(uint16_t local_port, const std::string& host, uint16_t remote_port);
+    ~UdpTransport();
+
+    void send(const Packet&) final;
+    bool receive(Packet& output) final;
+
+    /// The largest packet that can be received
+    static constexpr unsigned max_packet_size = 1024;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Net
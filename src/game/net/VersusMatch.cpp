@@ -0,0 +1,89 @@
+#include "VersusMatch.h"
+
+#include "game/util/Hash.h"
+
+#include <assert.h>
+
+
+namespace Net {
+
+VersusMatch::VersusMatch(const WellConfig& config, uint64_t seed, unsigned state_slots)
+    : rules(GameMode::MP_BATTLE)
+    , rng(seed)
+    , keys{}
+    , frame_count(0)
+    , saved_states(state_slots)
+{
+    for (unsigned i = 0; i < player_count; i++) {
+        players[i] = std::make_unique<HeadlessPlayer>(rules, config, seed);
+        player_states.push_back(&players[i]->state.gameplay);
+    }
+    for (unsigned i = 0; i < player_count; i++)
+        registerObservers(i);
+}
+
+VersusMatch::~VersusMatch() = default;
+
+void VersusMatch::saveState(unsigned slot)
+{
+    auto& saved = saved_states.at(slot);
+    saved.frame_count = frame_count;
+    saved.rng = rng.snapshot();
+    saved.keys = keys;
+    for (unsigned i = 0; i < player_count; i++)
+        players[i]->save(saved.players[i]);
+}
+
+void VersusMatch::loadState(unsigned slot)
+{
+    const auto& saved = saved_states.at(slot);
+    frame_count = saved.frame_count;
+    rng.restore(saved.rng);
+    keys = saved.keys;
+    for (unsigned i = 0; i < player_count; i++)
+        players[i]->restore(saved.players[i]);
+}
+
+uint64_t VersusMatch::stateHash() const
+{
+    uint64_t hash = Hash::combine(frame_count, rng.snapshot());
+    for (unsigned i = 0; i < player_count; i++) {
+        hash = Hash::combine(hash, keys[i]);
+        hash = Hash::combine(hash, players[i]->stateHash());
+    }
+    return hash;
+}
+
+void VersusMatch::advanceFrame(const std::array<InputBits, player_count>& new_keys)
+{
+    if (isOver())
+        return;
+
+    for (unsigned i = 0; i < player_count; i++) {
+        HeadlessPlayer& player = *players[i];
+        if (!player.isPlaying())
+            continue;
+
+        input_events.clear();
+        toEvents(keys[i], new_keys[i], i, input_events);
+        keys[i] = new_keys[i];
+        player.update(input_events);
+    }
+    for (unsigned i = 0; i < player_count; i++)
+        rules.updateIncomingAttacks(*player_states[i]);
+    frame_count++;
+}
+
+void VersusMatch::registerObservers(unsigned index)
+{
+    HeadlessPlayer& player = *players[index];
+
+    player.setAttackHandler([this, index](unsigned lines){
+        rules.sendAttack(rng, player_states, index, lines);
+    });
+    player.well.registerObserver(WellEvent::Type::GAME_OVER, [this](const WellEvent&){
+        rules.finishBattleMaybe(player_states);
+    });
+}
+
+} // namespace Net
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Rollback.h"
+#include "game/HeadlessPlayer.h"
+#include "game/MatchRules.h"
+#include "game/WellConfig.h"
+
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace Net {
+
+/// A headless battle between two players, played by the rules of the battle
+/// mode, for running the netplay sessions without the game (eg. in the simulator).
+class VersusMatch : public RollbackGame {
+public:
+    VersusMatch(const WellConfig&, uint64_t seed, unsigned state_slots);
+    ~VersusMatch();
+
+    void saveState(unsigned slot) final;
+    void loadState(unsigned slot) final;
+    void advanceFrame(const std::array<InputBits, player_count>&) final;
+    uint64_t stateHash() const final;
+
+    /// The number of simulated frames; the frames after the end
+    /// of the match don't change anything, and are not counted
+    uint32_t frame() const { return frame_count; }
+    const HeadlessPlayer& player(unsigned index) const { return *players.at(index); }
+    const Well& well(unsigned index) const { return players.at(index)->well; }
+    /// False if the player has topped out, or the other player has
+    bool isPlaying(unsigned index) const { return players.at(index)->isPlaying(); }
+    bool isOver() const { return !isPlaying(0) && !isPlaying(1); }
+
+private:
+    const MatchRules rules;
+    Random rng;
+    std::array<std::unique_ptr<HeadlessPlayer>, player_count> players;
+    std::vector<MatchRules::PlayerState*> player_states;
+    /// The key states of the previous frame
+    std::array<InputBits, player_count> keys;
+    uint32_t frame_count;
+
+    struct SavedState {
+        uint32_t frame_count;
+        uint64_t rng;
+        std::array<InputBits, player_count> keys;
+        std::array<HeadlessPlayer::Snapshot, player_count> players;
+    };
+    static_assert(std::is_trivially_copyable<SavedState>::value, "Match states must be plain data");
+    std::vector<SavedState> saved_states;
+
+    std::vector<InputEvent> input_events;
+
+    void registerObservers(unsigned index);
+};
+
+} // namespace Net
@@ -0,0 +1,189 @@
+#include "Keyframe.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace Replay {
+
+void KeyframeWriter::writeByte(uint8_t value)
+{
+    buffer.push_back(value);
+}
+
+void KeyframeWriter::writeVarint(uint64_t value)
+{
+    // 7 bits per byte, the high bit is set if more bytes follow
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void KeyframeWriter::writeSigned(int64_t value)
+{
+    writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void KeyframeWriter::writeDuration(Duration duration)
+{
+    // the tick length of the clock may differ between platforms
+    writeSigned(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+void KeyframeWriter::writeWell(const Well::Snapshot& well)
+{
+    // only the rows under the highest mino are stored,
+    // two cells per byte, with the piece type + 1 (or 0 if empty)
+    unsigned top_row = Well::height;
+    for (unsigned col = 0; col < Well::width; col++)
+        top_row = std::min(top_row, well.board.columnTop(col));
+
+    writeVarint(Well::height - top_row);
+    for (unsigned row = top_row; row < Well::height; row++) {
+        for (unsigned col = 0; col < Well::width; col += 2) {
+            uint8_t cells = 0;
+            for (unsigned i = 0; i < 2 && col + i < Well::width; i++) {
+                if (well.board.isOccupied(row, col + i))
+                    cells |= (static_cast<uint8_t>(well.board.cellType(row, col + i)) + 1) << (4 * i);
+            }
+            writeByte(cells);
+        }
+    }
+
+    writeBool(well.gameover);
+    writeDuration(well.temporal_disable_timer);
+    writeBool(well.has_active_piece);
+    writeByte(static_cast<uint8_t>(well.active_piece_type));
+    writeByte(static_cast<uint8_t>(well.active_piece_orientation));
+    writeSigned(well.active_piece_x);
+    writeByte(well.active_piece_y);
+    writeDuration(well.softdrop_timer);
+    writeVarint(well.pending_cleared_rows);
+    writeByte(static_cast<uint8_t>(well.last_lineclear_type));
+    writeVarint(well.garbage_rng);
+
+    writeDuration(well.das.das_timer);
+    writeDuration(well.gravity.gravity_delay);
+    writeDuration(well.gravity.gravity_timer);
+    writeBool(well.gravity.skip_gravity);
+    writeVarint(well.input.keystates);
+    writeVarint(well.input.previous_keystates);
+    writeByte(well.lock_delay.reset_counter);
+    writeByte(well.lock_delay.current_lowest_row);
+    writeDuration(well.lock_delay.countdown_elapsed);
+    writeBool(well.lock_delay.countdown_running);
+    writeBool(well.tspin.allowed);
+    writeByte(well.tspin.last_rotation_point);
+}
+
+void KeyframeWriter::writePieceQueue(const PieceQueue::Snapshot& queue)
+{
+    writeVarint(queue.rng);
+    writeByte(queue.size);
+    for (unsigned i = 0; i < queue.size; i++)
+        writeByte(static_cast<uint8_t>(queue.pieces[i]));
+}
+
+
+KeyframeReader::KeyframeReader(const std::vector<uint8_t>& data)
+    : data(data)
+    , read_pos(0)
+{}
+
+void KeyframeReader::invalidData()
+{
+    throw std::runtime_error("Invalid keyframe in the replay");
+}
+
+uint8_t KeyframeReader::readByte()
+{
+    if (read_pos >= data.size())
+        invalidData();
+    return data[read_pos++];
+}
+
+uint64_t KeyframeReader::readVarint()
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const uint8_t byte = readByte();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    invalidData();
+}
+
+int64_t KeyframeReader::readSigned()
+{
+    const uint64_t raw = readVarint();
+    return static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+}
+
+Duration KeyframeReader::readDuration()
+{
+    return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(readSigned()));
+}
+
+void KeyframeReader::readWell(Well::Snapshot& well)
+{
+    const uint64_t row_count = readVarint();
+    if (row_count > Well::height)
+        invalidData();
+
+    well.board.clear();
+    for (unsigned row = Well::height - row_count; row < Well::height; row++) {
+        for (unsigned col = 0; col < Well::width; col += 2) {
+            const uint8_t cells = readByte();
+            for (unsigned i = 0; i < 2 && col + i < Well::width; i++) {
+                const uint8_t cell = (cells >> (4 * i)) & 0xF;
+                if (cell > static_cast<uint8_t>(PieceType::GARBAGE) + 1)
+                    invalidData();
+                if (cell)
+                    well.board.setCell(row, col + i, static_cast<PieceType>(cell - 1));
+            }
+        }
+    }
+
+    well.gameover = readBool();
+    well.temporal_disable_timer = readDuration();
+    well.has_active_piece = readBool();
+    well.active_piece_type = readEnum(PieceType::Z);
+    well.active_piece_orientation = readEnum(PieceDirection::WEST);
+    well.active_piece_x = static_cast<int8_t>(readSigned());
+    well.active_piece_y = readByte();
+    well.softdrop_timer = readDuration();
+    well.pending_cleared_rows = readVarint();
+    well.last_lineclear_type = readEnum(LineClearType::MINI_TSPIN);
+    well.garbage_rng = readVarint();
+    if (well.active_piece_x < -3 || well.active_piece_x >= static_cast<int>(Well::width)
+        || well.active_piece_y >= Well::height)
+        invalidData();
+
+    well.das.das_timer = readDuration();
+    well.gravity.gravity_delay = readDuration();
+    well.gravity.gravity_timer = readDuration();
+    well.gravity.skip_gravity = readBool();
+    well.input.keystates = static_cast<uint16_t>(readVarint());
+    well.input.previous_keystates = static_cast<uint16_t>(readVarint());
+    well.lock_delay.reset_counter = readByte();
+    well.lock_delay.current_lowest_row = readByte();
+    well.lock_delay.countdown_elapsed = readDuration();
+    well.lock_delay.countdown_running = readBool();
+    well.tspin.allowed = readBool();
+    well.tspin.last_rotation_point = readByte();
+}
+
+void KeyframeReader::readPieceQueue(PieceQueue::Snapshot& queue)
+{
+    queue.rng = readVarint();
+    queue.size = readByte();
+    if (queue.size > PieceQueue::Snapshot::max_size)
+        invalidData();
+    for (unsigned i = 0; i < queue.size; i++)
+        queue.pieces[i] = readEnum(PieceType::Z);
+}
+
+} // namespace Replay
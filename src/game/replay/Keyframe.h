@@ -0,0 +1,68 @@
+#pragma once
+
+#include "game/Timing.h"
+#include "game/components/PieceQueue.h"
+#include "game/components/Well.h"
+
+#include <vector>
+#include <stdint.h>
+
+
+namespace Replay {
+
+/// Serializes a saved game state for a keyframe of a replay. The values are
+/// stored in a compact, portable form, independent of the memory layout of
+/// the snapshot types, and have to be read back in the same order.
+class KeyframeWriter {
+public:
+    void writeByte(uint8_t);
+    void writeBool(bool value) { writeByte(value); }
+    void writeVarint(uint64_t);
+    /// Signed values use zigzag encoding, so small negative values stay short
+    void writeSigned(int64_t);
+    void writeDuration(Duration);
+
+    void writeWell(const Well::Snapshot&);
+    void writePieceQueue(const PieceQueue::Snapshot&);
+
+    const std::vector<uint8_t>& data() const { return buffer; }
+
+private:
+    std::vector<uint8_t> buffer;
+};
+
+
+/// Reads the values of a keyframe. Throws `std::runtime_error` if the data
+/// is shorter than expected, or a value is out of its valid range.
+class KeyframeReader {
+public:
+    explicit KeyframeReader(const std::vector<uint8_t>& data);
+
+    uint8_t readByte();
+    bool readBool() { return readByte(); }
+    uint64_t readVarint();
+    int64_t readSigned();
+    Duration readDuration();
+    /// Read an enum value, stored in one byte; `last` is its largest valid value
+    template <typename Enum>
+    Enum readEnum(Enum last) {
+        const uint8_t value = readByte();
+        if (value > static_cast<uint8_t>(last))
+            invalidData();
+        return static_cast<Enum>(value);
+    }
+
+    void readWell(Well::Snapshot&);
+    void readPieceQueue(PieceQueue::Snapshot&);
+
+    /// True if every value was read
+    bool atEnd() const { return read_pos == data.size(); }
+
+private:
+    const std::vector<uint8_t>& data;
+    size_t read_pos;
+
+    [[noreturn]] static void invalidData();
+};
+
+} // namespace Replay
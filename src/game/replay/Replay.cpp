@@ -0,0 +1,33 @@
+#include "Replay.h"
+
+
+namespace Replay {
+
+Record Record::fromInput(InputType input, bool pressed, DeviceID device_id)
+{
+    Record record {};
+    record.type = EventType::INPUT;
+    record.device_id = device_id;
+    record.input = input;
+    record.pressed = pressed;
+    return record;
+}
+
+Record Record::fromWindow(WindowEvent window)
+{
+    Record record {};
+    record.type = EventType::WINDOW;
+    record.window = window;
+    return record;
+}
+
+Record Record::fromDevice(DeviceEventType device_event, DeviceID device_id)
+{
+    Record record {};
+    record.type = EventType::DEVICE;
+    record.device_id = device_id;
+    record.device_event = device_event;
+    return record;
+}
+
+} // namespace Replay
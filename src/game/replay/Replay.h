@@ -0,0 +1,96 @@
+#pragma once
+
+#include "game/GameMode.h"
+#include "game/WellConfig.h"
+#include "system/Event.h"
+
+#include <array>
+#include <stdint.h>
+
+
+/// Replays store the inputs of a game, from which the whole game can be
+/// reproduced. Every random decision of a match depends only on the seed,
+/// so the seed, the settings and the input events are enough.
+///
+/// In the file, the header is followed by the records. Every record starts
+/// with its frame distance from the previous record (varint), then a tag byte:
+/// - the tag of an input record is the input type (high 4 bits),
+///   the pressed state (bit 3) and the slot of the device (low 3 bits)
+/// - the other records have a ControlTag, followed by their payload bytes
+///
+/// To make seeking fast in long replays, the state of the game is also saved
+/// periodically into keyframes. Seeking starts from the last keyframe before
+/// the target frame, so only a limited number of frames has to be simulated.
+///
+/// A hash of the game state is also saved every second, so during the playback
+/// a replay that doesn't reproduce the original game is detected at the frame
+/// where the states differ, not just at the end.
+namespace Replay {
+
+/// The settings of the recorded game
+struct Header {
+    /// The seed of the match seed generator of the game state
+    uint64_t seed;
+    GameMode game_mode;
+    WellConfig well_config;
+    /// The format version of a replay that was read from a file
+    uint8_t version;
+
+    Header()
+        : seed(0)
+        , game_mode(GameMode::SP_MARATHON)
+        , version(0)
+    {}
+};
+
+
+/// A recorded event; the same as the game's events, except raw inputs,
+/// which are not recorded
+struct Record {
+    EventType type;
+    /// The source of input and device events
+    DeviceID device_id;
+    InputType input;
+    bool pressed;
+    WindowEvent window;
+    DeviceEventType device_event;
+
+    static Record fromInput(InputType, bool pressed, DeviceID);
+    static Record fromWindow(WindowEvent);
+    static Record fromDevice(DeviceEventType, DeviceID);
+};
+
+
+constexpr std::array<char, 4> file_magic = {{'O', 'B', 'R', 'P'}};
+constexpr uint8_t format_version = 4;
+/// The oldest version that can still be read; it has no keyframes and checksums
+constexpr uint8_t min_format_version = 1;
+/// The first version with the attacks in flight in the keyframes; the older
+/// keyframes were only saved when there were no attacks in flight
+constexpr uint8_t keyframe_attacks_version = 4;
+/// The number of devices that can be addressed directly by the input records
+constexpr uint8_t device_slot_count = 8;
+/// The number of frames between two keyframes (10 seconds at 60 Hz);
+/// a keyframe may be delayed if the game can't be saved at that frame
+constexpr uint32_t keyframe_interval = 10 * 60;
+/// The number of frames between two state checksums (1 second at 60 Hz)
+constexpr uint32_t checksum_interval = 60;
+
+enum class ControlTag : uint8_t {
+    /// The end of the replay
+    END = 0xF0,
+    /// Assign a device to a slot; payload: slot, device ID
+    DEVICE_SLOT = 0xF1,
+    /// payload: WindowEvent
+    WINDOW = 0xF2,
+    /// payload: DeviceEventType, device ID
+    DEVICE = 0xF3,
+    /// The saved game state at the beginning of the frame, see Keyframe.h;
+    /// payload: size (varint), the state bytes
+    KEYFRAME = 0xF4,
+    /// The hash of the game state at the beginning of the frame;
+    /// payload: 8 bytes, little endian
+    CHECKSUM = 0xF5,
+};
+
+} // namespace Replay
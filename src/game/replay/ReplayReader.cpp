@@ -0,0 +1,282 @@
+#include "ReplayReader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+namespace Replay {
+
+namespace {
+class TruncatedData : public std::runtime_error {
+public:
+    TruncatedData() : std::runtime_error("Unexpected end of replay data") {}
+};
+
+std::vector<uint8_t> loadFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not open replay file '" + path + "'");
+
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+} // namespace
+
+
+ReplayReader::ReplayReader(const std::string& path)
+    : ReplayReader(loadFile(path))
+{}
+
+ReplayReader::ReplayReader(std::vector<uint8_t>&& input)
+    : data(std::move(input))
+    , read_pos(0)
+    , first_record_pos(0)
+    , total_frames(0)
+    , current_frame(0)
+    , finished(false)
+    , has_next_record(false)
+    , next_record_frame(0)
+    , has_frame_checksum(false)
+    , frame_checksum(0)
+{
+    slot_devices.fill(0);
+
+    try {
+        readHeader();
+    }
+    catch (const TruncatedData&) {
+        throw std::runtime_error("The replay file is too short");
+    }
+    first_record_pos = read_pos;
+
+    // read through the whole replay once, to find its length and keyframes
+    std::vector<Record> records;
+    rewind();
+    while (nextFrame(records)) {}
+    total_frames = current_frame;
+    rewind();
+}
+
+void ReplayReader::rewind()
+{
+    read_pos = first_record_pos;
+    current_frame = 0;
+    finished = false;
+    slot_devices.fill(0);
+    has_frame_checksum = false;
+    peekNextRecord();
+}
+
+bool ReplayReader::frameChecksum(uint64_t& output) const
+{
+    if (has_frame_checksum)
+        output = frame_checksum;
+    return has_frame_checksum;
+}
+
+const ReplayReader::Keyframe* ReplayReader::findKeyframe(uint32_t frame) const
+{
+    const auto it = std::upper_bound(keyframes.cbegin(), keyframes.cend(), frame,
+        [](uint32_t target, const Keyframe& keyframe){ return target < keyframe.frame; });
+    if (it == keyframes.cbegin())
+        return nullptr;
+    return &*std::prev(it);
+}
+
+std::vector<uint8_t> ReplayReader::seek(const Keyframe& keyframe)
+{
+    read_pos = keyframe.next_record_pos;
+    current_frame = keyframe.frame;
+    finished = false;
+    slot_devices = keyframe.slot_devices;
+    has_frame_checksum = false;
+    peekNextRecord();
+
+    const auto state_begin = data.cbegin() + keyframe.state_pos;
+    return std::vector<uint8_t>(state_begin, state_begin + keyframe.state_size);
+}
+
+void ReplayReader::readHeader()
+{
+    if (!canRead(file_magic.size())
+        || !std::equal(file_magic.cbegin(), file_magic.cend(), data.cbegin()))
+        throw std::runtime_error("Not a replay file");
+    read_pos += file_magic.size();
+
+    const uint8_t version = readByte();
+    if (version < min_format_version || version > format_version)
+        throw std::runtime_error("Unsupported replay version " + std::to_string(version));
+    m_header.version = version;
+
+    m_header.seed = readVarint();
+
+    const uint8_t game_mode = readByte();
+    if (game_mode > static_cast<uint8_t>(GameMode::MP_MARATHON_SIMPLE))
+        throw std::runtime_error("Invalid game mode in the replay");
+    m_header.game_mode = static_cast<GameMode>(game_mode);
+
+    auto& well = m_header.well_config;
+    for (unsigned short* value : {&well.starting_gravity, &well.shift_normal, &well.shift_turbo,
+                                  &well.max_next_pieces, &well.lock_delay}) {
+        const uint64_t raw = readVarint();
+        if (raw > 0xFFFF)
+            throw std::runtime_error("Invalid well setting in the replay");
+        *value = raw;
+    }
+
+    const uint8_t flags = readByte();
+    well.instant_harddrop = flags & 0x1;
+    well.tspin_enabled = flags & 0x2;
+    well.tspin_allow_wallblock = flags & 0x4;
+    well.tspin_allow_wallkick = flags & 0x8;
+
+    const uint8_t lock_delay_type = readByte();
+    const uint8_t rotation_style = readByte();
+    if (lock_delay_type > static_cast<uint8_t>(LockDelayType::INFINITE)
+        || rotation_style > static_cast<uint8_t>(RotationStyle::SRS))
+        throw std::runtime_error("Invalid well setting in the replay");
+    well.lock_delay_type = static_cast<LockDelayType>(lock_delay_type);
+    well.rotation_style = static_cast<RotationStyle>(rotation_style);
+}
+
+bool ReplayReader::nextFrame(std::vector<Record>& output)
+{
+    output.clear();
+    has_frame_checksum = false;
+    if (finished)
+        return false;
+
+    while (has_next_record && next_record_frame == current_frame) {
+        Record record;
+        switch (readRecord(record)) {
+            case ReadResult::EVENT:
+                output.push_back(record);
+                break;
+            case ReadResult::CONTROL:
+                break;
+            case ReadResult::END:
+                finished = true;
+                return false;
+            case ReadResult::TRUNCATED:
+                has_next_record = false;
+                break;
+        }
+        if (has_next_record)
+            peekNextRecord();
+    }
+
+    // without an end record, the replay ends after the last event
+    if (!has_next_record && output.empty()) {
+        finished = true;
+        return false;
+    }
+
+    current_frame++;
+    return true;
+}
+
+void ReplayReader::peekNextRecord()
+{
+    try {
+        const uint64_t distance = readVarint();
+        if (distance > 0xFFFFFFFFu - current_frame)
+            throw TruncatedData();
+
+        next_record_frame = current_frame + distance;
+        has_next_record = true;
+    }
+    catch (const TruncatedData&) {
+        has_next_record = false;
+    }
+}
+
+ReplayReader::ReadResult ReplayReader::readRecord(Record& output)
+{
+    try {
+        const uint8_t tag = readByte();
+        if (tag < 0xE0) {
+            const uint8_t slot = tag & 0x7;
+            output = Record::fromInput(static_cast<InputType>(tag >> 4), tag & 0x8, slot_devices[slot]);
+            return ReadResult::EVENT;
+        }
+
+        switch (static_cast<ControlTag>(tag)) {
+            case ControlTag::END:
+                return ReadResult::END;
+            case ControlTag::DEVICE_SLOT: {
+                const uint8_t slot = readByte();
+                const DeviceID device_id = static_cast<DeviceID>(readByte());
+                if (slot >= device_slot_count)
+                    return ReadResult::TRUNCATED;
+                slot_devices[slot] = device_id;
+                return ReadResult::CONTROL;
+            }
+            case ControlTag::WINDOW: {
+                const uint8_t window = readByte();
+                if (window > static_cast<uint8_t>(WindowEvent::FOCUS_GAINED))
+                    return ReadResult::TRUNCATED;
+                output = Record::fromWindow(static_cast<WindowEvent>(window));
+                return ReadResult::EVENT;
+            }
+            case ControlTag::DEVICE: {
+                const uint8_t type = readByte();
+                const DeviceID device_id = static_cast<DeviceID>(readByte());
+                if (type > static_cast<uint8_t>(DeviceEventType::DISCONNECTED))
+                    return ReadResult::TRUNCATED;
+                output = Record::fromDevice(static_cast<DeviceEventType>(type), device_id);
+                return ReadResult::EVENT;
+            }
+            case ControlTag::KEYFRAME: {
+                Keyframe keyframe;
+                keyframe.frame = current_frame;
+                keyframe.state_size = readVarint();
+                keyframe.state_pos = read_pos;
+                if (!canRead(keyframe.state_size))
+                    return ReadResult::TRUNCATED;
+                read_pos += keyframe.state_size;
+                keyframe.next_record_pos = read_pos;
+                keyframe.slot_devices = slot_devices;
+
+                // the keyframes are collected during the first reading
+                if (keyframes.empty() || keyframes.back().frame < keyframe.frame)
+                    keyframes.push_back(keyframe);
+                return ReadResult::CONTROL;
+            }
+            case ControlTag::CHECKSUM: {
+                uint64_t state_hash = 0;
+                for (unsigned i = 0; i < 8; i++)
+                    state_hash |= static_cast<uint64_t>(readByte()) << (8 * i);
+                has_frame_checksum = true;
+                frame_checksum = state_hash;
+                return ReadResult::CONTROL;
+            }
+        }
+    }
+    catch (const TruncatedData&) {}
+
+    // an unknown or incomplete record; the rest of the data can't be trusted
+    return ReadResult::TRUNCATED;
+}
+
+uint8_t ReplayReader::readByte()
+{
+    if (!canRead(1))
+        throw TruncatedData();
+    return data[read_pos++];
+}
+
+uint64_t ReplayReader::readVarint()
+{
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const uint8_t byte = readByte();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    throw TruncatedData();
+}
+
+} // namespace Replay
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Replay.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+
+namespace Replay {
+
+/// Reads a replay file, one frame at a time. Throws `std::runtime_error`
+/// if the file can't be read or it's not a valid replay. A replay without
+/// an end record (eg. the game has crashed) is read until the last
+/// complete record.
+///
+/// The keyframes are collected when the replay is opened, so the reading
+/// can continue from any of them later.
+class ReplayReader {
+public:
+    /// A saved game state in the replay
+    struct Keyframe {
+        /// The state is from the beginning of this frame
+        uint32_t frame;
+        size_t state_pos;
+        size_t state_size;
+        /// The position of the next record
+        size_t next_record_pos;
+        std::array<DeviceID, device_slot_count> slot_devices;
+    };
+
+    explicit ReplayReader(const std::string& path);
+    /// Read a replay from memory
+    explicit ReplayReader(std::vector<uint8_t>&& data);
+
+    const Header& header() const { return m_header; }
+
+    /// Read the records of the next frame; returns false if the replay has ended
+    bool nextFrame(std::vector<Record>& output);
+    /// The number of frames read so far
+    uint32_t frameCount() const { return current_frame; }
+    /// The number of frames in the whole replay
+    uint32_t totalFrames() const { return total_frames; }
+    /// The saved hash of the game state at the beginning of the last read
+    /// frame; returns false if the frame has no checksum
+    bool frameChecksum(uint64_t& output) const;
+
+    /// The last keyframe at or before the frame, or nullptr if there's none
+    const Keyframe* findKeyframe(uint32_t frame) const;
+    /// Continue reading from the frame of the keyframe; returns the saved state
+    std::vector<uint8_t> seek(const Keyframe&);
+    /// Continue reading from the first frame
+    void rewind();
+
+private:
+    std::vector<uint8_t> data;
+    size_t read_pos;
+    size_t first_record_pos;
+    Header m_header;
+    uint32_t total_frames;
+    std::vector<Keyframe> keyframes;
+
+    uint32_t current_frame;
+    bool finished;
+    /// The frame of the next unread record, if there's one
+    bool has_next_record;
+    uint32_t next_record_frame;
+    std::array<DeviceID, device_slot_count> slot_devices;
+    bool has_frame_checksum;
+    uint64_t frame_checksum;
+
+    enum class ReadResult : uint8_t {
+        EVENT,
+        CONTROL,
+        END,
+        TRUNCATED,
+    };
+
+    void readHeader();
+    /// Read the frame distance of the next record
+    void peekNextRecord();
+    /// Read the rest of the record
+    ReadResult readRecord(Record& output);
+
+    bool canRead(size_t byte_count) const { return data.size() - read_pos >= byte_count; }
+    /// Throws on the end of the data
+    uint8_t readByte();
+    uint64_t readVarint();
+};
+
+} // namespace Replay
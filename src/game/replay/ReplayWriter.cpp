@@ -0,0 +1,174 @@
+#include "ReplayWriter.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+namespace Replay {
+
+// the buffer is written out to the file after reaching this size
+constexpr size_t flush_threshold = 4096;
+
+ReplayWriter::ReplayWriter(const std::string& path, const Header& header)
+    : file(path, std::ios::binary)
+    , frame_count(0)
+    , last_record_frame(0)
+    , has_keyframe(false)
+    , last_keyframe_frame(0)
+    , used_slots(0)
+    , next_replaced_slot(0)
+{
+    buffer.reserve(flush_threshold * 2);
+    slot_devices.fill(0);
+
+    buffer.insert(buffer.end(), file_magic.cbegin(), file_magic.cend());
+    writeByte(format_version);
+    writeVarint(header.seed);
+    writeByte(static_cast<uint8_t>(header.game_mode));
+
+    const auto& well = header.well_config;
+    writeVarint(well.starting_gravity);
+    writeVarint(well.shift_normal);
+    writeVarint(well.shift_turbo);
+    writeVarint(well.max_next_pieces);
+    writeVarint(well.lock_delay);
+    writeByte(well.instant_harddrop
+        | well.tspin_enabled << 1
+        | well.tspin_allow_wallblock << 2
+        | well.tspin_allow_wallkick << 3);
+    writeByte(static_cast<uint8_t>(well.lock_delay_type));
+    writeByte(static_cast<uint8_t>(well.rotation_style));
+}
+
+ReplayWriter::~ReplayWriter()
+{
+    // the end is after the last frame
+    beginRecord(frame_count);
+    writeByte(static_cast<uint8_t>(ControlTag::END));
+    flush();
+}
+
+void ReplayWriter::record(const Record& record)
+{
+    assert(frame_count > 0);
+
+    switch (record.type) {
+        case EventType::INPUT: {
+            assert(static_cast<uint8_t>(record.input) < 0xE);
+            const uint8_t slot = deviceSlot(record.device_id);
+            beginRecord(frame_count - 1);
+            writeByte(static_cast<uint8_t>(record.input) << 4 | record.pressed << 3 | slot);
+            break;
+        }
+        case EventType::WINDOW:
+            beginRecord(frame_count - 1);
+            writeByte(static_cast<uint8_t>(ControlTag::WINDOW));
+            writeByte(static_cast<uint8_t>(record.window));
+            break;
+        case EventType::DEVICE:
+            beginRecord(frame_count - 1);
+            writeByte(static_cast<uint8_t>(ControlTag::DEVICE));
+            writeByte(static_cast<uint8_t>(record.device_event));
+            writeByte(static_cast<uint8_t>(record.device_id));
+            break;
+        default:
+            assert(false);
+            break;
+    }
+}
+
+void ReplayWriter::beginFrame()
+{
+    frame_count++;
+    if (buffer.size() >= flush_threshold)
+        flush();
+}
+
+bool ReplayWriter::keyframeDue() const
+{
+    assert(frame_count > 0);
+    return !has_keyframe || frame_count - 1 - last_keyframe_frame >= keyframe_interval;
+}
+
+void ReplayWriter::writeKeyframe(const std::vector<uint8_t>& state)
+{
+    assert(frame_count > 0);
+
+    beginRecord(frame_count - 1);
+    writeByte(static_cast<uint8_t>(ControlTag::KEYFRAME));
+    writeVarint(state.size());
+    buffer.insert(buffer.end(), state.cbegin(), state.cend());
+
+    has_keyframe = true;
+    last_keyframe_frame = frame_count - 1;
+}
+
+bool ReplayWriter::checksumDue() const
+{
+    assert(frame_count > 0);
+    return (frame_count - 1) % checksum_interval == 0;
+}
+
+void ReplayWriter::writeChecksum(uint64_t state_hash)
+{
+    assert(frame_count > 0);
+
+    beginRecord(frame_count - 1);
+    writeByte(static_cast<uint8_t>(ControlTag::CHECKSUM));
+    for (unsigned i = 0; i < 8; i++)
+        writeByte(static_cast<uint8_t>(state_hash >> (8 * i)));
+}
+
+uint8_t ReplayWriter::deviceSlot(DeviceID device_id)
+{
+    const auto slots_end = slot_devices.cbegin() + used_slots;
+    const auto slot_it = std::find(slot_devices.cbegin(), slots_end, device_id);
+    if (slot_it != slots_end)
+        return std::distance(slot_devices.cbegin(), slot_it);
+
+    // a new device gets a free slot, or the one that was assigned the longest ago
+    uint8_t slot;
+    if (used_slots < device_slot_count)
+        slot = used_slots++;
+    else {
+        slot = next_replaced_slot;
+        next_replaced_slot = (next_replaced_slot + 1) % device_slot_count;
+    }
+    slot_devices[slot] = device_id;
+
+    beginRecord(frame_count - 1);
+    writeByte(static_cast<uint8_t>(ControlTag::DEVICE_SLOT));
+    writeByte(slot);
+    writeByte(static_cast<uint8_t>(device_id));
+    return slot;
+}
+
+void ReplayWriter::beginRecord(uint32_t frame)
+{
+    writeVarint(frame - last_record_frame);
+    last_record_frame = frame;
+}
+
+void ReplayWriter::writeByte(uint8_t value)
+{
+    buffer.push_back(value);
+}
+
+void ReplayWriter::writeVarint(uint64_t value)
+{
+    // 7 bits per byte, the high bit is set if more bytes follow
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void ReplayWriter::flush()
+{
+    if (file.is_open())
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    buffer.clear();
+}
+
+} // namespace Replay
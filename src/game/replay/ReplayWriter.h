@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Replay.h"
+
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace Replay {
+
+/// Streams the events of a game into a replay file. The records are
+/// collected in a memory buffer, and written out only in bigger chunks,
+/// so recording has practically no cost during the frames.
+class ReplayWriter {
+public:
+    ReplayWriter(const std::string& path, const Header&);
+    /// Writes the end of the replay, then closes the file
+    ~ReplayWriter();
+
+    /// False if the file could not be opened
+    bool isOpen() const { return file.is_open(); }
+
+    /// Start a new frame; has to be called at the beginning of every frame,
+    /// including the first one
+    void beginFrame();
+    /// Add an event to the current frame
+    void record(const Record&);
+    /// The number of recorded frames
+    uint32_t frameCount() const { return frame_count; }
+
+    /// True if the current frame should have a keyframe; it remains true
+    /// until a keyframe is written
+    bool keyframeDue() const;
+    /// Save the game state at the beginning of the current frame;
+    /// has to be written before the events of the frame
+    void writeKeyframe(const std::vector<uint8_t>& state);
+
+    /// True if the current frame should have a checksum
+    bool checksumDue() const;
+    /// Save the hash of the game state at the beginning of the current frame;
+    /// has to be written before the events of the frame
+    void writeChecksum(uint64_t state_hash);
+
+private:
+    std::ofstream file;
+    std::vector<uint8_t> buffer;
+
+    uint32_t frame_count;
+    uint32_t last_record_frame;
+    bool has_keyframe;
+    uint32_t last_keyframe_frame;
+
+    /// The devices of the slots, and the order the slots were assigned,
+    /// to replace the oldest one when a new device appears
+    std::array<DeviceID, device_slot_count> slot_devices;
+    uint8_t used_slots;
+    uint8_t next_replaced_slot;
+
+    uint8_t deviceSlot(DeviceID);
+    /// Write the frame distance of a new record
+    void beginRecord(uint32_t frame);
+    void writeByte(uint8_t);
+    void writeVarint(uint64_t);
+    void flush();
+};
+
+} // namespace Replay
@@ -2,14 +2,33 @@
 
 #include "game/AppContext.h"
 #include "game/layout/gameplay/PlayerArea.h"
+#include "game/net/NetplaySettings.h"
+#include "game/net/UdpTransport.h"
+#include "game/replay/Keyframe.h"
+#include "game/replay/ReplayReader.h"
+#include "game/replay/ReplayWriter.h"
+#include "game/util/DurationToString.h"
 #include "substates/Ingame.h"
 #include "substates/ingame/FadeInOut.h"
 #include "substates/ingame/PlayerSelect.h"
+#include "system/AudioContext.h"
+#include "system/Log.h"
 #include "system/Paths.h"
 #include "system/Texture.h"
 #include <game/states/substates/ingame/Countdown.h>
 #include <game/states/substates/ingame/Gameplay.h>
 
+#include <algorithm>
+#include <ctime>
+#include <set>
+#include <stdexcept>
+#include <assert.h>
+
+
+const std::string LOG_REPLAY = "replay";
+/// The left/right inputs seek this much during the playback of a replay
+constexpr auto REPLAY_SEEK_STEP = std::chrono::seconds(10);
+
 
 bool isSinglePlayer(GameMode gamemode)
 {
@@ -24,19 +43,63 @@ bool isSinglePlayer(GameMode gamemode)
 
 
 IngameState::IngameState(AppContext& app, GameMode gamemode)
+    : IngameState(app, gamemode, Random::makeSeed(), nullptr)
+{}
+
+IngameState::IngameState(AppContext& app, std::unique_ptr<Replay::ReplayReader> replay)
+    : IngameState(app, replay->header().game_mode, replay->header().seed, std::move(replay))
+{}
+
+IngameState::IngameState(AppContext& app, const Net::NetplaySettings& netplay)
+    : IngameState(app, GameMode::MP_BATTLE, netplay.seed, nullptr, &netplay)
+{}
+
+IngameState::IngameState(AppContext& app, GameMode gamemode, uint64_t seed,
+                         std::unique_ptr<Replay::ReplayReader>&& replay,
+                         const Net::NetplaySettings* netplay)
     : gamemode(gamemode)
     , draw_scale(isSinglePlayer(gamemode) ? 1.0 : 0.8)
     , draw_inverse_scale(1.0 / draw_scale)
+    , match_seeds(seed)
+    , replay_reader(std::move(replay))
+    , replay_desynced(false)
     , tex_bg_pattern(app.gcx().loadTexture(app.theme().get_texture("game_fill.png")))
 {
+    if (netplay) {
+        assert(gamemode == GameMode::MP_BATTLE);
+        netplay_settings = std::make_unique<Net::NetplaySettings>(*netplay);
+        netplay_transport = std::make_unique<Net::UdpTransport>(
+            netplay->local_port, netplay->remote_host, netplay->remote_port);
+    }
+
+    // the wells are created with the settings of the recorded game;
+    // replays are played in a separate session, so the user's settings
+    // are not saved after this
+    if (replay_reader)
+        app.wellconfig() = replay_reader->header().well_config;
+    else if (app.sysconfig().record_replays && !netplay) {
+        // the remote inputs only exist in the rollback session,
+        // so the online battles are not recorded
+        startRecording(app, seed);
+    }
+
     const auto wallpaper_path = app.theme().random_game_background();
     if (!wallpaper_path.empty())
         tex_bg_wallpaper = app.gcx().loadTexture(wallpaper_path);
 
     updatePositions(app);
+    addInitialStates(app);
+}
 
-    if (isSinglePlayer(gamemode)) {
+void IngameState::addInitialStates(AppContext& app)
+{
+    if (isSinglePlayer(gamemode) || isNetplay()) {
         device_order = {-1};
+        // in the online battles, every local input belongs to the local player
+        if (isNetplay()) {
+            device_order = {Net::remote_device, Net::remote_device};
+            device_order.at(netplay_settings->local_player) = -1;
+        }
         states.emplace_back(std::make_unique<SubStates::Ingame::States::Gameplay>(app, *this));
         states.emplace_back(std::make_unique<SubStates::Ingame::States::Countdown>(app));
         states.emplace_back(std::make_unique<SubStates::Ingame::States::FadeIn>([this](){
@@ -51,10 +114,264 @@ IngameState::IngameState(AppContext& app, GameMode gamemode)
     }
 }
 
-IngameState::~IngameState() = default;
+IngameState::~IngameState()
+{
+    if (replay_reader)
+        logReplayResults();
+
+    // the substates may still use the player areas (eg. the CPU players
+    // are searching on their wells), so they are removed first
+    states.clear();
+}
+
+uint64_t IngameState::nextMatchSeed()
+{
+    return (static_cast<uint64_t>(match_seeds.next()) << 32) | match_seeds.next();
+}
+
+void IngameState::startRecording(AppContext& app, uint64_t seed)
+{
+    const std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    const std::string path = Paths::config() + "replay-" + timestamp + ".obr";
+
+    Replay::Header header;
+    header.seed = seed;
+    header.game_mode = gamemode;
+    header.well_config = app.wellconfig();
+
+    replay_writer = std::make_unique<Replay::ReplayWriter>(path, header);
+    if (!replay_writer->isOpen()) {
+        Log::warning(LOG_REPLAY) << "Could not create replay file " << path << "\n";
+        replay_writer.reset();
+        return;
+    }
+    Log::info(LOG_REPLAY) << "Recording to " << path << "\n";
+}
+
+void IngameState::recordEvents(const std::vector<Event>& events)
+{
+    replay_writer->beginFrame();
+    if (replay_writer->keyframeDue())
+        writeKeyframe();
+    if (replay_writer->checksumDue())
+        writeChecksum();
+
+    for (const auto& event : events) {
+        switch (event.type) {
+            case EventType::INPUT:
+                replay_writer->record(Replay::Record::fromInput(
+                    event.input.type(), event.input.down(), event.input.srcDeviceID()));
+                break;
+            case EventType::DEVICE:
+                replay_writer->record(Replay::Record::fromDevice(event.device.type, event.device.device_id));
+                break;
+            case EventType::WINDOW:
+                // resizing has no effect on the game
+                if (event.window != WindowEvent::RESIZED)
+                    replay_writer->record(Replay::Record::fromWindow(event.window));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void IngameState::recordInputs(const std::vector<InputEvent>& inputs)
+{
+    if (!replay_writer)
+        return;
+
+    for (const auto& input : inputs)
+        replay_writer->record(Replay::Record::fromInput(input.type(), input.down(), input.srcDeviceID()));
+}
+
+bool IngameState::readReplayFrame(const std::vector<Event>& live_events)
+{
+    if (!replay_reader->nextFrame(replay_records))
+        return false;
+
+    // the window can still be resized during the playback,
+    // but every other event comes from the replay
+    replayed_events.clear();
+    for (const auto& event : live_events) {
+        if (event.type == EventType::WINDOW && event.window == WindowEvent::RESIZED)
+            replayed_events.emplace_back(WindowEvent::RESIZED);
+    }
+    for (const auto& record : replay_records) {
+        switch (record.type) {
+            case EventType::INPUT:
+                replayed_events.emplace_back(InputEvent(record.input, record.pressed, record.device_id));
+                break;
+            case EventType::DEVICE:
+                replayed_events.emplace_back(DeviceEvent(record.device_event, record.device_id));
+                break;
+            case EventType::WINDOW:
+                replayed_events.emplace_back(WindowEvent(record.window));
+                break;
+            default:
+                assert(false);
+                break;
+        }
+    }
+    return true;
+}
+
+void IngameState::writeKeyframe()
+{
+    Replay::KeyframeWriter keyframe;
+    keyframe.writeVarint(match_seeds.snapshot());
+    keyframe.writeByte(device_order.size());
+    for (const DeviceID device_id : device_order)
+        keyframe.writeByte(static_cast<uint8_t>(device_id));
+
+    if (states.back()->saveKeyframe(*this, keyframe))
+        replay_writer->writeKeyframe(keyframe.data());
+}
+
+void IngameState::writeChecksum()
+{
+    uint64_t state_hash;
+    if (states.back()->stateHash(*this, state_hash))
+        replay_writer->writeChecksum(state_hash);
+}
+
+void IngameState::verifyChecksum()
+{
+    uint64_t saved_hash;
+    uint64_t state_hash;
+    if (replay_desynced
+        || !replay_reader->frameChecksum(saved_hash)
+        || !states.back()->stateHash(*this, state_hash))
+        return;
+
+    if (state_hash != saved_hash) {
+        // only the first difference is interesting, the rest follows from it
+        replay_desynced = true;
+        const uint32_t frame = replay_reader->frameCount() - 1;
+        Log::warning(LOG_REPLAY) << "The replay is out of sync from frame " << frame
+                                 << " (" << Timing::toString(frame * Timing::frame_duration) << ")\n";
+    }
+}
+
+void IngameState::loadKeyframe(AppContext& app, const std::vector<uint8_t>& data)
+{
+    Replay::KeyframeReader keyframe(data);
+    const uint64_t match_seeds_state = keyframe.readVarint();
+    const uint8_t player_count = keyframe.readByte();
+    if (player_count == 0 || player_count > 4)
+        throw std::runtime_error("Invalid keyframe in the replay");
+
+    device_order.clear();
+    for (unsigned i = 0; i < player_count; i++)
+        device_order.push_back(static_cast<DeviceID>(keyframe.readByte()));
+
+    // a new match is created, then its state is replaced
+    states.clear();
+    auto gameplay = std::make_unique<SubStates::Ingame::States::Gameplay>(app, *this);
+    gameplay->loadKeyframe(*this, keyframe, replay_reader->header().version);
+    if (!keyframe.atEnd())
+        throw std::runtime_error("Invalid keyframe in the replay");
+    states.emplace_back(std::move(gameplay));
+    match_seeds.restore(match_seeds_state);
+    replay_desynced = false;
+
+    // the new match would wait for its countdown
+    app.audio().resumeAll();
+}
+
+void IngameState::restartReplay(AppContext& app)
+{
+    replay_reader->rewind();
+
+    states.clear();
+    player_areas.clear();
+    player_stats.clear();
+    device_order.clear();
+    match_seeds.setSeed(replay_reader->header().seed);
+    replay_desynced = false;
+    addInitialStates(app);
+}
+
+void IngameState::seekReplay(uint32_t target_frame, AppContext& app)
+{
+    assert(replay_reader);
+    if (replay_reader->totalFrames() == 0)
+        return;
+
+    // the game was closed during the last frame, so it's never simulated here
+    target_frame = std::min(target_frame, replay_reader->totalFrames() - 1);
+
+    // continue from the closest keyframe, unless the game is already closer
+    const uint32_t current_frame = replay_reader->frameCount();
+    const auto* keyframe = replay_reader->findKeyframe(target_frame);
+    const bool keep_going = current_frame <= target_frame
+        && (!keyframe || keyframe->frame <= current_frame);
+    if (!keep_going) {
+        if (keyframe)
+            loadKeyframe(app, replay_reader->seek(*keyframe));
+        else
+            restartReplay(app);
+    }
+
+    // the skipped frames are simulated silently
+    const uint32_t simulated_frames = target_frame - replay_reader->frameCount();
+    if (app.sysconfig().sfx)
+        app.audio().toggleSFXMute();
+
+    const std::vector<Event> no_events;
+    while (replay_reader->frameCount() < target_frame)
+        update(no_events, app);
+
+    if (app.sysconfig().sfx)
+        app.audio().toggleSFXMute();
+
+    Log::info(LOG_REPLAY) << "Jumped to " << Timing::toString(target_frame * Timing::frame_duration)
+                          << ", simulated " << simulated_frames << " frames\n";
+}
+
+void IngameState::handleSeekInputs(const std::vector<Event>& live_events, AppContext& app)
+{
+    const uint32_t step = REPLAY_SEEK_STEP / Timing::frame_duration;
+    for (const auto& event : live_events) {
+        if (event.type != EventType::INPUT || !event.input.down())
+            continue;
+
+        const uint32_t current_frame = replay_reader->frameCount();
+        switch (event.input.type()) {
+            case InputType::MENU_LEFT:
+                seekReplay(current_frame - std::min(current_frame, step), app);
+                return;
+            case InputType::MENU_RIGHT:
+                seekReplay(current_frame + step, app);
+                return;
+            default:
+                break;
+        }
+    }
+}
+
+void IngameState::logReplayResults() const
+{
+    Log::info(LOG_REPLAY) << "Played " << replay_reader->frameCount() << " frames\n";
+    for (const DeviceID device_id : device_order) {
+        if (!player_stats.count(device_id))
+            continue;
+
+        const auto& stats = player_stats.at(device_id);
+        Log::info(LOG_REPLAY) << "Player " << static_cast<int>(device_id)
+                              << ": score " << stats.score
+                              << ", lines " << stats.total_cleared_lines
+                              << ", level " << static_cast<unsigned>(stats.level)
+                              << ", time " << std::chrono::duration_cast<std::chrono::milliseconds>(stats.gametime).count() / 1000.0
+                              << " s\n";
+    }
+}
 
 void IngameState::updatePositions(AppContext& app)
 {
+    background_layer.outdated = true;
     if (player_areas.empty())
         return;
 
@@ -84,8 +401,20 @@ void IngameState::updatePositions(AppContext& app)
     }
 }
 
-void IngameState::update(const std::vector<Event>& events, AppContext& app)
+void IngameState::update(const std::vector<Event>& live_events, AppContext& app)
 {
+    if (replay_reader) {
+        handleSeekInputs(live_events, app);
+        if (!readReplayFrame(live_events)) {
+            app.states().pop();
+            return;
+        }
+        verifyChecksum();
+    }
+    const auto& events = replay_reader ? replayed_events : live_events;
+    if (replay_writer)
+        recordEvents(events);
+
     std::unordered_map<DeviceID, std::vector<InputEvent>> input_events;
     for (const auto& event : events) {
         switch (event.type) {
@@ -112,8 +441,12 @@ void IngameState::update(const std::vector<Event>& events, AppContext& app)
         input_events.emplace(-1, std::move(temp));
     }
 
-    for (auto& ui_pa : player_areas)
-        ui_pa.second.well().updateKeystateOnly(input_events[ui_pa.first]);
+    // in the online battles, the key states are part of the rolled back
+    // state, and they are updated by the simulated frames
+    if (!isNetplay()) {
+        for (auto& ui_pa : player_areas)
+            ui_pa.second.well().updateKeystateOnly(input_events[ui_pa.first]);
+    }
 
     states.back()->update(*this, events, app);
 }
@@ -125,9 +458,6 @@ void IngameState::draw(GraphicsContext& gcx)
     const auto original_scale = gcx.getDrawScale();
     gcx.modifyDrawScale(original_scale * draw_scale);
 
-    if (tex_bg_wallpaper)
-        tex_bg_wallpaper->drawScaled(rect_wallpaper);
-
     for(const auto& state : states)
         state->drawPassive(*this, gcx);
     states.back()->drawActive(*this, gcx);
@@ -137,6 +467,38 @@ void IngameState::draw(GraphicsContext& gcx)
 
 void IngameState::drawCommon(GraphicsContext& gcx)
 {
-    tex_bg_pattern->drawScaled({0, 0, gcx.screenWidth(), gcx.screenHeight()});
+    updateBackgroundLayer(gcx);
+    background_layer.texture->drawScaled({0, 0, gcx.screenWidth(), gcx.screenHeight()});
+}
+
+void IngameState::updateBackgroundLayer(GraphicsContext& gcx)
+{
+    if (!background_layer.texture
+        || background_layer.draw_scale != gcx.getDrawScale()
+        || background_layer.target_resets != gcx.renderTargetResets()
+        || background_layer.width != gcx.screenWidth()
+        || background_layer.height != gcx.screenHeight()) {
+        background_layer.texture = gcx.createRenderTarget(gcx.screenWidth(), gcx.screenHeight());
+        background_layer.draw_scale = gcx.getDrawScale();
+        background_layer.target_resets = gcx.renderTargetResets();
+        background_layer.width = gcx.screenWidth();
+        background_layer.height = gcx.screenHeight();
+        background_layer.outdated = true;
+    }
+    if (!background_layer.outdated)
+        return;
+
+    const ::Rectangle screen_rect = {0, 0, gcx.screenWidth(), gcx.screenHeight()};
+    gcx.setRenderTarget(background_layer.texture.get());
+    gcx.clearRect(screen_rect);
+    tex_bg_pattern->drawScaled(screen_rect);
+
+    // the rest is drawn at the scale of the game
+    gcx.modifyDrawScale(gcx.getDrawScale() * draw_scale);
+    if (tex_bg_wallpaper)
+        tex_bg_wallpaper->drawScaled(rect_wallpaper);
+
+    gcx.setRenderTarget(nullptr);
+    background_layer.outdated = false;
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "game/GameMode.h"
 #include "game/GameState.h"
 #include "game/PlayerStatistics.h"
 #include "game/layout/gameplay/PlayerArea.h"
+#include "game/replay/Replay.h"
+#include "game/util/Random.h"
 
 #include <list>
 #include <memory>
@@ -11,23 +14,27 @@
 namespace SubStates { namespace Ingame {
     class State;
 } }
+namespace Replay {
+    class ReplayReader;
+    class ReplayWriter;
+}
+namespace Net {
+    struct NetplaySettings;
+    class Transport;
+}
 
 
-enum class GameMode : uint8_t {
-    SP_MARATHON,
-    SP_40LINES,
-    SP_2MIN,
-    SP_MARATHON_SIMPLE,
-    MP_MARATHON,
-    MP_BATTLE,
-    MP_MARATHON_SIMPLE,
-};
-
 bool isSinglePlayer(GameMode);
 
 class IngameState: public GameState {
 public:
     IngameState(AppContext&, GameMode);
+    /// Play back a recorded game; the state is removed when the replay ends
+    IngameState(AppContext&, std::unique_ptr<Replay::ReplayReader>);
+    /// Play an online battle against another machine; the state is removed
+    /// when the match ends. Throws `std::runtime_error` if the connection
+    /// can't be set up.
+    IngameState(AppContext&, const Net::NetplaySettings&);
     ~IngameState();
 
     void update(const std::vector<Event>&, AppContext&) final;
@@ -35,6 +42,21 @@ public:
 
     void updatePositions(AppContext&);
 
+    /// Every match of the state gets a new seed from here, so the matches
+    /// can be reproduced from the seed of the state
+    uint64_t nextMatchSeed();
+    bool isReplay() const { return replay_reader != nullptr; }
+    bool isNetplay() const { return netplay_transport != nullptr; }
+    /// The settings and the connection of the online battle
+    const Net::NetplaySettings& netplaySettings() const { return *netplay_settings; }
+    Net::Transport& netplayTransport() { return *netplay_transport; }
+    /// Add the inputs, that were not created by the input devices
+    /// (eg. the ones of the CPU players), to the recorded replay
+    void recordInputs(const std::vector<InputEvent>&);
+    /// Jump to a frame of the played replay. The game continues from the
+    /// closest keyframe, and the rest of the frames are simulated.
+    void seekReplay(uint32_t frame, AppContext&);
+
     const GameMode gamemode;
     std::list<std::unique_ptr<SubStates::Ingame::State>> states;
     std::vector<DeviceID> device_order;
@@ -45,10 +67,59 @@ public:
     const float draw_inverse_scale;
 
 private:
+    Random match_seeds;
+    std::unique_ptr<Replay::ReplayWriter> replay_writer;
+    std::unique_ptr<Replay::ReplayReader> replay_reader;
+    std::vector<Replay::Record> replay_records;
+    std::vector<Event> replayed_events;
+    /// The played replay has already reached a frame where the state
+    /// of the game differs from the recorded one
+    bool replay_desynced;
+
+    std::unique_ptr<Net::NetplaySettings> netplay_settings;
+    std::unique_ptr<Net::Transport> netplay_transport;
+
     std::unique_ptr<Texture> tex_bg_pattern;
     std::unique_ptr<Texture> tex_bg_wallpaper;
 
     ::Rectangle rect_wallpaper;
 
+    // The parts of the screen that only change when the window is resized
+    // (the background and the wallpaper), drawn together into one texture.
+    // The frames of the player areas are not included, as they have to
+    // cover the garbage gauges.
+    struct BackgroundLayer {
+        std::unique_ptr<Texture> texture;
+        // the texture is recreated when these change
+        float draw_scale = 0.f;
+        unsigned target_resets = 0;
+        unsigned short width = 0;
+        unsigned short height = 0;
+        // the contents are redrawn if set
+        bool outdated = true;
+    };
+    BackgroundLayer background_layer;
+
+    IngameState(AppContext&, GameMode, uint64_t seed, std::unique_ptr<Replay::ReplayReader>&&,
+                const Net::NetplaySettings* = nullptr);
+    void addInitialStates(AppContext&);
+
+    void startRecording(AppContext&, uint64_t seed);
+    void recordEvents(const std::vector<Event>&);
+    void writeKeyframe();
+    void loadKeyframe(AppContext&, const std::vector<uint8_t>&);
+    void writeChecksum();
+    /// Compare the state of the game to the checksum of the replayed frame
+    void verifyChecksum();
+    /// Start the replay again from the first frame
+    void restartReplay(AppContext&);
+    /// Seek in the replay with the live inputs
+    void handleSeekInputs(const std::vector<Event>& live_events, AppContext&);
+    /// Read the events of the next frame from the replay; returns false
+    /// if the replay has ended
+    bool readReplayFrame(const std::vector<Event>& live_events);
+    void logReplayResults() const;
+
     void drawCommon(GraphicsContext&);
+    void updateBackgroundLayer(GraphicsContext&);
 };
@@ -3,6 +3,9 @@
 #include "game/AppContext.h"
 #include "game/GameConfigFile.h"
 #include "game/Theme.h"
+#include "game/net/NetplaySettings.h"
+#include "game/replay/ReplayReader.h"
+#include "game/states/IngameState.h"
 #include "game/states/MainMenuState.h"
 #include "system/AudioContext.h"
 #include "system/Log.h"
@@ -12,7 +15,9 @@
 #include <assert.h>
 
 
-InitState::InitState(AppContext& app)
+InitState::InitState(AppContext& app, const std::string& replay_path, uint32_t replay_start_frame)
+    : replay_path(replay_path)
+    , replay_start_frame(replay_start_frame)
 {
     const auto mappings = app.inputconfig().load(Paths::config() + "input.cfg");
     app.inputconfig().save(mappings, Paths::config() + "input.cfg");
@@ -31,9 +36,39 @@ InitState::InitState(AppContext& app)
     Log::info("init") << "Loading resources from '" << Paths::data() << "'\n";
 }
 
+InitState::InitState(AppContext& app, const Net::NetplaySettings& netplay_settings)
+    : InitState(app)
+{
+    netplay = std::make_unique<Net::NetplaySettings>(netplay_settings);
+}
+
+InitState::~InitState() = default;
+
 void InitState::update(const std::vector<Event>&, AppContext& app)
 {
-    std::unique_ptr<GameState> temp = std::make_unique<MainMenuState>(app);
+    std::unique_ptr<GameState> temp;
+    if (replay_path.empty() && !netplay) {
+        temp = std::make_unique<MainMenuState>(app);
+        app.states().top().swap(temp);
+        return;
+    }
+
+    // the resources are normally loaded by the main menu
+    app.theme() = ThemeConfigFile::load(app.sysconfig().theme_dir_name);
+    app.minos().load(app);
+
+    if (netplay) {
+        Log::info("netplay") << "Playing against " << netplay->remote_host << ":" << netplay->remote_port
+                             << " as player " << (netplay->local_player + 1) << "\n";
+        temp = std::make_unique<IngameState>(app, *netplay);
+    }
+    else {
+        Log::info("replay") << "Playing '" << replay_path << "'\n";
+        auto replay_state = std::make_unique<IngameState>(app, std::make_unique<Replay::ReplayReader>(replay_path));
+        if (replay_start_frame > 0)
+            replay_state->seekReplay(replay_start_frame, app);
+        temp = std::move(replay_state);
+    }
     app.states().top().swap(temp);
 }
 
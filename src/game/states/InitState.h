@@ -2,10 +2,26 @@
 
 #include "game/GameState.h"
 
+#include <memory>
+#include <string>
+#include <stdint.h>
+
+namespace Net { struct NetplaySettings; }
+
 
 class InitState: public GameState {
 public:
-    InitState(AppContext&);
+    /// If a replay file is set, it is played back instead of starting the main menu,
+    /// starting from the frame `replay_start_frame`
+    InitState(AppContext&, const std::string& replay_path = "", uint32_t replay_start_frame = 0);
+    /// Start an online battle instead of the main menu
+    InitState(AppContext&, const Net::NetplaySettings&);
+    ~InitState();
     void update(const std::vector<Event>&, AppContext&) final;
     void draw(GraphicsContext& gcx) final;
+
+private:
+    const std::string replay_path;
+    const uint32_t replay_start_frame;
+    std::unique_ptr<Net::NetplaySettings> netplay;
 };
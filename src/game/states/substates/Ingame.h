@@ -3,10 +3,12 @@
 #include "system/Event.h"
 
 #include <vector>
+#include <stdint.h>
 
 class AppContext;
 class GraphicsContext;
 class IngameState;
+namespace Replay { class KeyframeWriter; }
 
 
 namespace SubStates {
@@ -19,6 +21,12 @@ public:
     virtual void update(IngameState&, const std::vector<Event>&, AppContext&) = 0;
     virtual void drawPassive(IngameState&, GraphicsContext&) const {}
     virtual void drawActive(IngameState&, GraphicsContext&) const {}
+    /// Save the game state into a keyframe of the recorded replay;
+    /// returns false if the state can't be saved in the current frame
+    virtual bool saveKeyframe(IngameState&, Replay::KeyframeWriter&) const { return false; }
+    /// Calculate a hash of the game state, for the checksums of the replay;
+    /// returns false if the state has nothing to check
+    virtual bool stateHash(IngameState&, uint64_t&) const { return false; }
 };
 
 } // namespace Ingame
@@ -4,12 +4,17 @@
 #include "Pause.h"
 #include "Statistics.h"
 #include "game/AppContext.h"
-#include "game/BattleAttackTable.h"
+#include "game/ai/Bot.h"
 #include "game/components/HoldQueue.h"
 #include "game/components/NextQueue.h"
 #include "game/components/Piece.h"
 #include "game/components/animations/TextPopup.h"
+#include "game/net/NetplaySettings.h"
+#include "game/replay/Keyframe.h"
+#include "game/replay/Replay.h"
 #include "game/states/IngameState.h"
+#include "game/util/Hash.h"
+#include "game/util/ThreadPool.h"
 #include "system/AudioContext.h"
 #include "system/Font.h"
 #include "system/Localize.h"
@@ -18,7 +23,8 @@
 #include "system/SoundEffect.h"
 
 #include <algorithm>
-#include <cmath>
+#include <stdexcept>
+#include <thread>
 
 
 namespace SubStates {
@@ -27,9 +33,12 @@ namespace States {
 
 Gameplay::Gameplay(AppContext& app, IngameState& parent, unsigned short starting_gravity_level)
     : player_devices(parent.device_order)
+    , random_seed(parent.nextMatchSeed())
+    , rng(random_seed)
     , theme_settings(app.theme().gameplay)
     , music(app.audio().loadMusic(app.theme().random_game_music()))
     , font_popuptext(app.gcx().loadFont(Paths::data() + "fonts/PTS76F.ttf", 34))
+    , garbage_mino(app.minos().getMino(PieceType::GARBAGE))
     , sfx_onhold(app.audio().loadSound(app.theme().get_sfx("hold.ogg")))
     , sfx_onlevelup(app.audio().loadSound(app.theme().get_sfx("levelup.ogg")))
     , sfx_onlineclear({{
@@ -44,17 +53,23 @@ Gameplay::Gameplay(AppContext& app, IngameState& parent, unsigned short starting
     , texts_need_update(true)
     , sfx_ongameover(app.audio().loadSound(app.theme().get_sfx("gameover.ogg")))
     , sfx_onfinish(app.audio().loadSound(app.theme().get_sfx("finish.ogg")))
+    , rules(parent.gamemode, starting_gravity_level)
     , gameend_statistics_delay(std::chrono::seconds(5),
         [](double t){ return t * 5; },
         [&parent, &app](){
             parent.states.emplace_back(std::make_unique<Statistics>(parent, app));
         })
+    , rollback_parent(parent)
+    , rollback_keys{}
+    , local_keys(0)
+    , rollback_frame(0)
+    , first_new_frame(0)
+    , resimulating(false)
 {
     TextPopup::text_color = app.theme().colors.popup;
 
     assert(player_devices.size() > 0);
     assert(player_devices.size() <= 4);
-    assert(starting_gravity_level < 15);
     parent.player_areas.clear();
     parent.player_stats.clear();
 
@@ -62,56 +77,23 @@ Gameplay::Gameplay(AppContext& app, IngameState& parent, unsigned short starting
     const bool is_battle = (parent.gamemode == GameMode::MP_BATTLE);
 
     for (const DeviceID device_id : player_devices) {
-        previous_lineclear_type[device_id] = ScoreType::CLEAR_SINGLE;
-        back2back_length[device_id] = 0;
-        combo_length[device_id] = 0;
-        current_piece_cleared_line[device_id] = false;
-        prev_piece_cleared_line[device_id] = false;
-        pending_garbage_lines[device_id] = 0;
-
-        player_status[device_id] = PlayerStatus::PLAYING;
+        players.emplace(device_id, rules.newPlayer());
+        player_states.push_back(&players.at(device_id));
+
         parent.player_areas.emplace(std::piecewise_construct,
                 std::forward_as_tuple(device_id), std::forward_as_tuple(app, is_battle));
         parent.player_stats.emplace(std::piecewise_construct,
             std::forward_as_tuple(device_id), std::forward_as_tuple());
 
+        // every player gets the same pieces and garbage gaps
+        auto& parea = parent.player_areas.at(device_id);
+        parea.nextQueue().setRandomSeed(random_seed);
+        parea.well().setRandomSeed(random_seed);
+        parea.well().setGravity(rules.gravity(players.at(device_id)));
+
         textpopups.emplace(std::piecewise_construct,
             std::forward_as_tuple(device_id), std::forward_as_tuple());
-    }
-    {
-        // TODO: consider alternative algorithm
-        std::stack<Duration> gravity_stack;
-        for (int i = 14; i >= starting_gravity_level; i--) {
-            float multiplier = std::pow(0.8 - (i * 0.007), i);
-            gravity_stack.push(std::chrono::duration_cast<Duration>(multiplier * std::chrono::seconds(1)));
-        }
-
-        for (const DeviceID device_id : player_devices) {
-            gravity_levels[device_id] = gravity_stack;
-            parent.player_areas.at(device_id).well().setGravity(gravity_stack.top());
-            gravity_levels[device_id].pop();
-        }
-    }
-    {
-        std::stack<unsigned short> lineclear_stack;
-        if (usesDynamicLineAwards(parent)) {
-            for (int i = 15; i > starting_gravity_level; i--)
-                lineclear_stack.push(i * 5);
-        }
-        else {
-            if (parent.gamemode == GameMode::SP_40LINES)
-                lineclear_stack.push(40);
-            else {
-                for (int i = 15; i > starting_gravity_level; i--)
-                    lineclear_stack.push(10);
-            }
-        }
-
-        for (const DeviceID device_id : player_devices) {
-            lineclears_required[device_id] = lineclear_stack;
-            lineclears_left[device_id] = lineclear_stack.top();
-            lineclears_required[device_id].pop();
-        }
+        shown_statuses.emplace(device_id, PlayerStatus::PLAYING);
     }
 
     if (is_battle) {
@@ -127,10 +109,72 @@ Gameplay::Gameplay(AppContext& app, IngameState& parent, unsigned short starting
     gameend_statistics_delay.stop();
 
     registerObservers(parent, app);
+    createBots(parent, app);
+
+    if (parent.isNetplay()) {
+        assert(player_devices.size() == Net::player_count);
+        const auto& settings = parent.netplaySettings();
+        rollback_states.resize(Net::RollbackSession::stateSlots(settings.rollback));
+        Net::RollbackGame& rollback_game = *this;
+        rollback_session = std::make_unique<Net::RollbackSession>(
+            rollback_game, parent.netplayTransport(), settings.local_player, settings.rollback);
+    }
 }
 
 Gameplay::~Gameplay() = default;
 
+void Gameplay::createBots(IngameState& parent, AppContext& app)
+{
+    // the inputs of the bots are also in the replays
+    if (parent.isReplay())
+        return;
+
+    std::vector<DeviceID> bot_devices;
+    for (const DeviceID device_id : player_devices) {
+        if (AI::isBotDevice(device_id))
+            bot_devices.push_back(device_id);
+    }
+    if (bot_devices.empty())
+        return;
+
+    // one worker for every bot, but leave a core for the main thread
+    const unsigned cpu_count = std::max(2u, std::thread::hardware_concurrency());
+    bot_workers = std::make_unique<ThreadPool>(std::min<unsigned>(bot_devices.size(), cpu_count - 1));
+
+    const auto settings = AI::BotSettings::fromDifficulty(app.sysconfig().cpu_difficulty);
+    for (const DeviceID device_id : bot_devices) {
+        auto& well = parent.player_areas.at(device_id).well();
+        bots.emplace(device_id, std::make_unique<AI::Bot>(well, device_id, settings, *bot_workers));
+    }
+}
+
+void Gameplay::updateBots(IngameState& parent, std::unordered_map<DeviceID, std::vector<InputEvent>>& input_events)
+{
+    for (auto& entry : bots) {
+        const DeviceID device_id = entry.first;
+        if (players.at(device_id).status != PlayerStatus::PLAYING)
+            continue;
+
+        auto& parea = parent.player_areas.at(device_id);
+        const auto& hold_queue = parea.holdQueue();
+        const auto& next_queue = parea.nextQueue();
+
+        AI::PlayerView view;
+        view.hold_empty = hold_queue.isEmpty();
+        view.hold_piece = hold_queue.heldPiece();
+        view.hold_allowed = hold_queue.swapAllowed();
+        for (unsigned i = 0; i < next_queue.previewCount(); i++)
+            view.next_pieces.push_back(next_queue.pieces().peek(i));
+
+        // the bots don't have a real input device, so their key states
+        // are updated here, instead of the parent state
+        auto& bot_events = input_events[device_id];
+        entry.second->update(parea.well(), view, bot_events);
+        parea.well().updateKeystateOnly(bot_events);
+        parent.recordInputs(bot_events);
+    }
+}
+
 void Gameplay::addNextPiece(IngameState& parent, DeviceID device_id)
 {
     auto& parea = parent.player_areas.at(device_id);
@@ -143,190 +187,136 @@ std::vector<DeviceID> Gameplay::playingPlayers()
 {
     std::vector<DeviceID> playing_players;
     for (const DeviceID pdevid : player_devices) {
-        if (player_status.at(pdevid) == PlayerStatus::PLAYING)
+        if (players.at(pdevid).status == PlayerStatus::PLAYING)
             playing_players.push_back(pdevid);
     }
     return playing_players;
 }
 
-void Gameplay::increaseScoreMaybe(IngameState& parent, DeviceID source_player,
-                                  const WellEvent::lineclear_t& lcevent)
+void Gameplay::finishGame()
 {
-    const auto score_type = ScoreTable::lineclearType(lcevent);
-    std::string popup_text = ScoreTable::name(score_type);
-
-    auto& player_stats = parent.player_stats.at(source_player);
-    player_stats.event_count[score_type]++;
-    player_stats.total_cleared_lines += lcevent.count;
-
-
-    unsigned score = ScoreTable::value(score_type);
-    const bool back2back = ScoreTable::canContinueBackToBack(previous_lineclear_type.at(source_player), score_type);
-    if (back2back) {
-        score *= ScoreTable::back2backMultiplier();
-        popup_text = ScoreTable::back2backName() + "\n" + popup_text;
-        back2back_length.at(source_player)++;
-        player_stats.back_to_back_count++;
-        player_stats.back_to_back_longest = std::max(player_stats.back_to_back_longest,
-                                                    back2back_length.at(source_player));
-    }
-    else
-        back2back_length.at(source_player) = 0;
-
-    if (score_type != ScoreType::CLEAR_SINGLE)
-        textpopups.at(source_player).emplace_back(popup_text, font_popuptext);
-
-
-    auto& combo_count = combo_length.at(source_player);
-    if (prev_piece_cleared_line.at(source_player)) {
-        combo_count++;
-        score += ScoreTable::value(ScoreType::COMBO);
-        popup_text = std::to_string(combo_count) + ScoreTable::name(ScoreType::COMBO);
-        textpopups.at(source_player).emplace_back(popup_text, font_popuptext);
-    }
-    else
-        combo_count = 0;
+    playSFX(sfx_onfinish);
+    gameend_statistics_delay.restart();
 
-
-    player_stats.score += score * player_stats.level;
+    // find out who else is still playing
+    if (playingPlayers().empty() && !resimulating)
+        music->fadeOut(std::chrono::seconds(1));
 }
 
-void Gameplay::sendGarbageMaybe(IngameState& parent, DeviceID source_player,
-                                const WellEvent::lineclear_t& lcevent)
+void Gameplay::updateGameEndAnims(IngameState& parent)
 {
-    if (parent.gamemode != GameMode::MP_BATTLE)
-        return;
-
-    const auto score_type = ScoreTable::lineclearType(lcevent);
-    const bool back2back = ScoreTable::canContinueBackToBack(previous_lineclear_type.at(source_player), score_type);
-    unsigned sendable_lines = BattleAttackTable::sendableLineCount(lcevent, back2back);
-
-    if (sendable_lines > 0) {
-        // reduce current garbage
-        auto& parea = parent.player_areas.at(source_player);
-        unsigned current_queue = parea.queuedGarbageLines();
-        const unsigned smallest = std::min(sendable_lines, current_queue);
-        current_queue -= smallest;
-        sendable_lines -= smallest;
-        parea.setGarbageCount(current_queue);
-        pending_garbage_lines.at(source_player) = current_queue;
-    }
+    for (const DeviceID device_id : player_devices) {
+        const PlayerStatus status = players.at(device_id).status;
+        PlayerStatus& shown_status = shown_statuses.at(device_id);
+        if (status == shown_status)
+            continue;
 
-    // if we can still send some lines
-    if (sendable_lines > 0) {
-        // find target player
-        std::vector<DeviceID> possible_players;
-        for (const DeviceID possible_device : player_devices) {
-            if (player_status.at(possible_device) == PlayerStatus::PLAYING && possible_device != source_player)
-                possible_players.push_back(possible_device);
+        auto& parea = parent.player_areas.at(device_id);
+        switch (status) {
+            case PlayerStatus::GAME_OVER:
+                parea.startGameOver();
+                break;
+            case PlayerStatus::FINISHED:
+                parea.startGameFinish();
+                break;
+            case PlayerStatus::PLAYING:
+                parea.resetGameEnd();
+                break;
         }
-        assert(!possible_players.empty());
-
-        std::random_shuffle(possible_players.begin(), possible_players.end());
-        DeviceID target_id = possible_players.front();
-        assert(target_id != source_player);
-
-        const auto& src_parea = parent.player_areas.at(source_player);
-        const auto& dst_parea = parent.player_areas.at(target_id);
-        const int distance = dst_parea.wellCenterX() - src_parea.wellCenterX();
-        assert(distance != 0);
-
-        attackanims.emplace_back(
-            src_parea.wellCenterX(), distance,
-            src_parea.wellBox().y, src_parea.wellBox().y + src_parea.wellBox().h,
-            [this, &parent, target_id, sendable_lines](){
-                auto& target_player = parent.player_areas.at(target_id);
-                target_player.setGarbageCount(target_player.queuedGarbageLines() + sendable_lines);
-                sfx_ongarbageadded->playOnce();
-            });
+        shown_status = status;
     }
 }
 
-bool Gameplay::usesDynamicLineAwards(IngameState& parent)
+void Gameplay::updateAttackAnims(IngameState& parent)
 {
-    switch (parent.gamemode) {
-        case GameMode::SP_40LINES:
-        case GameMode::SP_MARATHON_SIMPLE:
-        case GameMode::MP_MARATHON_SIMPLE:
-            return false;
-        default:
-            return true;
+    attackanims.clear();
+    for (unsigned target_index = 0; target_index < player_devices.size(); target_index++) {
+        const auto& target = *player_states.at(target_index);
+        const auto& dst_parea = parent.player_areas.at(player_devices.at(target_index));
+
+        for (unsigned i = 0; i < target.incoming_attack_count; i++) {
+            const auto& attack = target.incoming_attacks[i];
+            const auto& src_parea = parent.player_areas.at(player_devices.at(attack.source));
+            const int distance = dst_parea.wellCenterX() - src_parea.wellCenterX();
+            assert(distance != 0);
+
+            attackanims.emplace_back(
+                garbage_mino,
+                src_parea.wellCenterX(), distance,
+                src_parea.wellBox().y, src_parea.wellBox().y + src_parea.wellBox().h);
+            attackanims.back().setProgress(
+                1.0 - attack.frames_left / static_cast<double>(MatchRules::attack_travel_frames));
+        }
     }
 }
 
-void Gameplay::increaseLevelMaybe(IngameState& parent, DeviceID source_player,
-                                  const WellEvent::lineclear_t& lcevent)
+void Gameplay::playSFX(const std::shared_ptr<SoundEffect>& sfx)
 {
-    auto& lines_left = lineclears_left.at(source_player);
-    int line_awards = lcevent.count;
-    if (usesDynamicLineAwards(parent)) {
-        const auto clear_type = ScoreTable::lineclearType(lcevent);
-        line_awards = ScoreTable::lineAwards(clear_type);
+    if (!resimulating)
+        sfx->playOnce();
+}
 
-        if (ScoreTable::canContinueBackToBack(previous_lineclear_type.at(source_player), clear_type))
-            line_awards *= ScoreTable::back2backMultiplier();
+void Gameplay::addPopup(DeviceID device_id, const std::string& text)
+{
+    if (!resimulating)
+        textpopups.at(device_id).emplace_back(text, font_popuptext);
+}
 
-        line_awards += combo_length.at(source_player) / 2;
-    }
-    lines_left -= line_awards;
-
-    while (lines_left <= 0) {
-        auto& parea = parent.player_areas.at(source_player);
-        auto& gravity_stack = gravity_levels.at(source_player);
-        auto& line_req_stack = lineclears_required.at(source_player);
-
-        if (line_req_stack.empty() || gravity_stack.empty()) {
-            lines_left = 0;
-            const bool finishable = (isSinglePlayer(parent.gamemode)
-                || parent.gamemode == GameMode::MP_MARATHON
-                || parent.gamemode == GameMode::MP_MARATHON_SIMPLE);
-            if (finishable) {
-                player_status.at(source_player) = PlayerStatus::FINISHED;
-                parea.startGameFinish();
-                sfx_onfinish->playOnce();
-                gameend_statistics_delay.restart();
+void Gameplay::onLineClear(IngameState& parent, unsigned player_index, const WellEvent::lineclear_t& lcevent)
+{
+    const DeviceID device_id = player_devices.at(player_index);
+    auto& player = players.at(device_id);
 
-                // find out who else is still playing
-                if (playingPlayers().empty())
-                    music->fadeOut(std::chrono::seconds(1));
-            }
-            return;
-        }
+    const auto result = rules.onLineClear(player, parent.player_stats.at(device_id), lcevent);
 
-        parea.well().setGravity(gravity_stack.top());
-        gravity_stack.pop();
-        lines_left += line_req_stack.top();
-        line_req_stack.pop();
-        parent.player_stats.at(source_player).level++;
+    if (result.type != ScoreType::CLEAR_SINGLE) {
+        std::string popup_text = ScoreTable::name(result.type);
+        if (result.back2back)
+            popup_text = ScoreTable::back2backName() + "\n" + popup_text;
+        addPopup(device_id, popup_text);
+    }
+    if (result.combo_length > 0)
+        addPopup(device_id, std::to_string(result.combo_length) + ScoreTable::name(ScoreType::COMBO));
 
-        sfx_onlevelup->playOnce();
-        textpopups.at(source_player).emplace_back(tr("LEVEL UP!"), font_popuptext);
+    auto& parea = parent.player_areas.at(device_id);
+    parea.setGarbageCount(player.queued_garbage_lines);
+    if (result.attack_lines > 0)
+        rules.sendAttack(rng, player_states, player_index, result.attack_lines);
+
+    if (result.level_ups > 0)
+        parea.well().setGravity(rules.gravity(player));
+    for (unsigned i = 0; i < result.level_ups; i++) {
+        playSFX(sfx_onlevelup);
+        addPopup(device_id, tr("LEVEL UP!"));
     }
+    if (result.finished)
+        finishGame();
+
+    texts_need_update = true;
 }
 
-void Gameplay::registerObservers(IngameState& parent, AppContext& app)
+void Gameplay::registerObservers(IngameState& parent, AppContext&)
 {
-    for (const DeviceID device_id : player_devices) {
+    for (unsigned player_index = 0; player_index < player_devices.size(); player_index++) {
+        const DeviceID device_id = player_devices.at(player_index);
         auto& well = parent.player_areas.at(device_id).well();
 
-        well.registerObserver(WellEvent::Type::PIECE_LOCKED, [this, &parent, device_id](const WellEvent&){
-            sfx_onlock->playOnce();
-
-            prev_piece_cleared_line.at(device_id) = current_piece_cleared_line.at(device_id);
-            current_piece_cleared_line.at(device_id) = false;
+        well.registerObserver(WellEvent::Type::PIECE_LOCKED, [this, device_id](const WellEvent&){
+            playSFX(sfx_onlock);
+            rules.onPieceLocked(players.at(device_id));
         });
 
         well.registerObserver(WellEvent::Type::PIECE_ROTATED, [this](const WellEvent&){
-            sfx_onrotate->playOnce();
+            playSFX(sfx_onrotate);
         });
 
         well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [this, &parent, device_id](const WellEvent&){
-            if (player_status.at(device_id) != PlayerStatus::PLAYING)
+            auto& player = players.at(device_id);
+            if (player.status != PlayerStatus::PLAYING)
                 return;
 
-            auto& parea = parent.player_areas.at(device_id);
-            pending_garbage_lines.at(device_id) = parea.queuedGarbageLines();
-            parea.setGarbageCount(0);
+            rules.onNextRequested(player);
+            parent.player_areas.at(device_id).setGarbageCount(player.queued_garbage_lines);
 
             addNextPiece(parent, device_id);
         });
@@ -346,7 +336,7 @@ void Gameplay::registerObservers(IngameState& parent, AppContext& app)
                 else
                     well.addPiece(hold_queue.swapWith(type));
 
-                sfx_onhold->playOnce();
+                playSFX(sfx_onhold);
             }
         });
 
@@ -354,80 +344,50 @@ void Gameplay::registerObservers(IngameState& parent, AppContext& app)
             assert(event.type == WellEvent::Type::LINE_CLEAR_ANIMATION_START);
             assert(event.lineclear.count > 0);
             assert(event.lineclear.count <= 4);
-            sfx_onlineclear.at(event.lineclear.count - 1)->playOnce();
+            playSFX(sfx_onlineclear.at(event.lineclear.count - 1));
         });
 
-        well.registerObserver(WellEvent::Type::LINE_CLEAR, [this, &parent, &app, device_id](const WellEvent& event){
+        well.registerObserver(WellEvent::Type::LINE_CLEAR, [this, &parent, player_index](const WellEvent& event){
             assert(event.type == WellEvent::Type::LINE_CLEAR);
-            assert(event.lineclear.count > 0);
-            assert(event.lineclear.count <= 4);
-
-            increaseScoreMaybe(parent, device_id, event.lineclear);
-            sendGarbageMaybe(parent, device_id, event.lineclear);
-            increaseLevelMaybe(parent, device_id, event.lineclear);
-
-            previous_lineclear_type.at(device_id) = ScoreTable::lineclearType(event.lineclear);
-            current_piece_cleared_line.at(device_id) = true;
-            texts_need_update = true;
+            onLineClear(parent, player_index, event.lineclear);
         });
 
         well.registerObserver(WellEvent::Type::MINI_TSPIN_DETECTED, [this, &parent, device_id](const WellEvent&){
             texts_need_update = true;
-            auto& player_stats = parent.player_stats.at(device_id);
-            player_stats.score += ScoreTable::value(ScoreType::MINI_TSPIN);
-            player_stats.event_count[ScoreType::MINI_TSPIN]++;
-
-            textpopups.at(device_id).emplace_back(ScoreTable::name(ScoreType::MINI_TSPIN), font_popuptext);
+            rules.onTSpin(parent.player_stats.at(device_id), ScoreType::MINI_TSPIN);
+            addPopup(device_id, ScoreTable::name(ScoreType::MINI_TSPIN));
         });
 
         well.registerObserver(WellEvent::Type::TSPIN_DETECTED, [this, &parent, device_id](const WellEvent&){
             texts_need_update = true;
-            auto& player_stats = parent.player_stats.at(device_id);
-            player_stats.score += ScoreTable::value(ScoreType::TSPIN);
-            player_stats.event_count[ScoreType::TSPIN]++;
-
-            textpopups.at(device_id).emplace_back(ScoreTable::name(ScoreType::TSPIN), font_popuptext);
+            rules.onTSpin(parent.player_stats.at(device_id), ScoreType::TSPIN);
+            addPopup(device_id, ScoreTable::name(ScoreType::TSPIN));
         });
 
         well.registerObserver(WellEvent::Type::HARDDROPPED, [this, &parent, device_id](const WellEvent& event){
-            assert(event.harddrop.count < 22);
             texts_need_update = true;
-            auto& player_stats = parent.player_stats.at(device_id);
-            player_stats.score += event.harddrop.count * ScoreTable::value(ScoreType::HARDDROP);
+            rules.onHardDrop(parent.player_stats.at(device_id), event.harddrop);
         });
 
         well.registerObserver(WellEvent::Type::SOFTDROPPED, [this, &parent, device_id](const WellEvent&){
             texts_need_update = true;
-            auto& player_stats = parent.player_stats.at(device_id);
-            player_stats.score += ScoreTable::value(ScoreType::SOFTDROP);
+            rules.onSoftDrop(parent.player_stats.at(device_id));
         });
 
-        well.registerObserver(WellEvent::Type::GAME_OVER, [this, &parent, &app, device_id](const WellEvent&){
+        well.registerObserver(WellEvent::Type::GAME_OVER, [this, device_id](const WellEvent&){
             // set game over for the triggering player
-            player_status.at(device_id) = PlayerStatus::GAME_OVER;
-            parent.player_areas.at(device_id).startGameOver();
-
-            // find out who else is still playing
-            auto playing_players = playingPlayers();
-
-            // IF MARATHON
-                // wait until all players finish the game
-            // IF BATTLE
-            if (parent.gamemode == GameMode::MP_BATTLE) {
-                // if there's only one player left, s/he is the winner
-                if (playing_players.size() == 1) {
-                    const DeviceID pdevid = playing_players.front();
-                    player_status.at(pdevid) = PlayerStatus::FINISHED;
-                    parent.player_areas.at(pdevid).startGameFinish();
-                    sfx_onfinish->playOnce();
-                    playing_players.clear();
-                }
-            }
+            rules.onGameOver(players.at(device_id));
+
+            // in battles, if there's only one player left, s/he is the winner
+            const int winner_index = rules.finishBattleMaybe(player_states);
+            if (winner_index >= 0)
+                playSFX(sfx_onfinish);
 
             // if everyone got KO'd, or someone won the battle, end the game
-            if (playing_players.empty()) {
+            if (playingPlayers().empty()) {
                 gameend_statistics_delay.restart();
-                music->fadeOut(std::chrono::seconds(1));
+                if (!resimulating)
+                    music->fadeOut(std::chrono::seconds(1));
             }
         });
     } // end of `for`
@@ -437,7 +397,7 @@ void Gameplay::updateAnimationsOnly(IngameState& parent, AppContext&)
 {
     for (const DeviceID device_id : player_devices) {
         auto& parea = parent.player_areas.at(device_id);
-        parea.well().updateAnimationsOnly();
+        parea.updateWellAnimations();
 
         auto& popups = textpopups.at(device_id);
 
@@ -459,9 +419,7 @@ void Gameplay::updateAnimationsOnly(IngameState& parent, AppContext&)
         }
     }
 
-    attackanims.remove_if([](BattleAttackAnim& anim){ return !anim.isActive(); });
-    for (auto& anim : attackanims)
-        anim.update();
+    updateAttackAnims(parent);
 }
 
 void Gameplay::update(IngameState& parent, const std::vector<Event>& events, AppContext& app)
@@ -469,10 +427,13 @@ void Gameplay::update(IngameState& parent, const std::vector<Event>& events, App
     const bool someone_still_playing = !playingPlayers().empty();
     std::unordered_map<DeviceID, std::vector<InputEvent>> input_events;
 
+    // the online battles can't be paused, as the other side would have to wait
+    const bool pausable = someone_still_playing && !rollback_session;
+
     for (const auto& event : events) {
         switch (event.type) {
             case EventType::WINDOW:
-                if (someone_still_playing && event.window == WindowEvent::FOCUS_LOST) {
+                if (pausable && event.window == WindowEvent::FOCUS_LOST) {
                     parent.states.emplace_back(std::make_unique<Countdown>(app));
                     parent.states.emplace_back(std::make_unique<Pause>(app));
                     return;
@@ -480,7 +441,7 @@ void Gameplay::update(IngameState& parent, const std::vector<Event>& events, App
                 break;
             case EventType::INPUT:
                 if (someone_still_playing) {
-                    if (event.input.type() == InputType::GAME_PAUSE && event.input.down()) {
+                    if (pausable && event.input.type() == InputType::GAME_PAUSE && event.input.down()) {
                         parent.states.emplace_back(std::make_unique<Countdown>(app));
                         parent.states.emplace_back(std::make_unique<Pause>(app));
                         return;
@@ -509,40 +470,27 @@ void Gameplay::update(IngameState& parent, const std::vector<Event>& events, App
         input_events.emplace(-1, std::move(temp));
     }
 
-    for (const DeviceID device_id : player_devices) {
-        if (player_status.at(device_id) == PlayerStatus::PLAYING) {
-            auto& parea = parent.player_areas.at(device_id);
-            auto& well = parea.well();
-
-            well.updateGameplayOnly(input_events[device_id]);
-            well.addGarbageLines(pending_garbage_lines.at(device_id));
-            pending_garbage_lines.at(device_id) = 0;
-
-            auto& stats = parent.player_stats.at(device_id);
-            stats.gametime += Timing::frame_duration;
-            parea.setGametime(stats.gametime);
-        }
-        parent.player_areas.at(device_id).update();
+    if (rollback_session) {
+        // every local input belongs to the local player; the session runs
+        // after the end of the match too, as the end may be rolled back
+        for (const auto& entry : input_events)
+            local_keys = Net::applyEvents(local_keys, entry.second);
+        rollback_session->update(local_keys);
     }
-
-    if (parent.gamemode == GameMode::SP_2MIN && someone_still_playing) {
-        assert(parent.device_order.size() == 1);
-        const DeviceID device_id = parent.device_order.front();
-        const auto gametime = parent.player_stats.at(device_id).gametime;
-        if (gametime >= std::chrono::minutes(2)) {
-            player_status.at(device_id) = PlayerStatus::FINISHED;
-            parent.player_areas.at(device_id).startGameFinish();
-            sfx_onfinish->playOnce();
-            gameend_statistics_delay.restart();
-            music->fadeOut(std::chrono::seconds(1));
-        }
+    else {
+        updateBots(parent, input_events);
+        simulateFrame(parent, input_events);
     }
 
+    updateGameEndAnims(parent);
+    for (const DeviceID device_id : player_devices)
+        parent.player_areas.at(device_id).update();
+
     if (texts_need_update) {
         for (const DeviceID device_id : player_devices) {
             const auto& stats = parent.player_stats.at(device_id);
             auto& parea = parent.player_areas.at(device_id);
-            parea.setGoalCounter(lineclears_left.at(device_id));
+            parea.setGoalCounter(players.at(device_id).lineclears_left);
             parea.setLevelCounter(app.theme().gameplay.draw_labels, stats.level);
             parea.setScore(stats.score);
         }
@@ -554,6 +502,89 @@ void Gameplay::update(IngameState& parent, const std::vector<Event>& events, App
     updateAnimationsOnly(parent, app);
 }
 
+void Gameplay::simulateFrame(IngameState& parent, std::unordered_map<DeviceID, std::vector<InputEvent>>& input_events)
+{
+    for (const DeviceID device_id : player_devices) {
+        auto& player = players.at(device_id);
+        if (player.status != PlayerStatus::PLAYING)
+            continue;
+
+        auto& parea = parent.player_areas.at(device_id);
+        auto& well = parea.well();
+
+        well.updateGameplayOnly(input_events[device_id]);
+        well.addGarbageLines(player.pending_garbage_lines);
+        player.pending_garbage_lines = 0;
+
+        // the time limit of the game may be reached
+        auto& stats = parent.player_stats.at(device_id);
+        if (rules.onFrameEnd(player, stats))
+            finishGame();
+        parea.setGametime(stats.gametime);
+    }
+
+    for (unsigned player_index = 0; player_index < player_devices.size(); player_index++) {
+        auto& player = *player_states.at(player_index);
+        if (rules.updateIncomingAttacks(player) > 0) {
+            parent.player_areas.at(player_devices.at(player_index)).setGarbageCount(player.queued_garbage_lines);
+            playSFX(sfx_ongarbageadded);
+        }
+    }
+}
+
+void Gameplay::saveState(unsigned slot)
+{
+    auto& saved = rollback_states.at(slot);
+    saved.frame = rollback_frame;
+    saved.rng = rng.snapshot();
+    saved.keys = rollback_keys;
+    for (unsigned i = 0; i < Net::player_count; i++)
+        savePlayer(rollback_parent, player_devices.at(i), saved.players[i]);
+}
+
+void Gameplay::loadState(unsigned slot)
+{
+    const auto& saved = rollback_states.at(slot);
+    rollback_frame = saved.frame;
+    rng.restore(saved.rng);
+    rollback_keys = saved.keys;
+    for (unsigned i = 0; i < Net::player_count; i++)
+        restorePlayer(rollback_parent, player_devices.at(i), saved.players[i]);
+
+    // the end of the match may have been mispredicted
+    if (playingPlayers().size() == Net::player_count)
+        gameend_statistics_delay.stop();
+}
+
+void Gameplay::advanceFrame(const std::array<Net::InputBits, Net::player_count>& keys)
+{
+    resimulating = rollback_frame < first_new_frame;
+
+    std::unordered_map<DeviceID, std::vector<InputEvent>> input_events;
+    for (unsigned i = 0; i < Net::player_count; i++) {
+        const DeviceID device_id = player_devices.at(i);
+        auto& events = input_events[device_id];
+        Net::toEvents(rollback_keys[i], keys[i], device_id, events);
+        rollback_parent.player_areas.at(device_id).well().updateKeystateOnly(events);
+    }
+    rollback_keys = keys;
+    simulateFrame(rollback_parent, input_events);
+
+    rollback_frame++;
+    first_new_frame = std::max(first_new_frame, rollback_frame);
+    resimulating = false;
+}
+
+uint64_t Gameplay::stateHash() const
+{
+    uint64_t hash = 0;
+    stateHash(rollback_parent, hash);
+    hash = Hash::combine(hash, rollback_frame);
+    for (const Net::InputBits player_keys : rollback_keys)
+        hash = Hash::combine(hash, player_keys);
+    return hash;
+}
+
 void Gameplay::drawPassive(IngameState& parent, GraphicsContext& gcx) const
 {
     for (const auto& parea : parent.player_areas)
@@ -575,6 +606,199 @@ void Gameplay::drawActive(IngameState& parent, GraphicsContext& gcx) const
         parea.second.drawActive(gcx);
 }
 
+void Gameplay::savePlayer(IngameState& parent, DeviceID device_id, PlayerSnapshot& saved) const
+{
+    auto& parea = parent.player_areas.at(device_id);
+    saved.gameplay = players.at(device_id);
+    saved.stats = parent.player_stats.at(device_id);
+    saved.hold_queue = parea.holdQueue().snapshot();
+    saved.next_queue = parea.nextQueue().snapshot();
+    saved.well = parea.well().snapshot();
+}
+
+void Gameplay::restorePlayer(IngameState& parent, DeviceID device_id, const PlayerSnapshot& saved)
+{
+    auto& player = players.at(device_id);
+    player = saved.gameplay;
+    parent.player_stats.at(device_id) = saved.stats;
+
+    auto& parea = parent.player_areas.at(device_id);
+    parea.setGarbageCount(player.queued_garbage_lines);
+    parea.holdQueue().restore(saved.hold_queue);
+    parea.nextQueue().restore(saved.next_queue);
+    parea.well().restore(saved.well);
+    parea.setGametime(saved.stats.gametime);
+
+    texts_need_update = true;
+}
+
+bool Gameplay::saveKeyframe(IngameState& parent, Replay::KeyframeWriter& keyframe) const
+{
+    // the ending of the match depends on animations, which are not saved
+    if (gameend_statistics_delay.running())
+        return false;
+
+    keyframe.writeVarint(rng.snapshot());
+    PlayerSnapshot saved;
+    for (const DeviceID device_id : player_devices) {
+        savePlayer(parent, device_id, saved);
+
+        const auto& player = saved.gameplay;
+        keyframe.writeByte(static_cast<uint8_t>(player.status));
+        keyframe.writeVarint(player.lineclear_levels_left);
+        keyframe.writeSigned(player.lineclears_left);
+        keyframe.writeVarint(player.gravity_levels_left);
+        keyframe.writeByte(static_cast<uint8_t>(player.previous_lineclear_type));
+        keyframe.writeVarint(player.back2back_length);
+        keyframe.writeVarint(player.combo_length);
+        keyframe.writeBool(player.prev_piece_cleared_line);
+        keyframe.writeBool(player.current_piece_cleared_line);
+        keyframe.writeVarint(player.pending_garbage_lines);
+
+        const auto& stats = saved.stats;
+        keyframe.writeVarint(stats.score);
+        keyframe.writeByte(stats.level);
+        keyframe.writeVarint(stats.total_cleared_lines);
+        keyframe.writeVarint(stats.back_to_back_count);
+        keyframe.writeVarint(stats.back_to_back_longest);
+        keyframe.writeDuration(stats.gametime);
+        // only the events that happened at least once
+        const auto event_types = std::count_if(stats.event_count.cbegin(), stats.event_count.cend(),
+            [](unsigned short count){ return count > 0; });
+        keyframe.writeByte(static_cast<uint8_t>(event_types));
+        for (unsigned type = 0; type < ScoreTypeCount; type++) {
+            if (stats.event_count[type] == 0)
+                continue;
+            keyframe.writeByte(type);
+            keyframe.writeVarint(stats.event_count[type]);
+        }
+
+        keyframe.writeBool(saved.hold_queue.swap_allowed);
+        keyframe.writeBool(saved.hold_queue.empty);
+        keyframe.writeByte(static_cast<uint8_t>(saved.hold_queue.current_piece));
+        keyframe.writeVarint(saved.gameplay.queued_garbage_lines);
+        keyframe.writeByte(saved.gameplay.incoming_attack_count);
+        for (unsigned i = 0; i < saved.gameplay.incoming_attack_count; i++) {
+            const auto& attack = saved.gameplay.incoming_attacks[i];
+            keyframe.writeByte(attack.source);
+            keyframe.writeByte(attack.lines);
+            keyframe.writeVarint(attack.frames_left);
+        }
+        keyframe.writePieceQueue(saved.next_queue);
+        keyframe.writeWell(saved.well);
+    }
+    return true;
+}
+
+bool Gameplay::stateHash(IngameState& parent, uint64_t& output) const
+{
+    uint64_t hash = rng.snapshot();
+    for (const DeviceID device_id : player_devices) {
+        const auto& player = players.at(device_id);
+        hash = Hash::combine(hash, static_cast<uint8_t>(player.status));
+        hash = Hash::combine(hash, player.lineclear_levels_left);
+        hash = Hash::combine(hash, static_cast<uint32_t>(player.lineclears_left));
+        hash = Hash::combine(hash, player.gravity_levels_left);
+        hash = Hash::combine(hash, static_cast<uint8_t>(player.previous_lineclear_type));
+        hash = Hash::combine(hash, player.back2back_length);
+        hash = Hash::combine(hash, player.combo_length);
+        hash = Hash::combine(hash, player.prev_piece_cleared_line);
+        hash = Hash::combine(hash, player.current_piece_cleared_line);
+        hash = Hash::combine(hash, player.pending_garbage_lines);
+
+        const auto& stats = parent.player_stats.at(device_id);
+        hash = Hash::combine(hash, stats.score);
+        hash = Hash::combine(hash, stats.level);
+        hash = Hash::combine(hash, stats.total_cleared_lines);
+        hash = Hash::combine(hash, stats.back_to_back_count);
+        hash = Hash::combine(hash, stats.back_to_back_longest);
+        hash = Hash::combine(hash, stats.gametime.count());
+
+        auto& parea = parent.player_areas.at(device_id);
+        const auto& hold_queue = parea.holdQueue();
+        hash = Hash::combine(hash, hold_queue.swapAllowed());
+        hash = Hash::combine(hash, hold_queue.isEmpty());
+        hash = Hash::combine(hash, static_cast<uint8_t>(hold_queue.heldPiece()));
+        hash = Hash::combine(hash, player.queued_garbage_lines);
+        for (unsigned i = 0; i < player.incoming_attack_count; i++) {
+            hash = Hash::combine(hash, player.incoming_attacks[i].source);
+            hash = Hash::combine(hash, player.incoming_attacks[i].lines);
+            hash = Hash::combine(hash, player.incoming_attacks[i].frames_left);
+        }
+        hash = Hash::combine(hash, parea.nextQueue().pieces().stateHash());
+        hash = Hash::combine(hash, parea.well().stateHash());
+    }
+    output = hash;
+    return true;
+}
+
+void Gameplay::loadKeyframe(IngameState& parent, Replay::KeyframeReader& keyframe, uint8_t format_version)
+{
+    rng.restore(keyframe.readVarint());
+    PlayerSnapshot saved;
+    for (const DeviceID device_id : player_devices) {
+        auto& player = saved.gameplay;
+        player = rules.newPlayer();
+        player.status = keyframe.readEnum(PlayerStatus::FINISHED);
+        const uint64_t lineclear_levels = keyframe.readVarint();
+        player.lineclears_left = keyframe.readSigned();
+        const uint64_t gravity_levels_count = keyframe.readVarint();
+        // the levels are counted from the beginning of the level tables
+        if (lineclear_levels >= rules.lineclearLevelCount() || gravity_levels_count >= rules.gravityLevelCount())
+            throw std::runtime_error("Invalid keyframe in the replay");
+        player.lineclear_levels_left = lineclear_levels;
+        player.gravity_levels_left = gravity_levels_count;
+
+        player.previous_lineclear_type = keyframe.readEnum(ScoreType::COMBO);
+        player.back2back_length = keyframe.readVarint();
+        player.combo_length = keyframe.readVarint();
+        player.prev_piece_cleared_line = keyframe.readBool();
+        player.current_piece_cleared_line = keyframe.readBool();
+        player.pending_garbage_lines = keyframe.readVarint();
+
+        auto& stats = saved.stats;
+        stats = PlayerStatistics();
+        stats.score = keyframe.readVarint();
+        stats.level = keyframe.readByte();
+        stats.total_cleared_lines = keyframe.readVarint();
+        stats.back_to_back_count = keyframe.readVarint();
+        stats.back_to_back_longest = keyframe.readVarint();
+        stats.gametime = keyframe.readDuration();
+        const uint8_t event_types = keyframe.readByte();
+        for (unsigned i = 0; i < event_types; i++) {
+            const ScoreType type = keyframe.readEnum(ScoreType::COMBO);
+            stats.eventCount(type) = keyframe.readVarint();
+        }
+
+        saved.hold_queue.swap_allowed = keyframe.readBool();
+        saved.hold_queue.empty = keyframe.readBool();
+        saved.hold_queue.current_piece = keyframe.readEnum(PieceType::Z);
+        saved.gameplay.queued_garbage_lines = std::min<uint64_t>(keyframe.readVarint(), MatchRules::max_queued_garbage);
+        if (format_version >= Replay::keyframe_attacks_version) {
+            const uint8_t attack_count = keyframe.readByte();
+            if (attack_count > MatchRules::max_incoming_attacks)
+                throw std::runtime_error("Invalid keyframe in the replay");
+            for (unsigned i = 0; i < attack_count; i++) {
+                auto& attack = player.incoming_attacks[i];
+                const uint8_t source = keyframe.readByte();
+                const uint8_t lines = keyframe.readByte();
+                const uint64_t frames_left = keyframe.readVarint();
+                if (source >= player_devices.size() || player_devices.at(source) == device_id
+                    || lines > MatchRules::max_queued_garbage
+                    || frames_left == 0 || frames_left > MatchRules::attack_travel_frames)
+                    throw std::runtime_error("Invalid keyframe in the replay");
+                attack = {source, lines, static_cast<uint16_t>(frames_left)};
+            }
+            player.incoming_attack_count = attack_count;
+        }
+        keyframe.readPieceQueue(saved.next_queue);
+        keyframe.readWell(saved.well);
+
+        restorePlayer(parent, device_id, saved);
+    }
+    updateGameEndAnims(parent);
+}
+
 } // namespace States
 } // namespace Ingame
 } // namespace SubStates
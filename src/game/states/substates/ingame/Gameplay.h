@@ -1,29 +1,45 @@
 #pragma once
 
+#include "game/MatchRules.h"
+#include "game/PlayerStatistics.h"
 #include "game/Theme.h"
 #include "game/ScoreTable.h"
 #include "game/Transition.h"
+#include "game/components/HoldQueue.h"
+#include "game/components/PieceQueue.h"
+#include "game/components/Well.h"
 #include "game/components/animations/BattleAttack.h"
+#include "game/net/Rollback.h"
+#include "game/util/Random.h"
 #include "game/states/substates/Ingame.h"
 
 #include <array>
 #include <list>
 #include <memory>
-#include <stack>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 class Font;
+class Mino;
 class Music;
 class SoundEffect;
 class TextPopup;
 class Texture;
+class ThreadPool;
+namespace AI { class Bot; }
+namespace Replay { class KeyframeReader; }
 
 
 namespace SubStates {
 namespace Ingame {
 namespace States {
 
-class Gameplay : public State {
+/// The match itself. In the online battles, the match is also the game of
+/// a rollback session: the remote player's inputs come from the session,
+/// and the match is rolled back when they were mispredicted.
+class Gameplay : public State, private Net::RollbackGame {
 public:
     Gameplay(AppContext&, IngameState&, unsigned short starting_gravity_level = 0);
     virtual ~Gameplay();
@@ -33,13 +49,40 @@ public:
     void drawPassive(IngameState&, GraphicsContext&) const final;
     void drawActive(IngameState&, GraphicsContext&) const final;
 
+    bool saveKeyframe(IngameState&, Replay::KeyframeWriter&) const final;
+    /// Continue the match from a replay keyframe of the given format version;
+    /// the match has to be created with the same players as when the keyframe was saved
+    void loadKeyframe(IngameState&, Replay::KeyframeReader&, uint8_t format_version);
+    /// A hash of the match, from the same fields as the keyframes
+    bool stateHash(IngameState&, uint64_t&) const final;
+
+    using PlayerStatus = MatchRules::PlayerStatus;
+    using PlayerState = MatchRules::PlayerState;
+    /// Everything that affects the rest of a player's game, without the
+    /// animations. It's plain data of a fixed size, so it can be copied
+    /// with memcpy, eg. for rolling back or trying out moves.
+    struct PlayerSnapshot {
+        PlayerState gameplay;
+        PlayerStatistics stats;
+        HoldQueue::Snapshot hold_queue;
+        PieceQueue::Snapshot next_queue;
+        Well::Snapshot well;
+    };
+    void savePlayer(IngameState&, DeviceID, PlayerSnapshot&) const;
+    void restorePlayer(IngameState&, DeviceID, const PlayerSnapshot&);
+
 private:
     const std::vector<DeviceID> player_devices;
 
+    // every random decision of the match depends only on this seed
+    const uint64_t random_seed;
+    Random rng;
+
     const GameplayTheme theme_settings;
 
     std::shared_ptr<Music> music;
     std::shared_ptr<Font> font_popuptext;
+    std::shared_ptr<Mino> garbage_mino;
     std::shared_ptr<SoundEffect> sfx_onhold;
     std::shared_ptr<SoundEffect> sfx_onlevelup;
     std::array<std::shared_ptr<SoundEffect>, 4> sfx_onlineclear;
@@ -51,40 +94,69 @@ private:
     std::shared_ptr<SoundEffect> sfx_ongameover;
     std::shared_ptr<SoundEffect> sfx_onfinish;
 
-    std::unordered_map<DeviceID, std::stack<unsigned short>> lineclears_required;
-    std::unordered_map<DeviceID, int> lineclears_left;
-    bool usesDynamicLineAwards(IngameState&);
-
-    std::unordered_map<DeviceID, std::stack<Duration>> gravity_levels;
-    std::unordered_map<DeviceID, ScoreType> previous_lineclear_type;
-    std::unordered_map<DeviceID, unsigned short> back2back_length;
+    const MatchRules rules;
+    std::unordered_map<DeviceID, PlayerState> players;
+    /// The states of the players, in the order of `player_devices`
+    std::vector<PlayerState*> player_states;
 
-    std::unordered_map<DeviceID, unsigned short> combo_length;
-    std::unordered_map<DeviceID, bool> prev_piece_cleared_line;
-    std::unordered_map<DeviceID, bool> current_piece_cleared_line;
-
-    std::unordered_map<DeviceID, unsigned short> pending_garbage_lines;
     std::unordered_map<DeviceID, std::list<TextPopup>> textpopups;
-    std::list<BattleAttackAnim> attackanims;
+    /// The attacks in flight, recreated from the player states in every frame
+    std::vector<BattleAttackAnim> attackanims;
+    /// The game end animations of the player areas are started
+    /// when the state of their player differs from these
+    std::unordered_map<DeviceID, PlayerStatus> shown_statuses;
 
     Transition<unsigned> gameend_statistics_delay;
 
-    enum class PlayerStatus : uint8_t {
-        PLAYING,
-        GAME_OVER,
-        FINISHED,
+    // the CPU players; the bots have to be destroyed before their workers
+    std::unique_ptr<ThreadPool> bot_workers;
+    std::unordered_map<DeviceID, std::unique_ptr<AI::Bot>> bots;
+    void createBots(IngameState&, AppContext&);
+    void updateBots(IngameState&, std::unordered_map<DeviceID, std::vector<InputEvent>>&);
+
+    // the online battles
+    /// The rollback callbacks have no other access to the parent state
+    IngameState& rollback_parent;
+    std::unique_ptr<Net::RollbackSession> rollback_session;
+    struct RollbackState {
+        uint32_t frame;
+        uint64_t rng;
+        std::array<Net::InputBits, Net::player_count> keys;
+        std::array<PlayerSnapshot, Net::player_count> players;
     };
-    std::unordered_map<DeviceID, PlayerStatus> player_status;
+    std::vector<RollbackState> rollback_states;
+    /// The key states of the players in the previous simulated frame
+    std::array<Net::InputBits, Net::player_count> rollback_keys;
+    Net::InputBits local_keys;
+    uint32_t rollback_frame;
+    /// The frames before this one were already simulated once; when they're
+    /// simulated again, their sounds and popups are not repeated
+    uint32_t first_new_frame;
+    bool resimulating;
+
+    void saveState(unsigned slot) final;
+    void loadState(unsigned slot) final;
+    void advanceFrame(const std::array<Net::InputBits, Net::player_count>&) final;
+    uint64_t stateHash() const final;
 
     std::vector<DeviceID> playingPlayers();
     void addNextPiece(IngameState&, DeviceID);
     void registerObservers(IngameState&, AppContext&);
+    /// Update the wells of the playing players, then the attacks in flight
+    void simulateFrame(IngameState&, std::unordered_map<DeviceID, std::vector<InputEvent>>&);
+
+    void onLineClear(IngameState&, unsigned player_index, const WellEvent::lineclear_t&);
+    void finishGame();
+    void updateGameEndAnims(IngameState&);
+    void updateAttackAnims(IngameState&);
 
-    void increaseScoreMaybe(IngameState&, DeviceID, const WellEvent::lineclear_t&);
-    void sendGarbageMaybe(IngameState&, DeviceID, const WellEvent::lineclear_t&);
-    void increaseLevelMaybe(IngameState&, DeviceID, const WellEvent::lineclear_t&);
+    // the sounds and popups are skipped in the re-simulated frames
+    void playSFX(const std::shared_ptr<SoundEffect>&);
+    void addPopup(DeviceID, const std::string&);
 };
 
+static_assert(std::is_trivially_copyable<Gameplay::PlayerSnapshot>::value, "Player snapshots must be plain data");
+
 } // namespace States
 } // namespace Ingame
 } // namespace SubStates
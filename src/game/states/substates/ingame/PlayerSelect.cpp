@@ -4,6 +4,7 @@
 #include "FadeInOut.h"
 #include "Gameplay.h"
 #include "game/AppContext.h"
+#include "game/ai/Bot.h"
 #include "game/components/Mino.h"
 #include "game/components/MinoStorage.h"
 #include "game/states/IngameState.h"
@@ -16,6 +17,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <set>
 
 
 namespace SubStates {
@@ -27,6 +29,7 @@ static const int well_height = 20 * Mino::texture_size_px;
 static const int well_padding_x = Mino::texture_size_px;
 
 PlayerSelect::PlayerSelect(AppContext& app)
+    : mino_storage(app.minos())
 {
     auto font_smaller = app.gcx().loadFont(Paths::data() + "fonts/PTS75F.ttf", 30);
     auto font_player = app.gcx().loadFont(Paths::data() + "fonts/PTS75F.ttf", 45);
@@ -38,6 +41,9 @@ PlayerSelect::PlayerSelect(AppContext& app)
     tex_player.at(3) = font_player->renderText(tr("PLAYER D"), 0xEEEE10_rgb);
     tex_pending = font_smaller->renderText(tr("PRESS START\nTO JOIN"), app.theme().colors.mainmenu_highlight);
     tex_begin = font_ready->renderText(tr("PRESS START TO BEGIN!"), app.theme().colors.mainmenu_highlight);
+    tex_cpu = font_ready->renderText(tr("CPU"), app.theme().colors.mainmenu_highlight);
+    tex_cpu_hint = font_smaller->renderText(tr("UP/DOWN: ADD OR REMOVE CPU PLAYERS"),
+                                            app.theme().colors.mainmenu_highlight);
 }
 
 void PlayerSelect::onPlayerJoin(DeviceID device_id)
@@ -66,9 +72,42 @@ void PlayerSelect::onPlayerJoin(DeviceID device_id)
 void PlayerSelect::onPlayerLeave(DeviceID device_id)
 {
     player_colors.erase(device_id);
-    for (auto& entry : column_slots) {
-        if (entry.second == device_id)
-            column_slots.erase(entry.first);
+    for (auto it = column_slots.begin(); it != column_slots.end();) {
+        if (it->second == device_id)
+            it = column_slots.erase(it);
+        else
+            ++it;
+    }
+}
+
+void PlayerSelect::onCpuAdd(DeviceID requester)
+{
+    // only the joined players can add CPUs
+    if (!player_colors.count(requester))
+        return;
+
+    if (column_slots.size() == MAX_PLAYERS)
+        return;
+
+    for (DeviceID bot_id = AI::first_bot_device; AI::isBotDevice(bot_id); bot_id++) {
+        if (!player_colors.count(bot_id)) {
+            onPlayerJoin(bot_id);
+            return;
+        }
+    }
+}
+
+void PlayerSelect::onCpuRemove(DeviceID requester)
+{
+    if (!player_colors.count(requester))
+        return;
+
+    // remove the last added one
+    for (DeviceID bot_id = AI::first_bot_device + AI::max_bot_count - 1; AI::isBotDevice(bot_id); bot_id--) {
+        if (player_colors.count(bot_id)) {
+            onPlayerLeave(bot_id);
+            return;
+        }
     }
 }
 
@@ -187,6 +226,14 @@ void PlayerSelect::update(IngameState& parent, const std::vector<Event>& events,
                 case InputType::MENU_RIGHT:
                     onPlayerNextWell(event.input.srcDeviceID());
                     break;
+                case InputType::MENU_UP:
+                    if (parent.gamemode == GameMode::MP_BATTLE)
+                        onCpuAdd(event.input.srcDeviceID());
+                    break;
+                case InputType::MENU_DOWN:
+                    if (parent.gamemode == GameMode::MP_BATTLE)
+                        onCpuRemove(event.input.srcDeviceID());
+                    break;
                 default:
                     break;
                 }
@@ -212,28 +259,34 @@ void PlayerSelect::drawPassive(IngameState& parent, GraphicsContext& gcx) const
         else {
             const DeviceID player_device = column_slots.at(column);
             assert(player_colors.count(player_device));
-            drawJoinedWell(gcx, well_x, well_y, player_colors.at(player_device));
+            drawJoinedWell(gcx, well_x, well_y, player_colors.at(player_device),
+                           AI::isBotDevice(player_device));
         }
         well_x += well_full_width;
     }
 
+    const int center_x = gcx.screenWidth() * parent.draw_inverse_scale / 2;
     if (column_slots.size() > 1) {
-        const int center_x = gcx.screenWidth() * parent.draw_inverse_scale / 2;
         tex_begin->drawAt(center_x - tex_begin->width() / 2,
                           well_y + well_height + 20);
     }
+    else if (parent.gamemode == GameMode::MP_BATTLE && !column_slots.empty()) {
+        tex_cpu_hint->drawAt(center_x - tex_cpu_hint->width() / 2,
+                             well_y + well_height + 20);
+    }
 }
 
 void PlayerSelect::drawWellBackground(GraphicsContext&, int x, int y) const
 {
-    const auto& cell = MinoStorage::getMatrixCell();
+    const auto matrixcell = mino_storage.getMatrixCell();
     for (unsigned row = 0; row < 20; row++) {
         for (unsigned col = 0; col < 10; col++)
-            cell->draw(x + col * Mino::texture_size_px, y + row * Mino::texture_size_px);
+            matrixcell->addSprite(sprite_batch, x + col * Mino::texture_size_px, y + row * Mino::texture_size_px);
     }
+    mino_storage.drawSprites(sprite_batch);
 }
 
-void PlayerSelect::drawJoinedWell(GraphicsContext& gcx, int x, int y, uint8_t player_id) const
+void PlayerSelect::drawJoinedWell(GraphicsContext& gcx, int x, int y, uint8_t player_id, bool is_cpu) const
 {
     assert(player_id < 4);
 
@@ -241,8 +294,9 @@ void PlayerSelect::drawJoinedWell(GraphicsContext& gcx, int x, int y, uint8_t pl
     drawWellBackground(gcx, x, y);
 
     const int center_y = well_height / 2;
-    tex_ok->drawAt(x + (well_width - tex_ok->width()) / 2,
-                   y + center_y);
+    const auto& status_tex = is_cpu ? tex_cpu : tex_ok;
+    status_tex->drawAt(x + (well_width - status_tex->width()) / 2,
+                       y + center_y);
 
     const auto& player_tex = tex_player.at(player_id);
     player_tex->drawAt(x + (well_width - player_tex->width()) / 2,
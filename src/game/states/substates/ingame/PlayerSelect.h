@@ -1,13 +1,15 @@
 #pragma once
 
 #include "game/states/substates/Ingame.h"
+#include "system/Texture.h"
 
 #include <array>
 #include <map>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
-class Texture;
+class MinoStorage;
 
 
 namespace SubStates {
@@ -29,15 +31,22 @@ private:
     std::unique_ptr<Texture> tex_ok;
     std::unique_ptr<Texture> tex_pending;
     std::unique_ptr<Texture> tex_begin;
+    std::unique_ptr<Texture> tex_cpu;
+    std::unique_ptr<Texture> tex_cpu_hint;
+    const MinoStorage& mino_storage;
+    mutable std::vector<SpriteQuad> sprite_batch;
 
     void onPlayerJoin(DeviceID);
     void onPlayerLeave(DeviceID);
+    /// Add or remove a CPU player, on the request of a joined human player
+    void onCpuAdd(DeviceID requester);
+    void onCpuRemove(DeviceID requester);
 
     void onPlayerPrevWell(DeviceID);
     void onPlayerNextWell(DeviceID);
     uint8_t columnOfPlayer(DeviceID);
 
-    void drawJoinedWell(GraphicsContext&, int x, int y, uint8_t player_id) const;
+    void drawJoinedWell(GraphicsContext&, int x, int y, uint8_t player_id, bool is_cpu) const;
     void drawPendingWell(GraphicsContext&, int x, int y) const;
     void drawWellBackground(GraphicsContext&, int x, int y) const;
 };
@@ -49,24 +49,23 @@ Statistics::Statistics(IngameState& parent, AppContext& app)
 
     for (const DeviceID device_id : parent.device_order) {
         auto& stats = parent.player_stats.at(device_id);
-        auto& event_cnt = stats.event_count;
         auto& texs = scores[device_id];
 
         texs.emplace_back(font->renderText(std::to_string(stats.total_cleared_lines), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_SINGLE]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_DOUBLE]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_TRIPLE]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_PERFECT]), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_SINGLE)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_DOUBLE)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_TRIPLE)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_PERFECT)), color));
 
         texs.emplace_back(font->renderText(std::to_string(stats.back_to_back_count), color));
         texs.emplace_back(font->renderText(std::to_string(stats.back_to_back_longest), color));
 
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::MINI_TSPIN]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_MINI_TSPIN_SINGLE]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::TSPIN]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_TSPIN_SINGLE]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_TSPIN_DOUBLE]), color));
-        texs.emplace_back(font->renderText(std::to_string(event_cnt[ScoreType::CLEAR_TSPIN_TRIPLE]), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::MINI_TSPIN)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_MINI_TSPIN_SINGLE)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::TSPIN)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_TSPIN_SINGLE)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_TSPIN_DOUBLE)), color));
+        texs.emplace_back(font->renderText(std::to_string(stats.eventCount(ScoreType::CLEAR_TSPIN_TRIPLE)), color));
 
         texs.emplace_back(font->renderText(Timing::toString(stats.gametime), color));
         texs.emplace_back(font_highlight->renderText(std::to_string(stats.level), color_highlight));
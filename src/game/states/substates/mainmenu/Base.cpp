@@ -4,8 +4,6 @@
 #include "game/AppContext.h"
 #include "game/Theme.h"
 #include "game/components/MinoStorage.h"
-#include "game/components/PieceFactory.h"
-#include "game/components/rotations/SRS.h"
 #include "game/states/MainMenuState.h"
 #include "game/states/IngameState.h"
 #include "game/util/CircularModulo.h"
@@ -23,12 +21,12 @@ namespace SubStates {
 namespace MainMenu {
 
 Base::Base(MainMenuState& parent, AppContext& app)
-    : current_column(&primary_buttons)
+    : mino_storage(app.minos())
+    , current_column(&primary_buttons)
     , column_slide_anim(std::chrono::milliseconds(350),
                         [](double t){ return t; },
                         [this](){  })
 {
-    PieceFactory::changeInitialPositions(Rotations::SRS().initialPositions());
     column_slide_anim.stop();
 
     desc_rect = { 0, 0, 0, 0 };
@@ -59,9 +57,7 @@ void Base::reloadTheme(MainMenuState& parent, AppContext& app)
 
 void Base::reloadGameAssets(AppContext& app)
 {
-    MinoStorage::loadMinos(app);
-    MinoStorage::loadGhosts(app);
-    MinoStorage::loadMatrixCell(app.gcx(), app.theme().get_texture("matrix.png"));
+    app.minos().load(app);
 }
 
 void Base::reloadUI(MainMenuState& parent, AppContext& app)
@@ -351,7 +347,7 @@ void Base::draw(MainMenuState&, GraphicsContext& gcx) const
     tex_background->drawScaled(screen_rect);
 
     for (const auto& rain : rains)
-        rain.draw();
+        rain.draw(mino_storage);
 
     logo->draw();
 
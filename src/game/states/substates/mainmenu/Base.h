@@ -10,6 +10,7 @@
 #include <memory>
 
 class GameState;
+class MinoStorage;
 class Music;
 class SoundEffect;
 class Texture;
@@ -35,6 +36,7 @@ private:
     ::Rectangle screen_rect;
     std::unique_ptr<Texture> tex_background;
     std::unique_ptr<Layout::Logo> logo;
+    const MinoStorage& mino_storage;
     std::array<Layout::PieceRain, 2> rains;
     ::Rectangle desc_rect;
     RGBAColor desc_panel_color;
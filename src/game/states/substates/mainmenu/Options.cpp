@@ -83,6 +83,26 @@ Options::Options(MainMenuState& parent, AppContext& app)
                 app.sysconfig().theme_dir_name = val;
                 parent.reloadTheme(app);
             }));
+        system_options.back()->setMarginBottom(40);
+
+        system_options.emplace_back(std::make_shared<ValueChooser>(app,
+            std::vector<std::string>({tr("Easy"), tr("Medium"), tr("Hard"), tr("Expert")}),
+            static_cast<size_t>(app.sysconfig().cpu_difficulty),
+            tr("CPU difficulty"),
+            tr("The strength of the CPU players in battle mode."),
+            [&app](const std::string& val){
+                static const std::unordered_map<std::string, AI::BotDifficulty> map = {
+                    {tr("Easy"), AI::BotDifficulty::EASY},
+                    {tr("Medium"), AI::BotDifficulty::MEDIUM},
+                    {tr("Hard"), AI::BotDifficulty::HARD},
+                    {tr("Expert"), AI::BotDifficulty::EXPERT},
+                };
+                app.sysconfig().cpu_difficulty = map.at(val);
+            }));
+        system_options.emplace_back(std::make_shared<ToggleButton>(
+            app, app.sysconfig().record_replays, tr("Record replays"),
+            tr("Save the replay of every game into the configuration directory."),
+            [&app](bool val){ app.sysconfig().record_replays = val; }));
     }
     subitem_panels.push_back(std::move(system_options));
 
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Bit scanning helpers for 64-bit masks, using the compiler intrinsics
+// where they are available.
+
+/// The index of the lowest set bit; the mask must not be zero
+inline unsigned lowestSetBit(uint64_t mask) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return index;
+#else
+    unsigned index = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/// The index of the highest set bit; the mask must not be zero
+inline unsigned highestSetBit(uint64_t mask) {
+#if defined(__GNUC__)
+    return 63 - static_cast<unsigned>(__builtin_clzll(mask));
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, mask);
+    return index;
+#else
+    unsigned index = 0;
+    while (mask >>= 1)
+        index++;
+    return index;
+#endif
+}
+
+/// The number of set bits
+inline unsigned countSetBits(uint64_t mask) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcountll(mask));
+#else
+    unsigned count = 0;
+    for (; mask; mask &= mask - 1)
+        count++;
+    return count;
+#endif
+}
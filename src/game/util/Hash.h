@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Hashing helpers for checksums of the game state. Unlike `std::hash`,
+// the results are the same on every platform and in every run, so the
+// checksums can be saved into replays and compared over the network.
+namespace Hash {
+
+/// Scramble the bits of the value (the finalizer of SplitMix64);
+/// different inputs always give different outputs
+constexpr uint64_t mix(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+/// Add a value to a hash; the result depends on the order of the values
+constexpr uint64_t combine(uint64_t hash, uint64_t value) {
+    return mix(hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2)));
+}
+
+} // namespace Hash
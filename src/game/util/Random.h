@@ -0,0 +1,71 @@
+#pragma once
+
+#include <iterator>
+#include <random>
+#include <utility>
+#include <stdint.h>
+
+
+/// A small, seedable pseudo-random number generator (PCG32).
+/// Every match and player owns its own instance, so the results only depend
+/// on the seed: games can be reproduced, and can run on multiple threads
+/// without sharing any global state. Unlike the standard library distributions,
+/// the output is the same on every platform.
+class Random {
+public:
+    explicit Random(uint64_t seed = 0) { setSeed(seed); }
+
+    /// Restart the sequence from the seed
+    void setSeed(uint64_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    /// The internal state of the generator, eg. for saving the game state
+    uint64_t snapshot() const { return state; }
+    /// Continue the sequence from a previously saved state
+    void restore(uint64_t saved_state) { state = saved_state; }
+
+    /// A random 32-bit number
+    uint32_t next() {
+        const uint64_t old_state = state;
+        state = old_state * 6364136223846793005ULL + increment;
+        const uint32_t xorshifted = static_cast<uint32_t>(((old_state >> 18u) ^ old_state) >> 27u);
+        const uint32_t rot = static_cast<uint32_t>(old_state >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    /// A random number in the range [0, bound), without modulo bias;
+    /// the bound must not be zero
+    uint32_t below(uint32_t bound) {
+        const uint32_t threshold = (0u - bound) % bound;
+        while (true) {
+            const uint32_t value = next();
+            if (value >= threshold)
+                return value % bound;
+        }
+    }
+
+    /// Randomly reorder the range (Fisher-Yates)
+    template <typename RandomIt>
+    void shuffle(RandomIt first, RandomIt last) {
+        const auto count = std::distance(first, last);
+        for (auto i = count - 1; i > 0; i--) {
+            const auto j = below(static_cast<uint32_t>(i + 1));
+            using std::swap;
+            swap(first[i], first[j]);
+        }
+    }
+
+    /// A non-deterministic seed, for when reproducibility is not required
+    static uint64_t makeSeed() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+private:
+    static constexpr uint64_t increment = 1442695040888963407ULL;
+    uint64_t state;
+};
@@ -0,0 +1,106 @@
+#include "ThreadPool.h"
+
+#include <assert.h>
+
+
+ThreadPool::ThreadPool(unsigned thread_count)
+    : next_queue(0)
+    , queued_tasks(0)
+    , unfinished_tasks(0)
+    , sleeping_workers(0)
+    , stopping(false)
+{
+    assert(thread_count > 0);
+
+    for (unsigned i = 0; i < thread_count; i++)
+        queues.emplace_back(std::make_unique<WorkerQueue>());
+    for (unsigned i = 0; i < thread_count; i++)
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    task_available.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void ThreadPool::submit(Task&& task)
+{
+    unfinished_tasks++;
+    {
+        auto& queue = *queues.at(next_queue++ % queues.size());
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+    queued_tasks++;
+
+    // a worker checks the counter after it has announced that it goes to sleep,
+    // so either it finds the new task, or it's woken up here
+    if (sleeping_workers > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        task_available.notify_one();
+    }
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    all_finished.wait(lock, [this]{ return unfinished_tasks == 0; });
+}
+
+void ThreadPool::workerLoop(unsigned index)
+{
+    while (true) {
+        Task task;
+        if (tryPop(index, task)) {
+            // the counter may go below zero for a moment,
+            // if the task was taken before it was counted
+            queued_tasks--;
+            task();
+
+            if (--unfinished_tasks == 0) {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                all_finished.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleeping_workers++;
+        task_available.wait(lock, [this]{ return stopping || queued_tasks > 0; });
+        sleeping_workers--;
+        if (stopping && queued_tasks <= 0)
+            return;
+    }
+}
+
+bool ThreadPool::tryPop(unsigned index, Task& output)
+{
+    {
+        auto& own_queue = *queues.at(index);
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+        if (!own_queue.tasks.empty()) {
+            output = std::move(own_queue.tasks.back());
+            own_queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (unsigned offset = 1; offset < queues.size(); offset++) {
+        auto& other_queue = *queues.at((index + offset) % queues.size());
+        std::lock_guard<std::mutex> lock(other_queue.mutex);
+        if (!other_queue.tasks.empty()) {
+            output = std::move(other_queue.tasks.front());
+            other_queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
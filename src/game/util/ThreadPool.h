@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/// A fixed size thread pool, where every worker has its own task queue.
+/// The workers take the tasks from the back of their own queue, and when
+/// it is empty, steal from the front of the others, so tasks of uneven
+/// length still keep every thread busy.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned thread_count);
+    /// Waits for the submitted tasks to finish
+    ~ThreadPool();
+
+    unsigned threadCount() const { return threads.size(); }
+
+    /// Add a task to one of the worker queues
+    void submit(Task&&);
+    /// Block until every submitted task has finished
+    void wait();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> next_queue;
+
+    // The queues are only guarded by their own mutex; the counters are atomic,
+    // and the shared mutex is only used by the workers going to sleep
+    // and the threads waking them up
+    std::atomic<int> queued_tasks;
+    std::atomic<unsigned> unfinished_tasks;
+    std::atomic<unsigned> sleeping_workers;
+    std::mutex sleep_mutex;
+    std::condition_variable task_available;
+    std::condition_variable all_finished;
+    bool stopping;
+
+    void workerLoop(unsigned index);
+    bool tryPop(unsigned index, Task&);
+};
@@ -17,26 +17,53 @@
 
 #include "version.h"
 #include "game/AppContext.h"
+#include "game/FrameScheduler.h"
 #include "game/GameState.h"
 #include "game/Timing.h"
+#include "game/net/NetplaySettings.h"
 #include "game/states/InitState.h"
+#include "system/AudioContext.h"
+#include "system/GraphicsContext.h"
 #include "system/Log.h"
 #include "system/Paths.h"
 
 #include <algorithm>
 #include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <thread>
 #include <assert.h>
 
 
 const std::string LOG_MAIN = "main";
 const std::string LOG_HELP = "help";
+/// The frame counters are logged this often
+constexpr auto FRAME_STATS_INTERVAL = std::chrono::seconds(10);
+
+void logFrameStats(const FrameStats& current, const FrameStats& previous, unsigned draw_calls)
+{
+    std::ostream& log = Log::info(LOG_MAIN);
+    log << (current.draws - previous.draws) << " frames drawn, "
+        << draw_calls << " draw calls in the last frame";
+    if (current.late_frames != previous.late_frames) {
+        log << "; slow frames: " << (current.late_frames - previous.late_frames) << " late, "
+            << (current.skipped_draws - previous.skipped_draws) << " draws skipped, "
+            << (current.dropped_updates - previous.dropped_updates) << " updates dropped"
+            << " (of " << (current.updates - previous.updates) << " updates)";
+    }
+    log << "\n";
+}
 
 int main(int argc, const char** argv)
 {
     Log::info(LOG_MAIN) << "OpenBlok, created by Mátyás Mustoha, " << game_version << "\n";
 
+    std::string replay_path;
+    unsigned replay_start_seconds = 0;
+    bool headless = false;
+    bool netplay = false;
+    bool has_netplay_seed = false;
+    Net::NetplaySettings netplay_settings;
     for (int arg_i = 1; arg_i < argc; arg_i++) {
         std::string arg = argv[arg_i];
         if (arg == "-v" || arg == "--version")
@@ -46,6 +73,17 @@ int main(int argc, const char** argv)
             Log::info(LOG_HELP) << "  -v, --version            Display the version number then quit\n";
             Log::info(LOG_HELP) << "  --help                   Display this help then quit\n";
             Log::info(LOG_HELP) << "  --data <dir>             Load game resources from the <dir> directory\n";
+            Log::info(LOG_HELP) << "  --replay <file>          Play back a recorded game, then quit\n";
+            Log::info(LOG_HELP) << "  --seek <seconds>         With --replay: start the playback at the given time\n";
+            Log::info(LOG_HELP) << "  --headless               With --replay: simulate the game at maximum speed,\n";
+            Log::info(LOG_HELP) << "                           without drawing and sound; works without\n";
+            Log::info(LOG_HELP) << "                           a display or a sound device too\n";
+            Log::info(LOG_HELP) << "  --netplay <player> <port> <host> <remote port>\n";
+            Log::info(LOG_HELP) << "                           Play an online battle as player 1 or 2 on the\n";
+            Log::info(LOG_HELP) << "                           local UDP <port>, against the game at\n";
+            Log::info(LOG_HELP) << "                           <host>:<remote port>, then quit\n";
+            Log::info(LOG_HELP) << "  --seed <number>          With --netplay: the seed of the match, which has\n";
+            Log::info(LOG_HELP) << "                           to be the same on both sides (default: 0)\n";
             return 0;
         }
         else if (arg == "--data") {
@@ -55,6 +93,60 @@ int main(int argc, const char** argv)
             }
             Paths::changeDataDir(argv[arg_i]);
         }
+        else if (arg == "--replay") {
+            if (++arg_i >= argc) {
+                Log::error(LOG_MAIN) << "'--replay' requires a file as parameter!\n";
+                return 1;
+            }
+            replay_path = argv[arg_i];
+        }
+        else if (arg == "--seek") {
+            if (++arg_i >= argc) {
+                Log::error(LOG_MAIN) << "'--seek' requires a time in seconds as parameter!\n";
+                return 1;
+            }
+            try { replay_start_seconds = std::stoul(argv[arg_i]); }
+            catch (const std::exception&) {
+                Log::error(LOG_MAIN) << "Invalid time '" << argv[arg_i] << "' for '--seek'!\n";
+                return 1;
+            }
+        }
+        else if (arg == "--headless")
+            headless = true;
+        else if (arg == "--netplay") {
+            if (arg_i + 4 >= argc) {
+                Log::error(LOG_MAIN) << "'--netplay' requires a player number, a port, a host and a remote port as parameters!\n";
+                return 1;
+            }
+            try {
+                const unsigned long player = std::stoul(argv[++arg_i]);
+                const unsigned long local_port = std::stoul(argv[++arg_i]);
+                netplay_settings.remote_host = argv[++arg_i];
+                const unsigned long remote_port = std::stoul(argv[++arg_i]);
+                if (player < 1 || player > Net::player_count || local_port > 0xFFFF || remote_port > 0xFFFF)
+                    throw std::out_of_range("--netplay");
+                netplay_settings.local_player = player - 1;
+                netplay_settings.local_port = local_port;
+                netplay_settings.remote_port = remote_port;
+            }
+            catch (const std::exception&) {
+                Log::error(LOG_MAIN) << "Invalid parameters for '--netplay'!\n";
+                return 1;
+            }
+            netplay = true;
+        }
+        else if (arg == "--seed") {
+            if (++arg_i >= argc) {
+                Log::error(LOG_MAIN) << "'--seed' requires a number as parameter!\n";
+                return 1;
+            }
+            try { netplay_settings.seed = std::stoull(argv[arg_i]); }
+            catch (const std::exception&) {
+                Log::error(LOG_MAIN) << "Invalid seed '" << argv[arg_i] << "' for '--seed'!\n";
+                return 1;
+            }
+            has_netplay_seed = true;
+        }
         else {
             Log::error(LOG_MAIN) << "Unknown parameter '" << arg << "'.\n";
             return 1;
@@ -62,49 +154,116 @@ int main(int argc, const char** argv)
     }
 
 
-    AppContext app;
-    if (!app.init())
+    if (headless && replay_path.empty()) {
+        Log::error(LOG_MAIN) << "'--headless' can only be used with '--replay'!\n";
         return 1;
+    }
+    if (replay_start_seconds > 0 && replay_path.empty()) {
+        Log::error(LOG_MAIN) << "'--seek' can only be used with '--replay'!\n";
+        return 1;
+    }
+    if (netplay && !replay_path.empty()) {
+        Log::error(LOG_MAIN) << "'--netplay' can't be used with '--replay'!\n";
+        return 1;
+    }
+    if (has_netplay_seed && !netplay) {
+        Log::error(LOG_MAIN) << "'--seed' can only be used with '--netplay'!\n";
+        return 1;
+    }
 
 
-    try { app.states().emplace(std::make_unique<InitState>(app)); }
+    AppContext app;
+    if (!app.init(headless)) {
+        if (headless)
+            Log::error(LOG_MAIN) << "Could not start the headless playback; SDL2 has to be built "
+                                    "with its 'dummy' video and audio drivers for it\n";
+        return 1;
+    }
+
+    const uint32_t replay_start_frame = std::chrono::seconds(replay_start_seconds) / Timing::frame_duration;
+    try {
+        if (netplay)
+            app.states().emplace(std::make_unique<InitState>(app, netplay_settings));
+        else
+            app.states().emplace(std::make_unique<InitState>(app, replay_path, replay_start_frame));
+    }
     catch (const std::exception& err) {
         app.window().showErrorMessage(err.what());
         return 1;
     }
 
+    if (headless) {
+        if (app.sysconfig().sfx)
+            app.audio().toggleSFXMute();
+        if (app.sysconfig().music)
+            app.audio().toggleMusicMute();
+        // the settings are not saved during replays
+        app.sysconfig().sfx = false;
+        app.sysconfig().music = false;
 
-    auto frame_starttime = std::chrono::steady_clock::now();
-    auto frame_planned_endtime = frame_starttime + Timing::frame_duration;
-    auto gametime_delay = Timing::frame_duration; // start with an update
+        // the game runs as fast as possible, without drawing anything
+        try {
+            while (!app.window().quitRequested() && !app.states().empty()) {
+                auto events = app.window().collectEvents();
+                app.states().top()->update(events, app);
+            }
+        }
+        catch (const std::exception& err) {
+            Log::error(LOG_MAIN) << err.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+
+    FrameSchedulerSettings frame_settings;
+    frame_settings.frame_skip = app.sysconfig().frame_skip;
+    // every skipped draw is followed by one more update
+    frame_settings.max_catchup_updates = app.sysconfig().max_frame_skip + 1;
+    FrameScheduler scheduler(frame_settings);
+    scheduler.start(FrameScheduler::Clock::now());
+
+    FrameStats logged_frame_stats;
+    auto next_frame_stats_log = FrameScheduler::Clock::now() + FRAME_STATS_INTERVAL;
 
     while (!app.window().quitRequested()) {
         try {
-            while (gametime_delay >= Timing::frame_duration && !app.states().empty()) {
+            const unsigned update_count = scheduler.beginFrame(FrameScheduler::Clock::now());
+            for (unsigned i = 0; i < update_count && !app.states().empty(); i++) {
                 auto events = app.window().collectEvents();
                 app.states().top()->update(events, app);
-                gametime_delay -= Timing::frame_duration;
             }
             if (app.states().empty())
                 break;
 
-            app.states().top()->draw(app.gcx());
-            app.gcx().render();
+            // nothing has changed since the last drawing without updates
+            if (update_count > 0) {
+                app.states().top()->interpolate(scheduler.interpolation());
+                app.states().top()->draw(app.gcx());
+                app.gcx().render();
+                scheduler.frameDrawn();
+            }
         }
         catch (const std::exception& err) {
             app.window().showErrorMessage(err.what());
             return 1;
         }
 
-        auto lag = std::max(std::chrono::steady_clock::now() - frame_planned_endtime, Duration::zero());
-        gametime_delay += Timing::frame_duration + lag;
+        const auto& frame_stats = scheduler.stats();
+        if (FrameScheduler::Clock::now() >= next_frame_stats_log) {
+            logFrameStats(frame_stats, logged_frame_stats, app.gcx().drawCallCount());
+            logged_frame_stats = frame_stats;
+            next_frame_stats_log = FrameScheduler::Clock::now() + FRAME_STATS_INTERVAL;
+        }
 
         // max frame rate limiting
-        std::this_thread::sleep_until(frame_planned_endtime);
-
-        frame_starttime = std::chrono::steady_clock::now();
-        frame_planned_endtime = frame_starttime + Timing::frame_duration;
+        std::this_thread::sleep_until(scheduler.nextUpdateTime());
     }
+    logFrameStats(scheduler.stats(), FrameStats(), app.gcx().drawCallCount());
+    const CacheStats& text_cache = app.gcx().textCacheStats();
+    Log::info(LOG_MAIN) << "Text cache: " << text_cache.hits << " hits, " << text_cache.misses << " misses, "
+                        << text_cache.evictions << " evictions, " << text_cache.entries << " textures ("
+                        << text_cache.size / 1024 << " KiB)\n";
 
     // save input config on exit
     const auto mappings = app.window().createInputConfig();
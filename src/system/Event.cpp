@@ -1,11 +1,5 @@
 #include "Event.h"
 
-InputEvent::InputEvent(InputType type, bool pressed, DeviceID source)
-    : m_type(type)
-    , m_down(pressed)
-    , m_src_device_id(source)
-{}
-
 DeviceEvent::DeviceEvent(DeviceEventType type, int device_id)
     : type(type), device_id(device_id)
 {}
@@ -33,10 +33,14 @@ using DeviceID = int8_t;
 class InputEvent {
 public:
 #ifndef NDEBUG
-    explicit InputEvent(InputType type, bool pressed, DeviceID source = -1);
+    explicit InputEvent(InputType type, bool pressed, DeviceID source = -1)
 #else
-    explicit InputEvent(InputType type, bool pressed, DeviceID source);
+    explicit InputEvent(InputType type, bool pressed, DeviceID source)
 #endif
+        : m_type(type)
+        , m_down(pressed)
+        , m_src_device_id(source)
+    {}
     InputType type() const { return m_type; }
     bool down() const { return m_down; }
     DeviceID srcDeviceID() const { return m_src_device_id; }
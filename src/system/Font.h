@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 
+class GlyphText;
 class Texture;
 
 
@@ -17,4 +18,7 @@ public:
                                                 TextAlign align = TextAlign::LEFT) = 0;
     virtual std::unique_ptr<Texture> renderText(const std::string&, const RGBAColor&,
                                                 TextAlign align = TextAlign::LEFT) = 0;
+    /// Create an empty text, drawn from the cached glyphs of this font
+    /// in the color; the glyphs are not kerned
+    virtual std::unique_ptr<GlyphText> createGlyphText(const RGBAColor&) = 0;
 };
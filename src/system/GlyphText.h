@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+
+/// A single line of text, drawn glyph by glyph from a cache. Unlike the
+/// textures of `Font::renderText`, changing the text does not render
+/// anything or create new textures, so it's suitable for counters
+/// and other short, frequently changing texts.
+class GlyphText {
+public:
+    virtual ~GlyphText() {}
+
+    /// Change the displayed text; the glyphs not seen before
+    /// are rendered only once per font and color
+    virtual void setText(const std::string&) = 0;
+
+    /// Draw the text with its top left corner at a location
+    virtual void drawAt(int x, int y) = 0;
+
+    /// Get the width of the current text
+    virtual unsigned width() const = 0;
+    /// Get the height of the text line
+    virtual unsigned height() const = 0;
+};
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "Color.h"
+#include "LRUCache.h"
 #include "Rectangle.h"
 
 #include <memory>
 #include <string>
+#include <vector>
 
 
 class Font;
@@ -37,8 +39,41 @@ public:
     /// Load an image file as texture with additional tinting.
     virtual std::unique_ptr<Texture> loadTexture(const std::string& path, const RGBColor& tint) = 0;
 
+    /// An image of a texture atlas
+    struct AtlasImage {
+        std::string path;
+        RGBColor tint;
+        /// Loaded instead of the path, if that one fails to load (optional)
+        std::string fallback_path;
+    };
+    /// Load multiple images into one texture, next to each other, so their parts
+    /// can be drawn together with `Texture::drawSprites`. Every image is scaled
+    /// to the cell size; the Nth image starts at (N * cell_width, 0).
+    virtual std::unique_ptr<Texture> loadAtlas(const std::vector<AtlasImage>&,
+                                               unsigned cell_width, unsigned cell_height) = 0;
+
+    /// Create a transparent texture that can be drawn on, see `setRenderTarget`.
+    /// The size is in the units of the current draw scale, but the texture
+    /// has enough pixels to be drawn at that scale without resampling.
+    virtual std::unique_ptr<Texture> createRenderTarget(unsigned width, unsigned height) = 0;
+    /// Draw on a texture created by `createRenderTarget` instead of the screen,
+    /// until this is called again with `nullptr`
+    virtual void setRenderTarget(Texture*) = 0;
+    /// The contents of the render targets may get lost (eg. when the graphics
+    /// device is reset); this counter increases every time it happens,
+    /// and the render targets have to be redrawn
+    virtual unsigned renderTargetResets() const = 0;
+
+    /// The number of draw calls sent to the graphics driver in the last frame
+    virtual unsigned drawCallCount() const = 0;
+    /// The counters of the rendered text cache; the texts of all fonts are cached,
+    /// so rendering the same text again (eg. when a screen is opened again) is cheap
+    virtual const CacheStats& textCacheStats() const = 0;
+
     /// Draw a rectangle on the screen, defined by [x,y,w,h], filled with [r,g,b]
     virtual void drawFilledRect(const Rectangle& rectangle, const RGBColor& color) = 0;
     /// Draw a rectangle on the screen, defined by [x,y,w,h], filled with the optionally transparent color [r,g,b,a]
     virtual void drawFilledRect(const Rectangle& rectangle, const RGBAColor& color) = 0;
+    /// Make a rectangle fully transparent; useful for redrawing parts of render targets
+    virtual void clearRect(const Rectangle& rectangle) = 0;
 };
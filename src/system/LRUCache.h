@@ -0,0 +1,97 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// The counters of a cache
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    /// The number of entries removed to make room for new ones
+    uint64_t evictions = 0;
+    /// The number of entries currently in the cache
+    size_t entries = 0;
+    /// The total size of the current entries
+    size_t size = 0;
+};
+
+
+/// A cache with a limit on the total size of its values (eg. in bytes);
+/// when a new value doesn't fit, the least recently used ones are removed.
+template <typename Value>
+class LRUCache {
+public:
+    explicit LRUCache(size_t max_size)
+        : max_size(max_size)
+    {}
+
+    /// Returns the cached value of the key and marks it as recently used,
+    /// or `nullptr` if the key is not in the cache
+    const Value* find(const std::string& key) {
+        const auto it = index.find(key);
+        if (it == index.end()) {
+            m_stats.misses++;
+            return nullptr;
+        }
+
+        m_stats.hits++;
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->value;
+    }
+
+    /// Add or replace the value of the key; values larger
+    /// than the size limit of the cache are not stored
+    void insert(const std::string& key, Value value, size_t size) {
+        erase(key);
+        if (size > max_size)
+            return;
+
+        while (m_stats.size + size > max_size) {
+            erase(entries.back().key);
+            m_stats.evictions++;
+        }
+
+        entries.push_front({key, std::move(value), size});
+        index.emplace(key, entries.begin());
+        m_stats.entries++;
+        m_stats.size += size;
+    }
+
+    void clear() {
+        entries.clear();
+        index.clear();
+        m_stats.entries = 0;
+        m_stats.size = 0;
+    }
+
+    const CacheStats& stats() const { return m_stats; }
+
+private:
+    struct Entry {
+        std::string key;
+        Value value;
+        size_t size;
+    };
+
+    const size_t max_size;
+    // the most recently used entry is the first
+    std::list<Entry> entries;
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> index;
+    CacheStats m_stats;
+
+    void erase(const std::string& key) {
+        const auto it = index.find(key);
+        if (it == index.end())
+            return;
+
+        m_stats.entries--;
+        m_stats.size -= it->second->size;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+};
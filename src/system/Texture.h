@@ -2,9 +2,16 @@
 
 #include "Rectangle.h"
 
+#include <vector>
 #include <stdint.h>
 
 
+/// A part of a texture, and the area where it should be drawn
+struct SpriteQuad {
+    Rectangle from;
+    Rectangle to;
+};
+
 class Texture {
 public:
     virtual ~Texture() {}
@@ -15,6 +22,8 @@ public:
     virtual void drawScaled(const Rectangle&) = 0;
     /// Copy part of the texture and fill a rectangle with it
     virtual void drawPartialScaled(const Rectangle& from, const Rectangle& to) = 0;
+    /// Draw multiple parts of the texture, with a single draw call if possible
+    virtual void drawSprites(const std::vector<SpriteQuad>&) = 0;
 
     /// Set the current alpha value (visibility) of the texture
     virtual void setAlpha(uint8_t) = 0;
@@ -4,8 +4,10 @@
 #include "sdl/SDLWindow.h"
 
 
-std::unique_ptr<Window> Window::create()
+std::unique_ptr<Window> Window::create(bool headless)
 {
+    if (headless)
+        SDLWindow::useDummyDrivers();
     return std::make_unique<SDLWindow>();
 }
 
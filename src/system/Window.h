@@ -59,7 +59,8 @@ public:
     static void showErrorMessage(const std::string& content);
 
 private:
-    static std::unique_ptr<Window> create();
+    /// Create the window; a headless one uses no display or sound device
+    static std::unique_ptr<Window> create(bool headless);
 
 friend class AppContext;
 };
@@ -26,32 +26,23 @@ const std::string LOG_TAG("audio");
 SDLAudioContext::SDLAudioContext()
     : audio_loader(SDL_MIX_FLAGS)
     , mixer(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 1024)
-{
-    SDLMusic::mixer = &mixer;
-    SDLSoundEffect::mixer = &mixer;
-}
+{}
 
-SDLAudioContext::~SDLAudioContext()
-{
-    SDLMusic::mixer = nullptr;
-    SDLSoundEffect::mixer = nullptr;
-}
+SDLAudioContext::~SDLAudioContext() = default;
 
 std::shared_ptr<Music> SDLAudioContext::loadMusic(const std::string& path)
 {
-    static std::map<const std::string, std::weak_ptr<Music>> cache;
-    auto item = cache[path].lock();
+    auto item = music_cache[path].lock();
     if (!item)
-        cache[path] = item = std::make_shared<SDLMusic>(SDL2pp::Music(path));
+        music_cache[path] = item = std::make_shared<SDLMusic>(mixer, SDL2pp::Music(path));
     return item;
 }
 
 std::shared_ptr<SoundEffect> SDLAudioContext::loadSound(const std::string& path)
 {
-    static std::map<const std::string, std::weak_ptr<SoundEffect>> cache;
-    auto item = cache[path].lock();
+    auto item = sound_cache[path].lock();
     if (!item)
-        cache[path] = item = std::make_shared<SDLSoundEffect>(SDL2pp::Chunk(path));
+        sound_cache[path] = item = std::make_shared<SDLSoundEffect>(mixer, SDL2pp::Chunk(path));
     return item;
 }
 
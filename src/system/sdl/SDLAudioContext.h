@@ -3,6 +3,7 @@
 #include "system/AudioContext.h"
 
 #include <SDL2pp/SDL2pp.hh>
+#include <map>
 
 
 class SDLAudioContext : public AudioContext {
@@ -22,4 +23,7 @@ public:
 private:
     SDL2pp::SDLMixer audio_loader;
     SDL2pp::Mixer mixer;
+
+    std::map<const std::string, std::weak_ptr<Music>> music_cache;
+    std::map<const std::string, std::weak_ptr<SoundEffect>> sound_cache;
 };
@@ -1,5 +1,6 @@
 #include "SDLFont.h"
 
+#include "SDLGlyphText.h"
 #include "SDLTexture.h"
 
 #include "SDL2/SDL.h"
@@ -8,9 +9,6 @@
 #include <assert.h>
 
 
-SDL2pp::Renderer* SDLFont::renderer = nullptr;
-uint32_t SDLFont::pixelformat = 0x0;
-
 std::vector<std::string> splitByNL(const std::string& str) {
     std::vector<std::string> output;
     std::istringstream isst(str);
@@ -22,8 +20,13 @@ std::vector<std::string> splitByNL(const std::string& str) {
     return output;
 }
 
-SDLFont::SDLFont(SDL2pp::Font&& font)
-    : font(std::move(font))
+SDLFont::SDLFont(SDL2pp::Renderer& renderer, SDL2pp::Font&& font, const std::string& name,
+                 TextCache& text_cache, unsigned& draw_call_counter)
+    : renderer(renderer)
+    , font(std::move(font))
+    , name(name)
+    , text_cache(text_cache)
+    , draw_calls(draw_call_counter)
 {}
 
 std::unique_ptr<Texture> SDLFont::renderText(const std::string& text, const RGBColor& color, TextAlign align)
@@ -33,16 +36,28 @@ std::unique_ptr<Texture> SDLFont::renderText(const std::string& text, const RGBC
 
 std::unique_ptr<Texture> SDLFont::renderText(const std::string& text, const RGBAColor& color, TextAlign align)
 {
-    assert(renderer);
+    // the alpha is not part of the texture, so it's not in the key either
+    std::string key = name;
+    key += '\0';
+    key += static_cast<char>(align);
+    key.append({static_cast<char>(color.r), static_cast<char>(color.g), static_cast<char>(color.b)});
+    key += text;
+
+    if (const auto* cached = text_cache.find(key))
+        return std::make_unique<SDLTexture>(renderer, *cached, color.a, draw_calls);
+
+    auto tex = std::make_shared<SDL2pp::Texture>(createTextTexture(text, {color.r, color.g, color.b}, align));
+    text_cache.insert(key, tex, tex->GetWidth() * tex->GetHeight() * 4);
+    return std::make_unique<SDLTexture>(renderer, std::move(tex), color.a, draw_calls);
+}
 
+SDL2pp::Texture SDLFont::createTextTexture(const std::string& text, const RGBColor& color, TextAlign align)
+{
     const auto lines = splitByNL(text);
 
     // shortcut for single lines
-    if (lines.size() <= 1) {
-        return std::make_unique<SDLTexture>(SDL2pp::Texture(
-            *renderer, font.RenderUTF8_Blended(text, {color.r, color.g, color.b, 255}).SetAlphaMod(color.a)
-        ));
-    }
+    if (lines.size() <= 1)
+        return SDL2pp::Texture(renderer, font.RenderUTF8_Blended(text, {color.r, color.g, color.b, 255}));
 
     // find out texture dimensions
     const int line_height = font.GetLineSkip();
@@ -83,5 +98,14 @@ std::unique_ptr<Texture> SDLFont::renderText(const std::string& text, const RGBA
             assert(false);
     }
 
-    return std::make_unique<SDLTexture>(SDL2pp::Texture(*renderer, basesurf.SetAlphaMod(color.a)));
+    return SDL2pp::Texture(renderer, basesurf);
+}
+
+std::unique_ptr<GlyphText> SDLFont::createGlyphText(const RGBAColor& color)
+{
+    const uint32_t key = (color.r << 16) | (color.g << 8) | color.b;
+    auto& atlas = glyph_atlases[key];
+    if (!atlas)
+        atlas = std::make_shared<SDLGlyphAtlas>(renderer, font, RGBColor {color.r, color.g, color.b}, draw_calls);
+    return std::make_unique<SDLGlyphText>(atlas, color.a);
 }
@@ -1,20 +1,35 @@
 #pragma once
 
 #include "system/Font.h"
+#include "system/LRUCache.h"
 
 #include <SDL2pp/SDL2pp.hh>
+#include <map>
+#include <memory>
+
+class SDLGlyphAtlas;
 
 
 class SDLFont : public Font {
 public:
-    SDLFont(SDL2pp::Font&&);
+    /// The rendered texts are stored in the shared cache, with the name of the font
+    /// (path and size) in their keys; their draw calls are added to the counter
+    using TextCache = LRUCache<std::shared_ptr<SDL2pp::Texture>>;
+    SDLFont(SDL2pp::Renderer&, SDL2pp::Font&&, const std::string& name,
+            TextCache& text_cache, unsigned& draw_call_counter);
     std::unique_ptr<Texture> renderText(const std::string&, const RGBColor&, TextAlign) final;
     std::unique_ptr<Texture> renderText(const std::string&, const RGBAColor&, TextAlign) final;
+    std::unique_ptr<GlyphText> createGlyphText(const RGBAColor&) final;
 
 private:
-    static SDL2pp::Renderer* renderer;
-    static uint32_t pixelformat;
+    SDL2pp::Renderer& renderer;
     SDL2pp::Font font;
+    const std::string name;
+    TextCache& text_cache;
+    unsigned& draw_calls;
+
+    // one atlas per color, shared by the glyph texts
+    std::map<uint32_t, std::shared_ptr<SDLGlyphAtlas>> glyph_atlases;
 
-friend class SDLGraphicsContext;
+    SDL2pp::Texture createTextTexture(const std::string&, const RGBColor&, TextAlign);
 };
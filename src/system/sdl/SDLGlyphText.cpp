@@ -0,0 +1,141 @@
+#include "SDLGlyphText.h"
+
+#include "SDLTexture.h"
+
+#include <algorithm>
+#include <assert.h>
+
+
+namespace {
+// the glyphs are placed in rows of this width
+constexpr int ATLAS_WIDTH = 512;
+// the atlas starts with this many rows, and doubles its height when full
+constexpr int ATLAS_INITIAL_ROWS = 2;
+
+/// The length of the UTF-8 sequence starting with the byte
+size_t utf8SequenceLength(char first_byte)
+{
+    const auto byte = static_cast<uint8_t>(first_byte);
+    if ((byte & 0xE0) == 0xC0)
+        return 2;
+    if ((byte & 0xF0) == 0xE0)
+        return 3;
+    if ((byte & 0xF8) == 0xF0)
+        return 4;
+    return 1;
+}
+
+SDL2pp::Surface createAtlasSurface(int height)
+{
+    // the same masks as for the rendered texts; new surfaces are fully transparent
+    return SDL2pp::Surface(0x0, ATLAS_WIDTH, height, 32, 0xff0000, 0xff00, 0xff, 0xff000000);
+}
+} // namespace
+
+
+SDLGlyphAtlas::SDLGlyphAtlas(SDL2pp::Renderer& renderer, SDL2pp::Font& font,
+                             const RGBColor& color, unsigned& draw_call_counter)
+    : renderer(renderer)
+    , font(font)
+    , color({color.r, color.g, color.b, 255})
+    , draw_calls(draw_call_counter)
+    , line_height(font.GetHeight())
+    , surface(createAtlasSurface(line_height * ATLAS_INITIAL_ROWS))
+    , next_x(0)
+    , next_y(0)
+{}
+
+SDLGlyphAtlas::~SDLGlyphAtlas() = default;
+
+const Rectangle& SDLGlyphAtlas::glyph(const std::string& character)
+{
+    auto it = glyphs.find(character);
+    if (it == glyphs.end())
+        it = glyphs.emplace(character, addGlyph(character)).first;
+    return it->second;
+}
+
+Rectangle SDLGlyphAtlas::addGlyph(const std::string& character)
+{
+    // characters without visible size (or invalid sequences) are skipped
+    if (font.GetSizeUTF8(character).GetX() <= 0)
+        return {0, 0, 0, 0};
+
+    SDL2pp::Surface glyph_surf = font.RenderUTF8_Blended(character, color);
+    const int width = std::min(glyph_surf.GetWidth(), ATLAS_WIDTH);
+    const int height = std::min(glyph_surf.GetHeight(), line_height);
+
+    if (next_x + width > ATLAS_WIDTH) {
+        next_x = 0;
+        next_y += line_height;
+    }
+    if (next_y + line_height > surface.GetHeight()) {
+        // the glyphs keep their places in the larger atlas
+        SDL2pp::Surface larger = createAtlasSurface(surface.GetHeight() * 2);
+        surface.SetBlendMode(SDL_BLENDMODE_NONE);
+        surface.Blit(SDL2pp::NullOpt, larger, SDL2pp::Rect(0, 0, surface.GetWidth(), surface.GetHeight()));
+        surface = std::move(larger);
+        tex.reset();
+    }
+
+    const Rectangle rect = {next_x, next_y, width, height};
+    const SDL2pp::Rect sdl_rect(rect.x, rect.y, rect.w, rect.h);
+    glyph_surf.SetBlendMode(SDL_BLENDMODE_NONE);
+    glyph_surf.Blit(SDL2pp::Rect(0, 0, width, height), surface, sdl_rect);
+    if (tex)
+        tex->sdlTexture().Update(sdl_rect, glyph_surf);
+
+    next_x += width;
+    return rect;
+}
+
+Texture& SDLGlyphAtlas::texture()
+{
+    if (!tex) {
+        SDL2pp::Texture sdl_tex(renderer, surface);
+        sdl_tex.SetBlendMode(SDL_BLENDMODE_BLEND);
+        tex = std::make_unique<SDLTexture>(renderer, std::move(sdl_tex), draw_calls);
+    }
+    return *tex;
+}
+
+
+SDLGlyphText::SDLGlyphText(std::shared_ptr<SDLGlyphAtlas> atlas, uint8_t alpha)
+    : atlas(std::move(atlas))
+    , alpha(alpha)
+    , m_width(0)
+{
+    assert(this->atlas);
+}
+
+void SDLGlyphText::setText(const std::string& new_text)
+{
+    if (new_text == text)
+        return;
+
+    text = new_text;
+    glyph_quads.clear();
+    m_width = 0;
+
+    for (size_t pos = 0; pos < text.size();) {
+        const size_t length = std::min(utf8SequenceLength(text[pos]), text.size() - pos);
+        const Rectangle& glyph = atlas->glyph(text.substr(pos, length));
+        if (glyph.w > 0) {
+            glyph_quads.push_back({glyph, {static_cast<int>(m_width), 0, glyph.w, glyph.h}});
+            m_width += glyph.w;
+        }
+        pos += length;
+    }
+}
+
+void SDLGlyphText::drawAt(int x, int y)
+{
+    draw_quads.clear();
+    for (const SpriteQuad& quad : glyph_quads)
+        draw_quads.push_back({quad.from, {x + quad.to.x, y + quad.to.y, quad.to.w, quad.to.h}});
+
+    // the atlas is shared by the texts of the same color, but not their alpha
+    Texture& tex = atlas->texture();
+    tex.setAlpha(alpha);
+    tex.drawSprites(draw_quads);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "system/Color.h"
+#include "system/GlyphText.h"
+#include "system/Texture.h"
+
+#include <SDL2pp/SDL2pp.hh>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SDLTexture;
+
+
+/// The rendered glyphs of a font in one color, packed into a texture.
+/// New glyphs are rendered when they're first requested.
+class SDLGlyphAtlas {
+public:
+    /// The font has to outlive the atlas; the draw calls are added to the counter
+    SDLGlyphAtlas(SDL2pp::Renderer&, SDL2pp::Font&, const RGBColor&, unsigned& draw_call_counter);
+    ~SDLGlyphAtlas();
+
+    /// The area of a character (one UTF-8 sequence) on the atlas
+    const Rectangle& glyph(const std::string& character);
+    /// The atlas texture, including all glyphs requested so far
+    Texture& texture();
+
+    unsigned lineHeight() const { return line_height; }
+
+private:
+    SDL2pp::Renderer& renderer;
+    SDL2pp::Font& font;
+    const SDL_Color color;
+    unsigned& draw_calls;
+    const int line_height;
+
+    std::unordered_map<std::string, Rectangle> glyphs;
+    // a copy of the texture, so it can be recreated with a larger size
+    SDL2pp::Surface surface;
+    std::unique_ptr<SDLTexture> tex;
+    int next_x;
+    int next_y;
+
+    Rectangle addGlyph(const std::string&);
+};
+
+
+class SDLGlyphText : public GlyphText {
+public:
+    SDLGlyphText(std::shared_ptr<SDLGlyphAtlas>, uint8_t alpha);
+
+    void setText(const std::string&) final;
+    void drawAt(int x, int y) final;
+
+    unsigned width() const final { return m_width; }
+    unsigned height() const final { return atlas->lineHeight(); }
+
+private:
+    const std::shared_ptr<SDLGlyphAtlas> atlas;
+    const uint8_t alpha;
+
+    std::string text;
+    unsigned m_width;
+    // the glyphs of the text, relative to its top left corner
+    std::vector<SpriteQuad> glyph_quads;
+    // the glyphs at the drawing location; kept to reuse its memory
+    std::vector<SpriteQuad> draw_quads;
+};
@@ -19,11 +19,17 @@ static constexpr int SDL_IMG_FLAGS = IMG_INIT_PNG
 ;
 
 const std::string LOG_TAG("video");
+/// The memory limit of the rendered text cache
+constexpr size_t TEXT_CACHE_BYTES = 16 * 1024 * 1024;
 
 SDLGraphicsContext::SDLGraphicsContext(SDL2pp::Window& window)
     : renderer(window, -1, 0x0)
     , image_loader(SDL_IMG_FLAGS)
     , ttf()
+    , text_cache(TEXT_CACHE_BYTES)
+    , draw_calls(0)
+    , last_frame_draw_calls(0)
+    , render_target_resets(0)
     , on_render_callback([](){})
 {
     SDL_RendererInfo rinfo;
@@ -37,22 +43,9 @@ SDLGraphicsContext::SDLGraphicsContext(SDL2pp::Window& window)
     renderer.Clear();
     renderer.Present();
     window.Raise();
-
-    // save the window's preferred pixel format for optimal drawing later
-    pixelformat = SDL_GetWindowPixelFormat(window.Get());
-    if (pixelformat == SDL_PIXELFORMAT_UNKNOWN)
-        throw std::runtime_error(SDL_GetError());
-
-    SDLTexture::renderer = &renderer;
-    SDLFont::pixelformat = pixelformat;
-    SDLFont::renderer = &renderer;
 }
 
-SDLGraphicsContext::~SDLGraphicsContext()
-{
-    SDLTexture::renderer = nullptr;
-    SDLFont::renderer = nullptr;
-}
+SDLGraphicsContext::~SDLGraphicsContext() = default;
 
 void SDLGraphicsContext::render()
 {
@@ -60,6 +53,9 @@ void SDLGraphicsContext::render()
     on_render_callback();
 
     renderer.Clear();
+
+    last_frame_draw_calls = draw_calls;
+    draw_calls = 0;
 }
 
 unsigned short SDLGraphicsContext::screenWidth() const
@@ -89,20 +85,82 @@ std::shared_ptr<Font> SDLGraphicsContext::loadFont(const std::string& path, unsi
 {
     const std::string key = path + ";" + std::to_string(pt);
     if (!font_cache.count(key))
-        font_cache[key] = std::make_shared<SDLFont>(SDL2pp::Font(path, pt));
+        font_cache[key] = std::make_shared<SDLFont>(renderer, SDL2pp::Font(path, pt), key, text_cache, draw_calls);
     return font_cache.at(key);
 }
 
 std::unique_ptr<Texture> SDLGraphicsContext::loadTexture(const std::string& path)
 {
-    return std::make_unique<SDLTexture>(SDL2pp::Texture(renderer, path));
+    return std::make_unique<SDLTexture>(renderer, SDL2pp::Texture(renderer, path), draw_calls);
 }
 
 std::unique_ptr<Texture> SDLGraphicsContext::loadTexture(const std::string& path, const RGBColor& tint)
 {
     SDL2pp::Texture tex(renderer, path);
     tex.SetColorMod(tint.r, tint.g, tint.b);
-    return std::make_unique<SDLTexture>(std::move(tex));
+    return std::make_unique<SDLTexture>(renderer, std::move(tex), draw_calls);
+}
+
+std::unique_ptr<Texture> SDLGraphicsContext::loadAtlas(const std::vector<AtlasImage>& images,
+                                                       unsigned cell_width, unsigned cell_height)
+{
+    assert(images.size() > 0);
+    assert(cell_width > 0 && cell_height > 0);
+
+    // the images are composed on the CPU, so the tint is baked into the pixels;
+    // the masks are the same as for the font surfaces
+    SDL2pp::Surface atlas(0x0, cell_width * images.size(), cell_height,
+                          32, 0xff0000, 0xff00, 0xff, 0xff000000);
+    for (unsigned i = 0; i < images.size(); i++) {
+        const AtlasImage& image = images.at(i);
+        SDL2pp::Surface surf = [&image]{
+            try {
+                return SDL2pp::Surface(image.path);
+            }
+            catch (const std::runtime_error&) {
+                if (image.fallback_path.empty())
+                    throw;
+                return SDL2pp::Surface(image.fallback_path);
+            }
+        }();
+        surf.SetColorMod(image.tint.r, image.tint.g, image.tint.b);
+        surf.SetBlendMode(SDL_BLENDMODE_NONE);
+        surf.BlitScaled(SDL2pp::NullOpt,
+                        atlas,
+                        SDL2pp::Rect(i * cell_width, 0, cell_width, cell_height));
+    }
+
+    SDL2pp::Texture tex(renderer, atlas);
+    tex.SetBlendMode(SDL_BLENDMODE_BLEND);
+    return std::make_unique<SDLTexture>(renderer, std::move(tex), draw_calls);
+}
+
+std::unique_ptr<Texture> SDLGraphicsContext::createRenderTarget(unsigned width, unsigned height)
+{
+    const float pixel_scale = getDrawScale();
+    SDL2pp::Texture tex(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                        static_cast<int>(std::ceil(width * pixel_scale)),
+                        static_cast<int>(std::ceil(height * pixel_scale)));
+    tex.SetBlendMode(SDL_BLENDMODE_BLEND);
+
+    std::unique_ptr<Texture> target = std::make_unique<SDLTexture>(renderer, std::move(tex), draw_calls, pixel_scale);
+    setRenderTarget(target.get());
+    clearRect({0, 0, static_cast<int>(width), static_cast<int>(height)});
+    setRenderTarget(nullptr);
+    return target;
+}
+
+void SDLGraphicsContext::setRenderTarget(Texture* target)
+{
+    if (!target) {
+        // also restores the previous scale
+        renderer.SetTarget();
+        return;
+    }
+
+    SDLTexture& sdl_target = static_cast<SDLTexture&>(*target);
+    renderer.SetTarget(sdl_target.sdlTexture());
+    renderer.SetScale(sdl_target.pixelScale(), sdl_target.pixelScale());
 }
 
 void SDLGraphicsContext::drawFilledRect(const Rectangle& rect, const RGBColor& color)
@@ -112,6 +170,7 @@ void SDLGraphicsContext::drawFilledRect(const Rectangle& rect, const RGBColor& c
     renderer.SetDrawColor(color.r, color.g, color.b);
     renderer.FillRect(rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
     renderer.SetDrawColor(r, g, b, a);
+    draw_calls++;
 }
 
 void SDLGraphicsContext::drawFilledRect(const Rectangle& rect, const RGBAColor& color)
@@ -127,6 +186,22 @@ void SDLGraphicsContext::drawFilledRect(const Rectangle& rect, const RGBAColor&
 
     renderer.SetDrawBlendMode(blend);
     renderer.SetDrawColor(r, g, b, a);
+    draw_calls++;
+}
+
+void SDLGraphicsContext::clearRect(const Rectangle& rect)
+{
+    Uint8 r, g, b, a;
+    auto blend = renderer.GetDrawBlendMode();
+    renderer.GetDrawColor(r, g, b, a);
+
+    renderer.SetDrawBlendMode(SDL_BLENDMODE_NONE);
+    renderer.SetDrawColor(0, 0, 0, 0);
+    renderer.FillRect(SDL2pp::Rect(rect.x, rect.y, rect.w, rect.h));
+
+    renderer.SetDrawBlendMode(blend);
+    renderer.SetDrawColor(r, g, b, a);
+    draw_calls++;
 }
 
 void SDLGraphicsContext::requestScreenshot(const SDL2pp::Window& window, const std::string& path)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "SDLFont.h"
 #include "system/GraphicsContext.h"
 
 #include <SDL2pp/SDL2pp.hh>
@@ -22,22 +23,38 @@ public:
     std::shared_ptr<Font> loadFont(const std::string& path, unsigned pt) final;
     std::unique_ptr<Texture> loadTexture(const std::string& path) final;
     std::unique_ptr<Texture> loadTexture(const std::string& path, const RGBColor& tint) final;
+    std::unique_ptr<Texture> loadAtlas(const std::vector<AtlasImage>&,
+                                       unsigned cell_width, unsigned cell_height) final;
+
+    std::unique_ptr<Texture> createRenderTarget(unsigned width, unsigned height) final;
+    void setRenderTarget(Texture*) final;
+    unsigned renderTargetResets() const final { return render_target_resets; }
+
+    unsigned drawCallCount() const final { return last_frame_draw_calls; }
+    const CacheStats& textCacheStats() const final { return text_cache.stats(); }
 
     void drawFilledRect(const Rectangle& rect, const RGBColor& color) final;
     void drawFilledRect(const Rectangle& rect, const RGBAColor& color) final;
+    void clearRect(const Rectangle& rect) final;
 
     // SDL only
     void requestScreenshot(const SDL2pp::Window&, const std::string& path);
     void onResize(int width, int height);
+    void onRenderTargetsReset() { render_target_resets++; }
 
 private:
     SDL2pp::Renderer renderer;
     SDL2pp::SDLImage image_loader;
     SDL2pp::SDLTTF ttf;
-    uint32_t pixelformat;
 
+    // declared before the fonts, which refer to it
+    SDLFont::TextCache text_cache;
     std::map<std::string, std::shared_ptr<Font>> font_cache;
 
+    unsigned draw_calls;
+    unsigned last_frame_draw_calls;
+    unsigned render_target_resets;
+
     std::function<void()> on_render_callback;
     void saveScreenshotBMP(const SDL2pp::Window&, const std::string& path);
 };
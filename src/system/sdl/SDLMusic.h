@@ -6,14 +6,12 @@
 
 class SDLMusic : public Music {
 public:
-    SDLMusic(SDL2pp::Music&&);
+    SDLMusic(SDL2pp::Mixer&, SDL2pp::Music&&);
 
     void playLoop() final;
     void fadeOut(std::chrono::steady_clock::duration) final;
 
 private:
-    static SDL2pp::Mixer* mixer;
+    SDL2pp::Mixer& mixer;
     SDL2pp::Music music;
-
-friend class SDLAudioContext;
 };
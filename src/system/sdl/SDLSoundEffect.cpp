@@ -1,16 +1,12 @@
 #include "SDLSoundEffect.h"
 
-#include <assert.h>
 
-
-SDL2pp::Mixer* SDLSoundEffect::mixer = nullptr;
-
-SDLSoundEffect::SDLSoundEffect(SDL2pp::Chunk&& chunk)
-    : chunk(std::move(chunk))
+SDLSoundEffect::SDLSoundEffect(SDL2pp::Mixer& mixer, SDL2pp::Chunk&& chunk)
+    : mixer(mixer)
+    , chunk(std::move(chunk))
 {}
 
 void SDLSoundEffect::playOnce()
 {
-    assert(mixer);
-    mixer->PlayChannel(-1, chunk);
+    mixer.PlayChannel(-1, chunk);
 }
@@ -7,13 +7,11 @@
 
 class SDLSoundEffect : public SoundEffect {
 public:
-    SDLSoundEffect(SDL2pp::Chunk&&);
+    SDLSoundEffect(SDL2pp::Mixer&, SDL2pp::Chunk&&);
 
     void playOnce() final;
 
 private:
-    static SDL2pp::Mixer* mixer;
+    SDL2pp::Mixer& mixer;
     SDL2pp::Chunk chunk;
-
-friend class SDLAudioContext;
 };
@@ -1,35 +1,111 @@
 #include "SDLTexture.h"
 
-#include <assert.h>
 
+SDLTexture::SDLTexture(SDL2pp::Renderer& renderer, SDL2pp::Texture&& tex,
+                       unsigned& draw_call_counter, float pixel_scale)
+    : renderer(renderer)
+    , tex(std::make_shared<SDL2pp::Texture>(std::move(tex)))
+    , draw_calls(draw_call_counter)
+    , pixel_scale(pixel_scale)
+    , m_alpha(this->tex->GetAlphaMod())
+{}
 
-SDL2pp::Renderer* SDLTexture::renderer = nullptr;
+SDLTexture::SDLTexture(SDL2pp::Renderer& renderer, std::shared_ptr<SDL2pp::Texture> tex,
+                       uint8_t alpha, unsigned& draw_call_counter)
+    : renderer(renderer)
+    , tex(std::move(tex))
+    , draw_calls(draw_call_counter)
+    , pixel_scale(1.f)
+    , m_alpha(alpha)
+{
+    this->tex->SetAlphaMod(m_alpha);
+}
 
-SDLTexture::SDLTexture(SDL2pp::Texture&& tex)
-    : tex(std::move(tex))
-{}
+void SDLTexture::applyAlpha()
+{
+    // only shared textures can have a different alpha
+    if (tex.use_count() > 1)
+        tex->SetAlphaMod(m_alpha);
+}
 
 void SDLTexture::drawAt(int x, int y)
 {
-    assert(renderer);
-    renderer->Copy(tex, SDL2pp::NullOpt, SDL2pp::Point(x, y));
+    if (pixel_scale != 1.f) {
+        drawScaled({x, y, static_cast<int>(width()), static_cast<int>(height())});
+        return;
+    }
+
+    applyAlpha();
+    renderer.Copy(*tex, SDL2pp::NullOpt, SDL2pp::Point(x, y));
+    draw_calls++;
 }
 
 void SDLTexture::drawScaled(const Rectangle& rect)
 {
-    assert(renderer);
-    renderer->Copy(tex, SDL2pp::NullOpt, SDL2pp::Rect(rect.x, rect.y, rect.w, rect.h));
+    applyAlpha();
+    renderer.Copy(*tex, SDL2pp::NullOpt, SDL2pp::Rect(rect.x, rect.y, rect.w, rect.h));
+    draw_calls++;
 }
 
 void SDLTexture::drawPartialScaled(const Rectangle& from, const Rectangle& to)
 {
-    assert(renderer);
-    renderer->Copy(tex,
-                   SDL2pp::Rect(from.x, from.y, from.w, from.h),
+    const SDL2pp::Rect source = pixel_scale == 1.f
+        ? SDL2pp::Rect(from.x, from.y, from.w, from.h)
+        : SDL2pp::Rect(from.x * pixel_scale, from.y * pixel_scale, from.w * pixel_scale, from.h * pixel_scale);
+    applyAlpha();
+    renderer.Copy(*tex,
+                   source,
                    SDL2pp::Rect(to.x, to.y, to.w, to.h));
+    draw_calls++;
+}
+
+void SDLTexture::drawSprites(const std::vector<SpriteQuad>& sprites)
+{
+    if (sprites.empty())
+        return;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // two triangles per sprite; the texture's color and alpha
+    // modulation is not applied to geometry, so it's in the vertices
+    Uint8 r, g, b;
+    tex->GetColorMod(r, g, b);
+    const SDL_Color color = {r, g, b, m_alpha};
+    const float tex_width = tex->GetWidth() / pixel_scale;
+    const float tex_height = tex->GetHeight() / pixel_scale;
+
+    vertices.clear();
+    indices.clear();
+    for (const SpriteQuad& sprite : sprites) {
+        const int first = vertices.size();
+        const float left = sprite.from.x / tex_width;
+        const float right = (sprite.from.x + sprite.from.w) / tex_width;
+        const float top = sprite.from.y / tex_height;
+        const float bottom = (sprite.from.y + sprite.from.h) / tex_height;
+        const float x1 = sprite.to.x;
+        const float x2 = sprite.to.x + sprite.to.w;
+        const float y1 = sprite.to.y;
+        const float y2 = sprite.to.y + sprite.to.h;
+        vertices.push_back({{x1, y1}, color, {left, top}});
+        vertices.push_back({{x2, y1}, color, {right, top}});
+        vertices.push_back({{x1, y2}, color, {left, bottom}});
+        vertices.push_back({{x2, y2}, color, {right, bottom}});
+        for (const int index : {0, 1, 2, 2, 1, 3})
+            indices.push_back(first + index);
+    }
+
+    SDL_RenderGeometry(renderer.Get(), tex->Get(),
+                       vertices.data(), vertices.size(),
+                       indices.data(), indices.size());
+    draw_calls++;
+#else
+    // older SDL versions can only copy one rectangle at a time
+    for (const SpriteQuad& sprite : sprites)
+        drawPartialScaled(sprite.from, sprite.to);
+#endif
 }
 
 void SDLTexture::setAlpha(uint8_t alpha)
 {
-    tex.SetAlphaMod(alpha);
+    m_alpha = alpha;
+    tex->SetAlphaMod(alpha);
 }
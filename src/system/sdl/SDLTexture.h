@@ -3,25 +3,46 @@
 #include "system/Texture.h"
 
 #include <SDL2pp/SDL2pp.hh>
+#include <memory>
 
 
 class SDLTexture : public Texture {
 public:
-    SDLTexture(SDL2pp::Texture&&);
+    /// The draw calls of the texture are added to the counter. The texture
+    /// may have more pixels than its size by the pixel scale (for render targets).
+    SDLTexture(SDL2pp::Renderer&, SDL2pp::Texture&&, unsigned& draw_call_counter, float pixel_scale = 1.f);
+    /// Create a texture that shares its pixels with others (eg. cached textures);
+    /// the alpha value is still separate
+    SDLTexture(SDL2pp::Renderer&, std::shared_ptr<SDL2pp::Texture>, uint8_t alpha, unsigned& draw_call_counter);
 
     void drawAt(int x, int y) final;
     void drawScaled(const Rectangle&) final;
     void drawPartialScaled(const Rectangle& from, const Rectangle& to) final;
+    void drawSprites(const std::vector<SpriteQuad>&) final;
 
     void setAlpha(uint8_t) final;
-    uint8_t alpha() const final { return tex.GetAlphaMod(); }
+    uint8_t alpha() const final { return m_alpha; }
 
-    unsigned width() const final { return tex.GetWidth(); }
-    unsigned height() const final { return tex.GetHeight(); }
+    unsigned width() const final { return tex->GetWidth() / pixel_scale; }
+    unsigned height() const final { return tex->GetHeight() / pixel_scale; }
 
-private:
-    static SDL2pp::Renderer* renderer;
-    SDL2pp::Texture tex;
+    // SDL only
+    SDL2pp::Texture& sdlTexture() { return *tex; }
+    float pixelScale() const { return pixel_scale; }
 
-friend class SDLGraphicsContext;
+private:
+    SDL2pp::Renderer& renderer;
+    const std::shared_ptr<SDL2pp::Texture> tex;
+    unsigned& draw_calls;
+    const float pixel_scale;
+    // applied before every drawing, as the pixels may be shared
+    uint8_t m_alpha;
+
+    void applyAlpha();
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // reused between the batches
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+#endif
 };
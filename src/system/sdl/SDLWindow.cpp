@@ -190,6 +190,10 @@ std::vector<Event> SDLWindow::collectEvents()
                     break;
             }
             break;
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            gcx.onRenderTargetsReset();
+            break;
         case SDL_CONTROLLERDEVICEADDED:
             // Note: It seems this event doesn't always trigger,
             // so the code was moved to SDL_JOYDEVICEADDED, which happens
@@ -401,3 +405,11 @@ void SDLWindow::showErrorMessage(const std::string& title, const std::string& co
 {
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, title.c_str(), content.c_str(), NULL);
 }
+
+void SDLWindow::useDummyDrivers()
+{
+    // the driver hints are read from the environment by every SDL 2 version,
+    // while SDL_HINT_VIDEODRIVER and SDL_HINT_AUDIODRIVER are only in 2.0.22+
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+}
@@ -31,6 +31,9 @@ public:
     std::string buttonName(DeviceID, uint16_t) const final;
 
     static void showErrorMessage(const std::string& title, const std::string& content);
+    /// Make the windows created after this draw and play nothing;
+    /// has to be called before creating the window
+    static void useDummyDrivers();
 
 private:
     SDL2pp::SDL sdl;
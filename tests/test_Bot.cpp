@@ -0,0 +1,155 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/ai/Bot.h"
+#include "game/ai/Planner.h"
+#include "game/components/PieceQueue.h"
+#include "game/components/Well.h"
+#include "game/components/rotations/SRS.h"
+#include "game/util/ThreadPool.h"
+
+#include <thread>
+
+
+SUITE(Bot) {
+
+struct BotFixture {
+    Well well;
+    std::string emptyline_ascii;
+    std::atomic<bool> not_cancelled;
+
+    BotFixture()
+        : not_cancelled(false)
+    {
+        for (unsigned i = 0; i < 10; i++)
+            emptyline_ascii += '.';
+        emptyline_ascii += '\n';
+
+        well.setRotationFn(std::make_unique<Rotations::SRS>());
+    }
+
+    AI::PlanRequest makeRequest(PieceType current_piece) {
+        AI::PlanRequest request;
+        request.board = well.lockedMinos();
+        request.current_piece = current_piece;
+        request.hold_empty = true;
+        request.hold_piece = PieceType::I;
+        request.hold_allowed = false;
+        request.last_clear = ScoreType::CLEAR_SINGLE;
+        return request;
+    }
+
+    static AI::Planner::Clock::time_point farDeadline() {
+        return AI::Planner::Clock::now() + std::chrono::seconds(10);
+    }
+};
+
+TEST_FIXTURE(BotFixture, PlannerFillsWell)
+{
+    std::string base_ascii;
+    for (unsigned i = 0; i < 18; i++)
+        base_ascii += emptyline_ascii;
+    for (unsigned i = 0; i < 4; i++)
+        base_ascii += "OOOOOOOOO.\n";
+    well.fromAscii(base_ascii);
+
+    AI::Planner planner(well, AI::BotSettings::fromDifficulty(AI::BotDifficulty::EASY));
+    const auto plan = planner.search(makeRequest(PieceType::I), farDeadline(), not_cancelled);
+    REQUIRE CHECK(plan.valid);
+    CHECK_EQUAL(false, plan.use_hold);
+    REQUIRE CHECK(!plan.path.empty());
+    CHECK(plan.path.back().input == InputType::GAME_HARDDROP);
+
+    WellComponents::MoveGen<10, 40> movegen(well);
+    auto board = well.lockedMinos();
+    CHECK_EQUAL(4u, movegen.lockOnto(board, plan.placement));
+}
+
+TEST_FIXTURE(BotFixture, PlannerPrefersTSpin)
+{
+    std::string base_ascii;
+    for (unsigned i = 0; i < 19; i++)
+        base_ascii += emptyline_ascii;
+    base_ascii += ".....OO...\n";
+    base_ascii += "OOO...OOOO\n";
+    base_ascii += "OOOO.OOOOO\n";
+    well.fromAscii(base_ascii);
+
+    AI::Planner planner(well, AI::BotSettings::fromDifficulty(AI::BotDifficulty::MEDIUM));
+    auto request = makeRequest(PieceType::T);
+    request.next_pieces = {PieceType::O};
+    const auto plan = planner.search(request, farDeadline(), not_cancelled);
+    REQUIRE CHECK(plan.valid);
+    CHECK(plan.placement.tspin == TSpinDetectionResult::TSPIN);
+}
+
+TEST_FIXTURE(BotFixture, PlannerUsesHold)
+{
+    std::string base_ascii;
+    for (unsigned i = 0; i < 18; i++)
+        base_ascii += emptyline_ascii;
+    for (unsigned i = 0; i < 4; i++)
+        base_ascii += "OOOOOOOOO.\n";
+    well.fromAscii(base_ascii);
+
+    // the I piece is in the hold queue
+    AI::Planner planner(well, AI::BotSettings::fromDifficulty(AI::BotDifficulty::MEDIUM));
+    auto request = makeRequest(PieceType::S);
+    request.hold_empty = false;
+    request.hold_piece = PieceType::I;
+    request.hold_allowed = true;
+    const auto plan = planner.search(request, farDeadline(), not_cancelled);
+    REQUIRE CHECK(plan.valid);
+    CHECK_EQUAL(true, plan.use_hold);
+    CHECK(plan.placement.type == PieceType::I);
+}
+
+TEST_FIXTURE(BotFixture, PlaysGame)
+{
+    PieceQueue queue(1234);
+    unsigned locked_pieces = 0;
+    unsigned cleared_lines = 0;
+    bool gameover = false;
+    well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [this, &queue](const WellEvent&){
+        well.addPiece(queue.next());
+    });
+    well.registerObserver(WellEvent::Type::PIECE_LOCKED, [&locked_pieces](const WellEvent&){
+        locked_pieces++;
+    });
+    well.registerObserver(WellEvent::Type::LINE_CLEAR, [&cleared_lines](const WellEvent& event){
+        cleared_lines += event.lineclear.count;
+    });
+    well.registerObserver(WellEvent::Type::GAME_OVER, [&gameover](const WellEvent&){
+        gameover = true;
+    });
+
+    ThreadPool workers(1);
+    AI::BotSettings settings = AI::BotSettings::fromDifficulty(AI::BotDifficulty::HARD);
+    settings.think_time = std::chrono::milliseconds(2);
+    AI::Bot bot(well, AI::first_bot_device, settings, workers);
+
+    // the frames are shortened, but the search still has to finish
+    // in a few frames, before gravity moves the piece too much
+    AI::PlayerView view;
+    view.hold_empty = true;
+    view.hold_piece = PieceType::I;
+    view.hold_allowed = false;
+    for (unsigned frame = 0; frame < 100000 && locked_pieces < 30 && !gameover; frame++) {
+        view.next_pieces.clear();
+        queue.fill(5);
+        for (unsigned i = 0; i < 5; i++)
+            view.next_pieces.push_back(queue.peek(i));
+
+        std::vector<InputEvent> events;
+        bot.update(well, view, events);
+        for (const auto& event : events)
+            CHECK_EQUAL(AI::first_bot_device, event.srcDeviceID());
+        well.update(events);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    CHECK_EQUAL(false, gameover);
+    CHECK_EQUAL(30u, locked_pieces);
+    CHECK(cleared_lines >= 8);
+}
+
+}
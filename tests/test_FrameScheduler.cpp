@@ -0,0 +1,92 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/FrameScheduler.h"
+
+
+SUITE(FrameScheduler) {
+    using namespace std::chrono_literals;
+
+struct SchedulerFixture {
+    const Duration frame = 10ms;
+    FrameScheduler::Clock::time_point now;
+
+    FrameSchedulerSettings settings(bool frame_skip, unsigned max_catchup) const {
+        FrameSchedulerSettings output;
+        output.frame_skip = frame_skip;
+        output.max_catchup_updates = max_catchup;
+        return output;
+    }
+};
+
+TEST_FIXTURE(SchedulerFixture, SteadyRate)
+{
+    FrameScheduler scheduler(settings(true, 4), frame);
+    scheduler.start(now);
+    CHECK_EQUAL(1u, scheduler.beginFrame(now));
+
+    // waking up early has no updates, and the next one is due at the end of the frame
+    now += 4ms;
+    CHECK_EQUAL(0u, scheduler.beginFrame(now));
+    CHECK(scheduler.nextUpdateTime() == now + 6ms);
+    CHECK_CLOSE(0.4f, scheduler.interpolation(), 0.001f);
+
+    for (unsigned i = 0; i < 100; i++) {
+        now = scheduler.nextUpdateTime();
+        CHECK_EQUAL(1u, scheduler.beginFrame(now));
+    }
+    CHECK_EQUAL(101u, scheduler.stats().updates);
+    CHECK_EQUAL(0u, scheduler.stats().late_frames);
+    CHECK_EQUAL(0u, scheduler.stats().skipped_draws);
+}
+
+TEST_FIXTURE(SchedulerFixture, CatchUp)
+{
+    FrameScheduler scheduler(settings(true, 4), frame);
+    scheduler.start(now);
+    scheduler.beginFrame(now);
+
+    // a slow frame is made up by running the missed updates in a batch
+    now += 35ms;
+    CHECK_EQUAL(3u, scheduler.beginFrame(now));
+    CHECK_EQUAL(1u, scheduler.stats().late_frames);
+    CHECK_EQUAL(2u, scheduler.stats().skipped_draws);
+    CHECK(scheduler.nextUpdateTime() == now + 5ms);
+
+    // but not too many at once
+    now += 105ms;
+    CHECK_EQUAL(4u, scheduler.beginFrame(now));
+    CHECK_EQUAL(2u, scheduler.stats().late_frames);
+    CHECK_EQUAL(7u, scheduler.stats().dropped_updates);
+    CHECK_EQUAL(1u + 3u + 4u, scheduler.stats().updates);
+
+    // the dropped time is not made up later
+    now = scheduler.nextUpdateTime();
+    CHECK_EQUAL(1u, scheduler.beginFrame(now));
+}
+
+TEST_FIXTURE(SchedulerFixture, WithoutFrameSkip)
+{
+    FrameScheduler scheduler(settings(false, 4), frame);
+    scheduler.start(now);
+    scheduler.beginFrame(now);
+
+    // every update is drawn, the game slows down instead
+    now += 35ms;
+    CHECK_EQUAL(1u, scheduler.beginFrame(now));
+    CHECK_EQUAL(2u, scheduler.stats().dropped_updates);
+    CHECK_EQUAL(0u, scheduler.stats().skipped_draws);
+    CHECK(scheduler.nextUpdateTime() == now + 5ms);
+}
+
+TEST_FIXTURE(SchedulerFixture, ClockGoingBackwards)
+{
+    FrameScheduler scheduler(settings(true, 4), frame);
+    scheduler.start(now);
+    scheduler.beginFrame(now);
+    now -= 1s;
+    CHECK_EQUAL(0u, scheduler.beginFrame(now));
+    now += frame;
+    CHECK_EQUAL(1u, scheduler.beginFrame(now));
+}
+
+}
@@ -10,7 +10,7 @@
 class AppContext {
 public:
     AppContext()
-        : window(Window::create())
+        : window(Window::create(false))
     {
         // TODO: set window and resolution to 640x480
     }
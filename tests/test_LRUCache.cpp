@@ -0,0 +1,78 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "system/LRUCache.h"
+
+
+SUITE(LRUCache) {
+
+TEST(FindInserted)
+{
+    LRUCache<int> cache(100);
+    CHECK(cache.find("a") == nullptr);
+
+    cache.insert("a", 1, 10);
+    cache.insert("b", 2, 10);
+    const int* value = cache.find("a");
+    CHECK(value != nullptr);
+    CHECK_EQUAL(1, *value);
+
+    CHECK_EQUAL(1u, cache.stats().hits);
+    CHECK_EQUAL(1u, cache.stats().misses);
+    CHECK_EQUAL(2u, cache.stats().entries);
+    CHECK_EQUAL(20u, cache.stats().size);
+}
+
+TEST(Replace)
+{
+    LRUCache<int> cache(100);
+    cache.insert("a", 1, 10);
+    cache.insert("a", 2, 30);
+    CHECK_EQUAL(2, *cache.find("a"));
+    CHECK_EQUAL(1u, cache.stats().entries);
+    CHECK_EQUAL(30u, cache.stats().size);
+}
+
+TEST(EvictLeastRecentlyUsed)
+{
+    LRUCache<int> cache(30);
+    cache.insert("a", 1, 10);
+    cache.insert("b", 2, 10);
+    cache.insert("c", 3, 10);
+
+    // "b" becomes the least recently used one
+    cache.find("a");
+    cache.insert("d", 4, 10);
+    CHECK(cache.find("b") == nullptr);
+    CHECK(cache.find("a") != nullptr);
+    CHECK(cache.find("c") != nullptr);
+    CHECK(cache.find("d") != nullptr);
+    CHECK_EQUAL(1u, cache.stats().evictions);
+
+    // a large value removes as many as needed
+    cache.insert("e", 5, 25);
+    CHECK_EQUAL(1u, cache.stats().entries);
+    CHECK_EQUAL(25u, cache.stats().size);
+    CHECK_EQUAL(4u, cache.stats().evictions);
+}
+
+TEST(TooLarge)
+{
+    LRUCache<int> cache(30);
+    cache.insert("a", 1, 10);
+    cache.insert("b", 2, 40);
+    CHECK(cache.find("b") == nullptr);
+    CHECK(cache.find("a") != nullptr);
+    CHECK_EQUAL(0u, cache.stats().evictions);
+}
+
+TEST(Clear)
+{
+    LRUCache<int> cache(30);
+    cache.insert("a", 1, 10);
+    cache.clear();
+    CHECK(cache.find("a") == nullptr);
+    CHECK_EQUAL(0u, cache.stats().entries);
+    CHECK_EQUAL(0u, cache.stats().size);
+}
+
+}
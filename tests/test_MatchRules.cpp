@@ -0,0 +1,117 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/MatchRules.h"
+
+
+SUITE(MatchRules) {
+
+WellEvent::lineclear_t makeClear(uint8_t count)
+{
+    WellEvent::lineclear_t lineclear;
+    lineclear.count = count;
+    lineclear.type = LineClearType::NORMAL;
+    lineclear.rows = (1ull << count) - 1;
+    return lineclear;
+}
+
+TEST(LevelUp)
+{
+    MatchRules rules(GameMode::SP_MARATHON);
+    auto player = rules.newPlayer();
+    PlayerStatistics stats;
+    const Duration first_gravity = rules.gravity(player);
+
+    // a four line clear is worth 8 line awards, and the first level requires 5
+    const auto result = rules.onLineClear(player, stats, makeClear(4));
+    CHECK(result.type == ScoreType::CLEAR_PERFECT);
+    CHECK_EQUAL(false, result.back2back);
+    CHECK_EQUAL(0, result.attack_lines);
+    CHECK_EQUAL(1, result.level_ups);
+    CHECK_EQUAL(2, stats.level);
+    CHECK_EQUAL(4, stats.total_cleared_lines);
+    CHECK(rules.gravity(player) < first_gravity);
+    // the score is counted on the level of the line clear
+    CHECK_EQUAL(ScoreTable::value(ScoreType::CLEAR_PERFECT), stats.score);
+}
+
+TEST(LineGoalFinishes)
+{
+    MatchRules rules(GameMode::SP_40LINES);
+    auto player = rules.newPlayer();
+    PlayerStatistics stats;
+
+    for (unsigned i = 0; i < 9; i++) {
+        rules.onPieceLocked(player);
+        CHECK_EQUAL(false, rules.onLineClear(player, stats, makeClear(4)).finished);
+    }
+    rules.onPieceLocked(player);
+    CHECK_EQUAL(true, rules.onLineClear(player, stats, makeClear(4)).finished);
+    CHECK(player.status == MatchRules::PlayerStatus::FINISHED);
+    CHECK_EQUAL(40, stats.total_cleared_lines);
+}
+
+TEST(ComboAndBackToBack)
+{
+    MatchRules rules(GameMode::SP_MARATHON_SIMPLE);
+    auto player = rules.newPlayer();
+    PlayerStatistics stats;
+
+    rules.onPieceLocked(player);
+    CHECK_EQUAL(0, rules.onLineClear(player, stats, makeClear(4)).combo_length);
+    rules.onPieceLocked(player);
+    const auto result = rules.onLineClear(player, stats, makeClear(4));
+    CHECK_EQUAL(1, result.combo_length);
+    CHECK_EQUAL(true, result.back2back);
+    CHECK_EQUAL(1, stats.back_to_back_count);
+}
+
+TEST(BattleGarbage)
+{
+    MatchRules rules(GameMode::MP_BATTLE);
+    auto attacker = rules.newPlayer();
+    auto target = rules.newPlayer();
+    PlayerStatistics stats;
+
+    // the own garbage is reduced first
+    rules.receiveGarbage(attacker, 3);
+    const auto result = rules.onLineClear(attacker, stats, makeClear(4));
+    CHECK_EQUAL(1, result.attack_lines);
+    CHECK_EQUAL(0, attacker.queued_garbage_lines);
+
+    rules.receiveGarbage(target, 100);
+    CHECK_EQUAL(MatchRules::max_queued_garbage, target.queued_garbage_lines);
+    rules.onNextRequested(target);
+    CHECK_EQUAL(0, target.queued_garbage_lines);
+    CHECK_EQUAL(MatchRules::max_queued_garbage, target.pending_garbage_lines);
+}
+
+TEST(BattleTargetsAndWinner)
+{
+    MatchRules rules(GameMode::MP_BATTLE);
+    std::vector<MatchRules::PlayerState> players(3, rules.newPlayer());
+    std::vector<MatchRules::PlayerState*> player_states;
+    for (auto& player : players)
+        player_states.push_back(&player);
+
+    Random rng(1);
+    rules.onGameOver(players[0]);
+    CHECK_EQUAL(-1, rules.finishBattleMaybe(player_states));
+    for (unsigned i = 0; i < 10; i++)
+        CHECK_EQUAL(2, rules.attackTarget(rng, player_states, 1));
+
+    // the attacks arrive after their travel time
+    CHECK_EQUAL(2, rules.sendAttack(rng, player_states, 1, 3));
+    CHECK_EQUAL(2, rules.sendAttack(rng, player_states, 1, 2));
+    for (unsigned i = 1; i < MatchRules::attack_travel_frames; i++)
+        CHECK_EQUAL(0u, rules.updateIncomingAttacks(players[2]));
+    CHECK_EQUAL(5u, rules.updateIncomingAttacks(players[2]));
+    CHECK_EQUAL(0, players[2].incoming_attack_count);
+    CHECK_EQUAL(5, players[2].queued_garbage_lines);
+
+    rules.onGameOver(players[1]);
+    CHECK_EQUAL(2, rules.finishBattleMaybe(player_states));
+    CHECK(players[2].status == MatchRules::PlayerStatus::FINISHED);
+    CHECK_EQUAL(-1, rules.attackTarget(rng, player_states, 2));
+}
+
+}
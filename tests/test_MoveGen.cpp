@@ -0,0 +1,237 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/components/Well.h"
+#include "game/components/rotations/SRS.h"
+#include "game/components/well/MoveGen.h"
+
+#include <algorithm>
+
+
+SUITE(MoveGen) {
+
+// TODO: get these values from config
+constexpr unsigned softdrop_delay_frames = 64 / 20.0;
+
+struct MoveGenFixture {
+    Well well;
+    std::string emptyline_ascii;
+
+    MoveGenFixture() {
+        for (unsigned i = 0; i < 10; i++)
+            emptyline_ascii += '.';
+        emptyline_ascii += '\n';
+
+        well.setRotationFn(std::make_unique<Rotations::SRS>());
+    }
+
+    // press every key for one frame
+    void play(const std::vector<InputType>& path) {
+        for (const auto input : path) {
+            well.update({InputEvent(input, true)});
+            well.update({InputEvent(input, false)});
+            if (input == InputType::GAME_SOFTDROP) {
+                for (unsigned i = 0; i < softdrop_delay_frames; i++)
+                    well.update({});
+            }
+        }
+    }
+};
+
+TEST_FIXTURE(MoveGenFixture, EmptyWell)
+{
+    WellComponents::MoveGen<10, 40> movegen(well);
+    const Well::Board board;
+
+    // the rotations with the same shape are only listed once
+    CHECK_EQUAL(9u, movegen.generate(board, PieceType::O).size());
+    CHECK_EQUAL(17u, movegen.generate(board, PieceType::I).size());
+    CHECK_EQUAL(17u, movegen.generate(board, PieceType::S).size());
+    CHECK_EQUAL(34u, movegen.generate(board, PieceType::T).size());
+    CHECK_EQUAL(34u, movegen.generate(board, PieceType::L).size());
+
+    for (const auto& placement : movegen.placements())
+        CHECK(placement.tspin == TSpinDetectionResult::NONE);
+}
+
+TEST_FIXTURE(MoveGenFixture, ActivePiece)
+{
+    WellComponents::MoveGen<10, 40> movegen(well);
+    CHECK(movegen.generate(well).empty());
+
+    well.addPiece(PieceType::J);
+    const auto& placements = movegen.generate(well);
+    CHECK_EQUAL(34u, placements.size());
+
+    // every path ends with a hard drop, and leads to the placement
+    for (const auto& placement : placements) {
+        const auto path = movegen.pathTo(placement);
+        CHECK(!path.empty() && path.back() == InputType::GAME_HARDDROP);
+    }
+    auto expected_board = well.lockedMinos();
+    movegen.lockOnto(expected_board, placements.back());
+
+    play(movegen.pathTo(placements.back()));
+    CHECK(well.activePiece() == nullptr);
+    for (unsigned row = 0; row < Well::height; row++) {
+        for (unsigned col = 0; col < Well::width; col++)
+            CHECK_EQUAL(expected_board.isOccupied(row, col), well.lockedMinos().isOccupied(row, col));
+    }
+}
+
+TEST_FIXTURE(MoveGenFixture, Tuck)
+{
+    std::string base_ascii;
+    for (unsigned i = 0; i < 19; i++)
+        base_ascii += emptyline_ascii;
+    base_ascii += "OOOOOOOO..\n";
+    base_ascii += "..........\n";
+    base_ascii += "..........\n";
+    well.fromAscii(base_ascii);
+
+    WellComponents::MoveGen<10, 40> movegen(well);
+    const auto& placements = movegen.generate(well.lockedMinos(), PieceType::O);
+
+    // the O piece can be moved under the overhang, to the left wall
+    const auto tuck = std::find_if(placements.cbegin(), placements.cend(), [&](const auto& placement){
+        auto board = well.lockedMinos();
+        movegen.lockOnto(board, placement);
+        return board.isOccupied(39, 0);
+    });
+    REQUIRE CHECK(tuck != placements.cend());
+
+    const auto path = movegen.pathTo(*tuck);
+    CHECK(std::find(path.cbegin(), path.cend(), InputType::GAME_SOFTDROP) != path.cend());
+
+    well.addPiece(PieceType::O);
+    play(path);
+
+    std::string expected_ascii;
+    for (unsigned i = 0; i < 19; i++)
+        expected_ascii += emptyline_ascii;
+    expected_ascii += "OOOOOOOO..\n";
+    expected_ascii += "OO........\n";
+    expected_ascii += "OO........\n";
+    CHECK_EQUAL(expected_ascii, well.asAscii());
+}
+
+TEST_FIXTURE(MoveGenFixture, TSpin)
+{
+    bool tspin_detected = false;
+    well.registerObserver(WellEvent::Type::LINE_CLEAR, [&tspin_detected](const WellEvent& event){
+        if (event.lineclear.type == LineClearType::TSPIN && event.lineclear.count == 2)
+            tspin_detected = true;
+    });
+
+    std::string base_ascii;
+    for (unsigned i = 0; i < 19; i++)
+        base_ascii += emptyline_ascii;
+    base_ascii += ".....OO...\n";
+    base_ascii += "OOO...OOOO\n";
+    base_ascii += "OOOO.OOOOO\n";
+    well.fromAscii(base_ascii);
+
+    WellComponents::MoveGen<10, 40> movegen(well);
+    const auto& placements = movegen.generate(well.lockedMinos(), PieceType::T);
+    const auto spin = std::find_if(placements.cbegin(), placements.cend(), [](const auto& placement){
+        return placement.tspin == TSpinDetectionResult::TSPIN;
+    });
+    REQUIRE CHECK(spin != placements.cend());
+    CHECK_EQUAL(3, spin->x);
+    CHECK_EQUAL(37u, static_cast<unsigned>(spin->y));
+    CHECK(spin->orientation == PieceDirection::SOUTH);
+
+    auto expected_board = well.lockedMinos();
+    CHECK_EQUAL(2u, movegen.lockOnto(expected_board, *spin));
+
+    well.addPiece(PieceType::T);
+    play(movegen.pathTo(*spin));
+    CHECK(well.activePiece() == nullptr);
+    for (unsigned i = 0; i < 100; i++)
+        well.update({});
+    CHECK_EQUAL(true, tspin_detected);
+}
+
+TEST_FIXTURE(MoveGenFixture, Gravity20G)
+{
+    const auto gravity_20g = Timing::frame_duration_60Hz / 20;
+    const auto input_interval = 2 * Timing::frame_duration;
+
+    std::string base_ascii;
+    for (unsigned i = 0; i < 7; i++)
+        base_ascii += emptyline_ascii;
+    for (unsigned i = 0; i < 15; i++)
+        base_ascii += ".......O..\n";
+    well.fromAscii(base_ascii);
+    well.setGravity(gravity_20g);
+
+    // without gravity, the piece can be moved over the column
+    WellComponents::MoveGen<10, 40> movegen(well);
+    const auto is_right_of_column = [&](const auto& placement){
+        auto board = well.lockedMinos();
+        movegen.lockOnto(board, placement);
+        return board.isOccupied(39, 8) || board.isOccupied(39, 9);
+    };
+    const auto& free_placements = movegen.generate(well.lockedMinos(), PieceType::T);
+    CHECK(std::any_of(free_placements.cbegin(), free_placements.cend(), is_right_of_column));
+
+    // with 20G, it falls to the bottom before it could pass the column
+    movegen.setGravity(gravity_20g, input_interval);
+    const auto& placements = movegen.generate(well.lockedMinos(), PieceType::T);
+    REQUIRE CHECK(!placements.empty());
+    CHECK(std::none_of(placements.cbegin(), placements.cend(), is_right_of_column));
+
+    // the paths are still valid
+    const auto leftmost = std::min_element(placements.cbegin(), placements.cend(),
+        [](const auto& a, const auto& b){ return a.x < b.x; });
+    auto expected_board = well.lockedMinos();
+    movegen.lockOnto(expected_board, *leftmost);
+
+    well.addPiece(PieceType::T);
+    play(movegen.pathTo(*leftmost));
+    CHECK(well.activePiece() == nullptr);
+    for (unsigned row = 0; row < Well::height; row++) {
+        for (unsigned col = 0; col < Well::width; col++)
+            CHECK_EQUAL(expected_board.isOccupied(row, col), well.lockedMinos().isOccupied(row, col));
+    }
+}
+
+TEST_FIXTURE(MoveGenFixture, ExtendedLockDelayResets)
+{
+    const auto gravity_20g = Timing::frame_duration_60Hz / 20;
+    well.setGravity(gravity_20g);
+
+    // the piece falls to the bottom, then uses up all but one of its resets
+    well.addPiece(PieceType::T);
+    well.update({});
+    for (unsigned i = 0; i < WellComponents::LockDelay::reset_counter_max - 1u; i++)
+        play({i % 2 ? InputType::GAME_MOVE_RIGHT : InputType::GAME_MOVE_LEFT});
+    REQUIRE CHECK(well.activePiece() != nullptr);
+    const int start_x = well.snapshot().active_piece_x;
+
+    // only one more move or rotation is possible
+    WellComponents::MoveGen<10, 40> movegen(well);
+    movegen.setGravity(gravity_20g, 2 * Timing::frame_duration);
+    const auto& placements = movegen.generate(well);
+    CHECK(placements.size() <= 5u);
+    for (const auto& placement : placements)
+        CHECK(std::abs(placement.x - start_x) <= 1);
+
+    const auto moved_left = std::find_if(placements.cbegin(), placements.cend(), [start_x](const auto& placement){
+        return placement.x == start_x - 1 && placement.orientation == PieceDirection::NORTH;
+    });
+    REQUIRE CHECK(moved_left != placements.cend());
+    auto expected_board = well.lockedMinos();
+    movegen.lockOnto(expected_board, *moved_left);
+
+    // the piece locks right after the move, without the hard drop
+    auto path = movegen.pathTo(*moved_left);
+    path.pop_back();
+    play(path);
+    CHECK(well.activePiece() == nullptr);
+    for (unsigned row = 0; row < Well::height; row++) {
+        for (unsigned col = 0; col < Well::width; col++)
+            CHECK_EQUAL(expected_board.isOccupied(row, col), well.lockedMinos().isOccupied(row, col));
+    }
+}
+
+}
@@ -1,68 +1,61 @@
 #include "UnitTest++/UnitTest++.h"
 
-#include "game/components/MinoStorage.h"
 #include "game/components/Piece.h"
+#include "game/components/PieceShape.h"
 #include "game/components/PieceType.h"
 
-#include <bitset>
-#include <string>
-#include <memory>
-
 
 SUITE(Piece) {
 
+constexpr std::array<PieceShape, 4> test_shape = {{
+    makePieceShape(0b1111111111111111),
+    makePieceShape(0b0000000000010000),
+    makePieceShape(0b0000000100000000),
+    makePieceShape(0b0001000000000000),
+}};
+constexpr PieceShapeTable test_shapes = {{
+    test_shape, test_shape, test_shape, test_shape, test_shape, test_shape, test_shape,
+}};
+
 struct PieceFixture {
-    std::unique_ptr<Piece> p;
-    const std::array<std::bitset<16>, 4> grid;
+    Piece piece;
 
     PieceFixture()
-        : grid({{std::bitset<16>("1111111111111111"),
-                 std::bitset<16>("0000000000010000"),
-                 std::bitset<16>("0000000100000000"),
-                 std::bitset<16>("0001000000000000")}})
-    {
-        MinoStorage::loadDummyMinos();
-        p = std::make_unique<Piece>(PieceType::I, grid);
-    }
+        : piece(PieceType::I, test_shapes)
+    {}
 };
 
 TEST_FIXTURE(PieceFixture, CtorFirstFrame)
 {
-    const auto& grid = p->currentGrid();
-
-    for (const auto& row : grid) {
-        for (const auto& col : row) {
-            REQUIRE CHECK(col.get() != nullptr);
+    for (unsigned row = 0; row < 4; row++) {
+        for (unsigned col = 0; col < 4; col++) {
+            REQUIRE CHECK(piece.hasMinoAt(row, col));
         }
     }
 }
 
 TEST_FIXTURE(PieceFixture, RotateCW)
 {
-    p->rotateCW();
-    const auto& grid = p->currentGrid();
-
+    piece.rotateCW();
     for (unsigned row = 0; row < 4; row++) {
         for (unsigned col = 0; col < 4; col++) {
             if (row == 2 && col == 3)
-                CHECK(grid[row][col].get() != nullptr);
+                CHECK(piece.hasMinoAt(row, col));
             else
-                CHECK(grid[row][col].get() == nullptr);
+                CHECK(!piece.hasMinoAt(row, col));
         }
     }
 }
 
 TEST_FIXTURE(PieceFixture, RotateCCW)
 {
-    p->rotateCCW();
-    const auto& grid = p->currentGrid();
-
+    piece.rotateCCW();
     for (unsigned row = 0; row < 4; row++) {
         for (unsigned col = 0; col < 4; col++) {
             if (row == 0 && col == 3)
-                CHECK(grid[row][col].get() != nullptr);
+                CHECK(piece.hasMinoAt(row, col));
             else
-                CHECK(grid[row][col].get() == nullptr);
+                CHECK(!piece.hasMinoAt(row, col));
         }
     }
 }
@@ -70,25 +63,21 @@ TEST_FIXTURE(PieceFixture, RotateCCW)
 TEST_FIXTURE(PieceFixture, RotateBack)
 {
     {
-        p->rotateCCW();
-        p->rotateCW();
-        const auto& grid = p->currentGrid();
-
-        for (const auto& row : grid) {
-            for (const auto& col : row) {
-                REQUIRE CHECK(col.get() != nullptr);
+        piece.rotateCCW();
+        piece.rotateCW();
+        for (unsigned row = 0; row < 4; row++) {
+            for (unsigned col = 0; col < 4; col++) {
+                REQUIRE CHECK(piece.hasMinoAt(row, col));
             }
         }
     }
 
     {
-        p->rotateCW();
-        p->rotateCCW();
-        const auto& grid = p->currentGrid();
-
-        for (const auto& row : grid) {
-            for (const auto& col : row) {
-                REQUIRE CHECK(col.get() != nullptr);
+        piece.rotateCW();
+        piece.rotateCCW();
+        for (unsigned row = 0; row < 4; row++) {
+            for (unsigned col = 0; col < 4; col++) {
+                REQUIRE CHECK(piece.hasMinoAt(row, col));
             }
         }
     }
@@ -97,32 +86,56 @@ TEST_FIXTURE(PieceFixture, RotateBack)
 TEST_FIXTURE(PieceFixture, RotateAround)
 {
     {
-        p->rotateCCW();
-        p->rotateCCW();
-        p->rotateCCW();
-        p->rotateCCW();
-        const auto& grid = p->currentGrid();
-
-        for (const auto& row : grid) {
-            for (const auto& col : row) {
-                REQUIRE CHECK(col.get() != nullptr);
+        piece.rotateCCW();
+        piece.rotateCCW();
+        piece.rotateCCW();
+        piece.rotateCCW();
+        for (unsigned row = 0; row < 4; row++) {
+            for (unsigned col = 0; col < 4; col++) {
+                REQUIRE CHECK(piece.hasMinoAt(row, col));
             }
         }
     }
 
     {
-        p->rotateCW();
-        p->rotateCW();
-        p->rotateCW();
-        p->rotateCW();
-        const auto& grid = p->currentGrid();
-
-        for (const auto& row : grid) {
-            for (const auto& col : row) {
-                REQUIRE CHECK(col.get() != nullptr);
+        piece.rotateCW();
+        piece.rotateCW();
+        piece.rotateCW();
+        piece.rotateCW();
+        for (unsigned row = 0; row < 4; row++) {
+            for (unsigned col = 0; col < 4; col++) {
+                REQUIRE CHECK(piece.hasMinoAt(row, col));
             }
         }
     }
 }
 
+TEST(ShapeTable)
+{
+    // the I piece is in the second row of its 4x4 grid
+    constexpr PieceShape shape = makePieceShape(0b0000111100000000);
+    static_assert(shape.grid_rows[0] == 0b0000, "");
+    static_assert(shape.grid_rows[1] == 0b1111, "");
+    static_assert(shape.bottom_profile[0] == 1, "");
+
+    // the T piece has its leftmost column in bit 0
+    constexpr PieceShape t_shape = makePieceShape(0b0100111000000000);
+    CHECK_EQUAL(0b0010, t_shape.grid_rows[0]);
+    CHECK_EQUAL(0b0111, t_shape.grid_rows[1]);
+    CHECK_EQUAL(1, t_shape.bottom_profile[0]);
+    CHECK_EQUAL(1, t_shape.bottom_profile[1]);
+    CHECK_EQUAL(1, t_shape.bottom_profile[2]);
+    CHECK_EQUAL(-1, t_shape.bottom_profile[3]);
+}
+
+TEST(ValueType)
+{
+    // copies of a piece rotate independently
+    Piece piece(PieceType::T, test_shapes);
+    Piece copy = piece;
+    copy.rotateCW();
+    CHECK(piece.orientation() == PieceDirection::NORTH);
+    CHECK(copy.orientation() == PieceDirection::EAST);
+}
+
 } // Suite
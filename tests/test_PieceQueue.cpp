@@ -0,0 +1,68 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/components/PieceQueue.h"
+
+#include <algorithm>
+#include <array>
+
+
+SUITE(PieceQueue) {
+
+TEST(EveryBagHasEveryPiece) {
+    PieceQueue queue(1234);
+    for (unsigned bag = 0; bag < 10; bag++) {
+        std::array<PieceType, 7> pieces;
+        for (auto& piece : pieces)
+            piece = queue.next();
+        CHECK(std::is_permutation(pieces.cbegin(), pieces.cend(), PieceTypeList.cbegin()));
+    }
+}
+
+TEST(SameSeedSameOrder) {
+    PieceQueue queue_a(42);
+    PieceQueue queue_b(42);
+    for (unsigned i = 0; i < 50; i++)
+        CHECK(queue_a.next() == queue_b.next());
+}
+
+TEST(Reseed) {
+    PieceQueue queue(7);
+    std::array<PieceType, 14> first_pieces;
+    for (auto& piece : first_pieces)
+        piece = queue.next();
+
+    queue.setRandomSeed(7);
+    for (const auto piece : first_pieces)
+        CHECK(piece == queue.next());
+}
+
+TEST(Preview) {
+    PieceQueue queue(99);
+    queue.fill(10);
+    CHECK(queue.size() >= 10);
+
+    std::array<PieceType, 10> previewed;
+    for (unsigned i = 0; i < previewed.size(); i++)
+        previewed[i] = queue.peek(i);
+    for (const auto piece : previewed)
+        CHECK(piece == queue.next());
+}
+
+TEST(SnapshotRestore) {
+    PieceQueue queue(3);
+    for (unsigned i = 0; i < 5; i++)
+        queue.next();
+    queue.fill(15);
+    const auto saved = queue.snapshot();
+
+    std::array<PieceType, 30> expected;
+    for (auto& piece : expected)
+        piece = queue.next();
+
+    queue.restore(saved);
+    CHECK(queue.size() >= 15);
+    for (const auto piece : expected)
+        CHECK(piece == queue.next());
+}
+
+} // Suite
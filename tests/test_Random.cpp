@@ -0,0 +1,63 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/util/Random.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+
+SUITE(Random) {
+
+TEST(SameSeedSameSequence) {
+    Random a(1234);
+    Random b(1234);
+    for (unsigned i = 0; i < 100; i++)
+        CHECK_EQUAL(a.next(), b.next());
+}
+
+TEST(DifferentSeedDifferentSequence) {
+    Random a(1);
+    Random b(2);
+    unsigned same_count = 0;
+    for (unsigned i = 0; i < 100; i++)
+        same_count += (a.next() == b.next());
+    CHECK(same_count < 5);
+}
+
+TEST(Reseed) {
+    Random rng(42);
+    const uint32_t first = rng.next();
+    rng.next();
+    rng.setSeed(42);
+    CHECK_EQUAL(first, rng.next());
+}
+
+TEST(Below) {
+    Random rng(7);
+    std::array<unsigned, 10> hits {};
+    for (unsigned i = 0; i < 1000; i++) {
+        const uint32_t value = rng.below(hits.size());
+        CHECK(value < hits.size());
+        hits.at(value)++;
+    }
+    for (const unsigned count : hits)
+        CHECK(count > 0);
+}
+
+TEST(ShuffleIsPermutation) {
+    Random rng(99);
+    std::array<int, 7> values;
+    std::iota(values.begin(), values.end(), 0);
+    const auto original = values;
+
+    rng.shuffle(values.begin(), values.end());
+    CHECK(std::is_permutation(values.cbegin(), values.cend(), original.cbegin()));
+
+    Random rng_again(99);
+    auto values_again = original;
+    rng_again.shuffle(values_again.begin(), values_again.end());
+    CHECK(values == values_again);
+}
+
+} // Suite
@@ -0,0 +1,345 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/components/PieceQueue.h"
+#include "game/components/Well.h"
+#include "game/components/rotations/SRS.h"
+#include "game/replay/Keyframe.h"
+#include "game/replay/ReplayReader.h"
+#include "game/replay/ReplayWriter.h"
+#include "game/util/Random.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+SUITE(Replay) {
+
+const std::string replay_path = "openblok_test.replay";
+
+struct ReplayFixture {
+    Replay::Header header;
+
+    ReplayFixture() {
+        header.seed = 0x0123456789ABCDEFull;
+        header.game_mode = GameMode::MP_BATTLE;
+        header.well_config.lock_delay_type = LockDelayType::INFINITE;
+        header.well_config.rotation_style = RotationStyle::TGM;
+        header.well_config.shift_normal = 300;
+        header.well_config.tspin_allow_wallkick = false;
+    }
+    ~ReplayFixture() {
+        std::remove(replay_path.c_str());
+    }
+
+    std::vector<uint8_t> fileContent() const {
+        std::ifstream file(replay_path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_FIXTURE(ReplayFixture, Header)
+{
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        REQUIRE CHECK(writer.isOpen());
+    }
+
+    Replay::ReplayReader reader(replay_path);
+    CHECK_EQUAL(header.seed, reader.header().seed);
+    CHECK(reader.header().game_mode == GameMode::MP_BATTLE);
+    CHECK(reader.header().well_config.lock_delay_type == LockDelayType::INFINITE);
+    CHECK(reader.header().well_config.rotation_style == RotationStyle::TGM);
+    CHECK_EQUAL(300, reader.header().well_config.shift_normal);
+    CHECK_EQUAL(header.well_config.shift_turbo, reader.header().well_config.shift_turbo);
+    CHECK_EQUAL(true, reader.header().well_config.tspin_enabled);
+    CHECK_EQUAL(false, reader.header().well_config.tspin_allow_wallkick);
+    CHECK_EQUAL(Replay::format_version, reader.header().version);
+
+    std::vector<Replay::Record> records;
+    CHECK_EQUAL(false, reader.nextFrame(records));
+}
+
+TEST_FIXTURE(ReplayFixture, Frames)
+{
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        writer.beginFrame();
+        writer.record(Replay::Record::fromInput(InputType::GAME_HARDDROP, true, -1));
+        writer.record(Replay::Record::fromWindow(WindowEvent::FOCUS_LOST));
+        writer.beginFrame();
+        writer.beginFrame();
+        writer.record(Replay::Record::fromInput(InputType::GAME_HARDDROP, false, -1));
+        writer.record(Replay::Record::fromDevice(DeviceEventType::DISCONNECTED, 3));
+        for (unsigned i = 0; i < 1000; i++)
+            writer.beginFrame();
+        writer.record(Replay::Record::fromInput(InputType::MENU_CANCEL, true, 101));
+        writer.beginFrame();
+        CHECK_EQUAL(1004u, writer.frameCount());
+    }
+
+    Replay::ReplayReader reader(replay_path);
+    std::vector<Replay::Record> records;
+
+    REQUIRE CHECK(reader.nextFrame(records));
+    REQUIRE CHECK_EQUAL(2u, records.size());
+    CHECK(records[0].type == EventType::INPUT);
+    CHECK(records[0].input == InputType::GAME_HARDDROP);
+    CHECK_EQUAL(true, records[0].pressed);
+    CHECK_EQUAL(-1, records[0].device_id);
+    CHECK(records[1].type == EventType::WINDOW);
+    CHECK(records[1].window == WindowEvent::FOCUS_LOST);
+
+    REQUIRE CHECK(reader.nextFrame(records));
+    CHECK(records.empty());
+
+    REQUIRE CHECK(reader.nextFrame(records));
+    REQUIRE CHECK_EQUAL(2u, records.size());
+    CHECK_EQUAL(false, records[0].pressed);
+    CHECK(records[1].type == EventType::DEVICE);
+    CHECK(records[1].device_event == DeviceEventType::DISCONNECTED);
+    CHECK_EQUAL(3, records[1].device_id);
+
+    for (unsigned i = 0; i < 999; i++) {
+        REQUIRE CHECK(reader.nextFrame(records));
+        CHECK(records.empty());
+    }
+
+    REQUIRE CHECK(reader.nextFrame(records));
+    REQUIRE CHECK_EQUAL(1u, records.size());
+    CHECK(records[0].input == InputType::MENU_CANCEL);
+    CHECK_EQUAL(101, records[0].device_id);
+
+    // the last frame has no records
+    CHECK(reader.nextFrame(records));
+    CHECK_EQUAL(false, reader.nextFrame(records));
+    CHECK_EQUAL(1004u, reader.frameCount());
+}
+
+TEST_FIXTURE(ReplayFixture, ManyDevices)
+{
+    // there are less device slots than devices
+    const std::vector<DeviceID> devices = {-1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 100, 101, 0, 8, -1};
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        for (const DeviceID device_id : devices) {
+            writer.beginFrame();
+            writer.record(Replay::Record::fromInput(InputType::MENU_OK, true, device_id));
+        }
+    }
+
+    Replay::ReplayReader reader(replay_path);
+    std::vector<Replay::Record> records;
+    for (const DeviceID device_id : devices) {
+        REQUIRE CHECK(reader.nextFrame(records));
+        REQUIRE CHECK_EQUAL(1u, records.size());
+        CHECK_EQUAL(device_id, records[0].device_id);
+    }
+    CHECK_EQUAL(false, reader.nextFrame(records));
+}
+
+TEST_FIXTURE(ReplayFixture, Truncated)
+{
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        for (unsigned i = 0; i < 10; i++) {
+            writer.beginFrame();
+            writer.record(Replay::Record::fromInput(InputType::GAME_MOVE_LEFT, i % 2, -1));
+        }
+    }
+    auto data = fileContent();
+
+    // no end record, and a partially written record (eg. a crash during writing)
+    data.resize(data.size() - 3);
+    Replay::ReplayReader reader(std::move(data));
+    std::vector<Replay::Record> records;
+    for (unsigned i = 0; i < 9; i++)
+        CHECK(reader.nextFrame(records));
+    CHECK_EQUAL(false, reader.nextFrame(records));
+
+    CHECK_THROW(Replay::ReplayReader(std::vector<uint8_t>({'O', 'B'})), std::runtime_error);
+    CHECK_THROW(Replay::ReplayReader(std::vector<uint8_t>({'n', 'o', 'p', 'e', 1})), std::runtime_error);
+    CHECK_THROW(Replay::ReplayReader("not_existing.replay"), std::runtime_error);
+}
+
+TEST_FIXTURE(ReplayFixture, Keyframes)
+{
+    // a key tap in every frame, from a device that was assigned a slot before the keyframes;
+    // the first keyframe can't be saved until frame 5
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        for (uint32_t frame = 0; frame < 3000; frame++) {
+            writer.beginFrame();
+            if (frame >= 5 && writer.keyframeDue())
+                writer.writeKeyframe({static_cast<uint8_t>(frame >> 8), static_cast<uint8_t>(frame)});
+            writer.record(Replay::Record::fromInput(InputType::GAME_HOLD, frame % 2, 3));
+        }
+    }
+
+    Replay::ReplayReader reader(replay_path);
+    CHECK_EQUAL(3000u, reader.totalFrames());
+    CHECK_EQUAL(0u, reader.frameCount());
+    CHECK(reader.findKeyframe(4) == nullptr);
+
+    const auto* keyframe = reader.findKeyframe(1500);
+    REQUIRE CHECK(keyframe != nullptr);
+    CHECK_EQUAL(1205u, keyframe->frame);
+    CHECK_EQUAL(2405u, reader.findKeyframe(2999)->frame);
+    CHECK_EQUAL(5u, reader.findKeyframe(5)->frame);
+
+    const auto state = reader.seek(*keyframe);
+    REQUIRE CHECK_EQUAL(2u, state.size());
+    CHECK_EQUAL(1205, (state[0] << 8) | state[1]);
+
+    // the reading continues with the events of the keyframe's frame
+    std::vector<Replay::Record> records;
+    for (uint32_t frame = 1205; frame < 3000; frame++) {
+        REQUIRE CHECK(reader.nextFrame(records));
+        REQUIRE CHECK_EQUAL(1u, records.size());
+        CHECK_EQUAL(3, records[0].device_id);
+        CHECK_EQUAL(frame % 2, records[0].pressed);
+    }
+    CHECK_EQUAL(false, reader.nextFrame(records));
+
+    reader.rewind();
+    REQUIRE CHECK(reader.nextFrame(records));
+    CHECK_EQUAL(1u, reader.frameCount());
+    REQUIRE CHECK_EQUAL(1u, records.size());
+    CHECK_EQUAL(false, records[0].pressed);
+}
+
+TEST_FIXTURE(ReplayFixture, Checksums)
+{
+    // a checksum in every second, and a keyframe after one of them
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        for (uint32_t frame = 0; frame < 1000; frame++) {
+            writer.beginFrame();
+            if (frame >= 10 && writer.keyframeDue())
+                writer.writeKeyframe({1, 2, 3});
+            if (writer.checksumDue())
+                writer.writeChecksum(0xFEDCBA9876543210ull + frame);
+            if (frame % 7 == 0)
+                writer.record(Replay::Record::fromInput(InputType::GAME_HARDDROP, frame % 2, -1));
+        }
+    }
+
+    Replay::ReplayReader reader(replay_path);
+    std::vector<Replay::Record> records;
+    uint64_t checksum = 0;
+    unsigned checksum_count = 0;
+    for (uint32_t frame = 0; frame < 1000; frame++) {
+        REQUIRE CHECK(reader.nextFrame(records));
+        const bool has_checksum = reader.frameChecksum(checksum);
+        REQUIRE CHECK_EQUAL(frame % Replay::checksum_interval == 0, has_checksum);
+        if (has_checksum) {
+            CHECK_EQUAL(0xFEDCBA9876543210ull + frame, checksum);
+            checksum_count++;
+        }
+        // the checksums don't appear as events
+        CHECK_EQUAL(frame % 7 == 0 ? 1u : 0u, records.size());
+    }
+    CHECK_EQUAL(17u, checksum_count);
+
+    // after seeking, the checksums continue from the keyframe's frame
+    const auto* keyframe = reader.findKeyframe(700);
+    REQUIRE CHECK(keyframe != nullptr);
+    reader.seek(*keyframe);
+    REQUIRE CHECK(reader.nextFrame(records));
+    CHECK_EQUAL(false, reader.frameChecksum(checksum));
+    for (uint32_t frame = keyframe->frame + 1; frame <= 720; frame++)
+        REQUIRE CHECK(reader.nextFrame(records));
+    REQUIRE CHECK(reader.frameChecksum(checksum));
+    CHECK_EQUAL(0xFEDCBA9876543210ull + 720, checksum);
+}
+
+TEST(WellKeyframe)
+{
+    // random inputs and garbage, until the game is over
+    struct Frame {
+        std::vector<InputEvent> inputs;
+        unsigned short garbage_lines;
+    };
+    Random rng(42);
+    std::vector<Frame> frames(20 * 60);
+    for (auto& frame : frames) {
+        if (rng.below(4) == 0)
+            frame.inputs.emplace_back(static_cast<InputType>(1 + rng.below(7)), rng.below(2), -1);
+        frame.garbage_lines = (rng.below(1500) == 0) ? 1 : 0;
+    }
+
+    struct Player {
+        Well well;
+        PieceQueue queue;
+
+        Player() {
+            well.setRotationFn(std::make_unique<Rotations::SRS>());
+            well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [this](const WellEvent&){
+                well.addPiece(queue.next());
+            });
+        }
+        void update(const Frame& frame) {
+            well.update(frame.inputs);
+            well.addGarbageLines(frame.garbage_lines);
+        }
+    };
+
+    // save a keyframe in every few frames, in different states of the pieces
+    const unsigned keyframe_distance = 37;
+    Player original;
+    original.queue.setRandomSeed(7);
+    original.well.setRandomSeed(7);
+    std::vector<Replay::KeyframeWriter> keyframes;
+    std::vector<std::string> expected;
+    for (unsigned i = 0; i < frames.size(); i++) {
+        if (i % keyframe_distance == 0) {
+            keyframes.emplace_back();
+            keyframes.back().writeWell(original.well.snapshot());
+            keyframes.back().writePieceQueue(original.queue.snapshot());
+        }
+        original.update(frames[i]);
+        expected.push_back(original.well.asAscii());
+    }
+
+    // continue in a new game from every keyframe
+    for (unsigned k = 0; k < keyframes.size(); k++) {
+        Replay::KeyframeReader reader(keyframes[k].data());
+        Well::Snapshot well_state;
+        PieceQueue::Snapshot queue_state;
+        reader.readWell(well_state);
+        reader.readPieceQueue(queue_state);
+        REQUIRE CHECK(reader.atEnd());
+
+        Player restored;
+        restored.well.restore(well_state);
+        restored.queue.restore(queue_state);
+        for (unsigned i = k * keyframe_distance; i < frames.size(); i++) {
+            restored.update(frames[i]);
+            REQUIRE CHECK_EQUAL(expected[i], restored.well.asAscii());
+        }
+    }
+}
+
+TEST_FIXTURE(ReplayFixture, CompactSize)
+{
+    // two minutes of quick play, with a key tap in every 8 frames
+    Random rng(1);
+    {
+        Replay::ReplayWriter writer(replay_path, header);
+        for (unsigned frame = 0; frame < 2 * 60 * 60; frame++) {
+            writer.beginFrame();
+            if (frame % 8 == 0) {
+                const auto input = static_cast<InputType>(1 + rng.below(7));
+                writer.record(Replay::Record::fromInput(input, true, -1));
+            }
+            if (frame % 8 == 1) {
+                const auto input = static_cast<InputType>(1 + rng.below(7));
+                writer.record(Replay::Record::fromInput(input, false, -1));
+            }
+        }
+    }
+    CHECK(fileContent().size() < 4 * 1024);
+}
+
+}
@@ -0,0 +1,167 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/net/LoopbackTransport.h"
+#include "game/net/Rollback.h"
+#include "game/net/VersusMatch.h"
+#include "game/util/Random.h"
+
+#include <memory>
+
+
+SUITE(Rollback) {
+
+TEST(LoopbackConditions)
+{
+    Net::LinkConditions conditions;
+    conditions.latency = std::chrono::milliseconds(50);
+    conditions.jitter = std::chrono::milliseconds(20);
+    conditions.loss = 0.25;
+    Net::LoopbackLink link(conditions, 1);
+
+    for (uint8_t i = 0; i < 200; i++)
+        link.endpoint(0).send({i});
+
+    Net::Packet packet;
+    link.advance(std::chrono::milliseconds(49));
+    CHECK_EQUAL(false, link.endpoint(1).receive(packet));
+    link.advance(std::chrono::milliseconds(22));
+
+    unsigned received = 0;
+    while (link.endpoint(1).receive(packet)) {
+        REQUIRE CHECK_EQUAL(1u, packet.size());
+        received++;
+    }
+    CHECK_EQUAL(200u, link.sentPackets());
+    CHECK_EQUAL(200u - link.lostPackets(), received);
+    CHECK(received > 120 && received < 180);
+    CHECK_EQUAL(false, link.endpoint(0).receive(packet));
+}
+
+TEST(InputBits)
+{
+    std::vector<InputEvent> events;
+    events.emplace_back(InputType::GAME_MOVE_LEFT, true, 1);
+    events.emplace_back(InputType::GAME_HARDDROP, true, 1);
+    const Net::InputBits keys = Net::applyEvents(0, events);
+
+    events.clear();
+    Net::toEvents(keys, Net::applyEvents(keys, {InputEvent(InputType::GAME_HARDDROP, false, 1)}), 1, events);
+    REQUIRE CHECK_EQUAL(1u, events.size());
+    CHECK(events[0].type() == InputType::GAME_HARDDROP);
+    CHECK_EQUAL(false, events[0].down());
+}
+
+struct Peer {
+    Net::VersusMatch match;
+    Net::RollbackSession session;
+
+    Peer(Net::Transport& transport, unsigned player, const Net::RollbackSettings& settings,
+         uint64_t seed = 77)
+        : match(WellConfig(), seed, Net::RollbackSession::stateSlots(settings))
+        , session(match, transport, player, settings)
+    {}
+};
+
+TEST(SidesStayInSync)
+{
+    // random movements and rotations, sometimes a hold or a hard drop;
+    // a different sequence for both players
+    constexpr unsigned frame_count = 1200;
+    std::array<std::vector<Net::InputBits>, Net::player_count> keys;
+    Random rng(3);
+    for (auto& player_keys : keys) {
+        player_keys.resize(frame_count);
+        for (unsigned frame = 1; frame < frame_count; frame++) {
+            InputType input = static_cast<InputType>(4 + rng.below(4));
+            if (rng.below(10) == 0)
+                input = rng.below(4) == 0 ? InputType::GAME_HOLD : InputType::GAME_HARDDROP;
+            if (rng.below(4) == 0)
+                player_keys[frame] = 1u << static_cast<uint8_t>(input);
+        }
+    }
+
+    Net::RollbackSettings settings;
+    settings.input_delay = 2;
+    settings.max_rollback = 8;
+
+    // the expected result, when every input is known in advance
+    Net::VersusMatch reference(WellConfig(), 77, 1);
+    for (unsigned frame = 0; frame < frame_count + settings.input_delay; frame++) {
+        std::array<Net::InputBits, Net::player_count> frame_keys = {{0, 0}};
+        if (frame >= settings.input_delay && frame - settings.input_delay < frame_count) {
+            for (unsigned player = 0; player < Net::player_count; player++)
+                frame_keys[player] = keys[player][frame - settings.input_delay];
+        }
+        reference.advanceFrame(frame_keys);
+    }
+
+    Net::LinkConditions conditions;
+    conditions.latency = std::chrono::milliseconds(40);
+    conditions.jitter = std::chrono::milliseconds(30);
+    conditions.loss = 0.1;
+    Net::LoopbackLink link(conditions, 5);
+    std::array<std::unique_ptr<Peer>, Net::player_count> peers;
+    for (unsigned player = 0; player < Net::player_count; player++)
+        peers[player] = std::make_unique<Peer>(link.endpoint(player), player, settings);
+
+    // after its last input, every side waits for the other to confirm everything
+    const uint32_t last_frame = frame_count + settings.input_delay;
+    for (unsigned tick = 0; tick < 100000; tick++) {
+        bool done = true;
+        for (unsigned player = 0; player < Net::player_count; player++) {
+            auto& session = peers[player]->session;
+            if (session.frame() < last_frame) {
+                const uint32_t input_frame = session.frame();
+                session.update(input_frame < frame_count ? keys[player][input_frame] : 0);
+            }
+            else
+                session.poll();
+            done = done && session.confirmedFrame() == last_frame;
+        }
+        if (done)
+            break;
+        link.advance(Timing::frame_duration);
+    }
+
+    for (const auto& peer : peers) {
+        const auto& stats = peer->session.stats();
+        REQUIRE CHECK_EQUAL(last_frame, peer->session.confirmedFrame());
+        CHECK(stats.rollbacks > 0);
+        CHECK(stats.max_rollback_depth <= settings.max_rollback);
+        CHECK(stats.resimulated_frames >= stats.rollbacks);
+        CHECK(stats.verified_checksums > 0);
+        CHECK_EQUAL(false, stats.desynced);
+
+        // the match stops counting the frames when a player tops out
+        CHECK_EQUAL(reference.frame(), peer->match.frame());
+        CHECK_EQUAL(reference.stateHash(), peer->match.stateHash());
+        for (unsigned player = 0; player < Net::player_count; player++) {
+            CHECK_EQUAL(reference.well(player).asAscii(), peer->match.well(player).asAscii());
+            CHECK_EQUAL(reference.isPlaying(player), peer->match.isPlaying(player));
+        }
+    }
+}
+
+TEST(DetectDesync)
+{
+    // the two sides play different matches
+    Net::RollbackSettings settings;
+    Net::LoopbackLink link(Net::LinkConditions(), 1);
+    Peer first(link.endpoint(0), 0, settings, 77);
+    Peer second(link.endpoint(1), 1, settings, 78);
+
+    for (unsigned frame = 0; frame < 3 * Net::RollbackSession::checksum_interval; frame++) {
+        first.session.update(0);
+        second.session.update(0);
+        link.advance(Timing::frame_duration);
+    }
+
+    for (const Peer* peer : {&first, &second}) {
+        const auto& stats = peer->session.stats();
+        CHECK_EQUAL(true, stats.desynced);
+        CHECK_EQUAL(0u, stats.desync_frame);
+        CHECK_EQUAL(0u, stats.verified_checksums);
+    }
+}
+
+}
@@ -0,0 +1,88 @@
+#include "UnitTest++/UnitTest++.h"
+
+#include "game/net/UdpTransport.h"
+
+#include <chrono>
+#include <thread>
+
+
+SUITE(UdpTransport) {
+
+// the sockets are bound to these local ports
+constexpr uint16_t port_a = 47301;
+constexpr uint16_t port_b = 47302;
+constexpr uint16_t port_other = 47303;
+
+/// The packets may take a moment to arrive, even on the loopback interface
+bool receiveWithin(Net::Transport& transport, Net::Packet& packet)
+{
+    for (unsigned tries = 0; tries < 100; tries++) {
+        if (transport.receive(packet))
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+TEST(SendReceive)
+{
+    Net::UdpTransport side_a(port_a, "127.0.0.1", port_b);
+    Net::UdpTransport side_b(port_b, "127.0.0.1", port_a);
+
+    Net::Packet packet;
+    CHECK_EQUAL(false, side_a.receive(packet));
+    CHECK(packet.empty());
+
+    side_a.send({1, 2, 3});
+    REQUIRE CHECK(receiveWithin(side_b, packet));
+    CHECK(packet == Net::Packet({1, 2, 3}));
+
+    side_b.send({4});
+    side_b.send({5, 6});
+    REQUIRE CHECK(receiveWithin(side_a, packet));
+    CHECK(packet == Net::Packet({4}));
+    REQUIRE CHECK(receiveWithin(side_a, packet));
+    CHECK(packet == Net::Packet({5, 6}));
+
+    // everything was read
+    CHECK_EQUAL(false, side_a.receive(packet));
+    CHECK_EQUAL(false, side_b.receive(packet));
+}
+
+TEST(ForeignSenderDropped)
+{
+    Net::UdpTransport side_a(port_a, "127.0.0.1", port_b);
+    Net::UdpTransport side_b(port_b, "127.0.0.1", port_a);
+    Net::UdpTransport other(port_other, "127.0.0.1", port_a);
+
+    Net::Packet packet;
+    other.send({9, 9});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK_EQUAL(false, side_a.receive(packet));
+
+    // the packets of the peer are still read after the foreign ones
+    other.send({9, 9});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    side_b.send({7});
+    REQUIRE CHECK(receiveWithin(side_a, packet));
+    CHECK(packet == Net::Packet({7}));
+    CHECK_EQUAL(false, side_a.receive(packet));
+}
+
+TEST(EmptyDatagramDropped)
+{
+    Net::UdpTransport side_a(port_a, "127.0.0.1", port_b);
+    Net::UdpTransport side_b(port_b, "127.0.0.1", port_a);
+
+    Net::Packet packet;
+    side_b.send({});
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK_EQUAL(false, side_a.receive(packet));
+
+    side_b.send({});
+    side_b.send({8});
+    REQUIRE CHECK(receiveWithin(side_a, packet));
+    CHECK(packet == Net::Packet({8}));
+}
+
+}
@@ -1,11 +1,14 @@
 #include "UnitTest++/UnitTest++.h"
 
 #include "game/WellConfig.h"
-#include "game/components/MinoStorage.h"
+#include "game/components/PieceQueue.h"
 #include "game/components/PieceType.h"
-#include "game/components/PieceFactory.h"
 #include "game/components/Well.h"
-#include "game/components/rotations/SRS.h"
+#include "game/util/Random.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 
 SUITE(Well) {
@@ -19,13 +22,9 @@ struct WellFixture {
     std::string emptyline_ascii;
 
     WellFixture() {
-        MinoStorage::loadDummyMinos();
-
         for (unsigned i = 0; i < 10; i++)
             emptyline_ascii += '.';
         emptyline_ascii += '\n';
-
-        PieceFactory::changeInitialPositions(Rotations::SRS().initialPositions());
     }
 };
 
@@ -201,9 +200,130 @@ TEST_FIXTURE(WellFixture, Rotate) {
     CHECK_EQUAL(expected_ascii, well.asAscii());
 }
 
+TEST_FIXTURE(WellFixture, LineClearAndGarbage) {
+    std::string base_ascii;
+    for (unsigned i = 0; i < 18; i++)
+        base_ascii += emptyline_ascii;
+    base_ascii += "Z.........\n";
+    base_ascii += "SSSSSSSSS.\n";
+    base_ascii += "TTTTTTTT..\n";
+    base_ascii += "OOOOOOOOO.\n";
+    well.fromAscii(base_ascii);
+
+    well.addPiece(PieceType::I);
+    well.update({InputEvent(InputType::GAME_ROTATE_RIGHT, true)});
+    well.update({InputEvent(InputType::GAME_ROTATE_RIGHT, false)});
+    for (unsigned i = 0; i < 4; i++) {
+        well.update({InputEvent(InputType::GAME_MOVE_RIGHT, true)});
+        well.update({InputEvent(InputType::GAME_MOVE_RIGHT, false)});
+    }
+    well.update({InputEvent(InputType::GAME_HARDDROP, true)});
+    well.update({InputEvent(InputType::GAME_HARDDROP, false)});
+    // wait for the line clear
+    for (unsigned i = 0; i < 100; i++)
+        well.update({});
+
+    std::string expected_ascii;
+    for (unsigned i = 0; i < 20; i++)
+        expected_ascii += emptyline_ascii;
+    expected_ascii += "Z........I\n";
+    expected_ascii += "TTTTTTTT.I\n";
+    CHECK_EQUAL(expected_ascii, well.asAscii());
+
+    well.deletePiece();
+    well.addGarbageLines(2);
+    const std::string ascii = well.asAscii();
+    const size_t line_length = emptyline_ascii.length();
+    CHECK_EQUAL("Z........I\nTTTTTTTT.I\n", ascii.substr(18 * line_length, 2 * line_length));
+    for (unsigned row = 20; row < 22; row++) {
+        const std::string garbage_line = ascii.substr(row * line_length, line_length);
+        CHECK_EQUAL(9, std::count(garbage_line.begin(), garbage_line.end(), '+'));
+        CHECK_EQUAL(1, std::count(garbage_line.begin(), garbage_line.end(), '.'));
+    }
+}
+
+TEST(GhostUnderOverhang) {
+    std::string emptyline_ascii;
+    for (unsigned i = 0; i < 10; i++)
+        emptyline_ascii += '.';
+    emptyline_ascii += '\n';
+
+    WellConfig cfg;
+    cfg.instant_harddrop = false;
+    Well well(std::move(cfg));
+
+    std::string base_ascii;
+    for (unsigned i = 0; i < 19; i++)
+        base_ascii += emptyline_ascii;
+    base_ascii += "......OOOO\n";
+    base_ascii += "..........\n";
+    base_ascii += "OOOOOOOOO.\n";
+    well.fromAscii(base_ascii);
+
+    well.addPiece(PieceType::I);
+    // move to the left wall
+    for (unsigned i = 0; i < 3; i++) {
+        well.update({InputEvent(InputType::GAME_MOVE_LEFT, true)});
+        well.update({InputEvent(InputType::GAME_MOVE_LEFT, false)});
+    }
+    // sonic drop
+    well.update({InputEvent(InputType::GAME_HARDDROP, true)});
+    well.update({InputEvent(InputType::GAME_HARDDROP, false)});
+    // tuck under the overhang
+    for (unsigned i = 0; i < 3; i++) {
+        well.update({InputEvent(InputType::GAME_MOVE_RIGHT, true)});
+        well.update({InputEvent(InputType::GAME_MOVE_RIGHT, false)});
+    }
+    REQUIRE CHECK(well.activePiece() != nullptr);
+
+    // the ghost must stay under the overhang too
+    std::string expected_ascii;
+    for (unsigned i = 0; i < 19; i++)
+        expected_ascii += emptyline_ascii;
+    expected_ascii += "......OOOO\n";
+    expected_ascii += "...iiii...\n";
+    expected_ascii += "OOOOOOOOO.\n";
+
+    CHECK_EQUAL(expected_ascii, well.asAscii());
+}
+
+TEST_FIXTURE(WellFixture, GhostOnGarbage) {
+    well.addPiece(PieceType::I);
+    well.addGarbageLines(2);
+
+    const std::string ascii = well.asAscii();
+    const size_t line_length = emptyline_ascii.length();
+    CHECK_EQUAL("...gggg...\n", ascii.substr(19 * line_length, line_length));
+}
+
+TEST(NarrowWell) {
+    NarrowWell well;
+    std::string expected_ascii;
+    for (unsigned i = 0; i < 22; i++)
+        expected_ascii += "....\n";
+    CHECK_EQUAL(expected_ascii, well.asAscii());
+
+    well.addPiece(PieceType::O);
+    well.update({InputEvent(InputType::GAME_HARDDROP, true)});
+    well.update({InputEvent(InputType::GAME_HARDDROP, false)});
+    well.addPiece(PieceType::I);
+    well.update({InputEvent(InputType::GAME_MOVE_RIGHT, true)});
+    well.update({InputEvent(InputType::GAME_MOVE_RIGHT, false)});
+
+    expected_ascii = "";
+    for (unsigned i = 0; i < 3; i++)
+        expected_ascii += "....\n";
+    expected_ascii += "iiii\n";
+    for (unsigned i = 0; i < 15; i++)
+        expected_ascii += "....\n";
+    expected_ascii += "gggg\n";
+    expected_ascii += ".OO.\n";
+    expected_ascii += ".OO.\n";
+    CHECK_EQUAL(expected_ascii, well.asAscii());
+}
+
 TEST(Zangi) {
     std::string emptyline_ascii;
-    MinoStorage::loadDummyMinos();
     for (unsigned i = 0; i < 10; i++)
         emptyline_ascii += '.';
     emptyline_ascii += '\n';
@@ -257,4 +377,141 @@ TEST(Zangi) {
     CHECK_EQUAL(expected_ascii, well.asAscii());
 }
 
+TEST(SnapshotRollback) {
+    Well well;
+    PieceQueue queue(5);
+    well.setRandomSeed(5);
+    well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [&well, &queue](const WellEvent&){
+        well.addPiece(queue.next());
+    });
+
+    // random key taps and garbage
+    Random rng(11);
+    std::array<std::vector<InputEvent>, 600> frame_inputs;
+    for (auto& inputs : frame_inputs) {
+        if (rng.below(3) == 0)
+            inputs.emplace_back(static_cast<InputType>(1 + rng.below(7)), rng.below(2), -1);
+    }
+    auto play = [&](unsigned frame){
+        well.update(frame_inputs[frame]);
+        if (frame % 150 == 0)
+            well.addGarbageLines(1);
+    };
+
+    for (unsigned frame = 0; frame < 300; frame++)
+        play(frame);
+
+    // the snapshots are plain data, they can be stored as raw bytes
+    std::array<uint8_t, sizeof(Well::Snapshot) + sizeof(PieceQueue::Snapshot)> saved_bytes;
+    {
+        const Well::Snapshot well_state = well.snapshot();
+        const PieceQueue::Snapshot queue_state = queue.snapshot();
+        std::memcpy(saved_bytes.data(), &well_state, sizeof(well_state));
+        std::memcpy(saved_bytes.data() + sizeof(well_state), &queue_state, sizeof(queue_state));
+    }
+
+    std::vector<std::string> expected;
+    for (unsigned frame = 300; frame < frame_inputs.size(); frame++) {
+        play(frame);
+        expected.push_back(well.asAscii());
+    }
+
+    // roll back to the saved state multiple times
+    for (unsigned rollback = 0; rollback < 2; rollback++) {
+        Well::Snapshot well_state;
+        PieceQueue::Snapshot queue_state;
+        std::memcpy(&well_state, saved_bytes.data(), sizeof(well_state));
+        std::memcpy(&queue_state, saved_bytes.data() + sizeof(well_state), sizeof(queue_state));
+        well.restore(well_state);
+        queue.restore(queue_state);
+
+        for (unsigned frame = 300; frame < frame_inputs.size(); frame++) {
+            play(frame);
+            REQUIRE CHECK_EQUAL(expected[frame - 300], well.asAscii());
+        }
+    }
+}
+
+TEST(StateHash) {
+    Well well;
+    PieceQueue queue(9);
+    well.setRandomSeed(9);
+    well.registerObserver(WellEvent::Type::NEXT_REQUESTED, [&well, &queue](const WellEvent&){
+        well.addPiece(queue.next());
+    });
+    bool gameover = false;
+    well.registerObserver(WellEvent::Type::GAME_OVER, [&gameover](const WellEvent&){
+        gameover = true;
+    });
+
+    // the incrementally updated board hash is always the same as a full one,
+    // after locks, line clears and garbage
+    Random rng(13);
+    std::vector<InputEvent> inputs;
+    std::vector<uint64_t> hashes;
+    for (unsigned frame = 0; frame < 1200 && !gameover; frame++) {
+        inputs.clear();
+        if (rng.below(3) == 0)
+            inputs.emplace_back(static_cast<InputType>(1 + rng.below(7)), rng.below(2), -1);
+        well.update(inputs);
+        if (frame % 200 == 0)
+            well.addGarbageLines(1 + rng.below(3));
+
+        REQUIRE CHECK_EQUAL(well.lockedMinos().calculateHash(), well.lockedMinos().hash());
+        hashes.push_back(well.stateHash());
+    }
+    CHECK(well.lockedMinos().hash() != Well().lockedMinos().hash());
+
+    // the state changes in (almost) every frame, eg. the timers
+    std::sort(hashes.begin(), hashes.end());
+    const auto unique_count = std::distance(hashes.begin(), std::unique(hashes.begin(), hashes.end()));
+    CHECK(unique_count > static_cast<long>(hashes.size() * 9 / 10));
+
+    // the same state has the same hash, even in a different well
+    Well copy;
+    copy.restore(well.snapshot());
+    CHECK_EQUAL(well.stateHash(), copy.stateHash());
+    CHECK_EQUAL(well.lockedMinos().hash(), copy.lockedMinos().hash());
+}
+
+TEST(BoardColumnTops) {
+    // the incrementally updated column heights and hash are always
+    // the same as the recalculated ones, after every kind of change
+    Well::Board board;
+    Random rng(7);
+    for (unsigned step = 0; step < 2000; step++) {
+        const unsigned row = Well::height - 1 - rng.below(Well::height / 2);
+        const unsigned col = rng.below(Well::width);
+        switch (rng.below(4)) {
+            case 0:
+                board.setCell(row, col, PieceType::GARBAGE);
+                break;
+            case 1:
+                if (board.isOccupied(row, col))
+                    board.clearCell(row, col);
+                break;
+            case 2:
+                board.addGarbageRows(rng.below(3), col);
+                break;
+            case 3: {
+                // a line clear, sometimes with rows that aren't full
+                Well::Board::RowSet cleared_rows = board.fullRows(0, Well::height - 1);
+                if (rng.below(4) == 0)
+                    cleared_rows |= Well::Board::RowSet(1) << row;
+                board.clearRows(cleared_rows);
+                board.removeRows(cleared_rows);
+                break;
+            }
+        }
+
+        for (unsigned c = 0; c < Well::width; c++) {
+            unsigned top = 0;
+            while (top < Well::height && !board.isOccupied(top, c))
+                top++;
+            REQUIRE CHECK_EQUAL(top, board.columnTop(c));
+        }
+        REQUIRE CHECK_EQUAL(board.calculateHash(), board.hash());
+    }
+}
+
 } // Suite
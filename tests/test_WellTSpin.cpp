@@ -1,7 +1,5 @@
 #include "UnitTest++/UnitTest++.h"
 
-#include "game/components/MinoStorage.h"
-#include "game/components/PieceFactory.h"
 #include "game/components/Well.h"
 #include "game/components/rotations/SRS.h"
 
@@ -16,13 +14,10 @@ struct WellFixture {
     std::string emptyline_ascii;
 
     WellFixture() {
-        MinoStorage::loadDummyMinos();
-
         for (unsigned i = 0; i < 10; i++)
             emptyline_ascii += '.';
         emptyline_ascii += '\n';
 
-        PieceFactory::changeInitialPositions(Rotations::SRS().initialPositions());
         well.setRotationFn(std::make_unique<Rotations::SRS>());
     }
 };
@@ -1,8 +1,6 @@
 #include "UnitTest++/UnitTest++.h"
 
 #include "game/WellConfig.h"
-#include "game/components/MinoStorage.h"
-#include "game/components/PieceFactory.h"
 #include "game/components/Well.h"
 #include "game/components/rotations/TGM.h"
 
@@ -18,13 +16,10 @@ struct WellFixture {
         cfg.instant_harddrop = false;
         well = std::make_unique<Well>(std::move(cfg));
 
-        MinoStorage::loadDummyMinos();
-
         for (unsigned i = 0; i < 10; i++)
             emptyline_ascii += '.';
         emptyline_ascii += '\n';
 
-        PieceFactory::changeInitialPositions(Rotations::TGM().initialPositions());
         well->setRotationFn(std::make_unique<Rotations::TGM>());
     }
 };